@@ -100,6 +100,7 @@ add_library(core
   fboss/agent/ApplyThriftConfig.cpp
   fboss/agent/ArpCache.cpp
   fboss/agent/ArpHandler.cpp
+  fboss/agent/AsyncStateObserverQueue.cpp
   fboss/agent/DHCPv4Handler.cpp
   fboss/agent/DHCPv6Handler.cpp
   fboss/agent/FibHelpers.cpp
@@ -124,6 +125,7 @@ add_library(core
   fboss/agent/MirrorManagerImpl.cpp
   fboss/agent/MPLSHandler.cpp
   fboss/agent/NdpCache.cpp
+  fboss/agent/NeighborStateUpdateBatcher.cpp
   fboss/agent/NeighborUpdater.cpp
   fboss/agent/NeighborUpdaterImpl.cpp
   fboss/agent/PortUpdateHandler.cpp
@@ -134,6 +136,7 @@ add_library(core
   fboss/agent/RouteUpdateLogger.cpp
   fboss/agent/RouteUpdateLoggingPrefixTracker.cpp
   fboss/agent/RouteUpdateWrapper.cpp
+  fboss/agent/RxPacketDispatcher.cpp
   fboss/agent/StandaloneRibConversions.cpp
   fboss/agent/StaticL2ForNeighborObserver.cpp
   fboss/agent/StaticL2ForNeighborUpdater.cpp
@@ -191,6 +194,7 @@ target_link_libraries(error
 )
 
 add_library(handler
+  fboss/agent/TableUpdatePublisher.cpp
   fboss/agent/ThriftHandler.cpp
 )
 
@@ -58,6 +58,7 @@ target_link_libraries(hw_switch_warmboot_helper
   async_logger
   utils
   common_file_utils
+  switch_state_cpp2
   Folly::folly
 )
 
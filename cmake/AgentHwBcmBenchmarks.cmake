@@ -184,6 +184,24 @@ target_link_libraries(bcm_stats_collection_speed
   -Wl,--no-whole-archive
 )
 
+add_executable(bcm_stats_collection_all_ports_and_queues_speed /dev/null)
+
+target_link_libraries(bcm_stats_collection_all_ports_and_queues_speed
+  -Wl,--whole-archive
+  bcm_switch_ensemble
+  hw_stats_collection_all_ports_and_queues_speed
+  -Wl,--no-whole-archive
+)
+
+add_executable(bcm_route_churn_with_stats_collection_speed /dev/null)
+
+target_link_libraries(bcm_route_churn_with_stats_collection_speed
+  -Wl,--whole-archive
+  bcm_switch_ensemble
+  hw_route_churn_with_stats_collection_speed
+  -Wl,--no-whole-archive
+)
+
 add_executable(bcm_tx_slow_path_rate /dev/null)
 
 target_link_libraries(bcm_tx_slow_path_rate
@@ -286,6 +304,23 @@ target_link_libraries(bcm_rib_resolution_speed
   Folly::follybenchmark
 )
 
+add_executable(bcm_rib_resolution_single_prefix_churn_speed /dev/null)
+
+target_link_libraries(bcm_rib_resolution_single_prefix_churn_speed
+  -Wl,--whole-archive
+  bcm
+  config
+  bcm_switch_ensemble
+  config_factory
+  hw_rib_resolution_single_prefix_churn_speed
+  route_scale_gen
+  -Wl,--no-whole-archive
+  hw_benchmark_main
+  Folly::folly
+  ${OPENNSA}
+  Folly::follybenchmark
+)
+
 add_executable(bcm_rib_sync_fib_speed /dev/null)
 
 target_link_libraries(bcm_rib_sync_fib_speed
@@ -303,6 +338,23 @@ target_link_libraries(bcm_rib_sync_fib_speed
   Folly::follybenchmark
 )
 
+add_executable(bcm_rib_sync_fib_resolution_threads_speed /dev/null)
+
+target_link_libraries(bcm_rib_sync_fib_resolution_threads_speed
+  -Wl,--whole-archive
+  bcm
+  config
+  bcm_switch_ensemble
+  config_factory
+  hw_rib_sync_fib_resolution_threads_speed
+  route_scale_gen
+  -Wl,--no-whole-archive
+  hw_benchmark_main
+  Folly::folly
+  ${OPENNSA}
+  Folly::follybenchmark
+)
+
 add_executable(bcm_rib_conversion_speed /dev/null)
 
 target_link_libraries(bcm_rib_conversion_speed
@@ -332,6 +384,8 @@ if (BENCHMARK_INSTALL)
   install(TARGETS bcm_hgrid_uu_scale_route_add_speed)
   install(TARGETS bcm_hgrid_uu_scale_route_del_speed)
   install(TARGETS bcm_stats_collection_speed)
+  install(TARGETS bcm_stats_collection_all_ports_and_queues_speed)
+  install(TARGETS bcm_route_churn_with_stats_collection_speed)
   install(TARGETS bcm_tx_slow_path_rate)
   install(TARGETS bcm_warm_boot_exit_speed)
   install(TARGETS bcm_rx_slow_path_rate)
@@ -341,6 +395,8 @@ if (BENCHMARK_INSTALL)
   install(TARGETS bcm_init_and_exit_100Gx50G)
   install(TARGETS bcm_init_and_exit_100Gx100G)
   install(TARGETS bcm_rib_resolution_speed)
+  install(TARGETS bcm_rib_resolution_single_prefix_churn_speed)
   install(TARGETS bcm_rib_sync_fib_speed)
+  install(TARGETS bcm_rib_sync_fib_resolution_threads_speed)
   install(TARGETS bcm_rib_conversion_speed)
 endif()
@@ -21,10 +21,21 @@ add_library(hw_warm_boot_exit_speed
 target_link_libraries(hw_warm_boot_exit_speed
   config_factory
   hw_switch_ensemble
+  hw_switch_warmboot_helper
   route_scale_gen
   Folly::folly
 )
 
+add_library(hw_stats_collection_benchmark_helper
+  fboss/agent/hw/benchmarks/HwStatsCollectionBenchmarkHelper.cpp
+)
+
+target_link_libraries(hw_stats_collection_benchmark_helper
+  hw_switch_ensemble
+  Folly::folly
+  Folly::follybenchmark
+)
+
 add_library(hw_stats_collection_speed
   fboss/agent/hw/benchmarks/HwStatsCollectionBenchmark.cpp
 )
@@ -34,6 +45,34 @@ target_link_libraries(hw_stats_collection_speed
   hw_packet_utils
   ecmp_helper
   hw_benchmark_main
+  hw_stats_collection_benchmark_helper
+  Folly::folly
+  Folly::follybenchmark
+)
+
+add_library(hw_stats_collection_all_ports_and_queues_speed
+  fboss/agent/hw/benchmarks/HwStatsCollectionAllPortsAndQueuesBenchmark.cpp
+)
+
+target_link_libraries(hw_stats_collection_all_ports_and_queues_speed
+  config_factory
+  hw_packet_utils
+  ecmp_helper
+  hw_benchmark_main
+  hw_stats_collection_benchmark_helper
+  Folly::folly
+  Folly::follybenchmark
+)
+
+add_library(hw_route_churn_with_stats_collection_speed
+  fboss/agent/hw/benchmarks/HwRouteChurnWithStatsCollectionBenchmark.cpp
+)
+
+target_link_libraries(hw_route_churn_with_stats_collection_speed
+  config_factory
+  hw_switch_ensemble
+  route_scale_gen
+  hw_benchmark_main
   Folly::folly
   Folly::follybenchmark
 )
@@ -152,6 +191,16 @@ target_link_libraries(hw_rib_resolution_speed
   Folly::folly
 )
 
+add_library(hw_rib_resolution_single_prefix_churn_speed
+  fboss/agent/hw/benchmarks/HwRibResolutionSinglePrefixChurnBenchmark.cpp
+)
+
+target_link_libraries(hw_rib_resolution_single_prefix_churn_speed
+  config_factory
+  hw_benchmark_main
+  Folly::folly
+)
+
 add_library(hw_rib_sync_fib_speed
   fboss/agent/hw/benchmarks/HwRibSyncFibBenchmark.cpp
 )
@@ -162,6 +211,16 @@ target_link_libraries(hw_rib_sync_fib_speed
   Folly::folly
 )
 
+add_library(hw_rib_sync_fib_resolution_threads_speed
+  fboss/agent/hw/benchmarks/HwRibSyncFibResolutionThreadsBenchmark.cpp
+)
+
+target_link_libraries(hw_rib_sync_fib_resolution_threads_speed
+  config_factory
+  hw_benchmark_main
+  Folly::folly
+)
+
 add_library(hw_ecmp_shrink_speed
   fboss/agent/hw/benchmarks/HwEcmpShrinkSpeedBenchmark.cpp
 )
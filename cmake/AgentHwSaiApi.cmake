@@ -43,6 +43,7 @@ set(SAI_API_SRC
   fboss/agent/hw/sai/api/QosMapApi.cpp
   fboss/agent/hw/sai/api/RouteApi.cpp
   fboss/agent/hw/sai/api/SaiApiLock.cpp
+  fboss/agent/hw/sai/api/SaiBulkWrites.cpp
   fboss/agent/hw/sai/api/SaiApiTable.cpp
   fboss/agent/hw/sai/api/SwitchApi.cpp
   fboss/agent/hw/sai/api/Types.cpp
@@ -64,6 +65,7 @@ set(SAI_API_SRC
   fboss/agent/hw/sai/api/SaiApiError.h
   fboss/agent/hw/sai/api/SaiAttribute.h
   fboss/agent/hw/sai/api/SaiAttributeDataTypes.h
+  fboss/agent/hw/sai/api/SaiBulkWrites.h
   fboss/agent/hw/sai/api/SaiObjectApi.h
   fboss/agent/hw/sai/api/SaiVersion.h
   fboss/agent/hw/sai/api/SamplePacketApi.h
@@ -44,3 +44,20 @@ set_target_properties(store_test PROPERTIES COMPILE_FLAGS
 )
 
 gtest_discover_tests(store_test)
+
+add_executable(sai_store_reload_benchmark
+    fboss/agent/hw/sai/store/tests/SaiStoreReloadBenchmark.cpp
+)
+
+target_link_libraries(sai_store_reload_benchmark
+    sai_store
+    fake_sai
+    Folly::folly
+    Folly::follybenchmark
+)
+
+set_target_properties(sai_store_reload_benchmark PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
@@ -23,6 +23,7 @@ add_library(sai_tracer
   fboss/agent/hw/sai/tracer/QueueApiTracer.cpp
   fboss/agent/hw/sai/tracer/RouteApiTracer.cpp
   fboss/agent/hw/sai/tracer/RouterInterfaceApiTracer.cpp
+  fboss/agent/hw/sai/tracer/SaiBinaryTrace.cpp
   fboss/agent/hw/sai/tracer/SaiTracer.cpp
   fboss/agent/hw/sai/tracer/SamplePacketApiTracer.cpp
   fboss/agent/hw/sai/tracer/SchedulerApiTracer.cpp
@@ -52,3 +53,58 @@ target_link_options(sai_tracer
   "LINKER:-wrap,sai_api_query"
   "LINKER:-wrap,sai_api_initialize"
 )
+
+# Turns binary traces into replayable C code. The tracer wraps the SAI entry
+# points, so it still needs a SAI implementation to link, though none is called.
+add_executable(sai_replayer_gen
+  fboss/agent/hw/sai/tracer/gen/Main.cpp
+)
+
+target_link_libraries(sai_replayer_gen
+  sai_tracer
+  fake_sai
+  Folly::folly
+)
+
+set_target_properties(sai_replayer_gen PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
+
+add_executable(sai_tracer_benchmark
+  fboss/agent/hw/sai/tracer/test/SaiTracerBenchmark.cpp
+)
+
+target_link_libraries(sai_tracer_benchmark
+  sai_tracer
+  fake_sai
+  Folly::folly
+  Folly::follybenchmark
+)
+
+set_target_properties(sai_tracer_benchmark PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
+
+add_executable(sai_binary_trace_test
+  fboss/agent/test/oss/Main.cpp
+  fboss/agent/hw/sai/tracer/test/SaiBinaryTraceTest.cpp
+)
+
+target_link_libraries(sai_binary_trace_test
+  sai_tracer
+  fake_sai
+  Folly::folly
+  ${GTEST}
+)
+
+set_target_properties(sai_binary_trace_test PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
+
+gtest_discover_tests(sai_binary_trace_test)
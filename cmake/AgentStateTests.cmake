@@ -0,0 +1,38 @@
+# CMake to build libraries and binaries in fboss/agent/state/tests
+
+# In general, libraries and binaries in fboss/foo/bar are built by
+# cmake/FooBar.cmake
+
+add_executable(persistent_node_container_test
+  fboss/agent/test/oss/Main.cpp
+  fboss/agent/state/tests/PersistentNodeContainerTests.cpp
+)
+
+target_link_libraries(persistent_node_container_test
+  state
+  Folly::folly
+  ${GTEST}
+  ${LIBGMOCK_LIBRARIES}
+)
+
+gtest_discover_tests(persistent_node_container_test)
+
+add_executable(node_map_clone_benchmark
+  fboss/agent/state/tests/NodeMapCloneBenchmark.cpp
+)
+
+target_link_libraries(node_map_clone_benchmark
+  state
+  Folly::folly
+  Folly::follybenchmark
+)
+
+add_executable(state_delta_benchmark
+  fboss/agent/state/tests/StateDeltaBenchmark.cpp
+)
+
+target_link_libraries(state_delta_benchmark
+  state
+  Folly::folly
+  Folly::follybenchmark
+)
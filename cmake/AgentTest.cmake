@@ -85,3 +85,56 @@ target_link_libraries(multinode_tests
   ${GTEST}
   ${LIBGMOCK_LIBRARIES}
 )
+
+# Depends on the Sim implementation, which is not part of fboss_agent
+add_executable(tun_intf_benchmark
+  fboss/agent/test/TunIntfBenchmark.cpp
+  fboss/agent/hw/sim/SimPlatform.cpp
+  fboss/agent/hw/sim/SimPlatformMapping.cpp
+  fboss/agent/hw/sim/SimPlatformPort.cpp
+)
+
+target_link_libraries(tun_intf_benchmark
+  fboss_agent
+  hw_benchmark_main
+  Folly::folly
+  Folly::follybenchmark
+)
+
+add_executable(apply_thrift_config_benchmark
+  fboss/agent/test/ApplyThriftConfigBenchmark.cpp
+  fboss/agent/test/MockTunManager.cpp
+  fboss/agent/test/TestUtils.cpp
+)
+
+target_compile_definitions(apply_thrift_config_benchmark
+  PUBLIC
+    ${LIBGMOCK_DEFINES}
+)
+
+target_include_directories(apply_thrift_config_benchmark
+  PUBLIC
+    ${LIBGMOCK_INCLUDE_DIR}
+)
+
+target_link_libraries(apply_thrift_config_benchmark
+  fboss_agent
+  Folly::folly
+  Folly::follybenchmark
+  ${GTEST}
+  ${LIBGMOCK_LIBRARIES}
+)
+
+# Depends on the Sim implementation, which is not part of fboss_agent
+add_executable(switch_state_read_benchmark
+  fboss/agent/test/SwitchStateReadBenchmark.cpp
+  fboss/agent/hw/sim/SimPlatform.cpp
+  fboss/agent/hw/sim/SimPlatformMapping.cpp
+  fboss/agent/hw/sim/SimPlatformPort.cpp
+)
+
+target_link_libraries(switch_state_read_benchmark
+  fboss_agent
+  Folly::folly
+  Folly::follybenchmark
+)
@@ -11,6 +11,8 @@
 
 #include <folly/FileUtil.h>
 #include <folly/gen/Base.h>
+#include <folly/hash/SpookyHashV2.h>
+#include <folly/logging/xlog.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/FbossError.h"
@@ -56,7 +58,10 @@
 #include <boost/container/flat_set.hpp>
 #include <folly/Range.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <functional>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -87,9 +92,10 @@ std::shared_ptr<facebook::fboss::SwitchState> updateFibFromConfig(
     facebook::fboss::RouterID vrf,
     const facebook::fboss::IPv4NetworkToRouteMap& v4NetworkToRoute,
     const facebook::fboss::IPv6NetworkToRouteMap& v6NetworkToRoute,
+    const facebook::fboss::RibRouteDelta* ribDelta,
     void* cookie) {
   facebook::fboss::ForwardingInformationBaseUpdater fibUpdater(
-      vrf, v4NetworkToRoute, v6NetworkToRoute);
+      vrf, v4NetworkToRoute, v6NetworkToRoute, ribDelta);
 
   auto nextStatePtr =
       static_cast<std::shared_ptr<facebook::fboss::SwitchState>*>(cookie);
@@ -115,17 +121,24 @@ class ThriftConfigApplier {
       const std::shared_ptr<SwitchState>& orig,
       const cfg::SwitchConfig* config,
       const Platform* platform,
-      RoutingInformationBase* rib)
-      : orig_(orig), cfg_(config), platform_(platform), rib_(rib) {}
+      RoutingInformationBase* rib,
+      ThriftConfigApplyCache* cache)
+      : orig_(orig),
+        cfg_(config),
+        platform_(platform),
+        rib_(rib),
+        cache_(cache) {}
   ThriftConfigApplier(
       const std::shared_ptr<SwitchState>& orig,
       const cfg::SwitchConfig* config,
       const Platform* platform,
-      RouteUpdateWrapper* routeUpdater)
+      RouteUpdateWrapper* routeUpdater,
+      ThriftConfigApplyCache* cache)
       : orig_(orig),
         cfg_(config),
         platform_(platform),
-        routeUpdater_(routeUpdater) {}
+        routeUpdater_(routeUpdater),
+        cache_(cache) {}
 
   std::shared_ptr<SwitchState> run();
 
@@ -189,7 +202,26 @@ class ThriftConfigApplier {
    *
    * Methods such as updateAggregatePorts(), updateVlans(), etc. encapsulate
    * this logic for each type of NodeBase.
+   *
+   * run() goes through these a section of the state at a time. With a
+   * ThriftConfigApplyCache, a section is skipped altogether when the config
+   * fields it reads hash to what they did the last time it was applied, and
+   * the state nodes it builds and reads are the ones it left behind then.
+   */
+
+  using SectionState = std::vector<std::shared_ptr<const void>>;
+  /*
+   * Run apply(), unless the cache shows the section would be left as is.
+   * getConfig() copies the fields of cfg_ the section reads into an
+   * otherwise empty config, and getState() returns the nodes of new_ the
+   * section builds and those it reads. Sections without getConfig() are
+   * always applied, as run() relies on what they collect along the way.
    */
+  void applySection(
+      const std::string& name,
+      const std::function<void(cfg::SwitchConfig*)>& getConfig,
+      const std::function<SectionState()>& getState,
+      const std::function<void()>& apply);
 
   void processVlanPorts();
   void updateVlanInterfaces(const Interface* intf);
@@ -326,6 +358,11 @@ class ThriftConfigApplier {
   const Platform* platform_{nullptr};
   RoutingInformationBase* rib_{nullptr};
   RouteUpdateWrapper* routeUpdater_{nullptr};
+  ThriftConfigApplyCache* cache_{nullptr};
+  // To be stored in cache_ once run() succeeds
+  std::map<std::string, ThriftConfigApplyCache::Section> appliedSections_;
+  std::map<std::string, ThriftConfigApplyCache::SectionApplyStats>
+      applyStats_;
 
   struct VlanIpInfo {
     VlanIpInfo(uint8_t mask, MacAddress mac, InterfaceID intf)
@@ -350,83 +387,163 @@ shared_ptr<SwitchState> ThriftConfigApplier::run() {
   new_ = orig_->clone();
   bool changed = false;
 
-  {
-    auto newSwitchSettings = updateSwitchSettings();
-    if (newSwitchSettings) {
-      new_->resetSwitchSettings(std::move(newSwitchSettings));
-      changed = true;
-    }
-  }
+  applySection(
+      "switch_settings",
+      [this](cfg::SwitchConfig* config) {
+        config->switchSettings_ref() = *cfg_->switchSettings_ref();
+      },
+      [this]() { return SectionState{new_->getSwitchSettings()}; },
+      [&]() {
+        auto newSwitchSettings = updateSwitchSettings();
+        if (newSwitchSettings) {
+          new_->resetSwitchSettings(std::move(newSwitchSettings));
+          changed = true;
+        }
+      });
 
-  {
-    bool qcmChanged = false;
-    auto newQcmConfig = updateQcmCfg(&qcmChanged);
-    if (qcmChanged) {
-      new_->resetQcmCfg(newQcmConfig);
-      changed = true;
-    }
-  }
+  applySection(
+      "qcm",
+      [this](cfg::SwitchConfig* config) {
+        config->qcmConfig_ref().copy_from(cfg_->qcmConfig_ref());
+      },
+      [this]() { return SectionState{new_->getQcmCfg()}; },
+      [&]() {
+        bool qcmChanged = false;
+        auto newQcmConfig = updateQcmCfg(&qcmChanged);
+        if (qcmChanged) {
+          new_->resetQcmCfg(newQcmConfig);
+          changed = true;
+        }
+      });
 
-  {
-    auto newControlPlane = updateControlPlane();
-    if (newControlPlane) {
-      new_->resetControlPlane(std::move(newControlPlane));
-      changed = true;
-    }
-  }
+  applySection(
+      "control_plane",
+      [this](cfg::SwitchConfig* config) {
+        config->cpuQueues_ref() = *cfg_->cpuQueues_ref();
+        config->cpuTrafficPolicy_ref().copy_from(cfg_->cpuTrafficPolicy_ref());
+        config->dataPlaneTrafficPolicy_ref().copy_from(
+            cfg_->dataPlaneTrafficPolicy_ref());
+        config->qosPolicies_ref() = *cfg_->qosPolicies_ref();
+        config->defaultPortQueues_ref() = *cfg_->defaultPortQueues_ref();
+      },
+      [this]() { return SectionState{new_->getControlPlane()}; },
+      [&]() {
+        auto newControlPlane = updateControlPlane();
+        if (newControlPlane) {
+          new_->resetControlPlane(std::move(newControlPlane));
+          changed = true;
+        }
+      });
 
   processVlanPorts();
 
-  {
-    bool bufferPoolConfigChanged = false;
-    auto newBufferPoolCfg = updateBufferPoolConfigs(&bufferPoolConfigChanged);
-    if (bufferPoolConfigChanged) {
-      new_->resetBufferPoolCfgs(newBufferPoolCfg);
-      changed = true;
-    }
-  }
+  applySection(
+      "buffer_pools",
+      [this](cfg::SwitchConfig* config) {
+        config->bufferPoolConfigs_ref().copy_from(
+            cfg_->bufferPoolConfigs_ref());
+      },
+      [this]() { return SectionState{new_->getBufferPoolCfgs()}; },
+      [&]() {
+        bool bufferPoolConfigChanged = false;
+        auto newBufferPoolCfg =
+            updateBufferPoolConfigs(&bufferPoolConfigChanged);
+        if (bufferPoolConfigChanged) {
+          new_->resetBufferPoolCfgs(newBufferPoolCfg);
+          changed = true;
+        }
+      });
 
-  {
-    auto newPorts = updatePorts();
-    if (newPorts) {
-      new_->resetPorts(std::move(newPorts));
-      changed = true;
-    }
-  }
+  applySection(
+      "ports",
+      [this](cfg::SwitchConfig* config) {
+        config->ports_ref() = *cfg_->ports_ref();
+        config->vlanPorts_ref() = *cfg_->vlanPorts_ref();
+        config->dataPlaneTrafficPolicy_ref().copy_from(
+            cfg_->dataPlaneTrafficPolicy_ref());
+        config->portPgConfigs_ref().copy_from(cfg_->portPgConfigs_ref());
+        config->portQueueConfigs_ref() = *cfg_->portQueueConfigs_ref();
+        config->qosPolicies_ref() = *cfg_->qosPolicies_ref();
+        config->defaultPortQueues_ref() = *cfg_->defaultPortQueues_ref();
+      },
+      [this]() {
+        return SectionState{new_->getPorts(), new_->getBufferPoolCfgs()};
+      },
+      [&]() {
+        auto newPorts = updatePorts();
+        if (newPorts) {
+          new_->resetPorts(std::move(newPorts));
+          changed = true;
+        }
+      });
 
-  {
-    auto newAggPorts = updateAggregatePorts();
-    if (newAggPorts) {
-      new_->resetAggregatePorts(std::move(newAggPorts));
-      changed = true;
-    }
-  }
+  applySection(
+      "aggregate_ports",
+      [this](cfg::SwitchConfig* config) {
+        config->aggregatePorts_ref() = *cfg_->aggregatePorts_ref();
+        config->lacp_ref().copy_from(cfg_->lacp_ref());
+      },
+      [this]() { return SectionState{new_->getAggregatePorts()}; },
+      [&]() {
+        auto newAggPorts = updateAggregatePorts();
+        if (newAggPorts) {
+          new_->resetAggregatePorts(std::move(newAggPorts));
+          changed = true;
+        }
+      });
 
   // updateMirrors must be called after updatePorts, mirror needs ports!
-  {
-    auto newMirrors = updateMirrors();
-    if (newMirrors) {
-      new_->resetMirrors(std::move(newMirrors));
-      changed = true;
-    }
-  }
+  applySection(
+      "mirrors",
+      [this](cfg::SwitchConfig* config) {
+        config->mirrors_ref() = *cfg_->mirrors_ref();
+      },
+      [this]() { return SectionState{new_->getMirrors(), new_->getPorts()}; },
+      [&]() {
+        auto newMirrors = updateMirrors();
+        if (newMirrors) {
+          new_->resetMirrors(std::move(newMirrors));
+          changed = true;
+        }
+      });
 
   // updateAcls must be called after updateMirrors, acls may need mirror!
-  {
-    auto newAcls = updateAcls();
-    if (newAcls) {
-      new_->resetAcls(std::move(newAcls));
-      changed = true;
-    }
-  }
+  applySection(
+      "acls",
+      [this](cfg::SwitchConfig* config) {
+        config->acls_ref() = *cfg_->acls_ref();
+        config->cpuTrafficPolicy_ref().copy_from(cfg_->cpuTrafficPolicy_ref());
+        config->dataPlaneTrafficPolicy_ref().copy_from(
+            cfg_->dataPlaneTrafficPolicy_ref());
+        config->trafficCounters_ref() = *cfg_->trafficCounters_ref();
+      },
+      [this]() { return SectionState{new_->getAcls(), new_->getMirrors()}; },
+      [&]() {
+        auto newAcls = updateAcls();
+        if (newAcls) {
+          new_->resetAcls(std::move(newAcls));
+          changed = true;
+        }
+      });
 
-  {
-    auto newQosPolicies = updateQosPolicies();
-    if (newQosPolicies) {
-      new_->resetQosPolicies(std::move(newQosPolicies));
-      changed = true;
-    }
-  }
+  applySection(
+      "qos_policies",
+      [this](cfg::SwitchConfig* config) {
+        config->qosPolicies_ref() = *cfg_->qosPolicies_ref();
+        config->dataPlaneTrafficPolicy_ref().copy_from(
+            cfg_->dataPlaneTrafficPolicy_ref());
+      },
+      [this]() {
+        return SectionState{
+            new_->getQosPolicies(), new_->getDefaultDataPlaneQosPolicy()};
+      },
+      [&]() {
+        auto newQosPolicies = updateQosPolicies();
+        if (newQosPolicies) {
+          new_->resetQosPolicies(std::move(newQosPolicies));
+          changed = true;
+        }
+      });
 
   // reset the default qos policy
   {
@@ -437,72 +554,83 @@ shared_ptr<SwitchState> ThriftConfigApplier::run() {
     }
   }
 
-  {
+  applySection("interfaces", nullptr, nullptr, [&]() {
     auto newIntfs = updateInterfaces();
     if (newIntfs) {
       new_->resetIntfs(std::move(newIntfs));
       changed = true;
     }
-  }
+  });
 
   // Note: updateInterfaces() must be called before updateVlans(),
   // as updateInterfaces() populates the vlanInterfaces_ data structure.
-  {
-    auto newVlans = updateVlans();
-    if (newVlans) {
-      new_->resetVlans(std::move(newVlans));
-      changed = true;
-    }
-  }
-
-  if (routeUpdater_) {
-    routeUpdater_->setRoutesToConfig(
-        intfRouteTables_,
-        *cfg_->staticRoutesWithNhops_ref(),
-        *cfg_->staticRoutesToNull_ref(),
-        *cfg_->staticRoutesToCPU_ref(),
-        *cfg_->staticIp2MplsRoutes_ref());
-  } else {
-    if (rib_) {
-      auto newFibs = updateForwardingInformationBaseContainers();
-      if (newFibs) {
-        new_->resetForwardingInformationBases(newFibs);
-        changed = true;
-      }
+  applySection(
+      "vlans",
+      [this](cfg::SwitchConfig* config) {
+        config->vlans_ref() = *cfg_->vlans_ref();
+        config->vlanPorts_ref() = *cfg_->vlanPorts_ref();
+        config->interfaces_ref() = *cfg_->interfaces_ref();
+      },
+      [this]() { return SectionState{new_->getVlans()}; },
+      [&]() {
+        auto newVlans = updateVlans();
+        if (newVlans) {
+          new_->resetVlans(std::move(newVlans));
+          changed = true;
+        }
+      });
 
-      rib_->reconfigure(
+  applySection("routes", nullptr, nullptr, [&]() {
+    if (routeUpdater_) {
+      routeUpdater_->setRoutesToConfig(
           intfRouteTables_,
           *cfg_->staticRoutesWithNhops_ref(),
           *cfg_->staticRoutesToNull_ref(),
           *cfg_->staticRoutesToCPU_ref(),
-          *cfg_->staticIp2MplsRoutes_ref(),
-          &updateFibFromConfig,
-          static_cast<void*>(&new_));
+          *cfg_->staticIp2MplsRoutes_ref());
     } else {
-      // Note: updateInterfaces() must be called before updateInterfaceRoutes(),
-      // as updateInterfaces() populates the intfRouteTables_ data structure.
-      // Also, updateInterfaceRoutes() should be the first call for updating
-      // RouteTable as this will take the RouteTable from orig_ and add
-      // Interface routes. Calling this after other RouteTable updates will
-      // result in other routes getting removed during updateInterfaceRoutes()
-
-      auto newTables = updateInterfaceRoutes();
-      if (newTables) {
-        new_->resetRouteTables(newTables);
-        changed = true;
-      }
+      if (rib_) {
+        auto newFibs = updateForwardingInformationBaseContainers();
+        if (newFibs) {
+          new_->resetForwardingInformationBases(newFibs);
+          changed = true;
+        }
+
+        rib_->reconfigure(
+            intfRouteTables_,
+            *cfg_->staticRoutesWithNhops_ref(),
+            *cfg_->staticRoutesToNull_ref(),
+            *cfg_->staticRoutesToCPU_ref(),
+            *cfg_->staticIp2MplsRoutes_ref(),
+            &updateFibFromConfig,
+            static_cast<void*>(&new_));
+      } else {
+        // Note: updateInterfaces() must be called before
+        // updateInterfaceRoutes(), as updateInterfaces() populates the
+        // intfRouteTables_ data structure. Also, updateInterfaceRoutes()
+        // should be the first call for updating RouteTable as this will take
+        // the RouteTable from orig_ and add Interface routes. Calling this
+        // after other RouteTable updates will result in other routes getting
+        // removed during updateInterfaceRoutes()
+
+        auto newTables = updateInterfaceRoutes();
+        if (newTables) {
+          new_->resetRouteTables(newTables);
+          changed = true;
+        }
 
-      // Retrieve RouteTableMap from new_ as this will have
-      // all the routes updated until now. Pass this to syncStaticRoutes
-      // so that routes added until now would not be excluded.
-      auto updatedRoutes = new_->getRouteTables();
-      auto newerTables = syncStaticRoutes(updatedRoutes);
-      if (newerTables) {
-        new_->resetRouteTables(std::move(newerTables));
-        changed = true;
+        // Retrieve RouteTableMap from new_ as this will have
+        // all the routes updated until now. Pass this to syncStaticRoutes
+        // so that routes added until now would not be excluded.
+        auto updatedRoutes = new_->getRouteTables();
+        auto newerTables = syncStaticRoutes(updatedRoutes);
+        if (newerTables) {
+          new_->resetRouteTables(std::move(newerTables));
+          changed = true;
+        }
       }
     }
-  }
+  });
 
   // resolving mpls next hops may need interfaces to be setup
   // process static mpls routes after processing interfaces
@@ -623,23 +751,36 @@ shared_ptr<SwitchState> ThriftConfigApplier::run() {
   }
 
   // Add sFlow collectors
-  {
-    auto newCollectors = updateSflowCollectors();
-    if (newCollectors) {
-      new_->resetSflowCollectors(std::move(newCollectors));
-      changed = true;
-    }
-  }
+  applySection(
+      "sflow_collectors",
+      [this](cfg::SwitchConfig* config) {
+        config->sFlowCollectors_ref() = *cfg_->sFlowCollectors_ref();
+      },
+      [this]() { return SectionState{new_->getSflowCollectors()}; },
+      [&]() {
+        auto newCollectors = updateSflowCollectors();
+        if (newCollectors) {
+          new_->resetSflowCollectors(std::move(newCollectors));
+          changed = true;
+        }
+      });
 
-  {
-    LoadBalancerConfigApplier loadBalancerConfigApplier(
-        orig_->getLoadBalancers(), cfg_->get_loadBalancers(), platform_);
-    auto newLoadBalancers = loadBalancerConfigApplier.updateLoadBalancers();
-    if (newLoadBalancers) {
-      new_->resetLoadBalancers(std::move(newLoadBalancers));
-      changed = true;
-    }
-  }
+  applySection(
+      "load_balancers",
+      [this](cfg::SwitchConfig* config) {
+        config->loadBalancers_ref() = *cfg_->loadBalancers_ref();
+      },
+      [this]() { return SectionState{new_->getLoadBalancers()}; },
+      [&]() {
+        LoadBalancerConfigApplier loadBalancerConfigApplier(
+            orig_->getLoadBalancers(), cfg_->get_loadBalancers(), platform_);
+        auto newLoadBalancers =
+            loadBalancerConfigApplier.updateLoadBalancers();
+        if (newLoadBalancers) {
+          new_->resetLoadBalancers(std::move(newLoadBalancers));
+          changed = true;
+        }
+      });
 
   // normalizer to refresh counter tags
   if (auto normalizer = Normalizer::getInstance()) {
@@ -649,12 +790,77 @@ shared_ptr<SwitchState> ThriftConfigApplier::run() {
         << "Normalizer failed to initialize, skipping loading counter tags";
   }
 
+  if (cache_) {
+    for (auto& [name, section] : appliedSections_) {
+      cache_->sections_[name] = std::move(section);
+    }
+    cache_->lastApplyStats_ = std::move(applyStats_);
+  }
+
   if (!changed) {
     return nullptr;
   }
   return new_;
 }
 
+void ThriftConfigApplier::applySection(
+    const std::string& name,
+    const std::function<void(cfg::SwitchConfig*)>& getConfig,
+    const std::function<SectionState()>& getState,
+    const std::function<void()>& apply) {
+  auto start = std::chrono::steady_clock::now();
+  std::optional<ThriftConfigApplyCache::Section> section;
+  bool skip = false;
+  if (cache_ && getConfig) {
+    cfg::SwitchConfig sectionConfig;
+    getConfig(&sectionConfig);
+    auto serialized =
+        apache::thrift::CompactSerializer::serialize<std::string>(
+            sectionConfig);
+    section = ThriftConfigApplyCache::Section();
+    folly::hash::SpookyHashV2::Hash128(
+        serialized.data(),
+        serialized.size(),
+        &section->fingerprint.first,
+        &section->fingerprint.second);
+
+    // Nodes of unpublished states may have been modified in place since
+    auto cached = cache_->sections_.find(name);
+    if (orig_->isPublished() && cached != cache_->sections_.end() &&
+        cached->second.fingerprint == section->fingerprint) {
+      auto state = getState();
+      const auto& cachedState = cached->second.state;
+      skip = state.size() == cachedState.size() &&
+          std::equal(
+                 state.begin(),
+                 state.end(),
+                 cachedState.begin(),
+                 [](const auto& node, const auto& cachedNode) {
+                   // Same node, or both null. A cached node that has since
+                   // been freed never matches.
+                   return !node.owner_before(cachedNode) &&
+                       !cachedNode.owner_before(node);
+                 });
+    }
+  }
+
+  if (!skip) {
+    apply();
+  }
+
+  if (section) {
+    for (const auto& node : getState()) {
+      section->state.emplace_back(node);
+    }
+    appliedSections_[name] = std::move(*section);
+  }
+  auto applyTime = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+  applyStats_[name] = {applyTime, skip};
+  XLOG(DBG2) << "Config section " << name << (skip ? " skipped" : " applied")
+             << " in " << applyTime.count() << "us";
+}
+
 void ThriftConfigApplier::processVlanPorts() {
   // Build the Port --> Vlan mappings
   //
@@ -3200,17 +3406,20 @@ shared_ptr<SwitchState> applyThriftConfig(
     const shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    RoutingInformationBase* rib) {
+    RoutingInformationBase* rib,
+    ThriftConfigApplyCache* cache) {
   cfg::SwitchConfig emptyConfig;
-  return ThriftConfigApplier(state, config, platform, rib).run();
+  return ThriftConfigApplier(state, config, platform, rib, cache).run();
 }
 shared_ptr<SwitchState> applyThriftConfig(
     const shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    RouteUpdateWrapper* routeUpdater) {
+    RouteUpdateWrapper* routeUpdater,
+    ThriftConfigApplyCache* cache) {
   cfg::SwitchConfig emptyConfig;
-  return ThriftConfigApplier(state, config, platform, routeUpdater).run();
+  return ThriftConfigApplier(state, config, platform, routeUpdater, cache)
+      .run();
 }
 
 } // namespace facebook::fboss
@@ -10,7 +10,13 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -24,21 +30,59 @@ class Platform;
 class SwitchState;
 class RouteUpdateWrapper;
 
+/*
+ * Remembers the config each section of the SwitchState (ports, ACLs, QoS
+ * policies, ...) was last built from by applyThriftConfig(). Applying a
+ * config again skips the sections whose config is unchanged, as long as
+ * their state has not been changed since by anything else either.
+ *
+ * A cache must only be used with states of a single platform, by one thread
+ * at a time, and only sections of published states are ever skipped.
+ */
+class ThriftConfigApplyCache {
+ public:
+  struct SectionApplyStats {
+    std::chrono::microseconds applyTime{0};
+    bool skipped{false};
+  };
+
+  // Stats of each section, from the last config applied without error
+  const std::map<std::string, SectionApplyStats>& getLastApplyStats() const {
+    return lastApplyStats_;
+  }
+
+ private:
+  friend class ThriftConfigApplier;
+
+  struct Section {
+    // Hash of the config fields the section is built from
+    std::pair<uint64_t, uint64_t> fingerprint;
+    // The state nodes the section built, and those it was built on
+    std::vector<std::weak_ptr<const void>> state;
+  };
+
+  std::map<std::string, Section> sections_;
+  std::map<std::string, SectionApplyStats> lastApplyStats_;
+};
+
 /*
  * Apply a thrift config structure to a SwitchState object.
  *
  * Returns a new SwitchState object with the resulting state, or null if
- * the config file results in no changes.
+ * the config file results in no changes. With a cache, the sections left
+ * unchanged since the config last applied with it are skipped.
  */
 std::shared_ptr<SwitchState> applyThriftConfig(
     const std::shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    RoutingInformationBase* rib = nullptr);
+    RoutingInformationBase* rib = nullptr,
+    ThriftConfigApplyCache* cache = nullptr);
 
 std::shared_ptr<SwitchState> applyThriftConfig(
     const std::shared_ptr<SwitchState>& state,
     const cfg::SwitchConfig* config,
     const Platform* platform,
-    RouteUpdateWrapper* routeUpdater);
+    RouteUpdateWrapper* routeUpdater,
+    ThriftConfigApplyCache* cache = nullptr);
 } // namespace facebook::fboss
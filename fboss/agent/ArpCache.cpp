@@ -23,7 +23,8 @@ ArpCache::ArpCache(
     const SwitchState* state,
     VlanID vlanID,
     std::string vlanName,
-    InterfaceID intfID)
+    InterfaceID intfID,
+    std::shared_ptr<NeighborStateUpdateBatcher> stateUpdateBatcher)
     : NeighborCache<ArpTable>(
           sw,
           vlanID,
@@ -31,7 +32,8 @@ ArpCache::ArpCache(
           intfID,
           state->getArpTimeout(),
           state->getMaxNeighborProbes(),
-          state->getStaleEntryInterval()) {}
+          state->getStaleEntryInterval(),
+          std::move(stateUpdateBatcher)) {}
 
 void ArpCache::sentArpRequest(folly::IPAddressV4 ip) {
   setPendingEntry(ip);
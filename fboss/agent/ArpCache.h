@@ -30,7 +30,8 @@ class ArpCache : public NeighborCache<ArpTable> {
       const SwitchState* state,
       VlanID vlanID,
       std::string vlanName,
-      InterfaceID intfID);
+      InterfaceID intfID,
+      std::shared_ptr<NeighborStateUpdateBatcher> stateUpdateBatcher);
 
   void sentArpRequest(folly::IPAddressV4 ip);
   void receivedArpMine(
@@ -0,0 +1,94 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/AsyncStateObserverQueue.h"
+
+#include <fb303/ServiceData.h>
+#include "fboss/agent/StateObserver.h"
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/state/StateDelta.h"
+
+#include <folly/Conv.h>
+#include <folly/String.h>
+#include <folly/logging/xlog.h>
+
+#include <utility>
+
+namespace facebook::fboss {
+
+AsyncStateObserverQueue::AsyncStateObserverQueue(
+    StateObserver* observer,
+    const std::string& name)
+    : observer_(observer),
+      name_(name),
+      lagCounter_(folly::to<std::string>("state_observer.", name, ".lag.ms")),
+      queuedCounter_(
+          folly::to<std::string>("state_observer.", name, ".queued_deltas")),
+      coalescedCounter_(folly::to<std::string>(
+          "state_observer.",
+          name,
+          ".coalesced_deltas")),
+      thread_([this]() {
+        initThread(folly::to<std::string>("obs", name_));
+        eventBase_.loopForever();
+      }) {
+  fb303::fbData->setCounter(coalescedCounter_, 0);
+}
+
+AsyncStateObserverQueue::~AsyncStateObserverQueue() {
+  // The observer is going away, so it is not handed anything more. A
+  // dispatch() still scheduled finds nothing pending and returns.
+  pending_.withLock([](auto& pending) { pending.reset(); });
+  eventBase_.runInEventBaseThread([this]() { eventBase_.terminateLoopSoon(); });
+  thread_.join();
+}
+
+void AsyncStateObserverQueue::enqueue(const StateDelta& delta) {
+  bool scheduleDispatch = pending_.withLock([&delta](auto& pending) {
+    if (pending) {
+      // The observer has yet to see the last delta, fold this one into it
+      pending->newState = delta.newState();
+      ++pending->deltas;
+      return false;
+    }
+    pending = PendingDelta{
+        delta.oldState(),
+        delta.newState(),
+        std::chrono::steady_clock::now(),
+        1};
+    return true;
+  });
+  if (scheduleDispatch) {
+    eventBase_.runInEventBaseThread([this]() { dispatch(); });
+  }
+}
+
+void AsyncStateObserverQueue::dispatch() {
+  auto pending = pending_.withLock(
+      [](auto& queued) { return std::exchange(queued, std::nullopt); });
+  if (!pending) {
+    // Dropped by the destructor
+    return;
+  }
+  try {
+    observer_->stateUpdated(StateDelta(pending->oldState, pending->newState));
+  } catch (const std::exception& ex) {
+    XLOG(FATAL) << "error notifying " << name_
+                << " of update: " << folly::exceptionStr(ex);
+  }
+  auto lag = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - pending->firstQueued);
+  fb303::fbData->setCounter(lagCounter_, lag.count());
+  fb303::fbData->setCounter(queuedCounter_, pending->deltas);
+  if (pending->deltas > 1) {
+    fb303::fbData->incrementCounter(coalescedCounter_, pending->deltas - 1);
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/Synchronized.h>
+#include <folly/io/async/EventBase.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace facebook::fboss {
+
+class StateDelta;
+class StateObserver;
+class SwitchState;
+
+/*
+ * Notifies a state observer of state updates on a thread of its own, so
+ * that a slow observer does not hold up the update thread.
+ *
+ * Deltas queued while the observer is busy are merged into one, from the
+ * oldest old state to the newest new state, so the observer catches up in
+ * a single stateUpdated() call however far behind it falls.
+ *
+ * Exports per observer counters:
+ *  - state_observer.<name>.lag.ms: time from the oldest delta being
+ *    queued to the observer being done with it
+ *  - state_observer.<name>.queued_deltas: deltas merged into the delta
+ *    the observer was last handed
+ *  - state_observer.<name>.coalesced_deltas: running count of deltas the
+ *    observer did not see individually
+ */
+class AsyncStateObserverQueue {
+ public:
+  AsyncStateObserverQueue(StateObserver* observer, const std::string& name);
+  // Drops the delta still queued, if any, and waits for a stateUpdated()
+  // call in progress to return. Must not be called from the observer's own
+  // stateUpdated().
+  ~AsyncStateObserverQueue();
+
+  void enqueue(const StateDelta& delta);
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  AsyncStateObserverQueue(AsyncStateObserverQueue const&) = delete;
+  AsyncStateObserverQueue& operator=(AsyncStateObserverQueue const&) = delete;
+
+  void dispatch();
+
+  struct PendingDelta {
+    std::shared_ptr<SwitchState> oldState;
+    std::shared_ptr<SwitchState> newState;
+    std::chrono::steady_clock::time_point firstQueued;
+    int64_t deltas{0};
+  };
+
+  StateObserver* const observer_;
+  const std::string name_;
+  const std::string lagCounter_;
+  const std::string queuedCounter_;
+  const std::string coalescedCounter_;
+  folly::Synchronized<std::optional<PendingDelta>, std::mutex> pending_;
+  folly::EventBase eventBase_;
+  std::thread thread_;
+};
+
+} // namespace facebook::fboss
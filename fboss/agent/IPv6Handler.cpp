@@ -146,7 +146,7 @@ void IPv6Handler::handlePacket(
   cursor.reset(payload.get());
 
   // retrieve the current switch state
-  auto state = sw_->getState();
+  auto state = sw_->getStateReadGuard();
   PortID port = pkt->getSrcPort();
 
   // NOTE: DHCPv6 solicit packet from client has hoplimit set to 1,
@@ -294,7 +294,7 @@ void IPv6Handler::handleRouterSolicitation(
 
   cursor.skip(4); // 4 reserved bytes
 
-  auto state = sw_->getState();
+  auto state = sw_->getStateReadGuard();
   auto vlan = state->getVlans()->getVlanIf(pkt->getSrcVlan());
   if (!vlan) {
     sw_->portStats(pkt)->pktDropped();
@@ -382,7 +382,7 @@ void IPv6Handler::handleNeighborSolicitation(
   }
   XLOG(DBG4) << "got neighbor solicitation for " << targetIP.str();
 
-  auto state = sw_->getState();
+  auto state = sw_->getStateReadGuard();
   auto vlan = state->getVlans()->getVlanIf(pkt->getSrcVlan());
   if (!vlan) {
     // Hmm, we don't actually have this VLAN configured.
@@ -421,7 +421,7 @@ void IPv6Handler::handleNeighborSolicitation(
     return;
   }
 
-  if (!AggregatePort::isIngressValid(state, pkt)) {
+  if (!AggregatePort::isIngressValid(*state, pkt)) {
     XLOG(INFO) << "Dropping invalid NS ingressing on port " << pkt->getSrcPort()
                << " on vlan " << vlan << " for " << targetIP;
     return;
@@ -500,7 +500,7 @@ void IPv6Handler::handleNeighborAdvertisement(
     return;
   }
 
-  auto state = sw_->getState();
+  auto state = sw_->getStateReadGuard();
   auto vlan = state->getVlans()->getVlanIf(pkt->getSrcVlan());
   if (!vlan) {
     // Hmm, we don't actually have this VLAN configured.
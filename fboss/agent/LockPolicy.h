@@ -15,12 +15,24 @@ namespace facebook::fboss {
 class CoarseGrainedLockPolicy {
  public:
   explicit CoarseGrainedLockPolicy(std::mutex& mutex) : lock_(mutex) {}
+  // Also hold held, after mutex, for as long as the policy lives
+  CoarseGrainedLockPolicy(std::mutex& mutex, std::mutex& held)
+      : lock_(mutex), heldLock_(held) {}
   const std::lock_guard<std::mutex>& lock() const {
     return lock_;
   }
+  // The policy's mutex is already held, so only take other, unless the
+  // policy holds that as well
+  std::unique_lock<std::mutex> lockWith(std::mutex& other) const {
+    if (heldLock_.mutex() == &other) {
+      return std::unique_lock<std::mutex>();
+    }
+    return std::unique_lock<std::mutex>(other);
+  }
 
  private:
   std::lock_guard<std::mutex> lock_;
+  std::unique_lock<std::mutex> heldLock_;
 };
 
 class FineGrainedLockPolicy {
@@ -29,8 +41,30 @@ class FineGrainedLockPolicy {
   std::lock_guard<std::mutex> lock() const {
     return std::lock_guard<std::mutex>(mutex_);
   }
+  std::scoped_lock<std::mutex, std::mutex> lockWith(std::mutex& other) const {
+    return std::scoped_lock<std::mutex, std::mutex>(mutex_, other);
+  }
+
+ private:
+  std::mutex& mutex_;
+};
+
+/*
+ * Locks as LockPolicyT does, and additionally holds another mutex for the
+ * duration of each lock(). Used for the parts of an update that must also
+ * exclude a thread which only takes that other mutex.
+ */
+template <typename LockPolicyT>
+class WithMutexLockPolicy {
+ public:
+  WithMutexLockPolicy(const LockPolicyT& policy, std::mutex& mutex)
+      : policy_(policy), mutex_(mutex) {}
+  auto lock() const {
+    return policy_.lockWith(mutex_);
+  }
 
  private:
+  const LockPolicyT& policy_;
   std::mutex& mutex_;
 };
 } // namespace facebook::fboss
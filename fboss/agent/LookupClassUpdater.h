@@ -17,8 +17,14 @@ namespace facebook::fboss {
 class LookupClassUpdater : public AutoRegisterStateObserver {
  public:
   explicit LookupClassUpdater(SwSwitch* sw)
-      : AutoRegisterStateObserver(sw, "LookupClassUpdater"), sw_(sw) {}
-  ~LookupClassUpdater() override {}
+      : AutoRegisterStateObserver(
+            sw,
+            "LookupClassUpdater",
+            SwSwitch::StateObserverDispatch::ASYNC),
+        sw_(sw) {}
+  ~LookupClassUpdater() override {
+    unregister();
+  }
 
   void stateUpdated(const StateDelta& stateDelta) override;
 
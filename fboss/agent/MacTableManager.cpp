@@ -21,14 +21,36 @@ MacTableManager::MacTableManager(SwSwitch* sw) : sw_(sw) {}
 void MacTableManager::handleL2LearningUpdate(
     L2Entry l2Entry,
     L2EntryUpdateType l2EntryUpdateType) {
-  auto updateMacTableFn =
-      [l2Entry, l2EntryUpdateType](const std::shared_ptr<SwitchState>& state) {
-        return MacTableUtils::updateMacTable(state, l2Entry, l2EntryUpdateType);
-      };
+  std::shared_ptr<SyncedPendingUpdates> batch;
+  {
+    auto openBatch = openBatch_.wlock();
+    if (*openBatch) {
+      auto pendingUpdates = (*openBatch)->wlock();
+      if (!pendingUpdates->closed) {
+        // The batch's update has not run yet and will apply this one too
+        pendingUpdates->updates.emplace_back(
+            std::move(l2Entry), l2EntryUpdateType);
+        return;
+      }
+    }
+    batch = std::make_shared<SyncedPendingUpdates>();
+    batch->wlock()->updates.emplace_back(
+        std::move(l2Entry), l2EntryUpdateType);
+    *openBatch = batch;
+  }
+
+  auto updateMacTableFn = [batch = std::move(batch)](
+                              const std::shared_ptr<SwitchState>& state)
+      -> std::shared_ptr<SwitchState> {
+    // Events received from here on go to a new batch, so this one stays
+    // the same should the update be run again
+    batch->wlock()->closed = true;
+    const auto& updates = batch->unsafeGetUnlocked().updates;
+    return MacTableUtils::updateMacTable(state, updates);
+  };
 
   sw_->updateState(
-      folly::to<std::string>("Programming : ", l2Entry.str()),
-      std::move(updateMacTableFn));
+      "Programming L2 learning updates", std::move(updateMacTableFn));
 }
 
 } // namespace facebook::fboss
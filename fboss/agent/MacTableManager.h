@@ -11,10 +11,31 @@
 
 #include "fboss/agent/L2Entry.h"
 
+#include <folly/Synchronized.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace facebook::fboss {
 
 class SwSwitch;
 
+/*
+ * Applies L2 learning callbacks from the HwSwitch to the MacTables in the
+ * SwitchState.
+ *
+ * Callbacks only queue the learning event. The first event queued after a
+ * state update has started applying learning events opens a new batch, and
+ * schedules one state update owning that batch. Events join the open batch
+ * until its update first runs on the update thread, which closes it. A burst
+ * of learning events (e.g. after a host migration) thus results in a handful
+ * of state updates, each making one MacTable modification per VLAN, rather
+ * than one state update per MAC.
+ *
+ * A closed batch no longer changes, so its update applies the same events
+ * however many times it is run.
+ */
 class MacTableManager {
  public:
   explicit MacTableManager(SwSwitch* sw);
@@ -24,11 +45,19 @@ class MacTableManager {
       L2EntryUpdateType l2EntryUpdateType);
 
  private:
+  struct PendingUpdates {
+    std::vector<std::pair<L2Entry, L2EntryUpdateType>> updates;
+    bool closed{false};
+  };
+  using SyncedPendingUpdates = folly::Synchronized<PendingUpdates>;
+
   // Forbidden copy constructor and assignment operator
   MacTableManager(MacTableManager const&) = delete;
   MacTableManager& operator=(MacTableManager const&) = delete;
 
   SwSwitch* sw_{nullptr};
+  // Batch new events join, shared with the state update that owns it
+  folly::Synchronized<std::shared_ptr<SyncedPendingUpdates>> openBatch_;
 };
 
 } // namespace facebook::fboss
@@ -9,6 +9,9 @@
  */
 #include "fboss/agent/MacTableUtils.h"
 
+#include <map>
+#include <optional>
+
 namespace {
 
 using facebook::fboss::MacEntry;
@@ -117,6 +120,48 @@ std::shared_ptr<SwitchState> MacTableUtils::updateMacTable(
   return newState;
 }
 
+std::shared_ptr<SwitchState> MacTableUtils::updateMacTable(
+    const std::shared_ptr<SwitchState>& state,
+    const std::vector<std::pair<L2Entry, L2EntryUpdateType>>& updates) {
+  // Only the last age and the last learn after it matter for each MAC: a
+  // learn followed by an age of the same entry cancel out, and repeated
+  // callbacks for an unchanged entry are no-ops.
+  struct NetUpdate {
+    std::optional<L2Entry> age;
+    std::optional<L2Entry> learn;
+  };
+  std::map<std::pair<VlanID, folly::MacAddress>, NetUpdate> netUpdates;
+  for (const auto& [l2Entry, l2EntryUpdateType] : updates) {
+    auto& netUpdate =
+        netUpdates[std::make_pair(l2Entry.getVlanID(), l2Entry.getMac())];
+    if (l2EntryUpdateType == L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE) {
+      netUpdate.age = l2Entry;
+      netUpdate.learn.reset();
+    } else {
+      netUpdate.learn = l2Entry;
+    }
+  }
+
+  // newState is unpublished after the first change, so each VLAN's MacTable
+  // is cloned once and then modified in place for the rest of the batch.
+  std::shared_ptr<SwitchState> newState{state};
+  for (const auto& [key, netUpdate] : netUpdates) {
+    if (netUpdate.age) {
+      newState = updateMacTable(
+          newState,
+          *netUpdate.age,
+          L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE);
+    }
+    if (netUpdate.learn) {
+      newState = updateMacTable(
+          newState,
+          *netUpdate.learn,
+          L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD);
+    }
+  }
+  return newState;
+}
+
 std::shared_ptr<SwitchState> MacTableUtils::updateOrAddEntryWithClassID(
     const std::shared_ptr<SwitchState>& state,
     VlanID vlanID,
@@ -12,6 +12,9 @@
 #include "fboss/agent/L2Entry.h"
 #include "fboss/agent/state/SwitchState.h"
 
+#include <utility>
+#include <vector>
+
 namespace facebook::fboss {
 
 class SwitchState;
@@ -24,6 +27,18 @@ class MacTableUtils {
       L2Entry l2Entry,
       L2EntryUpdateType l2EntryUpdateType);
 
+  /*
+   * Apply a batch of learning callbacks, in the order they were received,
+   * as one MacTable modification per VLAN.
+   *
+   * Callbacks for the same MAC are first reduced to at most one age event
+   * followed by one learn event, so e.g. a MAC that gets learned, aged and
+   * learned again within the batch is only looked up and programmed once.
+   */
+  static std::shared_ptr<SwitchState> updateMacTable(
+      const std::shared_ptr<SwitchState>& state,
+      const std::vector<std::pair<L2Entry, L2EntryUpdateType>>& updates);
+
   static std::shared_ptr<SwitchState> updateOrAddEntryWithClassID(
       const std::shared_ptr<SwitchState>& state,
       VlanID vlanID,
@@ -25,7 +25,8 @@ NdpCache::NdpCache(
     const SwitchState* state,
     VlanID vlanID,
     std::string vlanName,
-    InterfaceID intfID)
+    InterfaceID intfID,
+    std::shared_ptr<NeighborStateUpdateBatcher> stateUpdateBatcher)
     : NeighborCache<NdpTable>(
           sw,
           vlanID,
@@ -33,7 +34,8 @@ NdpCache::NdpCache(
           intfID,
           state->getNdpTimeout(),
           state->getMaxNeighborProbes(),
-          state->getStaleEntryInterval()) {}
+          state->getStaleEntryInterval(),
+          std::move(stateUpdateBatcher)) {}
 
 void NdpCache::sentNeighborSolicitation(folly::IPAddressV6 ip) {
   setPendingEntry(ip);
@@ -31,7 +31,8 @@ class NdpCache : public NeighborCache<NdpTable> {
       const SwitchState* state,
       VlanID vlanID,
       std::string vlanName,
-      InterfaceID intfID);
+      InterfaceID intfID,
+      std::shared_ptr<NeighborStateUpdateBatcher> stateUpdateBatcher);
 
   void sentNeighborSolicitation(folly::IPAddressV6 ip);
   void receivedNdpMine(
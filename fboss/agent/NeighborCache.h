@@ -112,7 +112,8 @@ class NeighborCache {
       InterfaceID intfID,
       std::chrono::seconds timeout,
       uint32_t maxNeighborProbes,
-      std::chrono::seconds staleEntryInterval)
+      std::chrono::seconds staleEntryInterval,
+      std::shared_ptr<NeighborStateUpdateBatcher> stateUpdateBatcher)
       : sw_(sw),
         timeout_(timeout),
         maxNeighborProbes_(maxNeighborProbes),
@@ -122,7 +123,8 @@ class NeighborCache {
             sw,
             vlanID,
             vlanName,
-            intfID)) {}
+            intfID,
+            std::move(stateUpdateBatcher))) {}
 
   // Methods useful for subclasses
   void setPendingEntry(AddressType ip) {
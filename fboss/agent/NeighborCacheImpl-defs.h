@@ -100,8 +100,7 @@ void NeighborCacheImpl<NTable>::programEntry(Entry* entry) {
     return newState;
   };
 
-  sw_->updateState(
-      folly::to<std::string>("add neighbor ", fields.ip), std::move(updateFn));
+  stateUpdateBatcher_->enqueue(std::move(updateFn));
 }
 
 template <typename NTable>
@@ -139,9 +138,7 @@ void NeighborCacheImpl<NTable>::programPendingEntry(Entry* entry, bool force) {
     return newState;
   };
 
-  sw_->updateStateNoCoalescing(
-      folly::to<std::string>("add pending entry ", fields.ip),
-      std::move(updateFn));
+  stateUpdateBatcher_->enqueue(std::move(updateFn), true /* nonCoalescing */);
 }
 
 template <typename NTable>
@@ -224,13 +221,7 @@ void NeighborCacheImpl<NTable>::updateEntryClassID(
           return newState;
         };
 
-    auto classIDStr = classID.has_value()
-        ? folly::to<std::string>(static_cast<int>(classID.value()))
-        : "None";
-    sw_->updateState(
-        folly::to<std::string>(
-            "NeighborCache configure lookup classID: ", classIDStr),
-        std::move(updateClassIDFn));
+    stateUpdateBatcher_->enqueue(std::move(updateClassIDFn));
   }
 }
 
@@ -359,10 +350,11 @@ void NeighborCacheImpl<NTable>::flushEntry(AddressType ip, bool* flushed) {
 
   if (flushed) {
     // need a blocking state update if the caller wants to know if an entry
-    // was actually flushed
+    // was actually flushed. Changes already queued must be applied first.
+    stateUpdateBatcher_->flush();
     sw_->updateStateBlocking("flush neighbor entry", std::move(updateFn));
   } else {
-    sw_->updateState("remove neighbor entry: " + ip.str(), std::move(updateFn));
+    stateUpdateBatcher_->enqueue(std::move(updateFn));
   }
 }
 
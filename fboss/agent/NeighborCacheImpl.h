@@ -11,6 +11,7 @@
 
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/NeighborCacheEntry.h"
+#include "fboss/agent/NeighborStateUpdateBatcher.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/state/NeighborEntry.h"
 #include "fboss/agent/state/PortDescriptor.h"
@@ -58,13 +59,15 @@ class NeighborCacheImpl {
       SwSwitch* sw,
       VlanID vlanID,
       std::string vlanName,
-      InterfaceID intfID)
+      InterfaceID intfID,
+      std::shared_ptr<NeighborStateUpdateBatcher> stateUpdateBatcher)
       : cache_(cache),
         sw_(sw),
         vlanID_(vlanID),
         vlanName_(vlanName),
         intfID_(intfID),
-        evb_(sw->getNeighborCacheEvb()) {}
+        evb_(sw->getNeighborCacheEvb()),
+        stateUpdateBatcher_(std::move(stateUpdateBatcher)) {}
 
   // Methods useful for subclasses
   void setPendingEntry(AddressType ip, bool force = false);
@@ -160,6 +163,8 @@ class NeighborCacheImpl {
   std::string vlanName_;
   InterfaceID intfID_;
   folly::EventBase* evb_;
+  // Shared by the caches of all VLANs, see NeighborStateUpdateBatcher
+  std::shared_ptr<NeighborStateUpdateBatcher> stateUpdateBatcher_;
 
   // Map of all entries
   std::unordered_map<AddressType, std::shared_ptr<Entry>> entries_;
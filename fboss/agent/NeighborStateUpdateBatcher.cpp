@@ -0,0 +1,104 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/NeighborStateUpdateBatcher.h"
+
+#include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <folly/Conv.h>
+#include <folly/logging/xlog.h>
+
+DEFINE_int32(
+    neighbor_update_batch_interval_ms,
+    10,
+    "Longest time (ms) a neighbor cache change may wait to be batched with "
+    "others before it is applied to the switch state");
+DEFINE_int32(
+    neighbor_update_max_batch_size,
+    1024,
+    "Apply batched neighbor cache changes to the switch state as soon as "
+    "this many are queued");
+
+namespace facebook::fboss {
+
+NeighborStateUpdateBatcher::NeighborStateUpdateBatcher(
+    SwSwitch* sw,
+    folly::EventBase* evb)
+    : sw_(sw),
+      evb_(evb),
+      flushTimeout_(folly::AsyncTimeout::make(
+          *evb,
+          [this]() noexcept { flush(); })) {}
+
+NeighborStateUpdateBatcher::~NeighborStateUpdateBatcher() {
+  // Don't lose changes the caches have already made to their own entries
+  flush();
+}
+
+void NeighborStateUpdateBatcher::enqueue(
+    SwSwitch::StateUpdateFn fn,
+    bool nonCoalescing) {
+  DCHECK(evb_->isInEventBaseThread());
+  if (nonCoalescing) {
+    // HwSwitch must see this change even if a later one undoes it, so it
+    // can't share a state update with the others. The changes queued ahead
+    // of it are still applied first.
+    flush();
+    sw_->updateStateNoCoalescing("neighbor update", std::move(fn));
+    return;
+  }
+  queued_.push_back({std::move(fn), std::chrono::steady_clock::now()});
+
+  if (queued_.size() >=
+      static_cast<size_t>(FLAGS_neighbor_update_max_batch_size)) {
+    flush();
+  } else if (!flushTimeout_->isScheduled()) {
+    flushTimeout_->scheduleTimeout(FLAGS_neighbor_update_batch_interval_ms);
+  }
+}
+
+void NeighborStateUpdateBatcher::flush() {
+  DCHECK(evb_->isInEventBaseThread());
+  flushTimeout_->cancelTimeout();
+  if (queued_.empty()) {
+    return;
+  }
+
+  auto name =
+      folly::to<std::string>("neighbor updates: ", queued_.size(), " changes");
+  sw_->stats()->neighborUpdateBatchSize(queued_.size());
+  auto updateFn = [sw = sw_, batch = std::move(queued_)](
+                      const std::shared_ptr<SwitchState>& state)
+      -> std::shared_ptr<SwitchState> {
+    sw->stats()->neighborUpdateQueueLatency(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - batch.front().queuedAt));
+
+    std::shared_ptr<SwitchState> newState{state};
+    bool changed{false};
+    for (const auto& update : batch) {
+      auto intermediateState = update.fn(newState);
+      if (intermediateState) {
+        // Publish after each change, as SwSwitch does between updates, so
+        // every function starts from a published state and clones what it
+        // modifies.
+        intermediateState->publish();
+        newState = intermediateState;
+        changed = true;
+      }
+    }
+    return changed ? newState : nullptr;
+  };
+  queued_.clear();
+
+  sw_->updateState(name, std::move(updateFn));
+}
+
+} // namespace facebook::fboss
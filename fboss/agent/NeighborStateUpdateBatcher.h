@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/SwSwitch.h"
+
+#include <folly/io/async/AsyncTimeout.h>
+#include <folly/io/async/EventBase.h>
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+DECLARE_int32(neighbor_update_batch_interval_ms);
+DECLARE_int32(neighbor_update_max_batch_size);
+
+namespace facebook::fboss {
+
+/*
+ * Collects the SwitchState changes made by the neighbor caches of all VLANs
+ * and applies them to the SwSwitch as a single state update.
+ *
+ * Each neighbor entry that gets resolved, marked pending or flushed needs a
+ * change to its VLAN's neighbor table. When a VLAN flaps or a rack peer
+ * reboots, thousands of entries change within milliseconds; scheduling a
+ * state update for each of them means as many clones, deltas and HwSwitch
+ * calls. Instead the caches queue their update functions here. A batch is
+ * handed to the SwSwitch once its oldest change has waited
+ * FLAGS_neighbor_update_batch_interval_ms, or as soon as it reaches
+ * FLAGS_neighbor_update_max_batch_size changes, and runs them in the order
+ * they were queued. Changes that must not be coalesced, such as marking an
+ * entry pending, are applied on their own instead, see enqueue().
+ *
+ * There is no locking in this class. Like the neighbor caches themselves, it
+ * must only be used from the neighbor cache thread.
+ */
+class NeighborStateUpdateBatcher {
+ public:
+  NeighborStateUpdateBatcher(SwSwitch* sw, folly::EventBase* evb);
+  ~NeighborStateUpdateBatcher();
+
+  /*
+   * Queue a state update function. Functions may return nullptr for no
+   * change, just as with SwSwitch::updateState(). A nonCoalescing function is
+   * not batched: the batch queued so far is flushed, and the function is then
+   * scheduled on its own with updateStateNoCoalescing().
+   */
+  void enqueue(SwSwitch::StateUpdateFn fn, bool nonCoalescing = false);
+
+  /*
+   * Schedule the state update for everything queued so far without waiting
+   * for the batch interval. Callers that need a change applied before some
+   * other state update (e.g. a blocking one) should flush first.
+   */
+  void flush();
+
+  size_t numQueued() const {
+    return queued_.size();
+  }
+
+ private:
+  struct QueuedUpdate {
+    SwSwitch::StateUpdateFn fn;
+    std::chrono::steady_clock::time_point queuedAt;
+  };
+
+  // Forbidden copy constructor and assignment operator
+  NeighborStateUpdateBatcher(NeighborStateUpdateBatcher const&) = delete;
+  NeighborStateUpdateBatcher& operator=(NeighborStateUpdateBatcher const&) =
+      delete;
+
+  SwSwitch* sw_;
+  folly::EventBase* evb_;
+  std::unique_ptr<folly::AsyncTimeout> flushTimeout_;
+  std::vector<QueuedUpdate> queued_;
+};
+
+} // namespace facebook::fboss
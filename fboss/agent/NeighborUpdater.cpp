@@ -56,7 +56,9 @@ NeighborUpdater::~NeighborUpdater() {
 }
 
 void NeighborUpdater::waitForPendingUpdates() {
-  folly::via(sw_->getNeighborCacheEvb(), [impl = this->impl_]() {}).get();
+  folly::via(sw_->getNeighborCacheEvb(), [impl = this->impl_]() {
+    impl->flushBatchedStateUpdates();
+  }).get();
 }
 
 void NeighborUpdater::stateUpdated(const StateDelta& delta) {
@@ -51,6 +51,10 @@ class NeighborUpdater : public AutoRegisterStateObserver {
   explicit NeighborUpdater(SwSwitch* sw);
   ~NeighborUpdater() override;
 
+  /*
+   * Wait for neighbor events queued so far to be processed, then schedule
+   * the state update for any changes they batched without further delay.
+   */
   void waitForPendingUpdates();
 
   void stateUpdated(const StateDelta& delta) override;
@@ -42,7 +42,11 @@ namespace facebook::fboss {
 
 using facebook::fboss::DeltaFunctions::forEachChanged;
 
-NeighborUpdaterImpl::NeighborUpdaterImpl(SwSwitch* sw) : sw_(sw) {}
+NeighborUpdaterImpl::NeighborUpdaterImpl(SwSwitch* sw)
+    : sw_(sw),
+      stateUpdateBatcher_(std::make_shared<NeighborStateUpdateBatcher>(
+          sw,
+          sw->getNeighborCacheEvb())) {}
 
 NeighborUpdaterImpl::~NeighborUpdaterImpl() {}
 
@@ -50,7 +54,12 @@ auto NeighborUpdaterImpl::createCaches(
     const SwitchState* state,
     const Vlan* vlan) -> std::shared_ptr<NeighborCaches> {
   auto caches = std::make_shared<NeighborCaches>(
-      sw_, state, vlan->getID(), vlan->getName(), vlan->getInterfaceID());
+      sw_,
+      state,
+      vlan->getID(),
+      vlan->getName(),
+      vlan->getInterfaceID(),
+      stateUpdateBatcher_);
 
   // We need to populate the caches from the SwitchState when a vlan is added
   // After this, we no longer process Arp or Ndp deltas for this vlan.
@@ -182,6 +191,10 @@ bool NeighborUpdaterImpl::flushEntryImpl(VlanID vlan, IPAddress ip) {
   return cache->flushEntryBlocking(ip.asV6());
 }
 
+void NeighborUpdaterImpl::flushBatchedStateUpdates() {
+  stateUpdateBatcher_->flush();
+}
+
 uint32_t NeighborUpdaterImpl::flushEntry(VlanID vlan, IPAddress ip) {
   uint32_t count{0};
   if (vlan == VlanID(0)) {
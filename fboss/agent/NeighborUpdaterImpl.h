@@ -15,6 +15,7 @@
 #include <string>
 #include "fboss/agent/ArpCache.h"
 #include "fboss/agent/NdpCache.h"
+#include "fboss/agent/NeighborStateUpdateBatcher.h"
 #include "fboss/agent/StateObserver.h"
 #include "fboss/agent/state/PortDescriptor.h"
 #include "fboss/agent/types.h"
@@ -48,12 +49,22 @@ class NeighborUpdaterImpl {
         const SwitchState* state,
         VlanID vlanID,
         std::string vlanName,
-        InterfaceID intfID)
-        : arpCache(
-              std::make_shared<ArpCache>(sw, state, vlanID, vlanName, intfID)),
-          ndpCache(
-              std::make_shared<NdpCache>(sw, state, vlanID, vlanName, intfID)) {
-    }
+        InterfaceID intfID,
+        const std::shared_ptr<NeighborStateUpdateBatcher>& stateUpdateBatcher)
+        : arpCache(std::make_shared<ArpCache>(
+              sw,
+              state,
+              vlanID,
+              vlanName,
+              intfID,
+              stateUpdateBatcher)),
+          ndpCache(std::make_shared<NdpCache>(
+              sw,
+              state,
+              vlanID,
+              vlanName,
+              intfID,
+              stateUpdateBatcher)) {}
   };
 
  public:
@@ -93,6 +104,9 @@ class NeighborUpdaterImpl {
 
   bool flushEntryImpl(VlanID vlan, folly::IPAddress ip);
 
+  // Apply the neighbor changes batched so far without further delay
+  void flushBatchedStateUpdates();
+
   // Forbidden copy constructor and assignment operator
   NeighborUpdaterImpl(NeighborUpdaterImpl const&) = delete;
   NeighborUpdaterImpl& operator=(NeighborUpdaterImpl const&) = delete;
@@ -101,6 +115,9 @@ class NeighborUpdaterImpl {
 
   SwSwitch* sw_{nullptr};
 
+  // Batches the SwitchState updates of the caches for all VLANs
+  std::shared_ptr<NeighborStateUpdateBatcher> stateUpdateBatcher_;
+
   friend class NeighborUpdater;
 };
 
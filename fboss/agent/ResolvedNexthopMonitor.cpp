@@ -59,7 +59,11 @@ folly::Synchronized<std::set<ClientID>>
     ResolvedNexthopMonitor::kMonitoredClients;
 
 ResolvedNexthopMonitor::ResolvedNexthopMonitor(SwSwitch* sw)
-    : AutoRegisterStateObserver(sw, "ResolvedNexthopMonitor"), sw_(sw) {}
+    : AutoRegisterStateObserver(
+          sw,
+          "ResolvedNexthopMonitor",
+          SwSwitch::StateObserverDispatch::ASYNC),
+      sw_(sw) {}
 
 void ResolvedNexthopMonitor::stateUpdated(const StateDelta& delta) {
   scheduleProbes_ = false;
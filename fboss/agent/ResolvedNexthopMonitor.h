@@ -37,6 +37,9 @@ class ResolvedNexthopMonitor : public AutoRegisterStateObserver {
    */
  public:
   explicit ResolvedNexthopMonitor(SwSwitch* sw);
+  ~ResolvedNexthopMonitor() override {
+    unregister();
+  }
   void stateUpdated(const StateDelta& delta) override;
 
   bool probesScheduled() const {
@@ -0,0 +1,215 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketDispatcher.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/RxPacket.h"
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/packet/Ethertype.h"
+#include "fboss/agent/packet/ICMPHdr.h"
+#include "fboss/agent/packet/IPProto.h"
+
+#include <folly/Conv.h>
+#include <folly/io/Cursor.h>
+
+#include <stdexcept>
+
+using folly::io::Cursor;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::steady_clock;
+
+namespace facebook::fboss {
+
+namespace {
+constexpr uint16_t kBgpPort = 179;
+constexpr uint32_t kIPv4MinHeaderLength = 20;
+
+bool isNdp(uint8_t icmpType) {
+  return icmpType >=
+      static_cast<uint8_t>(ICMPv6Type::ICMPV6_TYPE_NDP_ROUTER_SOLICITATION) &&
+      icmpType <=
+      static_cast<uint8_t>(ICMPv6Type::ICMPV6_TYPE_NDP_REDIRECT_MESSAGE);
+}
+
+RxPacketDispatcher::PacketClass classifyTcp(Cursor* cursor) {
+  auto srcPort = cursor->readBE<uint16_t>();
+  auto dstPort = cursor->readBE<uint16_t>();
+  return srcPort == kBgpPort || dstPort == kBgpPort
+      ? RxPacketDispatcher::PacketClass::CONTROL
+      : RxPacketDispatcher::PacketClass::DEFAULT;
+}
+
+void updateMax(std::atomic<uint64_t>* max, uint64_t value) {
+  auto current = max->load(std::memory_order_relaxed);
+  while (value > current &&
+         !max->compare_exchange_weak(
+             current, value, std::memory_order_relaxed)) {
+  }
+}
+} // namespace
+
+RxPacketDispatcher::RxPacketDispatcher(
+    Handler handler,
+    uint32_t numThreads,
+    uint32_t queueSize)
+    : handler_(std::move(handler)) {
+  if (numThreads == 0 || queueSize == 0) {
+    throw FbossError(
+        "rx packet dispatcher needs at least one thread and queue entry, got ",
+        numThreads,
+        " threads and ",
+        queueSize,
+        " entries");
+  }
+  for (auto& cls : classes_) {
+    cls = std::make_unique<ClassState>(queueSize);
+  }
+  for (uint32_t i = 0; i < numThreads; ++i) {
+    workers_.emplace_back([this, i]() {
+      initThread(folly::to<std::string>("fbossRxDisp", i));
+      workerLoop();
+    });
+  }
+}
+
+RxPacketDispatcher::~RxPacketDispatcher() {
+  stopping_ = true;
+  for (size_t i = 0; i < workers_.size(); ++i) {
+    sem_.post();
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+RxPacketDispatcher::PacketClass RxPacketDispatcher::classify(
+    const RxPacket* pkt) {
+  try {
+    Cursor c(pkt->buf());
+    c += 12; // Destination and source MAC
+    auto ethertype = c.readBE<uint16_t>();
+    if (ethertype == static_cast<uint16_t>(ETHERTYPE::ETHERTYPE_VLAN)) {
+      c += 2;
+      ethertype = c.readBE<uint16_t>();
+    }
+    switch (static_cast<ETHERTYPE>(ethertype)) {
+      case ETHERTYPE::ETHERTYPE_SLOW_PROTOCOLS:
+      case ETHERTYPE::ETHERTYPE_LLDP:
+      case ETHERTYPE::ETHERRTPE_EAPOL:
+        return PacketClass::CONTROL;
+      case ETHERTYPE::ETHERTYPE_ARP:
+        return PacketClass::NEIGHBOR;
+      case ETHERTYPE::ETHERTYPE_IPV4: {
+        uint32_t headerLength = (c.read<uint8_t>() & 0x0f) * 4;
+        c += 8; // DSCP through TTL
+        auto protocol = c.read<uint8_t>();
+        if (protocol == static_cast<uint8_t>(IP_PROTO::IP_PROTO_TCP) &&
+            headerLength >= kIPv4MinHeaderLength) {
+          c += headerLength - 10;
+          return classifyTcp(&c);
+        }
+        break;
+      }
+      case ETHERTYPE::ETHERTYPE_IPV6: {
+        c += 6; // Version through payload length
+        auto nextHeader = c.read<uint8_t>();
+        c += 33; // Hop limit and addresses
+        if (nextHeader == static_cast<uint8_t>(IP_PROTO::IP_PROTO_TCP)) {
+          return classifyTcp(&c);
+        }
+        if (nextHeader == static_cast<uint8_t>(IP_PROTO::IP_PROTO_IPV6_ICMP) &&
+            isNdp(c.read<uint8_t>())) {
+          return PacketClass::NEIGHBOR;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  } catch (const std::out_of_range&) {
+    // Too short to tell, it is up to the handler to count it as bogus
+  }
+  return PacketClass::DEFAULT;
+}
+
+std::string RxPacketDispatcher::getClassName(PacketClass cls) {
+  switch (cls) {
+    case PacketClass::CONTROL:
+      return "control";
+    case PacketClass::NEIGHBOR:
+      return "neighbor";
+    case PacketClass::DEFAULT:
+      return "default";
+  }
+  throw FbossError("Unknown rx packet class ", static_cast<int>(cls));
+}
+
+bool RxPacketDispatcher::dispatch(
+    std::unique_ptr<RxPacket> pkt,
+    PacketClass cls) {
+  auto& state = *classes_[static_cast<size_t>(cls)];
+  if (!state.queue.write(Entry{std::move(pkt), steady_clock::now()})) {
+    state.dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  state.enqueued.fetch_add(1, std::memory_order_relaxed);
+  sem_.post();
+  return true;
+}
+
+RxPacketDispatcher::Stats RxPacketDispatcher::getStats(PacketClass cls) const {
+  const auto& state = *classes_[static_cast<size_t>(cls)];
+  Stats stats;
+  stats.enqueued = state.enqueued.load(std::memory_order_relaxed);
+  stats.dropped = state.dropped.load(std::memory_order_relaxed);
+  stats.handled = state.handled.load(std::memory_order_relaxed);
+  stats.totalLatencyUsecs =
+      state.totalLatencyUsecs.load(std::memory_order_relaxed);
+  stats.maxLatencyUsecs = state.maxLatencyUsecs.load(std::memory_order_relaxed);
+  return stats;
+}
+
+std::optional<RxPacketDispatcher::PacketClass> RxPacketDispatcher::readNext(
+    Entry* entry) {
+  for (size_t i = 0; i < kNumPacketClasses; ++i) {
+    if (classes_[i]->queue.read(*entry)) {
+      return static_cast<PacketClass>(i);
+    }
+  }
+  return std::nullopt;
+}
+
+void RxPacketDispatcher::workerLoop() {
+  while (true) {
+    sem_.wait();
+    if (stopping_) {
+      return;
+    }
+    // Every post follows its packet being queued, but another worker may
+    // have taken that packet and left an earlier one still being written.
+    Entry entry;
+    std::optional<PacketClass> cls;
+    while (!(cls = readNext(&entry))) {
+      std::this_thread::yield();
+    }
+    auto latency =
+        duration_cast<microseconds>(steady_clock::now() - entry.enqueued)
+            .count();
+    handler_(std::move(entry.pkt));
+
+    auto& state = *classes_[static_cast<size_t>(*cls)];
+    state.handled.fetch_add(1, std::memory_order_relaxed);
+    state.totalLatencyUsecs.fetch_add(latency, std::memory_order_relaxed);
+    updateMax(&state.maxLatencyUsecs, latency);
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/MPMCQueue.h>
+#include <folly/synchronization/LifoSem.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace facebook::fboss {
+
+class RxPacket;
+
+/*
+ * Hands trapped packets off the HwSwitch rx thread to worker threads of
+ * their own, so that a flood of one kind of packet does not hold up the
+ * others behind it.
+ *
+ * Packets are sorted into classes, each with a bounded queue. Whenever a
+ * worker is free it takes the oldest packet of the highest priority class
+ * with any packets queued, so control protocol packets are always handled
+ * ahead of neighbor discovery packets, which are handled ahead of all else.
+ * Packets of a class whose queue is full are dropped, rather than blocking
+ * the rx thread or delaying the other classes.
+ */
+class RxPacketDispatcher {
+ public:
+  // In priority order, highest first
+  enum class PacketClass : uint8_t {
+    // LACP, LLDP, EAPOL and BGP
+    CONTROL,
+    // ARP and IPv6 neighbor discovery
+    NEIGHBOR,
+    DEFAULT,
+  };
+  static constexpr size_t kNumPacketClasses = 3;
+
+  struct Stats {
+    uint64_t enqueued{0};
+    uint64_t dropped{0};
+    uint64_t handled{0};
+    // Time handled packets spent queued
+    uint64_t totalLatencyUsecs{0};
+    uint64_t maxLatencyUsecs{0};
+  };
+
+  using Handler = std::function<void(std::unique_ptr<RxPacket>)>;
+
+  /*
+   * Starts numThreads workers calling handler for each packet dispatched,
+   * with room for queueSize packets per class. handler must not throw.
+   */
+  RxPacketDispatcher(Handler handler, uint32_t numThreads, uint32_t queueSize);
+  // Stops the workers, dropping the packets still queued
+  ~RxPacketDispatcher();
+
+  /*
+   * Classify a packet by its headers. The CPU queue a packet was trapped to
+   * is not known on every platform, so it is not relied upon.
+   */
+  static PacketClass classify(const RxPacket* pkt);
+  static std::string getClassName(PacketClass cls);
+
+  /*
+   * Queue the packet for a worker. Returns false, having dropped the packet,
+   * if the queue of its class is full.
+   */
+  bool dispatch(std::unique_ptr<RxPacket> pkt, PacketClass cls);
+
+  Stats getStats(PacketClass cls) const;
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  RxPacketDispatcher(RxPacketDispatcher const&) = delete;
+  RxPacketDispatcher& operator=(RxPacketDispatcher const&) = delete;
+
+  struct Entry {
+    std::unique_ptr<RxPacket> pkt;
+    std::chrono::steady_clock::time_point enqueued;
+  };
+
+  struct ClassState {
+    explicit ClassState(uint32_t queueSize) : queue(queueSize) {}
+
+    folly::MPMCQueue<Entry> queue;
+    std::atomic<uint64_t> enqueued{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> handled{0};
+    std::atomic<uint64_t> totalLatencyUsecs{0};
+    std::atomic<uint64_t> maxLatencyUsecs{0};
+  };
+
+  void workerLoop();
+  // Take the next packet in priority order, returning its class
+  std::optional<PacketClass> readNext(Entry* entry);
+
+  const Handler handler_;
+  std::array<std::unique_ptr<ClassState>, kNumPacketClasses> classes_;
+  // Posted once per packet queued, and once per worker on stopping
+  folly::LifoSem sem_;
+  std::atomic<bool> stopping_{false};
+  std::vector<std::thread> workers_;
+};
+
+} // namespace facebook::fboss
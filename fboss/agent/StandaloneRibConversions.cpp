@@ -75,7 +75,9 @@ std::shared_ptr<ForwardingInformationBaseMap> fibFromStandaloneRib(
           facebook::fboss::RouterID vrf,
           const facebook::fboss::IPv4NetworkToRouteMap& v4NetworkToRoute,
           const facebook::fboss::IPv6NetworkToRouteMap& v6NetworkToRoute,
+          const facebook::fboss::RibRouteDelta* /*ribDelta*/,
           void* cookie) {
+        // Building a FIB from scratch, so always sync the entire RIB
         facebook::fboss::ForwardingInformationBaseUpdater fibUpdater(
             vrf, v4NetworkToRoute, v6NetworkToRoute);
         fibUpdater(state);
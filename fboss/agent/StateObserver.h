@@ -25,11 +25,16 @@ class StateObserver : public boost::noncopyable {
 
 class AutoRegisterStateObserver : public StateObserver {
  public:
-  AutoRegisterStateObserver(SwSwitch* sw, const std::string& name) : sw_(sw) {
-    sw_->registerStateObserver(this, name);
+  AutoRegisterStateObserver(
+      SwSwitch* sw,
+      const std::string& name,
+      SwSwitch::StateObserverDispatch dispatch =
+          SwSwitch::StateObserverDispatch::SYNC)
+      : sw_(sw) {
+    sw_->registerStateObserver(this, name, dispatch);
   }
   ~AutoRegisterStateObserver() override {
-    sw_->unregisterStateObserver(this);
+    unregister();
   }
 
   // This empty implementation should be overridden by subclasses, but it is
@@ -43,6 +48,16 @@ class AutoRegisterStateObserver : public StateObserver {
   SwSwitch* sw_{nullptr};
 
  protected:
+  // Observers registered for ASYNC dispatch are called from a thread of their
+  // own, so they must call this from their own destructor, before their
+  // members are destroyed under a stateUpdated call in progress.
+  void unregister() {
+    if (sw_) {
+      sw_->unregisterStateObserver(this);
+      sw_ = nullptr;
+    }
+  }
+
   // Used to suppress TSAN data race on vptr between observer->stateUpdated() in
   // SwSwitch and destructor ~AutoRegisterStateObserver(), which might only
   // happen in unit tests
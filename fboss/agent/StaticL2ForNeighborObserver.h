@@ -21,8 +21,14 @@ class StateDelta;
 class StaticL2ForNeighborObserver : public AutoRegisterStateObserver {
  public:
   explicit StaticL2ForNeighborObserver(SwSwitch* sw)
-      : AutoRegisterStateObserver(sw, "StaticL2ForNeighborObserver"), sw_(sw) {}
-  ~StaticL2ForNeighborObserver() override {}
+      : AutoRegisterStateObserver(
+            sw,
+            "StaticL2ForNeighborObserver",
+            SwSwitch::StateObserverDispatch::ASYNC),
+        sw_(sw) {}
+  ~StaticL2ForNeighborObserver() override {
+    unregister();
+  }
 
   void stateUpdated(const StateDelta& stateDelta) override;
 
@@ -13,6 +13,7 @@
 #include "fboss/agent/AlpmUtils.h"
 #include "fboss/agent/ApplyThriftConfig.h"
 #include "fboss/agent/ArpHandler.h"
+#include "fboss/agent/AsyncStateObserverQueue.h"
 #include "fboss/agent/Constants.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/FbossHwUpdateError.h"
@@ -42,6 +43,7 @@
 #include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/RouteUpdateLogger.h"
 #include "fboss/agent/RxPacket.h"
+#include "fboss/agent/RxPacketDispatcher.h"
 #include "fboss/agent/StaticL2ForNeighborObserver.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/SwitchStats.h"
@@ -64,6 +66,7 @@
 #include "fboss/agent/state/SwitchState.h"
 
 #include <fb303/ServiceData.h>
+#include <folly/Conv.h>
 #include <folly/Demangle.h>
 #include <folly/FileUtil.h>
 #include <folly/GLog.h>
@@ -71,7 +74,9 @@
 #include <folly/MapUtil.h>
 #include <folly/SocketAddress.h>
 #include <folly/String.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
+#include <folly/synchronization/Rcu.h>
 #include <folly/system/ThreadName.h>
 #include <glog/logging.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
@@ -122,6 +127,36 @@ DEFINE_int32(
     64,
     "Expected minimum ethernet packet length");
 
+DEFINE_bool(
+    async_state_observers,
+    false,
+    "Notify state observers registered for ASYNC dispatch on threads of "
+    "their own rather than on the update thread");
+
+DEFINE_bool(
+    pipeline_state_updates,
+    false,
+    "Prepare the next batch of state updates on a separate thread while "
+    "the current batch is being applied to hardware");
+
+DEFINE_int32(
+    rx_packet_dispatch_threads,
+    0,
+    "Threads handling trapped packets in priority order of their protocol, "
+    "off the HwSwitch rx thread. 0 handles them on the rx thread itself");
+
+DEFINE_int32(
+    rx_packet_dispatch_queue_size,
+    1024,
+    "Trapped packets of each priority class queued for the dispatch threads, "
+    "beyond which they are dropped");
+
+DEFINE_bool(
+    incremental_config_apply,
+    true,
+    "Skip applying the sections of a new config left unchanged since the "
+    "last config applied");
+
 namespace {
 
 /**
@@ -171,7 +206,8 @@ auto constexpr kHwUpdateFailures = "hw_update_failures";
 namespace facebook::fboss {
 
 SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
-    : hw_(platform->getHwSwitch()),
+    : configApplyCache_(new ThriftConfigApplyCache()),
+      hw_(platform->getHwSwitch()),
       platform_(std::move(platform)),
       arp_(new ArpHandler(this)),
       ipv4_(new IPv4Handler(this)),
@@ -213,6 +249,9 @@ void SwSwitch::stop() {
   // while we are destroying ourselves
   hw_->unregisterCallbacks();
 
+  // Drop the trapped packets not handled yet, before the handlers go away
+  rxPacketDispatcher_.reset();
+
   // Stop tunMgr so we don't get any packets to process
   // in software that were sent to the switch ip or were
   // routed from kernel to the front panel tunnel interface.
@@ -452,6 +491,14 @@ void SwSwitch::publishTxPacket(TxPacket* pkt, uint16_t ethertype) {
 void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
   auto begin = steady_clock::now();
   flags_ = flags;
+  if (FLAGS_rx_packet_dispatch_threads > 0) {
+    rxPacketDispatcher_ = std::make_unique<RxPacketDispatcher>(
+        [this](std::unique_ptr<RxPacket> pkt) {
+          handlePacketNoThrow(std::move(pkt));
+        },
+        FLAGS_rx_packet_dispatch_threads,
+        FLAGS_rx_packet_dispatch_queue_size);
+  }
   auto hwInitRet = hw_->init(this, false /*failHwCallsOnWarmboot*/);
   auto initialState = hwInitRet.switchState;
   bootType_ = hwInitRet.bootType;
@@ -641,15 +688,20 @@ void SwSwitch::fibSynced() {
 
 void SwSwitch::registerStateObserver(
     StateObserver* observer,
-    const string name) {
+    const string name,
+    StateObserverDispatch dispatch) {
   XLOG(DBG2) << "Registering state observer: " << name;
   updateEventBase_.runImmediatelyOrRunInEventBaseThreadAndWait(
-      [=]() { addStateObserver(observer, name); });
+      [=]() { addStateObserver(observer, name, dispatch); });
 }
 
 void SwSwitch::unregisterStateObserver(StateObserver* observer) {
+  std::unique_ptr<AsyncStateObserverQueue> queue;
   updateEventBase_.runImmediatelyOrRunInEventBaseThreadAndWait(
-      [=]() { removeStateObserver(observer); });
+      [&]() { queue = removeStateObserver(observer); });
+  // Drops any delta still queued for the observer, and waits for it to return
+  // from a delta it is being handed
+  queue.reset();
 }
 
 bool SwSwitch::stateObserverRegistered(StateObserver* observer) {
@@ -657,20 +709,35 @@ bool SwSwitch::stateObserverRegistered(StateObserver* observer) {
   return stateObservers_.find(observer) != stateObservers_.end();
 }
 
-void SwSwitch::removeStateObserver(StateObserver* observer) {
+std::unique_ptr<AsyncStateObserverQueue> SwSwitch::removeStateObserver(
+    StateObserver* observer) {
   DCHECK(updateEventBase_.isInEventBaseThread());
   auto nErased = stateObservers_.erase(observer);
   if (!nErased) {
     throw FbossError("State observer remove failed: observer does not exist");
   }
+  std::unique_ptr<AsyncStateObserverQueue> queue;
+  auto iter = asyncStateObserverQueues_.find(observer);
+  if (iter != asyncStateObserverQueues_.end()) {
+    queue = std::move(iter->second);
+    asyncStateObserverQueues_.erase(iter);
+  }
+  return queue;
 }
 
-void SwSwitch::addStateObserver(StateObserver* observer, const string& name) {
+void SwSwitch::addStateObserver(
+    StateObserver* observer,
+    const string& name,
+    StateObserverDispatch dispatch) {
   DCHECK(updateEventBase_.isInEventBaseThread());
   if (stateObserverRegistered(observer)) {
     throw FbossError("State observer add failed: ", name, " already exists");
   }
   stateObservers_.emplace(observer, name);
+  if (dispatch == StateObserverDispatch::ASYNC && FLAGS_async_state_observers) {
+    asyncStateObserverQueues_.emplace(
+        observer, std::make_unique<AsyncStateObserverQueue>(observer, name));
+  }
 }
 
 void SwSwitch::notifyStateObservers(const StateDelta& delta) {
@@ -680,8 +747,13 @@ void SwSwitch::notifyStateObservers(const StateDelta& delta) {
     return;
   }
   for (auto observerName : stateObservers_) {
+    auto observer = observerName.first;
+    auto queue = asyncStateObserverQueues_.find(observer);
+    if (queue != asyncStateObserverQueues_.end()) {
+      queue->second->enqueue(delta);
+      continue;
+    }
     try {
-      auto observer = observerName.first;
       observer->stateUpdated(delta);
     } catch (const std::exception& ex) {
       // TODO: Figure out the best way to handle errors here.
@@ -754,6 +826,54 @@ void SwSwitch::handlePendingUpdatesHelper(SwSwitch* sw) {
 }
 
 void SwSwitch::handlePendingUpdates() {
+  auto updates = takePendingUpdates();
+  // handlePendingUpdates() is invoked once for each update, but a previous
+  // call might have already processed everything.  If we don't have anything
+  // to do just return early.
+  if (updates.empty()) {
+    return;
+  }
+
+  // This function should never be called with valid updates while we are
+  // not initialized yet
+  DCHECK(isInitialized());
+
+  auto prepared = prepareUpdates(std::move(updates), getState());
+  while (true) {
+    // While this batch is being applied to HW, prepare the next one on top
+    // of the state it is expected to leave us in.
+    std::optional<folly::Future<PreparedUpdates>> next;
+    if (statePrepareThread_ && updateEventBase_.inRunningEventBaseThread()) {
+      auto nextUpdates = takePendingUpdates();
+      if (!nextUpdates.empty()) {
+        next = folly::via(
+            folly::getKeepAliveToken(&statePrepareEventBase_),
+            [this,
+             nextUpdates = std::move(nextUpdates),
+             oldState = prepared.newDesiredState]() mutable {
+              return prepareUpdates(std::move(nextUpdates), oldState);
+            });
+      }
+    }
+    applyPreparedUpdates(std::move(prepared));
+    if (!next) {
+      return;
+    }
+    prepared = std::move(*next).get();
+    auto appliedState = getAppliedState();
+    if (prepared.oldState != appliedState) {
+      // The previous batch did not get applied as is: HW rejected or
+      // reverted part of it, or we started exiting. Prepare this batch
+      // again on top of what did get applied, as it would have been had it
+      // not been prepared ahead.
+      XLOG(DBG2) << "Preparing state update batch again on top of the "
+                 << "applied state, gen=" << appliedState->getGeneration();
+      prepared = prepareUpdates(std::move(prepared.updates), appliedState);
+    }
+  }
+}
+
+SwSwitch::StateUpdateList SwSwitch::takePendingUpdates() {
   // Get the list of updates to run.
   //
   // We might pull multiple updates off the list at once if several updates
@@ -786,12 +906,8 @@ void SwSwitch::handlePendingUpdates() {
     updates.splice(
         updates.begin(), pendingUpdates_, pendingUpdates_.begin(), iter);
   }
-
-  // handlePendingUpdates() is invoked once for each update, but a previous
-  // call might have already processed everything.  If we don't have anything
-  // to do just return early.
   if (updates.empty()) {
-    return;
+    return updates;
   }
 
   // Non coalescing updates should be applied individually
@@ -804,17 +920,25 @@ void SwSwitch::handlePendingUpdates() {
     CHECK(isNonCoalescing)
         << " Hw Failure protected updates should be non coalescing";
   }
+  return updates;
+}
 
-  // This function should never be called with valid updates while we are
-  // not initialized yet
-  DCHECK(isInitialized());
+SwSwitch::PreparedUpdates SwSwitch::prepareUpdates(
+    StateUpdateList updates,
+    std::shared_ptr<SwitchState> oldState) {
+  auto start = std::chrono::steady_clock::now();
+  PreparedUpdates prepared;
+  // Every update of a batch prepared again may have failed the first time
+  prepared.hwFailureProtected =
+      !updates.empty() && updates.begin()->hwFailureProtected();
+  prepared.updates = std::move(updates);
+  prepared.oldState = std::move(oldState);
 
   // Call all of the update functions to prepare the new SwitchState
-  auto oldAppliedState = getState();
   // We start with the old state, and apply state updates one at a time.
-  auto newDesiredState = oldAppliedState;
-  auto iter = updates.begin();
-  while (iter != updates.end()) {
+  auto newDesiredState = prepared.oldState;
+  auto iter = prepared.updates.begin();
+  while (iter != prepared.updates.end()) {
     StateUpdate* update = &(*iter);
     ++iter;
 
@@ -841,13 +965,24 @@ void SwSwitch::handlePendingUpdates() {
       newDesiredState = intermediateState;
     }
   }
+  prepared.newDesiredState = std::move(newDesiredState);
+  stats()->stateUpdatePrepare(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - start));
+  return prepared;
+}
+
+void SwSwitch::applyPreparedUpdates(PreparedUpdates prepared) {
+  auto& updates = prepared.updates;
+  const auto& oldAppliedState = prepared.oldState;
+  const auto& newDesiredState = prepared.newDesiredState;
   // Start newAppliedState as equal to newDesiredState unless
   // we learn otherwise
   auto newAppliedState = newDesiredState;
   // Now apply the update and notify subscribers
   if (newDesiredState != oldAppliedState) {
-    auto isTransaction = updates.begin()->hwFailureProtected() &&
-        getHw()->transactionsSupported();
+    auto isTransaction =
+        prepared.hwFailureProtected && getHw()->transactionsSupported();
     // There was some change during these state updates
     newAppliedState =
         applyUpdate(oldAppliedState, newDesiredState, isTransaction);
@@ -892,11 +1027,23 @@ void SwSwitch::handlePendingUpdates() {
 
 void SwSwitch::setStateInternal(std::shared_ptr<SwitchState> newAppliedState) {
   // This is one of the only two places that should ever directly access
-  // stateDontUseDirectly_.  (getState() being the other one.)
+  // stateDontUseDirectly_.  (getState() being the other one, with
+  // getStateReadGuard() reading rcuAppliedState_ published here.)
   CHECK(bool(newAppliedState));
   CHECK(newAppliedState->isPublished());
-  std::unique_lock guard(stateLock_);
-  appliedStateDontUseDirectly_.swap(newAppliedState);
+  {
+    std::unique_lock guard(stateLock_);
+    appliedStateDontUseDirectly_.swap(newAppliedState);
+    rcuAppliedState_.store(
+        appliedStateDontUseDirectly_.get(), std::memory_order_release);
+  }
+  // newAppliedState now holds the previously applied state. Readers that
+  // got it from getStateReadGuard() may still be using it, so drop our
+  // reference only once they are done.
+  if (newAppliedState) {
+    folly::rcu_retire(
+        new std::shared_ptr<SwitchState>(std::move(newAppliedState)));
+  }
 }
 
 std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
@@ -935,6 +1082,7 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   // take a non-trivial amount of time, and blocking other users seems
   // undesirable.  So far I don't think this brief discrepancy should cause
   // major issues.
+  auto hwStart = std::chrono::steady_clock::now();
   try {
     newAppliedState = isTransaction ? hw_->stateChangedTransaction(delta)
                                     : hw_->stateChanged(delta);
@@ -951,12 +1099,24 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
                 << folly::exceptionStr(ex);
   }
 
+  auto hwEnd = std::chrono::steady_clock::now();
+  stats()->stateUpdateHwApply(
+      std::chrono::duration_cast<std::chrono::microseconds>(hwEnd - hwStart));
+
   setStateInternal(newAppliedState);
 
-  // Notifies all observers of the current state update.
-  notifyStateObservers(StateDelta(oldState, newAppliedState));
+  // Notifies all observers of the current state update. The HwSwitch
+  // usually applies the new state as is, and then observers can share the
+  // delta it was handed rather than recomputing one.
+  if (newAppliedState == newState) {
+    notifyStateObservers(delta);
+  } else {
+    notifyStateObservers(StateDelta(oldState, newAppliedState));
+  }
 
   auto end = std::chrono::steady_clock::now();
+  stats()->stateUpdateNotify(
+      std::chrono::duration_cast<std::chrono::microseconds>(end - hwEnd));
   auto duration =
       std::chrono::duration_cast<std::chrono::microseconds>(end - start);
   stats()->stateUpdate(duration);
@@ -1036,6 +1196,19 @@ void SwSwitch::setPortStatusCounter(PortID port, bool up) {
 }
 
 void SwSwitch::packetReceived(std::unique_ptr<RxPacket> pkt) noexcept {
+  if (!rxPacketDispatcher_) {
+    handlePacketNoThrow(std::move(pkt));
+    return;
+  }
+  PortID port = pkt->getSrcPort();
+  auto cls = RxPacketDispatcher::classify(pkt.get());
+  if (!rxPacketDispatcher_->dispatch(std::move(pkt), cls)) {
+    stats()->rxDispatchDropped(cls);
+    portStats(port)->pktDropped();
+  }
+}
+
+void SwSwitch::handlePacketNoThrow(std::unique_ptr<RxPacket> pkt) noexcept {
   PortID port = pkt->getSrcPort();
   try {
     handlePacket(std::move(pkt));
@@ -1220,6 +1393,11 @@ void SwSwitch::startThreads() {
       [=] { this->threadLoop("fbossBgThread", &backgroundEventBase_); }));
   updateThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossUpdateThread", &updateEventBase_); }));
+  if (FLAGS_pipeline_state_updates) {
+    statePrepareThread_.reset(new std::thread([=] {
+      this->threadLoop("fbossStatePrepareThread", &statePrepareEventBase_);
+    }));
+  }
   packetTxThread_.reset(new std::thread(
       [=] { this->threadLoop("fbossPktTxThread", &packetTxEventBase_); }));
   pcapDistributionThread_.reset(new std::thread([=] {
@@ -1268,6 +1446,13 @@ void SwSwitch::stopThreads() {
   if (updateThread_) {
     updateThread_->join();
   }
+  // Updates are only prepared ahead from the update thread, so nothing can
+  // be queued for the prepare thread once that has stopped.
+  if (statePrepareThread_) {
+    statePrepareEventBase_.runInEventBaseThread(
+        [this] { statePrepareEventBase_.terminateLoopSoon(); });
+    statePrepareThread_->join();
+  }
   if (packetTxThread_) {
     packetTxThread_->join();
   }
@@ -1601,9 +1786,27 @@ void SwSwitch::applyConfig(
   updateStateBlocking(
       reason,
       [&](const shared_ptr<SwitchState>& state) -> shared_ptr<SwitchState> {
+        auto cache =
+            FLAGS_incremental_config_apply ? configApplyCache_.get() : nullptr;
         auto newState = rib_
-            ? applyThriftConfig(state, &newConfig, getPlatform(), &routeUpdater)
-            : applyThriftConfig(state, &newConfig, getPlatform());
+            ? applyThriftConfig(
+                  state, &newConfig, getPlatform(), &routeUpdater, cache)
+            : applyThriftConfig(
+                  state,
+                  &newConfig,
+                  getPlatform(),
+                  static_cast<RoutingInformationBase*>(nullptr),
+                  cache);
+        if (cache) {
+          int64_t skipped = 0;
+          for (const auto& [section, stats] : cache->getLastApplyStats()) {
+            fb303::fbData->setCounter(
+                folly::to<std::string>("config.apply.", section, ".usecs"),
+                stats.applyTime.count());
+            skipped += stats.skipped ? 1 : 0;
+          }
+          fb303::fbData->setCounter("config.apply.skipped_sections", skipped);
+        }
 
         if (newState && !isValidStateUpdate(StateDelta(state, newState))) {
           throw FbossError("Invalid config passed in, skipping");
@@ -12,6 +12,7 @@
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
+#include "fboss/agent/SwitchStateReadGuard.h"
 #include "fboss/agent/ThreadHeartbeat.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
@@ -48,12 +49,15 @@ class PortDescriptor;
 class PortStats;
 class PortUpdateHandler;
 class RxPacket;
+class RxPacketDispatcher;
 class SwitchState;
 class SwitchStats;
 class StateDelta;
+class ThriftConfigApplyCache;
 class NeighborUpdater;
 class RouteUpdateLogger;
 class StateObserver;
+class AsyncStateObserverQueue;
 class TunManager;
 class MirrorManager;
 class LookupClassUpdater;
@@ -200,6 +204,17 @@ class SwSwitch : public HwSwitch::Callback {
   std::shared_ptr<SwitchState> getState() const {
     return getAppliedState();
   }
+  /*
+   * Get read access to the same applied state as getState(), without
+   * taking stateLock_ or a reference to the state. This is intended for the
+   * packet rx path, where many threads look up the state concurrently.
+   * See SwitchStateReadGuard for how long the state may be used.
+   */
+  SwitchStateReadGuard getStateReadGuard() const {
+    folly::rcu_reader reader;
+    return SwitchStateReadGuard(
+        std::move(reader), rcuAppliedState_.load(std::memory_order_acquire));
+  }
   /**
    * Schedule an update to the switch state.
    *
@@ -236,6 +251,11 @@ class SwSwitch : public HwSwitch::Callback {
    * send a single update notification to the HwSwitch and other update
    * subscribers.  Therefore the StateUpdateFn may be called with an
    * unpublished SwitchState in some cases.
+   *
+   * With --pipeline_state_updates, the StateUpdateFn may first be called
+   * from the state prepare thread, and then a second time from the update
+   * thread, when the updates ahead of it did not get applied to HW as is.
+   * See StateUpdate::applyUpdate() for what that requires of it.
    */
   bool updateState(folly::StringPiece name, StateUpdateFn fn);
 
@@ -304,9 +324,24 @@ class SwSwitch : public HwSwitch::Callback {
    * should register using this api.
    *
    * The only required method for observers is stateUpdated and observers can
-   * count on this always being called from the update thread.
-   */
-  void registerStateObserver(StateObserver* observer, const std::string name);
+   * count on this always being called from the update thread, unless they
+   * register for ASYNC dispatch.
+   *
+   * With --async_state_observers, ASYNC observers are instead called from a
+   * thread of their own, and see deltas merged together when they fall
+   * behind. An observer may register for that only if its stateUpdated does
+   * not need the update thread. Without the flag they are called from the
+   * update thread like SYNC observers.
+   *
+   * Unregistering an ASYNC observer drops any delta still queued for it and
+   * waits for a stateUpdated call in progress, so an observer must be
+   * unregistered before any state its stateUpdated uses is destroyed.
+   */
+  enum class StateObserverDispatch { SYNC, ASYNC };
+  void registerStateObserver(
+      StateObserver* observer,
+      const std::string name,
+      StateObserverDispatch dispatch = StateObserverDispatch::SYNC);
   void unregisterStateObserver(StateObserver* observer);
 
   /*
@@ -571,6 +606,14 @@ class SwSwitch : public HwSwitch::Callback {
   LldpManager* getLldpMgr() {
     return lldpManager_.get();
   }
+
+  /*
+   * Get the dispatcher of trapped packets, null unless
+   * --rx_packet_dispatch_threads is set
+   */
+  const RxPacketDispatcher* getRxPacketDispatcher() const {
+    return rxPacketDispatcher_.get();
+  }
 #if FOLLY_HAS_COROUTINES
   /*
    *
@@ -737,9 +780,27 @@ class SwSwitch : public HwSwitch::Callback {
   void setSwitchRunState(SwitchRunState desiredState);
   SwitchStats* createSwitchStats();
   void handlePacket(std::unique_ptr<RxPacket> pkt);
+  // handlePacket(), counting rather than throwing errors
+  void handlePacketNoThrow(std::unique_ptr<RxPacket> pkt) noexcept;
+
+  /*
+   * A batch of StateUpdates taken off pendingUpdates_, with the state it
+   * was applied on top of and the resulting state to be applied to HW.
+   */
+  struct PreparedUpdates {
+    StateUpdateList updates;
+    std::shared_ptr<SwitchState> oldState;
+    std::shared_ptr<SwitchState> newDesiredState;
+    bool hwFailureProtected{false};
+  };
 
   static void handlePendingUpdatesHelper(SwSwitch* sw);
   void handlePendingUpdates();
+  StateUpdateList takePendingUpdates();
+  PreparedUpdates prepareUpdates(
+      StateUpdateList updates,
+      std::shared_ptr<SwitchState> oldState);
+  void applyPreparedUpdates(PreparedUpdates prepared);
   std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& oldState,
       const std::shared_ptr<SwitchState>& newState,
@@ -755,8 +816,14 @@ class SwSwitch : public HwSwitch::Callback {
    * called from the update thread, if the update thread is running.
    */
   bool stateObserverRegistered(StateObserver* observer);
-  void addStateObserver(StateObserver* observer, const std::string& name);
-  void removeStateObserver(StateObserver* observer);
+  void addStateObserver(
+      StateObserver* observer,
+      const std::string& name,
+      StateObserverDispatch dispatch);
+  // Returns the observer's queue if it is notified asynchronously, for the
+  // caller to destroy once off the update thread
+  std::unique_ptr<AsyncStateObserverQueue> removeStateObserver(
+      StateObserver* observer);
 
   /*
    * File where switch state gets dumped on exit
@@ -785,6 +852,8 @@ class SwSwitch : public HwSwitch::Callback {
 
   std::string curConfigStr_;
   cfg::SwitchConfig curConfig_;
+  // Sections of curConfig_, to skip those unchanged on the next applyConfig
+  std::unique_ptr<ThriftConfigApplyCache> configApplyCache_;
 
   // The HwSwitch object.  This object is owned by the Platform.
   HwSwitch* hw_;
@@ -820,6 +889,12 @@ class SwSwitch : public HwSwitch::Callback {
    */
   std::shared_ptr<SwitchState> appliedStateDontUseDirectly_;
   mutable folly::SpinLock stateLock_;
+  /*
+   * appliedStateDontUseDirectly_.get(), published for RCU readers in
+   * getStateReadGuard(). setStateInternal() retires the previous applied
+   * state through RCU so it outlives any reader still using it.
+   */
+  std::atomic<const SwitchState*> rcuAppliedState_{nullptr};
 
   /*
    * A thread for performing various background tasks.
@@ -850,6 +925,14 @@ class SwSwitch : public HwSwitch::Callback {
   folly::EventBase updateEventBase_;
   std::unique_ptr<ThreadHeartbeat> updThreadHeartbeat_;
 
+  /*
+   * A thread running the StateUpdate functions of the next batch of
+   * updates while the update thread applies the current one to HW.
+   * Only started with --pipeline_state_updates.
+   */
+  std::unique_ptr<std::thread> statePrepareThread_;
+  folly::EventBase statePrepareEventBase_;
+
   /*
    * A thread dedicated to LACP processing.
    */
@@ -879,12 +962,16 @@ class SwSwitch : public HwSwitch::Callback {
    * locking when we access the container during a state update.
    */
   std::map<StateObserver*, std::string> stateObservers_;
+  // Queues of the observers in stateObservers_ notified asynchronously
+  std::map<StateObserver*, std::unique_ptr<AsyncStateObserverQueue>>
+      asyncStateObserverQueues_;
 
   std::unique_ptr<ArpHandler> arp_;
   std::unique_ptr<IPv4Handler> ipv4_;
   std::unique_ptr<IPv6Handler> ipv6_;
   std::unique_ptr<NeighborUpdater> nUpdater_;
   std::unique_ptr<PktCaptureManager> pcapMgr_;
+  std::unique_ptr<RxPacketDispatcher> rxPacketDispatcher_;
   std::unique_ptr<MirrorManager> mirrorManager_;
   std::unique_ptr<MPLSHandler> mplsHandler_;
   std::unique_ptr<RouteUpdateLogger> routeUpdateLogger_;
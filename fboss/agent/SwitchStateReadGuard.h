@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <folly/synchronization/Rcu.h>
+
+#include <utility>
+
+namespace facebook::fboss {
+
+class SwitchState;
+
+/*
+ * Read-only access to the applied SwitchState, returned by
+ * SwSwitch::getStateReadGuard().
+ *
+ * The guard holds an RCU read lock rather than a reference to the state:
+ * taking it neither locks SwSwitch::stateLock_ nor touches the shared_ptr
+ * refcount, which every rx thread would otherwise contend on. SwSwitch
+ * retires replaced states through RCU, so the state stays alive for as long
+ * as the guard does.
+ *
+ * Guards are meant for short lookups on the packet path. Do not keep the raw
+ * SwitchState pointer past the guard's lifetime; shared_ptrs to nodes within
+ * the state (Vlans, Interfaces, ...) may of course be copied out and kept.
+ * Code that needs a std::shared_ptr<SwitchState> should call
+ * SwSwitch::getState() instead.
+ */
+class SwitchStateReadGuard {
+ public:
+  SwitchStateReadGuard(folly::rcu_reader reader, const SwitchState* state)
+      : reader_(std::move(reader)), state_(state) {}
+
+  SwitchStateReadGuard(const SwitchStateReadGuard&) = delete;
+  SwitchStateReadGuard& operator=(const SwitchStateReadGuard&) = delete;
+  SwitchStateReadGuard(SwitchStateReadGuard&&) = default;
+  SwitchStateReadGuard& operator=(SwitchStateReadGuard&&) = default;
+
+  const SwitchState* get() const {
+    return state_;
+  }
+  const SwitchState* operator->() const {
+    return state_;
+  }
+  const SwitchState& operator*() const {
+    return *state_;
+  }
+  explicit operator bool() const {
+    return state_ != nullptr;
+  }
+
+ private:
+  folly::rcu_reader reader_;
+  const SwitchState* state_{nullptr};
+};
+
+} // namespace facebook::fboss
@@ -30,6 +30,21 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
       trapPktBogus_(map, kCounterPrefix + "trapped.bogus", SUM, RATE),
       trapPktErrors_(map, kCounterPrefix + "trapped.error", SUM, RATE),
       trapPktUnhandled_(map, kCounterPrefix + "trapped.unhandled", SUM, RATE),
+      trapPktDispatchDropsControl_(
+          map,
+          kCounterPrefix + "trapped.dispatch.control.drops",
+          SUM,
+          RATE),
+      trapPktDispatchDropsNeighbor_(
+          map,
+          kCounterPrefix + "trapped.dispatch.neighbor.drops",
+          SUM,
+          RATE),
+      trapPktDispatchDropsDefault_(
+          map,
+          kCounterPrefix + "trapped.dispatch.default.drops",
+          SUM,
+          RATE),
       trapPktToHost_(map, kCounterPrefix + "host.rx", SUM, RATE),
       trapPktToHostBytes_(map, kCounterPrefix + "host.rx.bytes", SUM, RATE),
       pktFromHost_(map, kCounterPrefix + "host.tx", SUM, RATE),
@@ -79,6 +94,24 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           SUM,
           RATE),
       updateState_(map, kCounterPrefix + "state_update.us", 50000, 0, 1000000),
+      updateStatePrepare_(
+          map,
+          kCounterPrefix + "state_update.prepare.us",
+          50000,
+          0,
+          1000000),
+      updateStateHwApply_(
+          map,
+          kCounterPrefix + "state_update.hw_apply.us",
+          50000,
+          0,
+          1000000),
+      updateStateNotify_(
+          map,
+          kCounterPrefix + "state_update.notify.us",
+          50000,
+          0,
+          1000000),
       routeUpdate_(map, kCounterPrefix + "route_update.us", 50, 0, 500),
       bgHeartbeatDelay_(
           map,
@@ -170,6 +203,24 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
           AVG,
           50,
           100),
+      neighborUpdateBatchSize_(
+          map,
+          kCounterPrefix + "neighbor_update_batch_size",
+          10,
+          0,
+          1000,
+          AVG,
+          50,
+          100),
+      neighborUpdateQueueLatency_(
+          map,
+          kCounterPrefix + "neighbor_update_queue_latency.ms",
+          10,
+          0,
+          1000,
+          AVG,
+          50,
+          100),
       linkStateChange_(map, kCounterPrefix + "link_state.flap", SUM),
       pcapDistFailure_(map, kCounterPrefix + "pcap_dist_failure.error"),
       updateStatsExceptions_(
@@ -15,6 +15,7 @@
 #include <chrono>
 #include "fboss/agent/AggregatePortStats.h"
 #include "fboss/agent/PortStats.h"
+#include "fboss/agent/RxPacketDispatcher.h"
 #include "fboss/agent/types.h"
 
 namespace facebook::fboss {
@@ -81,6 +82,20 @@ class SwitchStats : public boost::noncopyable {
     trapPktUnhandled_.addValue(1);
     trapPktDrops_.addValue(1);
   }
+  // Counted as dropped through PortStats::pktDropped() as well
+  void rxDispatchDropped(RxPacketDispatcher::PacketClass cls) {
+    switch (cls) {
+      case RxPacketDispatcher::PacketClass::CONTROL:
+        trapPktDispatchDropsControl_.addValue(1);
+        break;
+      case RxPacketDispatcher::PacketClass::NEIGHBOR:
+        trapPktDispatchDropsNeighbor_.addValue(1);
+        break;
+      case RxPacketDispatcher::PacketClass::DEFAULT:
+        trapPktDispatchDropsDefault_.addValue(1);
+        break;
+    }
+  }
   void pktToHost(uint32_t bytes) {
     trapPktToHost_.addValue(1);
     trapPktToHostBytes_.addValue(bytes);
@@ -226,6 +241,18 @@ class SwitchStats : public boost::noncopyable {
     updateState_.addValue(us.count());
   }
 
+  void stateUpdatePrepare(std::chrono::microseconds us) {
+    updateStatePrepare_.addValue(us.count());
+  }
+
+  void stateUpdateHwApply(std::chrono::microseconds us) {
+    updateStateHwApply_.addValue(us.count());
+  }
+
+  void stateUpdateNotify(std::chrono::microseconds us) {
+    updateStateNotify_.addValue(us.count());
+  }
+
   void routeUpdate(std::chrono::microseconds us, uint64_t routes) {
     // As syncFib() could include no routes.
     if (routes == 0) {
@@ -274,6 +301,14 @@ class SwitchStats : public boost::noncopyable {
     neighborCacheEventBacklog_.addValue(value);
   }
 
+  void neighborUpdateBatchSize(int value) {
+    neighborUpdateBatchSize_.addValue(value);
+  }
+
+  void neighborUpdateQueueLatency(std::chrono::milliseconds ms) {
+    neighborUpdateQueueLatency_.addValue(ms.count());
+  }
+
   void linkStateChange() {
     linkStateChange_.addValue(1);
   }
@@ -361,6 +396,10 @@ class SwitchStats : public boost::noncopyable {
   TLTimeseries trapPktErrors_;
   // Trapped packets that the controller didn't know how to handle.
   TLTimeseries trapPktUnhandled_;
+  // Trapped packets dropped with the dispatch queue of their class full
+  TLTimeseries trapPktDispatchDropsControl_;
+  TLTimeseries trapPktDispatchDropsNeighbor_;
+  TLTimeseries trapPktDispatchDropsDefault_;
   // Trapped packets forwarded to host
   TLTimeseries trapPktToHost_;
   // Trapped packets forwarded to host in bytes
@@ -448,6 +487,15 @@ class SwitchStats : public boost::noncopyable {
    */
   TLHistogram updateState_;
 
+  /**
+   * Histograms for the stages of a state update (in microsecond): running
+   * the update functions, applying the resulting state to HW, and
+   * notifying state observers.
+   */
+  TLHistogram updateStatePrepare_;
+  TLHistogram updateStateHwApply_;
+  TLHistogram updateStateNotify_;
+
   /**
    * Histogram for time used for route update (in microsecond)
    */
@@ -495,6 +543,16 @@ class SwitchStats : public boost::noncopyable {
    */
   TLHistogram neighborCacheEventBacklog_;
 
+  /**
+   * Number of neighbor cache changes applied per batched state update
+   */
+  TLHistogram neighborUpdateBatchSize_;
+  /**
+   * Time neighbor cache changes waited to be applied to the switch state,
+   * from being queued until their batch ran on the update thread (ms)
+   */
+  TLHistogram neighborUpdateQueueLatency_;
+
   /**
    * Link state up/down change count
    */
@@ -0,0 +1,703 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/TableUpdatePublisher.h"
+
+#include "fboss/agent/AddressUtil.h"
+#include "fboss/agent/FibHelpers.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/state/ArpTable.h"
+#include "fboss/agent/state/DeltaFunctions.h"
+#include "fboss/agent/state/ForwardingInformationBaseContainer.h"
+#include "fboss/agent/state/ForwardingInformationBaseMap.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/RouteTable.h"
+#include "fboss/agent/state/RouteTableMap.h"
+#include "fboss/agent/state/RouteTableRib.h"
+#include "fboss/agent/state/StateDelta.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+#include "fboss/agent/state/VlanMapDelta.h"
+
+#include <folly/ScopeGuard.h>
+#include <folly/logging/xlog.h>
+
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+using facebook::network::toBinaryAddress;
+
+namespace facebook::fboss {
+
+namespace {
+
+template <typename PageT>
+using NextPageFn = folly::Function<std::optional<PageT>()>;
+
+/*
+ * Walks the nodes of the NodeMap innerOf() returns for each node of outer,
+ * one at a time. NodeMaps are immutable once published in a state, so the
+ * iterators stay valid for as long as the maps are held.
+ */
+template <typename OuterMapT, typename InnerOfFn>
+class NodeMapCursor {
+ public:
+  NodeMapCursor(std::shared_ptr<OuterMapT> outer, InnerOfFn innerOf)
+      : outer_(std::move(outer)),
+        innerOf_(std::move(innerOf)),
+        outerIt_(outer_->begin()) {
+    enterOuter();
+  }
+
+  // Call fn(outerNode, innerNode) for the next node. Returns false once
+  // all the nodes have been walked.
+  template <typename Fn>
+  bool next(Fn&& fn) {
+    while (outerIt_ != outer_->end()) {
+      if (innerIt_ != inner_->end()) {
+        fn(*outerIt_, *innerIt_++);
+        return true;
+      }
+      ++outerIt_;
+      enterOuter();
+    }
+    return false;
+  }
+
+ private:
+  using InnerMapPtr = std::decay_t<std::invoke_result_t<
+      InnerOfFn&,
+      const std::shared_ptr<typename OuterMapT::Node>&>>;
+
+  void enterOuter() {
+    if (outerIt_ != outer_->end()) {
+      inner_ = innerOf_(*outerIt_);
+      innerIt_ = inner_->begin();
+    }
+  }
+
+  std::shared_ptr<OuterMapT> outer_;
+  InnerOfFn innerOf_;
+  typename OuterMapT::Iterator outerIt_;
+  InnerMapPtr inner_;
+  typename InnerMapPtr::element_type::Iterator innerIt_;
+};
+
+// Walks the nodes of first, then those of second
+template <typename FirstT, typename SecondT>
+class ChainedCursor {
+ public:
+  ChainedCursor(FirstT first, SecondT second)
+      : first_(std::move(first)), second_(std::move(second)) {}
+
+  template <typename Fn>
+  bool next(Fn&& fn) {
+    return first_.next(fn) || second_.next(fn);
+  }
+
+ private:
+  FirstT first_;
+  SecondT second_;
+};
+
+auto fibRoutes(const std::shared_ptr<SwitchState>& state) {
+  return ChainedCursor(
+      NodeMapCursor(
+          state->getFibs(), [](const auto& fib) { return fib->getFibV6(); }),
+      NodeMapCursor(
+          state->getFibs(), [](const auto& fib) { return fib->getFibV4(); }));
+}
+
+auto ribRoutes(const std::shared_ptr<SwitchState>& state) {
+  return ChainedCursor(
+      NodeMapCursor(
+          state->getRouteTables(),
+          [](const auto& table) { return table->getRibV6()->routes(); }),
+      NodeMapCursor(state->getRouteTables(), [](const auto& table) {
+        return table->getRibV4()->routes();
+      }));
+}
+
+/*
+ * Walks the routes of a state, from its FIBs with the standalone RIB and
+ * from its route tables otherwise, like forAllRoutes() does. Unlike it,
+ * all the IPv6 routes come before the IPv4 ones.
+ */
+class RouteCursor {
+ public:
+  RouteCursor(bool isStandaloneRib, const std::shared_ptr<SwitchState>& state)
+      : cursor_(makeCursor(isStandaloneRib, state)) {}
+
+  // Call fn(rid, route) for the next route
+  template <typename Fn>
+  bool next(Fn&& fn) {
+    return std::visit(
+        [&fn](auto& cursor) {
+          return cursor.next([&fn](const auto& table, const auto& route) {
+            fn(table->getID(), route);
+          });
+        },
+        cursor_);
+  }
+
+ private:
+  using Cursor = std::
+      variant<decltype(fibRoutes(nullptr)), decltype(ribRoutes(nullptr))>;
+
+  static Cursor makeCursor(
+      bool isStandaloneRib,
+      const std::shared_ptr<SwitchState>& state) {
+    if (isStandaloneRib) {
+      return fibRoutes(state);
+    }
+    return ribRoutes(state);
+  }
+
+  Cursor cursor_;
+};
+
+// Walk the ARP or NDP entries of a state, calling fn(vlan, entry)
+auto arpEntries(const std::shared_ptr<SwitchState>& state) {
+  return NodeMapCursor(
+      state->getVlans(), [](const auto& vlan) { return vlan->getArpTable(); });
+}
+
+auto ndpEntries(const std::shared_ptr<SwitchState>& state) {
+  return NodeMapCursor(
+      state->getVlans(), [](const auto& vlan) { return vlan->getNdpTable(); });
+}
+
+/*
+ * Builds the pages of a snapshot one at a time, as they are asked for.
+ * add(pager, node...) adds each node the cursor walks to the pager, until
+ * the pager publishes a page.
+ */
+template <typename PageT, typename CursorT, typename PagerT, typename AddFn>
+class SnapshotPages {
+ public:
+  template <typename MakePagerFn>
+  SnapshotPages(CursorT cursor, MakePagerFn makePager, AddFn add)
+      : cursor_(std::move(cursor)),
+        pager_(makePager([this](PageT page) {
+          DCHECK(!page_);
+          page_ = std::move(page);
+        })),
+        add_(std::move(add)) {}
+
+  // The next page, nullopt once the whole snapshot has been paged
+  std::optional<PageT> next() {
+    while (!page_ && !finished_) {
+      if (!cursor_.next(
+              [this](const auto&... node) { add_(pager_, node...); })) {
+        pager_.finish();
+        finished_ = true;
+      }
+    }
+    return std::exchange(page_, std::nullopt);
+  }
+
+ private:
+  CursorT cursor_;
+  PagerT pager_;
+  AddFn add_;
+  std::optional<PageT> page_;
+  bool finished_{false};
+};
+
+template <
+    typename PageT,
+    typename CursorT,
+    typename MakePagerFn,
+    typename AddFn>
+NextPageFn<PageT>
+snapshotPages(CursorT cursor, MakePagerFn makePager, AddFn add) {
+  using PagerT = std::invoke_result_t<MakePagerFn&, std::function<void(PageT)>>;
+  auto pages = std::make_unique<SnapshotPages<PageT, CursorT, PagerT, AddFn>>(
+      std::move(cursor), std::move(makePager), std::move(add));
+  return [pages = std::move(pages)]() { return pages->next(); };
+}
+
+#if FOLLY_HAS_COROUTINES
+template <typename PageT>
+folly::coro::AsyncGenerator<PageT&&> generatePages(NextPageFn<PageT> nextPage) {
+  while (auto page = nextPage()) {
+    co_yield std::move(*page);
+  }
+}
+#endif
+
+template <typename PageT>
+apache::thrift::ServerStream<PageT> streamPages(NextPageFn<PageT> nextPage) {
+#if FOLLY_HAS_COROUTINES
+  return generatePages(std::move(nextPage));
+#else
+  auto streamAndPublisher =
+      apache::thrift::ServerStream<PageT>::createPublisher([]() {});
+  auto& publisher = streamAndPublisher.second;
+  while (auto page = nextPage()) {
+    publisher.next(std::move(*page));
+  }
+  std::move(publisher).complete();
+  return std::move(streamAndPublisher.first);
+#endif
+}
+
+/*
+ * Packs entries into vectors of at most pageSize entries
+ */
+template <typename EntryT>
+class VectorPager {
+ public:
+  VectorPager(size_t pageSize, std::function<void(std::vector<EntryT>)> publish)
+      : pageSize_(pageSize), publish_(publish) {}
+
+  void add(EntryT entry) {
+    page_.push_back(std::move(entry));
+    if (page_.size() >= pageSize_) {
+      flush();
+    }
+  }
+
+  void finish() {
+    if (!page_.empty()) {
+      flush();
+    }
+  }
+
+ private:
+  void flush() {
+    publish_(std::move(page_));
+    page_ = {};
+  }
+
+  const size_t pageSize_;
+  std::function<void(std::vector<EntryT>)> publish_;
+  std::vector<EntryT> page_;
+};
+
+/*
+ * Packs routes into RouteTableUpdates of at most pageSize routes, each for
+ * a single VRF.
+ */
+class RouteTableUpdatePager {
+ public:
+  RouteTableUpdatePager(
+      size_t pageSize,
+      bool snapshot,
+      std::function<void(RouteTableUpdate)> publish)
+      : pageSize_(pageSize), snapshot_(snapshot), publish_(publish) {}
+
+  template <typename RoutePtrT>
+  void addedOrChanged(RouterID rid, const RoutePtrT& route) {
+    pageFor(rid).addedOrChanged_ref()->push_back(route->toRouteDetails());
+    ++entries_;
+  }
+
+  template <typename RoutePtrT>
+  void removed(RouterID rid, const RoutePtrT& route) {
+    IpPrefix prefix;
+    *prefix.ip_ref() = toBinaryAddress(route->prefix().network);
+    *prefix.prefixLength_ref() = route->prefix().mask;
+    pageFor(rid).removed_ref()->push_back(std::move(prefix));
+    ++entries_;
+  }
+
+  // Publish the last page. A snapshot always ends with an update having
+  // endOfSnapshot set, even if the table is empty.
+  void finish() {
+    if (!page_ && snapshot_) {
+      newPage(RouterID(0));
+    }
+    if (page_) {
+      page_->endOfSnapshot_ref() = snapshot_;
+      flush();
+    }
+  }
+
+ private:
+  RouteTableUpdate& pageFor(RouterID rid) {
+    if (page_ && (pageRid_ != rid || entries_ >= pageSize_)) {
+      flush();
+    }
+    if (!page_) {
+      newPage(rid);
+    }
+    return *page_;
+  }
+
+  void newPage(RouterID rid) {
+    page_.emplace();
+    *page_->vrf_ref() = static_cast<int32_t>(rid);
+    *page_->snapshot_ref() = snapshot_;
+    pageRid_ = rid;
+    entries_ = 0;
+  }
+
+  void flush() {
+    publish_(std::move(*page_));
+    page_.reset();
+  }
+
+  const size_t pageSize_;
+  const bool snapshot_;
+  std::function<void(RouteTableUpdate)> publish_;
+  std::optional<RouteTableUpdate> page_;
+  RouterID pageRid_{0};
+  size_t entries_{0};
+};
+
+template <typename NeighborEntryThrift, typename NeighborEntryT>
+NeighborEntryThrift toNeighborEntryThrift(
+    const Vlan& vlan,
+    const NeighborEntryT& entry) {
+  NeighborEntryThrift thriftEntry;
+  *thriftEntry.ip_ref() = toBinaryAddress(entry.getIP());
+  *thriftEntry.mac_ref() = entry.getMac().toString();
+  *thriftEntry.port_ref() = entry.getPort().asThriftPort();
+  *thriftEntry.vlanName_ref() = vlan.getName();
+  *thriftEntry.vlanID_ref() = vlan.getID();
+  *thriftEntry.state_ref() = entry.isPending() ? "PENDING" : "REACHABLE";
+  *thriftEntry.classID_ref() = entry.getClassID().has_value()
+      ? static_cast<int>(entry.getClassID().value())
+      : 0;
+  return thriftEntry;
+}
+
+/*
+ * Packs ARP and NDP entries into NeighborTableUpdates of at most pageSize
+ * entries.
+ */
+class NeighborTableUpdatePager {
+ public:
+  NeighborTableUpdatePager(
+      size_t pageSize,
+      bool snapshot,
+      std::function<void(NeighborTableUpdate)> publish)
+      : pageSize_(pageSize), snapshot_(snapshot), publish_(publish) {}
+
+  template <typename NeighborEntryPtrT>
+  void add(const Vlan& vlan, const NeighborEntryPtrT& entry, bool removed) {
+    using AddrT = typename std::decay_t<decltype(*entry)>::AddressType;
+    auto& page = currentPage();
+    if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+      auto& entries =
+          removed ? *page.arpRemoved_ref() : *page.arpAddedOrChanged_ref();
+      entries.push_back(toNeighborEntryThrift<ArpEntryThrift>(vlan, *entry));
+    } else {
+      auto& entries =
+          removed ? *page.ndpRemoved_ref() : *page.ndpAddedOrChanged_ref();
+      entries.push_back(toNeighborEntryThrift<NdpEntryThrift>(vlan, *entry));
+    }
+    ++entries_;
+  }
+
+  // Same as RouteTableUpdatePager::finish()
+  void finish() {
+    if (!page_ && snapshot_) {
+      currentPage();
+    }
+    if (page_) {
+      page_->endOfSnapshot_ref() = snapshot_;
+      flush();
+    }
+  }
+
+ private:
+  NeighborTableUpdate& currentPage() {
+    if (page_ && entries_ >= pageSize_) {
+      flush();
+    }
+    if (!page_) {
+      page_.emplace();
+      *page_->snapshot_ref() = snapshot_;
+      entries_ = 0;
+    }
+    return *page_;
+  }
+
+  void flush() {
+    publish_(std::move(*page_));
+    page_.reset();
+  }
+
+  const size_t pageSize_;
+  const bool snapshot_;
+  std::function<void(NeighborTableUpdate)> publish_;
+  std::optional<NeighborTableUpdate> page_;
+  size_t entries_{0};
+};
+
+template <typename NTableDelta>
+void addNeighborDelta(
+    NeighborTableUpdatePager& pager,
+    const Vlan& vlan,
+    const NTableDelta& delta) {
+  DeltaFunctions::forEachChanged(
+      delta,
+      [&](const auto& /*oldEntry*/, const auto& newEntry) {
+        pager.add(vlan, newEntry, false);
+      },
+      [&](const auto& newEntry) { pager.add(vlan, newEntry, false); },
+      [&](const auto& oldEntry) { pager.add(vlan, oldEntry, true); });
+}
+
+} // namespace
+
+apache::thrift::ServerStream<std::vector<RouteDetails>> streamRoutePages(
+    bool isStandaloneRib,
+    std::shared_ptr<SwitchState> state,
+    size_t pageSize) {
+  return streamPages(snapshotPages<std::vector<RouteDetails>>(
+      RouteCursor(isStandaloneRib, state),
+      [pageSize](auto publish) {
+        return VectorPager<RouteDetails>(pageSize, std::move(publish));
+      },
+      [](auto& pager, RouterID /*rid*/, const auto& route) {
+        pager.add(route->toRouteDetails());
+      }));
+}
+
+apache::thrift::ServerStream<std::vector<ArpEntryThrift>> streamArpPages(
+    std::shared_ptr<SwitchState> state,
+    size_t pageSize) {
+  return streamPages(snapshotPages<std::vector<ArpEntryThrift>>(
+      arpEntries(state),
+      [pageSize](auto publish) {
+        return VectorPager<ArpEntryThrift>(pageSize, std::move(publish));
+      },
+      [](auto& pager, const auto& vlan, const auto& entry) {
+        pager.add(toNeighborEntryThrift<ArpEntryThrift>(*vlan, *entry));
+      }));
+}
+
+apache::thrift::ServerStream<std::vector<NdpEntryThrift>> streamNdpPages(
+    std::shared_ptr<SwitchState> state,
+    size_t pageSize) {
+  return streamPages(snapshotPages<std::vector<NdpEntryThrift>>(
+      ndpEntries(state),
+      [pageSize](auto publish) {
+        return VectorPager<NdpEntryThrift>(pageSize, std::move(publish));
+      },
+      [](auto& pager, const auto& vlan, const auto& entry) {
+        pager.add(toNeighborEntryThrift<NdpEntryThrift>(*vlan, *entry));
+      }));
+}
+
+template <typename UpdateT>
+apache::thrift::ServerStream<UpdateT> TableUpdatePublisher<UpdateT>::subscribe(
+    std::shared_ptr<TableUpdatePublisher> publisher,
+    const std::string& name) {
+#if FOLLY_HAS_COROUTINES
+  return generateUpdates(std::move(publisher), name);
+#else
+  auto streamAndPublisher =
+      apache::thrift::ServerStream<UpdateT>::createPublisher(
+          [publisher, name]() mutable {
+            unsubscribe(std::move(publisher), name);
+          });
+  publisher->publisher_ = std::move(streamAndPublisher.second);
+
+  auto snapshot = publisher->registerObserver(name);
+  try {
+    auto nextPage = publisher->pageSnapshot(snapshot);
+    while (auto page = nextPage()) {
+      publisher->publish(std::move(*page));
+    }
+    publisher->snapshotPublished(snapshot);
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to publish " << name << " snapshot: " << ex.what();
+    publisher->progress_.lock()->failed = true;
+    publisher->fail(folly::exception_wrapper(std::current_exception(), ex));
+  }
+  return std::move(streamAndPublisher.first);
+#endif
+}
+
+#if FOLLY_HAS_COROUTINES
+template <typename UpdateT>
+folly::coro::AsyncGenerator<UpdateT&&>
+TableUpdatePublisher<UpdateT>::generateUpdates(
+    std::shared_ptr<TableUpdatePublisher> publisher,
+    std::string name) {
+  // Registered only once the subscriber starts reading, so that a stream
+  // that is never read does not leave the observer registered
+  auto snapshot = publisher->registerObserver(name);
+  SCOPE_EXIT {
+    unsubscribe(publisher, name);
+  };
+  auto nextPage = publisher->pageSnapshot(snapshot);
+  while (auto page = nextPage()) {
+    co_yield std::move(*page);
+  }
+  publisher->snapshotPublished(snapshot);
+  while (true) {
+    auto update = co_await publisher->updates_.dequeue();
+    co_yield std::move(update).value();
+  }
+}
+#endif
+
+template <typename UpdateT>
+std::shared_ptr<SwitchState> TableUpdatePublisher<UpdateT>::registerObserver(
+    const std::string& name) {
+  std::shared_ptr<SwitchState> snapshot;
+  sw_->getUpdateEvb()->runImmediatelyOrRunInEventBaseThreadAndWait([&]() {
+    // Taken on the update thread, so that the first delta the observer sees
+    // starts from this state
+    snapshot = sw_->getState();
+    sw_->registerStateObserver(this, name);
+  });
+  return snapshot;
+}
+
+template <typename UpdateT>
+void TableUpdatePublisher<UpdateT>::unsubscribe(
+    std::shared_ptr<TableUpdatePublisher> publisher,
+    const std::string& name) {
+  XLOG(DBG2) << name << " subscriber disconnected";
+  // Not unregistered right away, as this may run while the update thread
+  // is notifying observers. Unregistering waits for any delta already
+  // queued for the observer, so nothing uses it once this lets go of it.
+  auto sw = publisher->sw_;
+  sw->getUpdateEvb()->runInEventBaseThread(
+      [sw, publisher = std::move(publisher)]() {
+        sw->unregisterStateObserver(publisher.get());
+      });
+}
+
+template <typename UpdateT>
+void TableUpdatePublisher<UpdateT>::publish(UpdateT update) {
+#if FOLLY_HAS_COROUTINES
+  updates_.enqueue(folly::Try<UpdateT>(std::move(update)));
+#else
+  publisher_->next(std::move(update));
+#endif
+}
+
+template <typename UpdateT>
+void TableUpdatePublisher<UpdateT>::snapshotPublished(
+    const std::shared_ptr<SwitchState>& snapshot) {
+  auto progress = progress_.lock();
+  if (progress->pending) {
+    publishDelta(StateDelta(snapshot, progress->pending));
+    progress->published = std::move(progress->pending);
+  } else {
+    progress->published = snapshot;
+  }
+}
+
+template <typename UpdateT>
+void TableUpdatePublisher<UpdateT>::stateUpdated(const StateDelta& delta) {
+  auto progress = progress_.lock();
+  if (progress->failed) {
+    return;
+  }
+  if (!progress->published) {
+    progress->pending = delta.newState();
+    return;
+  }
+  try {
+    publishDelta(delta);
+    progress->published = delta.newState();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to publish table update: " << ex.what();
+    progress->failed = true;
+    fail(folly::exception_wrapper(std::current_exception(), ex));
+  }
+}
+
+template <typename UpdateT>
+void TableUpdatePublisher<UpdateT>::fail(folly::exception_wrapper ew) {
+#if FOLLY_HAS_COROUTINES
+  updates_.enqueue(folly::Try<UpdateT>(std::move(ew)));
+#else
+  std::move(*publisher_).complete(std::move(ew));
+  publisher_.reset();
+#endif
+}
+
+template class TableUpdatePublisher<RouteTableUpdate>;
+template class TableUpdatePublisher<NeighborTableUpdate>;
+
+apache::thrift::ServerStream<RouteTableUpdate>
+RouteTableUpdatePublisher::subscribe(SwSwitch* sw, size_t pageSize) {
+  return TableUpdatePublisher::subscribe(
+      std::shared_ptr<RouteTableUpdatePublisher>(
+          new RouteTableUpdatePublisher(sw, pageSize)),
+      "RouteTableUpdatePublisher");
+}
+
+RouteTableUpdatePublisher::NextPageFn RouteTableUpdatePublisher::pageSnapshot(
+    std::shared_ptr<SwitchState> state) {
+  return snapshotPages<RouteTableUpdate>(
+      RouteCursor(sw_->isStandaloneRibEnabled(), state),
+      [pageSize = pageSize_](auto publish) {
+        return RouteTableUpdatePager(pageSize, true, std::move(publish));
+      },
+      [](auto& pager, RouterID rid, const auto& route) {
+        pager.addedOrChanged(rid, route);
+      });
+}
+
+void RouteTableUpdatePublisher::publishDelta(const StateDelta& delta) {
+  RouteTableUpdatePager pager(
+      pageSize_, false, [this](auto update) { publish(std::move(update)); });
+  auto changed = [&pager](
+                     RouterID rid,
+                     const auto& /*oldRoute*/,
+                     const auto& newRoute) {
+    pager.addedOrChanged(rid, newRoute);
+  };
+  auto added = [&pager](RouterID rid, const auto& newRoute) {
+    pager.addedOrChanged(rid, newRoute);
+  };
+  auto removed = [&pager](RouterID rid, const auto& oldRoute) {
+    pager.removed(rid, oldRoute);
+  };
+  forEachChangedRoute(
+      sw_->isStandaloneRibEnabled(), delta, changed, added, removed);
+  pager.finish();
+}
+
+apache::thrift::ServerStream<NeighborTableUpdate>
+NeighborTableUpdatePublisher::subscribe(SwSwitch* sw, size_t pageSize) {
+  return TableUpdatePublisher::subscribe(
+      std::shared_ptr<NeighborTableUpdatePublisher>(
+          new NeighborTableUpdatePublisher(sw, pageSize)),
+      "NeighborTableUpdatePublisher");
+}
+
+NeighborTableUpdatePublisher::NextPageFn
+NeighborTableUpdatePublisher::pageSnapshot(std::shared_ptr<SwitchState> state) {
+  return snapshotPages<NeighborTableUpdate>(
+      ChainedCursor(arpEntries(state), ndpEntries(state)),
+      [pageSize = pageSize_](auto publish) {
+        return NeighborTableUpdatePager(pageSize, true, std::move(publish));
+      },
+      [](auto& pager, const auto& vlan, const auto& entry) {
+        pager.add(*vlan, entry, false);
+      });
+}
+
+void NeighborTableUpdatePublisher::publishDelta(const StateDelta& delta) {
+  NeighborTableUpdatePager pager(
+      pageSize_, false, [this](auto update) { publish(std::move(update)); });
+  for (const auto& vlanDelta : delta.getVlansDelta()) {
+    const auto& vlan = vlanDelta.getNew() ? vlanDelta.getNew()
+                                          : vlanDelta.getOld();
+    addNeighborDelta(pager, *vlan, vlanDelta.getArpDelta());
+    addNeighborDelta(pager, *vlan, vlanDelta.getNdpDelta());
+  }
+  pager.finish();
+}
+
+} // namespace facebook::fboss
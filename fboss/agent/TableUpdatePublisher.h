@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/StateObserver.h"
+#include "fboss/agent/if/gen-cpp2/ctrl_types.h"
+
+#include <folly/ExceptionWrapper.h>
+#include <folly/Function.h>
+#include <folly/Synchronized.h>
+#if FOLLY_HAS_COROUTINES
+#include <folly/Try.h>
+#include <folly/experimental/coro/AsyncGenerator.h>
+#include <folly/experimental/coro/UnboundedQueue.h>
+#endif
+#include <thrift/lib/cpp2/async/ServerStream.h>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss {
+
+class SwSwitch;
+class SwitchState;
+
+/*
+ * Stream the routes, ARP or NDP entries in state in pages of at most
+ * pageSize entries. state is held until the stream ends, and each page is
+ * built from it when the subscriber asks for it. Without coroutine
+ * support, all the pages are queued in the stream up front instead.
+ */
+apache::thrift::ServerStream<std::vector<RouteDetails>> streamRoutePages(
+    bool isStandaloneRib,
+    std::shared_ptr<SwitchState> state,
+    size_t pageSize);
+apache::thrift::ServerStream<std::vector<ArpEntryThrift>> streamArpPages(
+    std::shared_ptr<SwitchState> state,
+    size_t pageSize);
+apache::thrift::ServerStream<std::vector<NdpEntryThrift>> streamNdpPages(
+    std::shared_ptr<SwitchState> state,
+    size_t pageSize);
+
+/*
+ * Streams one of the switch's tables to a thrift subscriber: first the
+ * table as of subscription, then the entries changed by each state update.
+ *
+ * The snapshot is paged like streamRoutePages() does, off the update
+ * thread, so that state updates are not held up by it. Updates applied
+ * meanwhile are sent as a single delta once the snapshot is out.
+ *
+ * A publisher is shared by its subscription and by whatever is publishing
+ * to it at the time. Once the subscriber goes away, it is unregistered on
+ * the update thread, and freed when the last of them lets go of it.
+ * Updates are queued until the subscriber reads them.
+ */
+template <typename UpdateT>
+class TableUpdatePublisher : public StateObserver {
+ public:
+  void stateUpdated(const StateDelta& delta) override;
+
+ protected:
+  using NextPageFn = folly::Function<std::optional<UpdateT>()>;
+
+  TableUpdatePublisher(SwSwitch* sw, size_t pageSize)
+      : sw_(sw), pageSize_(pageSize) {}
+
+  static apache::thrift::ServerStream<UpdateT> subscribe(
+      std::shared_ptr<TableUpdatePublisher> publisher,
+      const std::string& name);
+
+  // Page the table in state, the last page having endOfSnapshot set
+  virtual NextPageFn pageSnapshot(std::shared_ptr<SwitchState> state) = 0;
+  virtual void publishDelta(const StateDelta& delta) = 0;
+
+  void publish(UpdateT update);
+
+  SwSwitch* const sw_;
+  const size_t pageSize_;
+
+ private:
+#if FOLLY_HAS_COROUTINES
+  static folly::coro::AsyncGenerator<UpdateT&&> generateUpdates(
+      std::shared_ptr<TableUpdatePublisher> publisher,
+      std::string name);
+#endif
+  // Register with the switch, returning the state the first delta seen
+  // will start from
+  std::shared_ptr<SwitchState> registerObserver(const std::string& name);
+  static void unsubscribe(
+      std::shared_ptr<TableUpdatePublisher> publisher,
+      const std::string& name);
+  void snapshotPublished(const std::shared_ptr<SwitchState>& snapshot);
+  // Ends the stream with ew. Progress::failed must be set first, so that
+  // no more updates are published.
+  void fail(folly::exception_wrapper ew);
+
+  struct Progress {
+    // State the subscriber is up to date with. Null until the snapshot has
+    // been published.
+    std::shared_ptr<SwitchState> published;
+    // Latest state applied while the snapshot was being published
+    std::shared_ptr<SwitchState> pending;
+    bool failed{false};
+  };
+  folly::Synchronized<Progress, std::mutex> progress_;
+#if FOLLY_HAS_COROUTINES
+  folly::coro::UnboundedQueue<folly::Try<UpdateT>> updates_;
+#else
+  std::optional<apache::thrift::ServerStreamPublisher<UpdateT>> publisher_;
+#endif
+};
+
+class RouteTableUpdatePublisher
+    : public TableUpdatePublisher<RouteTableUpdate> {
+ public:
+  static apache::thrift::ServerStream<RouteTableUpdate> subscribe(
+      SwSwitch* sw,
+      size_t pageSize);
+
+ private:
+  using TableUpdatePublisher::TableUpdatePublisher;
+
+  NextPageFn pageSnapshot(std::shared_ptr<SwitchState> state) override;
+  void publishDelta(const StateDelta& delta) override;
+};
+
+class NeighborTableUpdatePublisher
+    : public TableUpdatePublisher<NeighborTableUpdate> {
+ public:
+  static apache::thrift::ServerStream<NeighborTableUpdate> subscribe(
+      SwSwitch* sw,
+      size_t pageSize);
+
+ private:
+  using TableUpdatePublisher::TableUpdatePublisher;
+
+  NextPageFn pageSnapshot(std::shared_ptr<SwitchState> state) override;
+  void publishDelta(const StateDelta& delta) override;
+};
+
+} // namespace facebook::fboss
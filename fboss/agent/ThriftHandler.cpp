@@ -23,6 +23,7 @@
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/TableUpdatePublisher.h"
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/capture/PktCapture.h"
@@ -511,6 +512,12 @@ void translateToFibError(
       });
   throw fibError;
 }
+
+void checkPageSize(int32_t pageSize) {
+  if (pageSize <= 0) {
+    throw FbossError("Invalid page size: ", pageSize);
+  }
+}
 } // namespace
 
 namespace facebook::fboss {
@@ -806,6 +813,30 @@ void ThriftHandler::getArpTable(std::vector<ArpEntryThrift>& arpTable) {
       std::make_move_iterator(std::end(entries)));
 }
 
+apache::thrift::ServerStream<std::vector<ArpEntryThrift>>
+ThriftHandler::streamArpTable(int32_t pageSize) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  checkPageSize(pageSize);
+  return streamArpPages(sw_->getState(), pageSize);
+}
+
+apache::thrift::ServerStream<std::vector<NdpEntryThrift>>
+ThriftHandler::streamNdpTable(int32_t pageSize) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  checkPageSize(pageSize);
+  return streamNdpPages(sw_->getState(), pageSize);
+}
+
+apache::thrift::ServerStream<NeighborTableUpdate>
+ThriftHandler::subscribeToNeighborTableUpdates(int32_t pageSize) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  checkPageSize(pageSize);
+  return NeighborTableUpdatePublisher::subscribe(sw_, pageSize);
+}
+
 void ThriftHandler::getL2Table(std::vector<L2EntryThrift>& l2Table) {
   auto log = LOG_THRIFT_CALL(DBG1);
   ensureConfigured(__func__);
@@ -1263,6 +1294,23 @@ void ThriftHandler::getRouteTableDetails(std::vector<RouteDetails>& routes) {
       });
 }
 
+apache::thrift::ServerStream<std::vector<RouteDetails>>
+ThriftHandler::streamRouteTableDetails(int32_t pageSize) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  checkPageSize(pageSize);
+  return streamRoutePages(
+      sw_->isStandaloneRibEnabled(), sw_->getState(), pageSize);
+}
+
+apache::thrift::ServerStream<RouteTableUpdate>
+ThriftHandler::subscribeToRouteTableUpdates(int32_t pageSize) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  ensureConfigured(__func__);
+  checkPageSize(pageSize);
+  return RouteTableUpdatePublisher::subscribe(sw_, pageSize);
+}
+
 void ThriftHandler::getIpRoute(
     UnicastRoute& route,
     std::unique_ptr<Address> addr,
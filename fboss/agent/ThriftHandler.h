@@ -165,6 +165,10 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
       std::vector<UnicastRoute>& routeTable,
       int16_t clientId) override;
   void getRouteTableDetails(std::vector<RouteDetails>& routeTable) override;
+  apache::thrift::ServerStream<std::vector<RouteDetails>>
+  streamRouteTableDetails(int32_t pageSize) override;
+  apache::thrift::ServerStream<RouteTableUpdate> subscribeToRouteTableUpdates(
+      int32_t pageSize) override;
 
   void getPortStatus(
       std::map<int32_t, PortStatus>& status,
@@ -198,6 +202,12 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
   void getAggregatePortTable(
       std::vector<AggregatePortThrift>& aggregatePortsThrift) override;
   void getNdpTable(std::vector<NdpEntryThrift>& arpTable) override;
+  apache::thrift::ServerStream<std::vector<ArpEntryThrift>> streamArpTable(
+      int32_t pageSize) override;
+  apache::thrift::ServerStream<std::vector<NdpEntryThrift>> streamNdpTable(
+      int32_t pageSize) override;
+  apache::thrift::ServerStream<NeighborTableUpdate>
+  subscribeToNeighborTableUpdates(int32_t pageSize) override;
   void getLacpPartnerPair(LacpPartnerPair& lacpPartnerPair, int32_t portID)
       override;
   void getAllLacpPartnerPairs(
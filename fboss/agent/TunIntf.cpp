@@ -32,15 +32,18 @@ extern "C" {
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/packet/EthHdr.h"
 
+DEFINE_int32(
+    tun_intf_rx_burst,
+    16,
+    "Max packets read from a tun queue per wakeup before yielding to other "
+    "events on the queue's thread");
+
 namespace facebook::fboss {
 
 namespace {
 
 const std::string kTunDev = "/dev/net/tun";
 
-// Max packets to be processed which are received from host
-const int kMaxSentOneTime = 16;
-
 // Definition of `iplink_req` as it is not well defined in any header files
 struct iplink_req {
   struct nlmsghdr n;
@@ -64,60 +67,52 @@ struct iplink_req {
 
 TunIntf::TunIntf(
     SwSwitch* sw,
-    folly::EventBase* evb,
+    const std::vector<folly::EventBase*>& evbs,
     InterfaceID ifID,
     int ifIndex,
     int mtu)
-    : folly::EventHandler(evb),
-      sw_(sw),
+    : sw_(sw),
       name_(util::createTunIntfName(ifID)),
       ifID_(ifID),
       ifIndex_(ifIndex),
       mtu_(mtu) {
   DCHECK(sw) << "NULL pointer to SwSwitch.";
-  DCHECK(evb) << "NULL pointer to EventBase";
+  DCHECK(!evbs.empty()) << "No EventBase";
 
-  openFD();
-  SCOPE_FAIL {
-    closeFD();
-  };
+  openQueues(evbs);
 
   // XXX: Disabling mode on existing interface so that we end up removing
   // automatically allocated v6 link local address on next release. from
   // next release onwards we will not need it
   disableIPv6AddrGenMode(ifIndex_);
 
-  XLOG(INFO) << "Added interface " << name_ << " with fd " << fd_ << " @ index "
-             << ifIndex_ << ", "
+  XLOG(INFO) << "Added interface " << name_ << " with " << queues_.size()
+             << " queue(s) @ index " << ifIndex_ << ", "
              << "DOWN";
 }
 
 TunIntf::TunIntf(
     SwSwitch* sw,
-    folly::EventBase* evb,
+    const std::vector<folly::EventBase*>& evbs,
     InterfaceID ifID,
     bool status,
     const Interface::Addresses& addr,
     int mtu)
-    : folly::EventHandler(evb),
-      sw_(sw),
+    : sw_(sw),
       name_(util::createTunIntfName(ifID)),
       ifID_(ifID),
       status_(status),
       addrs_(addr),
       mtu_(mtu) {
   DCHECK(sw) << "NULL pointer to SwSwitch.";
-  DCHECK(evb) << "NULL pointer to EventBase";
+  DCHECK(!evbs.empty()) << "No EventBase";
 
-  // Open Tun interface FD for socket-IO
-  openFD();
-  SCOPE_FAIL {
-    closeFD();
-  };
+  // Open Tun interface FDs for socket-IO
+  openQueues(evbs);
 
   // Make the Tun interface persistent, so that the network sessions from the
   // application (i.e. BGP)  will not be reset if controller restarts
-  auto ret = ioctl(fd_, TUNSETPERSIST, 1);
+  auto ret = ioctl(queues_.front()->getFD(), TUNSETPERSIST, 1);
   sysCheckError(ret, "Failed to set persist interface ", name_);
 
   // TODO: if needed, we can adjust send buffer size, TUNSETSNDBUF
@@ -153,82 +148,126 @@ TunIntf::TunIntf(
   // Disable v6 link-local address assignment on Tun interface
   disableIPv6AddrGenMode(ifIndex_);
 
-  XLOG(INFO) << "Created interface " << name_ << " with fd " << fd_
-             << " @ index " << ifIndex_ << ", " << (status ? "UP" : "DOWN");
+  XLOG(INFO) << "Created interface " << name_ << " with " << queues_.size()
+             << " queue(s) @ index " << ifIndex_ << ", "
+             << (status ? "UP" : "DOWN");
 }
 
 TunIntf::~TunIntf() {
   stop();
 
   // We must have a valid fd to TunIntf
-  CHECK_NE(fd_, -1);
+  CHECK(!queues_.empty());
 
   // Delete interface if need be
   if (toDelete_) {
-    auto ret = ioctl(fd_, TUNSETPERSIST, 0);
+    auto ret = ioctl(queues_.front()->getFD(), TUNSETPERSIST, 0);
     sysLogError(ret, "Failed to unset persist interface ", name_);
   }
 
-  // Close FD. This will delete the interface if TUNSETPERSIST is not on
-  closeFD();
+  // Close FDs. This will delete the interface if TUNSETPERSIST is not on
+  queues_.clear();
   XLOG(INFO) << (toDelete_ ? "Delete" : "Detach") << " interface " << name_;
 }
 
 void TunIntf::stop() {
-  unregisterHandler();
+  // The first queue is served by our own thread. Handlers of the others
+  // must be unregistered from the threads serving them, which also makes
+  // sure none of them is still reading once we return.
+  queues_.front()->stop();
+  for (size_t i = 1; i < queues_.size(); ++i) {
+    auto queue = queues_[i].get();
+    queue->getEventBase()->runInEventBaseThreadAndWait(
+        [queue]() { queue->stop(); });
+  }
 }
 
 void TunIntf::start() {
-  if (fd_ != -1 && !isHandlerRegistered()) {
-    changeHandlerFD(folly::NetworkSocket::fromFd(fd_));
-    registerHandler(folly::EventHandler::READ | folly::EventHandler::PERSIST);
+  queues_.front()->start();
+  for (size_t i = 1; i < queues_.size(); ++i) {
+    auto queue = queues_[i].get();
+    queue->getEventBase()->runInEventBaseThreadAndWait(
+        [queue]() { queue->start(); });
+  }
+}
+
+void TunIntf::openQueues(const std::vector<folly::EventBase*>& evbs) {
+  bool multiQueue = evbs.size() > 1;
+  auto fd = openFD(multiQueue);
+  if (fd == -1) {
+    // Interface was created by a run with a different --tun_intf_queues.
+    // Attach in its mode, single-queue if it is not multi-queue.
+    XLOG(WARNING) << "Interface " << name_ << " is "
+                  << (multiQueue ? "not " : "") << "multi-queue, attaching "
+                  << (multiQueue ? "single" : "multi") << "-queue";
+    multiQueue = !multiQueue;
+    fd = openFD(multiQueue);
+    if (fd == -1) {
+      throw FbossError("Failed to attach interface ", name_);
+    }
   }
+  queues_.push_back(std::make_unique<Queue>(this, evbs.front(), fd));
+  for (size_t i = 1; multiQueue && i < evbs.size(); ++i) {
+    fd = openFD(multiQueue);
+    if (fd == -1) {
+      throw FbossError("Failed to attach queue ", i, " of interface ", name_);
+    }
+    queues_.push_back(std::make_unique<Queue>(this, evbs[i], fd));
+  }
+
+  // Set configured MTU
+  setMtu(mtu_);
 }
 
-void TunIntf::openFD() {
-  fd_ = open(kTunDev.c_str(), O_RDWR);
-  sysCheckError(fd_, "Cannot open ", kTunDev.c_str());
+int TunIntf::openFD(bool multiQueue) {
+  auto fd = open(kTunDev.c_str(), O_RDWR);
+  sysCheckError(fd, "Cannot open ", kTunDev.c_str());
   SCOPE_FAIL {
-    closeFD();
+    closeFD(fd);
   };
 
   struct ifreq ifr;
   memset(&ifr, 0, sizeof(ifr));
   // Flags: IFF_TUN   - TUN device (no Ethernet headers)
   //        IFF_NO_PI - Do not provide packet information
+  //        IFF_MULTI_QUEUE - One queue per fd attached to the device
   ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+  if (multiQueue) {
+    ifr.ifr_flags |= IFF_MULTI_QUEUE;
+  }
   bzero(ifr.ifr_name, sizeof(ifr.ifr_name));
   size_t len = std::min(name_.size(), sizeof(ifr.ifr_name));
   memmove(ifr.ifr_name, name_.c_str(), len);
-  auto ret = ioctl(fd_, TUNSETIFF, (void*)&ifr);
+  auto ret = ioctl(fd, TUNSETIFF, (void*)&ifr);
+  if (ret < 0 && errno == EINVAL) {
+    // The interface exists with the other IFF_MULTI_QUEUE setting
+    closeFD(fd);
+    return -1;
+  }
   sysCheckError(ret, "Failed to create/attach interface ", name_);
 
-  // Set configured MTU
-  setMtu(mtu_);
-
   // make fd non-blocking
-  auto flags = fcntl(fd_, F_GETFL);
-  sysCheckError(flags, "Failed to get flags from fd ", fd_);
+  auto flags = fcntl(fd, F_GETFL);
+  sysCheckError(flags, "Failed to get flags from fd ", fd);
   flags |= O_NONBLOCK;
-  ret = fcntl(fd_, F_SETFL, flags);
-  sysCheckError(
-      ret, "Failed to set non-blocking flags ", flags, " to fd ", fd_);
-  flags = fcntl(fd_, F_GETFD);
-  sysCheckError(flags, "Failed to get flags from fd ", fd_);
+  ret = fcntl(fd, F_SETFL, flags);
+  sysCheckError(ret, "Failed to set non-blocking flags ", flags, " to fd ", fd);
+  flags = fcntl(fd, F_GETFD);
+  sysCheckError(flags, "Failed to get flags from fd ", fd);
   flags |= FD_CLOEXEC;
-  ret = fcntl(fd_, F_SETFD, flags);
+  ret = fcntl(fd, F_SETFD, flags);
   sysCheckError(
-      ret, "Failed to set close-on-exec flags ", flags, " to fd ", fd_);
+      ret, "Failed to set close-on-exec flags ", flags, " to fd ", fd);
 
-  XLOG(INFO) << "Create/attach to tun interface " << name_ << " @ fd " << fd_;
+  XLOG(INFO) << "Create/attach to tun interface " << name_ << " @ fd " << fd;
+  return fd;
 }
 
-void TunIntf::closeFD() noexcept {
-  auto ret = close(fd_);
-  sysLogError(ret, "Failed to close fd ", fd_, " for interface ", name_);
+void TunIntf::closeFD(int fd) noexcept {
+  auto ret = close(fd);
+  sysLogError(ret, "Failed to close fd ", fd, " for interface ", name_);
   if (ret == 0) {
-    XLOG(INFO) << "Closed fd " << fd_ << " for interface " << name_;
-    fd_ = -1;
+    XLOG(INFO) << "Closed fd " << fd << " for interface " << name_;
   }
 }
 
@@ -267,8 +306,8 @@ void TunIntf::setMtu(int mtu) {
       ret,
       "Failed to set MTU ",
       ifr.ifr_mtu,
-      " to fd ",
-      fd_,
+      " to interface ",
+      name_,
       " errno = ",
       errno);
   XLOG(DBG3) << "Set tun " << name_ << " MTU to " << mtu;
@@ -313,19 +352,45 @@ void TunIntf::disableIPv6AddrGenMode(int ifIndex) {
   return;
 }
 
-void TunIntf::handlerReady(uint16_t /*events*/) noexcept {
-  CHECK(fd_ != -1);
+TunIntf::Queue::Queue(TunIntf* intf, folly::EventBase* evb, int fd)
+    : folly::EventHandler(evb), intf_(intf), evb_(evb), fd_(fd) {
+  DCHECK(evb) << "NULL pointer to EventBase";
+}
+
+TunIntf::Queue::~Queue() {
+  // Must have been stopped from the thread serving evb_
+  DCHECK(!isHandlerRegistered());
+  intf_->closeFD(fd_);
+}
+
+void TunIntf::Queue::stop() {
+  unregisterHandler();
+}
+
+void TunIntf::Queue::start() {
+  if (!isHandlerRegistered()) {
+    changeHandlerFD(folly::NetworkSocket::fromFd(fd_));
+    registerHandler(folly::EventHandler::READ | folly::EventHandler::PERSIST);
+  }
+}
+
+std::unique_ptr<TxPacket> TunIntf::Queue::allocatePacket() {
+  if (sparePkt_ && sparePkt_->buf()->tailroom() >= intf_->mtu_) {
+    return std::move(sparePkt_);
+  }
+  // Since this is L3 packet size, allocateL3TxPacket also reserves space
+  // for L2 header, which is 18 bytes (including one vlan tag)
+  return intf_->sw_->allocateL3TxPacket(intf_->mtu_);
+}
 
-  // Since this is L3 packet size, we should also reserve some space for L2
-  // header, which is 18 bytes (including one vlan tag)
+void TunIntf::Queue::handlerReady(uint16_t /*events*/) noexcept {
   int sent = 0;
   int dropped = 0;
   uint64_t bytes = 0;
   bool fdFail = false;
   try {
-    while (sent + dropped < kMaxSentOneTime) {
-      std::unique_ptr<TxPacket> pkt;
-      pkt = sw_->allocateL3TxPacket(mtu_);
+    while (sent + dropped < FLAGS_tun_intf_rx_burst) {
+      auto pkt = allocatePacket();
       auto buf = pkt->buf();
       int ret = 0;
       do {
@@ -337,23 +402,26 @@ void TunIntf::handlerReady(uint16_t /*events*/) noexcept {
           // Cannot continue read on this fd
           fdFail = true;
         }
+        sparePkt_ = std::move(pkt);
         break;
       } else if (ret == 0) {
         // Nothing to read. It shall not happen as the fd is non-blocking.
         // Just add this case to be safe. Adding DCHECK for sanity checking
         // in debug mode.
         DCHECK(false) << "Unexpected event. Nothing to read.";
+        sparePkt_ = std::move(pkt);
         break;
       } else if (ret > buf->tailroom()) {
         // The pkt is larger than the buffer. We don't have complete packet.
         // It shall not happen unless the MTU is mis-match. Drop the packet.
         XLOG(ERR) << "Too large packet (" << ret << " > " << buf->tailroom()
                   << ") received from host. Drop the packet.";
+        sparePkt_ = std::move(pkt);
         ++dropped;
       } else {
         bytes += ret;
         buf->append(ret);
-        sw_->sendL3Packet(std::move(pkt), ifID_);
+        intf_->sw_->sendL3Packet(std::move(pkt), intf_->ifID_);
         ++sent;
       }
     } // while
@@ -367,15 +435,17 @@ void TunIntf::handlerReady(uint16_t /*events*/) noexcept {
   }
 
   XLOG(DBG4) << "Forwarded " << sent << " packets (" << bytes
-             << " bytes) from host @ fd " << fd_ << " for interface " << name_;
+             << " bytes) from host @ fd " << fd_ << " for interface "
+             << intf_->name_;
   if (dropped) {
     XLOG(DBG3) << "Dropped " << dropped << " packets from host @ fd " << fd_
-               << " for interface " << name_;
+               << " for interface " << intf_->name_;
   }
 }
 
 bool TunIntf::sendPacketToHost(std::unique_ptr<RxPacket> pkt) {
-  CHECK(fd_ != -1);
+  // Any queue hands the packet to the host stack the same way
+  auto fd = queues_.front()->getFD();
   const int l2Len = EthHdr::SIZE;
 
   auto buf = pkt->buf();
@@ -389,7 +459,7 @@ bool TunIntf::sendPacketToHost(std::unique_ptr<RxPacket> pkt) {
 
   int ret = 0;
   do {
-    ret = write(fd_, buf->data(), buf->length());
+    ret = write(fd, buf->data(), buf->length());
   } while (ret == -1 && errno == EINTR);
   if (ret < 0) {
     sysLogError(ret, "Failed to send packet to host from Interface ", ifID_);
@@ -15,22 +15,31 @@
 #include "fboss/agent/state/StateUtils.h"
 #include "fboss/agent/types.h"
 
+#include <atomic>
+#include <vector>
+
 namespace facebook::fboss {
 
 class SwSwitch;
 class RxPacket;
+class TxPacket;
 
-class TunIntf : private folly::EventHandler {
+class TunIntf {
  public:
   /**
    * Creates a TunIntf object of already existing linux interface. Initial
    * status is set to `false` for discovered interfaces because we do not
    * have real port-status info. Once initial config is applied in TunManager
    * their actual status will be reflected.
+   *
+   * One queue is opened per event base in `evbs`, each read from on the
+   * thread serving its event base. With more than one the interface is a
+   * multi-queue (IFF_MULTI_QUEUE) tun device. evbs[0] must be served by the
+   * thread managing this object.
    */
   TunIntf(
       SwSwitch* sw,
-      folly::EventBase* evb,
+      const std::vector<folly::EventBase*>& evbs,
       InterfaceID ifID,
       int ifIndex /* linux */,
       int mtu);
@@ -40,13 +49,13 @@ class TunIntf : private folly::EventHandler {
    */
   TunIntf(
       SwSwitch* sw,
-      folly::EventBase* evb,
+      const std::vector<folly::EventBase*>& evbs,
       InterfaceID ifID, // Switch interface ID
       bool status,
       const Interface::Addresses& addrs,
       int mtu);
 
-  ~TunIntf() override;
+  ~TunIntf();
 
   /**
    * Start/Stop packet forwarding on Tun interface.
@@ -119,23 +128,77 @@ class TunIntf : private folly::EventHandler {
     return mtu_;
   }
 
+  size_t getNumQueues() const {
+    return queues_.size();
+  }
+
   bool getStatus() const {
     return status_;
   }
 
  private:
+  // Forbidden copy constructor and assignment operator
+  TunIntf(TunIntf const&) = delete;
+  TunIntf& operator=(TunIntf const&) = delete;
+
+  /**
+   * One queue of the Tun interface, with its own socket-fd, read from on
+   * the thread serving its event base.
+   */
+  class Queue : private folly::EventHandler {
+   public:
+    Queue(TunIntf* intf, folly::EventBase* evb, int fd);
+    ~Queue() override;
+
+    void start();
+    void stop();
+
+    folly::EventBase* getEventBase() const {
+      return evb_;
+    }
+
+    int getFD() const {
+      return fd_;
+    }
+
+   private:
+    /**
+     * Callback for event on the queue's read socket-fd
+     * Override's folly::EventHandler handlerReady callback.
+     */
+    void handlerReady(uint16_t events) noexcept override;
+
+    /**
+     * Returns the packet left over from the last read, if still big enough
+     * for the MTU, else a newly allocated one.
+     */
+    std::unique_ptr<TxPacket> allocatePacket();
+
+    TunIntf* const intf_;
+    folly::EventBase* const evb_;
+    const int fd_;
+
+    /**
+     * Packet allocated for a read which found nothing to read (or a packet
+     * we dropped). Kept for the next read, so that each wakeup does not end
+     * with allocating and freeing a packet.
+     */
+    std::unique_ptr<TxPacket> sparePkt_;
+  };
+
   /**
-   * Callback for event on Tun interface's read socket-fd
-   * Override's folly::EventHandler handlerReady callback.
+   * Open one queue per event base. Falls back to single-queue if an existing
+   * interface was created in the other mode.
    */
-  void handlerReady(uint16_t events) noexcept override;
+  void openQueues(const std::vector<folly::EventBase*>& evbs);
 
   /**
-   * Open/Close a new socket-fd to read/write data from Tun interface.
-   * fd_ is mutated.
+   * Open/Close a socket-fd to read/write data from Tun interface. Returns -1
+   * if the interface exists but was created with a different multi-queue
+   * mode.
    */
-  void openFD();
-  void closeFD() noexcept;
+  int openFD(bool multiQueue);
+  void closeFD(int fd) noexcept;
 
   /**
    * In newer kernel an interface is automatically gets link-local IPv6 address
@@ -158,11 +221,12 @@ class TunIntf : private folly::EventHandler {
   Interface::Addresses addrs_; // The IP addresses assigned to this intf
 
   /**
-   * File descriptor for this interface through which packets can
-   * be received from or sent to.
+   * Queues of this interface through which packets can be received from or
+   * sent to. Packets to host are always written to the first queue.
    */
-  int fd_{-1};
-  int mtu_{-1};
+  std::vector<std::unique_ptr<Queue>> queues_;
+  // Read from the queue threads
+  std::atomic<int> mtu_{-1};
 };
 
 } // namespace facebook::fboss
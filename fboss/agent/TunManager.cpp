@@ -18,6 +18,7 @@ extern "C" {
 #include <sys/ioctl.h>
 }
 
+#include <folly/Conv.h>
 #include <folly/MapUtil.h>
 #include <folly/io/async/EventBase.h>
 #include <folly/lang/CString.h>
@@ -33,6 +34,12 @@ extern "C" {
 
 #include <boost/container/flat_set.hpp>
 
+DEFINE_int32(
+    tun_intf_queues,
+    1,
+    "Number of queues of each tun interface, each read from on a thread of "
+    "its own. With more than 1 the interfaces are multi-queue tun devices");
+
 namespace {
 const int kDefaultMtu = 1500;
 }
@@ -46,6 +53,15 @@ TunManager::TunManager(SwSwitch* sw, EventBase* evb) : sw_(sw), evb_(evb) {
   DCHECK(sw) << "NULL pointer to SwSwitch.";
   DCHECK(evb) << "NULL pointer to EventBase";
 
+  // The first queue of every interface is read from evb_, the others each
+  // from a thread of their own
+  queueEvbs_.push_back(evb_);
+  for (auto i = 1; i < FLAGS_tun_intf_queues; ++i) {
+    queueThreads_.push_back(std::make_unique<folly::ScopedEventBaseThread>(
+        folly::to<std::string>("TunQueue", i)));
+    queueEvbs_.push_back(queueThreads_.back()->getEventBase());
+  }
+
   sock_ = nl_socket_alloc();
   if (!sock_) {
     throw FbossError("failed to allocate libnl socket");
@@ -109,7 +125,7 @@ void TunManager::addExistingIntf(const std::string& ifName, int ifIndex) {
     intfs_.erase(ret.first);
   };
   ret.first->second.reset(
-      new TunIntf(sw_, evb_, ifID, ifIndex, getInterfaceMtu(ifID)));
+      new TunIntf(sw_, queueEvbs_, ifID, ifIndex, getInterfaceMtu(ifID)));
 }
 
 void TunManager::addNewIntf(
@@ -125,7 +141,7 @@ void TunManager::addNewIntf(
     intfs_.erase(ret.first);
   };
   auto intf = std::make_unique<TunIntf>(
-      sw_, evb_, ifID, isUp, addrs, getInterfaceMtu(ifID));
+      sw_, queueEvbs_, ifID, isUp, addrs, getInterfaceMtu(ifID));
 
   SCOPE_FAIL {
     intf->setDelete();
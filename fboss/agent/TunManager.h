@@ -10,6 +10,7 @@
 #pragma once
 
 #include <folly/io/async/EventBase.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
 #include "fboss/agent/StateObserver.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/types.h"
@@ -218,6 +219,14 @@ class TunManager : public StateObserver {
   SwSwitch* sw_{nullptr};
   folly::EventBase* evb_{nullptr};
 
+  /**
+   * Threads reading the queues of multi-queue tun interfaces other than the
+   * first, and the event bases each queue is read from, evb_ first. Must
+   * outlive intfs_.
+   */
+  std::vector<std::unique_ptr<folly::ScopedEventBaseThread>> queueThreads_;
+  std::vector<folly::EventBase*> queueEvbs_;
+
   // Netlink socket for managing interface/addresses in Host/Linux
   nl_sock* sock_{nullptr};
 
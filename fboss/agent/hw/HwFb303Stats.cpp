@@ -17,15 +17,19 @@
 namespace facebook::fboss {
 
 HwFb303Stats::~HwFb303Stats() {
-  for (const auto& statNameAndStat : counters_) {
-    utility::deleteCounter(statNameAndStat.second.getName());
+  for (const auto& counter : counters_) {
+    if (counter) {
+      utility::deleteCounter(counter->counter.getName());
+    }
   }
 }
 
 const stats::MonotonicCounter* HwFb303Stats::getCounterIf(
     const std::string& statName) const {
-  auto pcitr = counters_.find(statName);
-  return pcitr != counters_.end() ? &pcitr->second : nullptr;
+  auto pcitr = statName2Handle_.find(statName);
+  return pcitr != statName2Handle_.end()
+      ? &counters_[pcitr->second]->counter
+      : nullptr;
 }
 
 stats::MonotonicCounter* HwFb303Stats::getCounterIf(
@@ -42,29 +46,46 @@ int64_t HwFb303Stats::getCounterLastIncrement(
 /*
  * Reinit port or port queue stat
  */
-void HwFb303Stats::reinitStat(
+HwFb303Stats::StatHandle HwFb303Stats::reinitStat(
     const std::string& statName,
     std::optional<std::string> oldStatName) {
   if (oldStatName) {
+    auto handle = statName2Handle_.at(*oldStatName);
     if (oldStatName == statName) {
-      return;
+      return handle;
     }
-    auto stat = getCounterIf(*oldStatName);
+    auto& stat = *counters_[handle];
     stats::MonotonicCounter newStat{statName, fb303::SUM, fb303::RATE};
-    stat->swap(newStat);
+    stat.counter.swap(newStat);
+    stat.name = statName;
     utility::deleteCounter(newStat.getName());
-    counters_.insert(std::make_pair(statName, std::move(*stat)));
-    counters_.erase(*oldStatName);
+    statName2Handle_.erase(*oldStatName);
+    statName2Handle_.emplace(statName, handle);
+    return handle;
+  }
+  StatHandle handle;
+  if (freeHandles_.empty()) {
+    handle = counters_.size();
+    counters_.emplace_back();
   } else {
-    counters_.emplace(
-        statName, stats::MonotonicCounter(statName, fb303::SUM, fb303::RATE));
+    handle = freeHandles_.back();
+    freeHandles_.pop_back();
   }
+  counters_[handle].emplace(statName);
+  statName2Handle_.emplace(statName, handle);
+  return handle;
 }
 
 void HwFb303Stats::removeStat(const std::string& statName) {
-  auto stat = getCounterIf(statName);
-  utility::deleteCounter(stat->getName());
-  counters_.erase(stat->getName());
+  removeStat(statName2Handle_.at(statName));
+}
+
+void HwFb303Stats::removeStat(StatHandle handle) {
+  auto& stat = counters_[handle];
+  utility::deleteCounter(stat->counter.getName());
+  statName2Handle_.erase(stat->name);
+  stat.reset();
+  freeHandles_.push_back(handle);
 }
 
 void HwFb303Stats::updateStat(
@@ -76,4 +97,14 @@ void HwFb303Stats::updateStat(
   stat->updateValue(now, val);
 }
 
+void HwFb303Stats::updateStats(
+    const std::chrono::seconds& now,
+    folly::Range<const StatHandle*> handles,
+    folly::Range<const int64_t*> values) {
+  CHECK_EQ(handles.size(), values.size());
+  for (size_t i = 0; i < handles.size(); ++i) {
+    counters_[handles[i]]->counter.updateValue(now, values[i]);
+  }
+}
+
 } // namespace facebook::fboss
@@ -12,14 +12,25 @@
 
 #include "common/stats/MonotonicCounter.h"
 
+#include "folly/Range.h"
 #include "folly/container/F14Map.h"
 
 #include <optional>
 #include <string>
+#include <vector>
 namespace facebook::fboss {
 
+/*
+ * Counters live in a flat array, and are addressed by the handle returned
+ * when (re)initializing them. Updating through handles does not hash or
+ * build any stat names, which matters as every port and queue counter is
+ * updated on every stats collection. Handles stay valid until the stat is
+ * removed, a rename keeps the handle of the stat.
+ */
 class HwFb303Stats {
  public:
+  using StatHandle = uint32_t;
+
   ~HwFb303Stats();
 
   int64_t getCounterLastIncrement(const std::string& statName) const;
@@ -27,14 +38,28 @@ class HwFb303Stats {
   /*
    * Reinit stat
    */
-  void reinitStat(
+  StatHandle reinitStat(
       const std::string& statName,
       std::optional<std::string> oldStatName);
   void updateStat(
       const std::chrono::seconds& now,
       const std::string& statName,
       int64_t val);
+  void updateStat(
+      const std::chrono::seconds& now,
+      StatHandle handle,
+      int64_t val) {
+    counters_[handle]->counter.updateValue(now, val);
+  }
+  /*
+   * Update the stat of each handle with the value at the same position
+   */
+  void updateStats(
+      const std::chrono::seconds& now,
+      folly::Range<const StatHandle*> handles,
+      folly::Range<const int64_t*> values);
   void removeStat(const std::string& statName);
+  void removeStat(StatHandle handle);
 
  private:
   /*
@@ -44,6 +69,15 @@ class HwFb303Stats {
   const stats::MonotonicCounter* getCounterIf(
       const std::string& statName) const;
 
-  folly::F14FastMap<std::string, stats::MonotonicCounter> counters_;
+  struct Stat {
+    explicit Stat(const std::string& statName)
+        : name(statName), counter(statName, fb303::SUM, fb303::RATE) {}
+    std::string name;
+    stats::MonotonicCounter counter;
+  };
+  std::vector<std::optional<Stat>> counters_;
+  // Slots of removed stats, reused by the next new stats
+  std::vector<StatHandle> freeHandles_;
+  folly::F14FastMap<std::string, StatHandle> statName2Handle_;
 };
 } // namespace facebook::fboss
@@ -16,7 +16,8 @@
 
 namespace facebook::fboss {
 
-std::array<folly::StringPiece, 23> HwPortFb303Stats::kPortStatKeys() {
+std::array<folly::StringPiece, HwPortFb303Stats::kNumPortStatKeys>
+HwPortFb303Stats::kPortStatKeys() {
   return {
       kInBytes(),
       kInUnicastPkts(),
@@ -44,7 +45,8 @@ std::array<folly::StringPiece, 23> HwPortFb303Stats::kPortStatKeys() {
   };
 }
 
-std::array<folly::StringPiece, 4> HwPortFb303Stats::kQueueStatKeys() {
+std::array<folly::StringPiece, HwPortFb303Stats::kNumQueueStatKeys>
+HwPortFb303Stats::kQueueStatKeys() {
   return {
       kOutCongestionDiscardsBytes(),
       kOutCongestionDiscards(),
@@ -75,21 +77,27 @@ int64_t HwPortFb303Stats::getCounterLastIncrement(
 void HwPortFb303Stats::reinitStats(std::optional<std::string> oldPortName) {
   XLOG(DBG2) << "Reinitializing stats for " << portName_;
 
-  for (auto statKey : kPortStatKeys()) {
-    reinitStat(statKey, portName_, oldPortName);
+  auto portStatKeys = kPortStatKeys();
+  for (size_t i = 0; i < kNumPortStatKeys; ++i) {
+    portStatHandles_[i] = reinitStat(portStatKeys[i], portName_, oldPortName);
   }
+  auto queueStatKeys = kQueueStatKeys();
   for (auto queueIdAndName : queueId2Name_) {
-    for (auto statKey : kQueueStatKeys()) {
+    auto& handles = queueStatHandles_[queueIdAndName.first];
+    for (size_t i = 0; i < kNumQueueStatKeys; ++i) {
       auto newStatName = statName(
-          statKey, portName_, queueIdAndName.first, queueIdAndName.second);
+          queueStatKeys[i],
+          portName_,
+          queueIdAndName.first,
+          queueIdAndName.second);
       std::optional<std::string> oldStatName = oldPortName
           ? std::optional<std::string>(statName(
-                statKey,
+                queueStatKeys[i],
                 *oldPortName,
                 queueIdAndName.first,
                 queueIdAndName.second))
           : std::nullopt;
-      portCounters_.reinitStat(newStatName, oldStatName);
+      handles[i] = portCounters_.reinitStat(newStatName, oldStatName);
     }
   }
 }
@@ -97,11 +105,11 @@ void HwPortFb303Stats::reinitStats(std::optional<std::string> oldPortName) {
 /*
  * Reinit port stat
  */
-void HwPortFb303Stats::reinitStat(
+HwFb303Stats::StatHandle HwPortFb303Stats::reinitStat(
     folly::StringPiece statKey,
     const std::string& portName,
     std::optional<std::string> oldPortName) {
-  portCounters_.reinitStat(
+  return portCounters_.reinitStat(
       statName(statKey, portName),
       oldPortName ? std::optional<std::string>(statName(statKey, *oldPortName))
                   : std::nullopt);
@@ -110,11 +118,11 @@ void HwPortFb303Stats::reinitStat(
 /*
  * Reinit port queue stat
  */
-void HwPortFb303Stats::reinitStat(
+HwFb303Stats::StatHandle HwPortFb303Stats::reinitStat(
     folly::StringPiece statKey,
     int queueId,
     std::optional<std::string> oldQueueName) {
-  portCounters_.reinitStat(
+  return portCounters_.reinitStat(
       statName(statKey, portName_, queueId, queueId2Name_[queueId]),
       oldQueueName ? std::optional<std::string>(
                          statName(statKey, portName_, queueId, *oldQueueName))
@@ -127,16 +135,20 @@ void HwPortFb303Stats::queueChanged(int queueId, const std::string& queueName) {
       ? std::nullopt
       : std::optional<std::string>(qitr->second);
   queueId2Name_[queueId] = queueName;
-  for (auto statKey : kQueueStatKeys()) {
-    reinitStat(statKey, queueId, oldQueueName);
+  auto queueStatKeys = kQueueStatKeys();
+  auto& handles = queueStatHandles_[queueId];
+  for (size_t i = 0; i < kNumQueueStatKeys; ++i) {
+    handles[i] = reinitStat(queueStatKeys[i], queueId, oldQueueName);
   }
 }
 
 void HwPortFb303Stats::queueRemoved(int queueId) {
-  auto qitr = queueId2Name_.find(queueId);
-  for (auto statKey : kQueueStatKeys()) {
-    portCounters_.removeStat(
-        statName(statKey, portName_, queueId, queueId2Name_[queueId]));
+  auto qitr = queueStatHandles_.find(queueId);
+  if (qitr != queueStatHandles_.end()) {
+    for (auto handle : qitr->second) {
+      portCounters_.removeStat(handle);
+    }
+    queueStatHandles_.erase(qitr);
   }
   queueId2Name_.erase(queueId);
 }
@@ -145,104 +157,72 @@ void HwPortFb303Stats::updateStats(
     const HwPortStats& curPortStats,
     const std::chrono::seconds& retrievedAt) {
   timeRetrieved_ = retrievedAt;
-  updateStat(timeRetrieved_, kInBytes(), *curPortStats.inBytes__ref());
-  updateStat(
-      timeRetrieved_, kInUnicastPkts(), *curPortStats.inUnicastPkts__ref());
-  updateStat(
-      timeRetrieved_, kInMulticastPkts(), *curPortStats.inMulticastPkts__ref());
-  updateStat(
-      timeRetrieved_, kInBroadcastPkts(), *curPortStats.inBroadcastPkts__ref());
-  updateStat(
-      timeRetrieved_, kInDiscardsRaw(), *curPortStats.inDiscardsRaw__ref());
-  updateStat(timeRetrieved_, kInDiscards(), *curPortStats.inDiscards__ref());
-  updateStat(timeRetrieved_, kInErrors(), *curPortStats.inErrors__ref());
-  updateStat(timeRetrieved_, kInPause(), *curPortStats.inPause__ref());
-  updateStat(
-      timeRetrieved_, kInIpv4HdrErrors(), *curPortStats.inIpv4HdrErrors__ref());
-  updateStat(
-      timeRetrieved_, kInIpv6HdrErrors(), *curPortStats.inIpv6HdrErrors__ref());
-  updateStat(
-      timeRetrieved_,
-      kInDstNullDiscards(),
-      *curPortStats.inDstNullDiscards__ref());
-  // Egress Stats
-  updateStat(timeRetrieved_, kOutBytes(), *curPortStats.outBytes__ref());
-  updateStat(
-      timeRetrieved_, kOutUnicastPkts(), *curPortStats.outUnicastPkts__ref());
-  updateStat(
-      timeRetrieved_,
-      kOutMulticastPkts(),
-      *curPortStats.outMulticastPkts__ref());
-  updateStat(
-      timeRetrieved_,
-      kOutBroadcastPkts(),
-      *curPortStats.outBroadcastPkts__ref());
-  updateStat(timeRetrieved_, kOutDiscards(), *curPortStats.outDiscards__ref());
-  updateStat(timeRetrieved_, kOutErrors(), *curPortStats.outErrors__ref());
-  updateStat(timeRetrieved_, kOutPause(), *curPortStats.outPause__ref());
-  updateStat(
-      timeRetrieved_,
-      kOutCongestionDiscards(),
-      *curPortStats.outCongestionDiscardPkts__ref());
-  updateStat(
-      timeRetrieved_,
-      kWredDroppedPackets(),
-      *curPortStats.wredDroppedPackets__ref());
-  updateStat(
-      timeRetrieved_, kOutEcnCounter(), *curPortStats.outEcnCounter__ref());
-  updateStat(
-      timeRetrieved_,
-      kFecCorrectable(),
-      *curPortStats.fecCorrectableErrors_ref());
-  updateStat(
+  // In the order of kPortStatKeys()
+  const std::array<int64_t, kNumPortStatKeys> portStatValues = {
+      *curPortStats.inBytes__ref(),
+      *curPortStats.inUnicastPkts__ref(),
+      *curPortStats.inMulticastPkts__ref(),
+      *curPortStats.inBroadcastPkts__ref(),
+      *curPortStats.inDiscards__ref(),
+      *curPortStats.inErrors__ref(),
+      *curPortStats.inPause__ref(),
+      *curPortStats.inIpv4HdrErrors__ref(),
+      *curPortStats.inIpv6HdrErrors__ref(),
+      *curPortStats.inDstNullDiscards__ref(),
+      *curPortStats.inDiscardsRaw__ref(),
+      // Egress Stats
+      *curPortStats.outBytes__ref(),
+      *curPortStats.outUnicastPkts__ref(),
+      *curPortStats.outMulticastPkts__ref(),
+      *curPortStats.outBroadcastPkts__ref(),
+      *curPortStats.outDiscards__ref(),
+      *curPortStats.outErrors__ref(),
+      *curPortStats.outPause__ref(),
+      *curPortStats.outCongestionDiscardPkts__ref(),
+      *curPortStats.wredDroppedPackets__ref(),
+      *curPortStats.outEcnCounter__ref(),
+      *curPortStats.fecCorrectableErrors_ref(),
+      *curPortStats.fecUncorrectableErrors_ref(),
+  };
+  portCounters_.updateStats(
       timeRetrieved_,
-      kFecUncorrectable(),
-      *curPortStats.fecUncorrectableErrors_ref());
+      folly::range(portStatHandles_),
+      folly::range(portStatValues));
 
   // Update queue stats
-  auto updateQueueStat = [this](
-                             folly::StringPiece statKey,
-                             int queueId,
-                             const std::map<int16_t, int64_t>& queueStats) {
+  auto queueStat = [this](
+                       int queueId,
+                       const std::map<int16_t, int64_t>& queueStats,
+                       folly::StringPiece statKey) {
     auto qitr = queueStats.find(queueId);
     CHECK(qitr != queueStats.end())
         << "Missing stat: " << statKey
         << " for queue: :" << queueId2Name_[queueId];
-    updateStat(timeRetrieved_, statKey, queueId, qitr->second);
+    return qitr->second;
   };
-  for (const auto& queueIdAndName : queueId2Name_) {
-    updateQueueStat(
-        kOutCongestionDiscardsBytes(),
-        queueIdAndName.first,
-        *curPortStats.queueOutDiscardBytes__ref());
-    updateQueueStat(
-        kOutCongestionDiscards(),
-        queueIdAndName.first,
-        *curPortStats.queueOutDiscardPackets__ref());
-    updateQueueStat(
-        kOutBytes(), queueIdAndName.first, *curPortStats.queueOutBytes__ref());
-    updateQueueStat(
-        kOutPkts(), queueIdAndName.first, *curPortStats.queueOutPackets__ref());
+  for (const auto& queueIdAndHandles : queueStatHandles_) {
+    auto queueId = queueIdAndHandles.first;
+    // In the order of kQueueStatKeys()
+    const std::array<int64_t, kNumQueueStatKeys> queueStatValues = {
+        queueStat(
+            queueId,
+            *curPortStats.queueOutDiscardBytes__ref(),
+            kOutCongestionDiscardsBytes()),
+        queueStat(
+            queueId,
+            *curPortStats.queueOutDiscardPackets__ref(),
+            kOutCongestionDiscards()),
+        queueStat(queueId, *curPortStats.queueOutBytes__ref(), kOutBytes()),
+        queueStat(queueId, *curPortStats.queueOutPackets__ref(), kOutPkts()),
+    };
+    portCounters_.updateStats(
+        timeRetrieved_,
+        folly::range(queueIdAndHandles.second),
+        folly::range(queueStatValues));
   }
   if (curPortStats.queueWatermarkBytes__ref()->size()) {
     updateQueueWatermarkStats(*curPortStats.queueWatermarkBytes__ref());
   }
   portStats_ = curPortStats;
 }
-
-void HwPortFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    folly::StringPiece statKey,
-    int queueId,
-    int64_t val) {
-  portCounters_.updateStat(
-      now, statName(statKey, portName_, queueId, queueId2Name_[queueId]), val);
-}
-
-void HwPortFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    folly::StringPiece statKey,
-    int64_t val) {
-  portCounters_.updateStat(now, statName(statKey, portName_), val);
-}
 } // namespace facebook::fboss
@@ -15,6 +15,7 @@
 
 #include "folly/container/F14Map.h"
 
+#include <array>
 #include <optional>
 #include <string>
 
@@ -70,8 +71,10 @@ class HwPortFb303Stats {
       int queueId,
       folly::StringPiece queueName);
 
-  static std::array<folly::StringPiece, 23> kPortStatKeys();
-  static std::array<folly::StringPiece, 4> kQueueStatKeys();
+  static constexpr size_t kNumPortStatKeys = 23;
+  static constexpr size_t kNumQueueStatKeys = 4;
+  static std::array<folly::StringPiece, kNumPortStatKeys> kPortStatKeys();
+  static std::array<folly::StringPiece, kNumQueueStatKeys> kQueueStatKeys();
   int64_t getCounterLastIncrement(folly::StringPiece statKey) const;
 
  private:
@@ -79,46 +82,32 @@ class HwPortFb303Stats {
   /*
    * Reinit port stat
    */
-  void reinitStat(
+  HwFb303Stats::StatHandle reinitStat(
       folly::StringPiece statKey,
       const std::string& portName,
       std::optional<std::string> oldPortName);
   /*
    * Reinit port queue stat
    */
-  void reinitStat(
+  HwFb303Stats::StatHandle reinitStat(
       folly::StringPiece statKey,
       int queueId,
       std::optional<std::string> oldQueueName);
 
-  /*
-   * Reinit port or port queue stat
-   */
-  void reinitStat(
-      const std::string& statName,
-      std::optional<std::string> oldStatName);
-  /*
-   * update port stat
-   */
-  void updateStat(
-      const std::chrono::seconds& now,
-      folly::StringPiece statKey,
-      int64_t val);
-  /*
-   * update port queue stat
-   */
-  void updateStat(
-      const std::chrono::seconds& now,
-      folly::StringPiece statKey,
-      int queueId,
-      int64_t val);
-
   void updateQueueWatermarkStats(
       const std::map<int16_t, int64_t>& queueWatermarkBytes) const;
   std::chrono::seconds timeRetrieved_{0};
   std::string portName_;
   HwFb303Stats portCounters_;
   QueueId2Name queueId2Name_;
+  /*
+   * Handles of the port and port queue stats, in the order of
+   * kPortStatKeys() and kQueueStatKeys(), resolved on (re)init
+   */
+  using QueueStatHandles =
+      std::array<HwFb303Stats::StatHandle, kNumQueueStatKeys>;
+  std::array<HwFb303Stats::StatHandle, kNumPortStatKeys> portStatHandles_;
+  folly::F14FastMap<int, QueueStatHandles> queueStatHandles_;
   HwPortStats portStats_;
 };
 
@@ -56,6 +56,18 @@ HwSwitchStats::HwSwitchStats(
           100,
           0,
           1000),
+      sflowSamplesPerDatagram_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".sflow.samples_per_datagram",
+          1,
+          0,
+          64),
+      sflowFlushLatency_(
+          map,
+          SwitchStats::kCounterPrefix + vendor + ".sflow.flush_latency_us",
+          1000,
+          0,
+          100000),
       parityErrors_(
           map,
           SwitchStats::kCounterPrefix + vendor + ".parity.errors",
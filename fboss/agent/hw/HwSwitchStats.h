@@ -43,6 +43,13 @@ class HwSwitchStats {
     txPktAllocErrors_.addValue(1);
   }
 
+  void sflowDatagramSent(uint64_t samples) {
+    sflowSamplesPerDatagram_.addValue(samples);
+  }
+  void sflowSamplesFlushed(uint64_t latencyUs) {
+    sflowFlushLatency_.addValue(latencyUs);
+  }
+
   void corrParityError() {
     parityErrors_.addValue(1);
     corrParityErrors_.addValue(1);
@@ -107,6 +114,11 @@ class HwSwitchStats {
   // Time spent for each Tx packet queued in HW
   TLHistogram txQueued_;
 
+  // sFlow samples sent in each datagram, and time the oldest of them spent
+  // waiting to be sent
+  TLHistogram sflowSamplesPerDatagram_;
+  TLHistogram sflowFlushLatency_;
+
   // parity errors
   TLTimeseries parityErrors_;
   TLTimeseries corrParityErrors_;
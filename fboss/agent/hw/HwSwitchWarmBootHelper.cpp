@@ -13,18 +13,35 @@
 #include "fboss/agent/AsyncLogger.h"
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/Utils.h"
+#include "fboss/agent/gen-cpp2/switch_state_types.h"
 
 #include "fboss/lib/CommonFileUtils.h"
 
 #include <folly/FileUtil.h>
 #include <folly/json.h>
 #include <folly/logging/xlog.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <sys/stat.h>
+
+#include <optional>
+#include <tuple>
 
 DEFINE_bool(can_warm_boot, true, "Enable/disable warm boot functionality");
 DEFINE_string(
     switch_state_file,
     "switch_state",
     "File for dumping switch state JSON in on exit");
+DEFINE_string(
+    thrift_switch_state_file,
+    "thrift_switch_state",
+    "File for dumping switch state in on exit, with --thrift_warm_boot_state");
+DEFINE_bool(
+    thrift_warm_boot_state,
+    false,
+    "Store the warm boot switch state as compact thrift rather than JSON, "
+    "which is much faster to write and read back for large states. Either "
+    "form is read on warm boot.");
 
 namespace {
 constexpr auto wbFlagPrefix = "can_warm_boot_";
@@ -32,6 +49,89 @@ constexpr auto forceColdBootPrefix = "cold_boot_once_";
 constexpr auto shutdownDumpPrefix = "sdk_shutdown_dump_";
 constexpr auto startupDumpPrefix = "sdk_startup_dump_";
 
+using facebook::fboss::state::WarmbootValue;
+
+// When the file was last written, if it exists
+std::optional<timespec> fileModifiedTime(const std::string& path) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    return std::nullopt;
+  }
+  return st.st_mtim;
+}
+
+bool isOlder(const timespec& lhs, const timespec& rhs) {
+  return std::tie(lhs.tv_sec, lhs.tv_nsec) < std::tie(rhs.tv_sec, rhs.tv_nsec);
+}
+
+WarmbootValue toWarmbootValue(const folly::dynamic& dyn) {
+  WarmbootValue value;
+  switch (dyn.type()) {
+    case folly::dynamic::NULLT:
+      break;
+    case folly::dynamic::BOOL:
+      value.set_boolValue(dyn.asBool());
+      break;
+    case folly::dynamic::INT64:
+      value.set_intValue(dyn.asInt());
+      break;
+    case folly::dynamic::DOUBLE:
+      value.set_doubleValue(dyn.asDouble());
+      break;
+    case folly::dynamic::STRING:
+      value.set_stringValue(dyn.getString());
+      break;
+    case folly::dynamic::ARRAY: {
+      std::vector<WarmbootValue> list;
+      list.reserve(dyn.size());
+      for (const auto& elem : dyn) {
+        list.push_back(toWarmbootValue(elem));
+      }
+      value.set_listValue(std::move(list));
+      break;
+    }
+    case folly::dynamic::OBJECT: {
+      std::map<std::string, WarmbootValue> object;
+      for (const auto& item : dyn.items()) {
+        // Like JSON, only string keys are supported
+        object.emplace(item.first.getString(), toWarmbootValue(item.second));
+      }
+      value.set_objectValue(std::move(object));
+      break;
+    }
+  }
+  return value;
+}
+
+folly::dynamic fromWarmbootValue(WarmbootValue&& value) {
+  switch (value.getType()) {
+    case WarmbootValue::Type::__EMPTY__:
+      return nullptr;
+    case WarmbootValue::Type::boolValue:
+      return value.get_boolValue();
+    case WarmbootValue::Type::intValue:
+      return value.get_intValue();
+    case WarmbootValue::Type::doubleValue:
+      return value.get_doubleValue();
+    case WarmbootValue::Type::stringValue:
+      return std::move(value.mutable_stringValue());
+    case WarmbootValue::Type::listValue: {
+      folly::dynamic list = folly::dynamic::array;
+      for (auto& elem : value.mutable_listValue()) {
+        list.push_back(fromWarmbootValue(std::move(elem)));
+      }
+      return list;
+    }
+    case WarmbootValue::Type::objectValue: {
+      folly::dynamic object = folly::dynamic::object;
+      for (auto& item : value.mutable_objectValue()) {
+        object.insert(item.first, fromWarmbootValue(std::move(item.second)));
+      }
+      return object;
+    }
+  }
+  return nullptr;
+}
 } // namespace
 
 namespace facebook::fboss {
@@ -77,6 +177,11 @@ std::string HwSwitchWarmBootHelper::warmBootSwitchStateFile() const {
   return folly::to<std::string>(warmBootDir_, "/", FLAGS_switch_state_file);
 }
 
+std::string HwSwitchWarmBootHelper::warmBootThriftSwitchStateFile() const {
+  return folly::to<std::string>(
+      warmBootDir_, "/", FLAGS_thrift_switch_state_file);
+}
+
 std::string HwSwitchWarmBootHelper::warmBootFlag() const {
   return folly::to<std::string>(warmBootDir_, "/", wbFlagPrefix, switchId_);
 }
@@ -122,17 +227,39 @@ bool HwSwitchWarmBootHelper::checkAndClearWarmBootFlags() {
 
 bool HwSwitchWarmBootHelper::storeWarmBootState(
     const folly::dynamic& switchState) {
-  warmBootStateWritten_ =
-      dumpStateToFile(warmBootSwitchStateFile(), switchState);
+  // Remove the state in the other form, so that it can't be read back
+  // instead of the one stored now.
+  if (FLAGS_thrift_warm_boot_state) {
+    removeFile(warmBootSwitchStateFile());
+    warmBootStateWritten_ = folly::writeFile(
+        serializeWarmBootStateThrift(switchState),
+        warmBootThriftSwitchStateFile().c_str());
+  } else {
+    removeFile(warmBootThriftSwitchStateFile());
+    warmBootStateWritten_ =
+        dumpStateToFile(warmBootSwitchStateFile(), switchState);
+  }
   return warmBootStateWritten_;
 }
 
 folly::dynamic HwSwitchWarmBootHelper::getWarmBootState() const {
-  std::string warmBootJson;
-  auto ret = folly::readFile(warmBootSwitchStateFile().c_str(), warmBootJson);
-  sysCheckError(
-      ret, "Unable to read switch state from : ", warmBootSwitchStateFile());
-  return folly::parseJson(warmBootJson);
+  std::string warmBootState;
+  auto thriftFile = warmBootThriftSwitchStateFile();
+  auto jsonFile = warmBootSwitchStateFile();
+  // Agents that predate the thrift state write only the JSON state, leaving
+  // any thrift state in place. So after a rollback, the thrift state is stale
+  // and only read if it is newer than the JSON state.
+  auto thriftTime = fileModifiedTime(thriftFile);
+  auto jsonTime = fileModifiedTime(jsonFile);
+  if (thriftTime && !(jsonTime && isOlder(*thriftTime, *jsonTime))) {
+    auto ret = folly::readFile(thriftFile.c_str(), warmBootState);
+    sysCheckError(ret, "Unable to read switch state from : ", thriftFile);
+    XLOG(DBG1) << "Reading thrift warm boot state from " << thriftFile;
+    return deserializeWarmBootStateThrift(warmBootState);
+  }
+  auto ret = folly::readFile(jsonFile.c_str(), warmBootState);
+  sysCheckError(ret, "Unable to read switch state from : ", jsonFile);
+  return folly::parseJson(warmBootState);
 }
 
 void HwSwitchWarmBootHelper::setupWarmBootFile() {
@@ -142,4 +269,15 @@ void HwSwitchWarmBootHelper::setupWarmBootFile() {
     throw SysError(errno, "failed to open warm boot data file ", warmBootPath);
   }
 }
+
+std::string serializeWarmBootStateThrift(const folly::dynamic& switchState) {
+  return apache::thrift::CompactSerializer::serialize<std::string>(
+      toWarmbootValue(switchState));
+}
+
+folly::dynamic deserializeWarmBootStateThrift(folly::StringPiece serialized) {
+  return fromWarmbootValue(
+      apache::thrift::CompactSerializer::deserialize<state::WarmbootValue>(
+          serialized));
+}
 } // namespace facebook::fboss
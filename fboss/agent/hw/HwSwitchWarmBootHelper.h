@@ -9,10 +9,14 @@
  */
 #pragma once
 
+#include <folly/Range.h>
 #include <folly/dynamic.h>
+#include <gflags/gflags.h>
 
 #include <string>
 
+DECLARE_bool(thrift_warm_boot_state);
+
 namespace facebook::fboss {
 
 /*
@@ -40,6 +44,13 @@ class HwSwitchWarmBootHelper {
    */
   void setCanWarmBoot();
 
+  /*
+   * The switch state is stored as JSON, or as compact thrift with
+   * --thrift_warm_boot_state. Storing either removes the other, and
+   * getWarmBootState() reads whichever of the two was written last, so that
+   * either agent version, including ones that only know of the JSON state,
+   * can warm boot from the other's state.
+   */
   bool storeWarmBootState(const folly::dynamic& switchState);
   folly::dynamic getWarmBootState() const;
 
@@ -67,6 +78,7 @@ class HwSwitchWarmBootHelper {
   std::string warmBootFlag() const;
   std::string forceColdBootOnceFlag() const;
   std::string warmBootSwitchStateFile() const;
+  std::string warmBootThriftSwitchStateFile() const;
 
   void setupWarmBootFile();
   /*
@@ -89,4 +101,11 @@ class HwSwitchWarmBootHelper {
   bool canWarmBoot_{false};
   bool warmBootStateWritten_{false};
 };
+
+/*
+ * Encode and decode the warm boot switch state in the compact thrift form
+ * (state::WarmbootValue) used with --thrift_warm_boot_state.
+ */
+std::string serializeWarmBootStateThrift(const folly::dynamic& switchState);
+folly::dynamic deserializeWarmBootStateThrift(folly::StringPiece serialized);
 } // namespace facebook::fboss
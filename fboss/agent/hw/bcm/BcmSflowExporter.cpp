@@ -17,17 +17,45 @@
 #include <ifaddrs.h>
 
 #include <folly/Range.h>
+#include <folly/io/Cursor.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <optional>
 
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/HwSwitch.h"
+#include "fboss/agent/hw/HwSwitchStats.h"
+#include "fboss/agent/packet/SflowStructs.h"
+
+DEFINE_bool(
+    sflow_v5_datagrams,
+    false,
+    "Export sFlow samples as sFlow v5 datagrams, packing as many samples as "
+    "fit in one datagram, instead of one thrift SflowPacketInfo per datagram");
+DEFINE_int32(
+    sflow_export_batch_size,
+    1,
+    "Number of sFlow samples to buffer before sending them to the collectors. "
+    "1 sends every sample as soon as it is captured");
+DEFINE_int32(
+    sflow_export_flush_ms,
+    10,
+    "Longest time an sFlow sample may stay buffered before being sent, "
+    "with --sflow_export_batch_size above 1");
+DEFINE_int32(
+    sflow_datagram_mtu,
+    1400,
+    "Largest sFlow v5 datagram to send, in bytes");
 
 using namespace std;
 
 namespace {
+// Largest number of datagrams sendmmsg() takes in one call
+constexpr size_t kMaxDatagramsPerSyscall = 1024;
+
 std::optional<folly::IPAddress> getLocalIPv6FromWhoAmI() {
   const std::string whoAmIFn = "/etc/fbwhoami";
   const std::string key = "DEVICE_PRIMARY_IPV6";
@@ -165,28 +193,44 @@ BcmSflowExporter::BcmSflowExporter(const folly::SocketAddress& address)
   }
 }
 
-ssize_t BcmSflowExporter::sendUDPDatagram(iovec* vec, const size_t iovec_len) {
-  XLOG(DBG4) << "Sending an sFlow packet to " << address_.describe();
+size_t BcmSflowExporter::sendUDPDatagrams(
+    const iovec* datagrams,
+    const size_t count) {
+  XLOG(DBG4) << "Sending " << count << " sFlow packets to "
+             << address_.describe();
 
   sockaddr_storage addrStorage;
   address_.getAddress(&addrStorage);
 
-  struct msghdr msg = {};
-  msg.msg_name = reinterpret_cast<void*>(&addrStorage);
-  msg.msg_namelen = address_.getActualSize();
-  msg.msg_iov = vec;
-  msg.msg_iovlen = iovec_len;
-  msg.msg_control = nullptr;
-  msg.msg_controllen = 0;
-  msg.msg_flags = 0;
-  auto ret = ::sendmsg(socket_, &msg, 0);
-  if (ret < 0) {
-    XLOG(DBG1) << "Failed sending sFlow packet to " << address_.describe()
-               << " reason: " << folly::errnoStr(errno);
-  }
-  XLOG(DBG4) << "Sent " << ret << " bytes of sFlow packet to "
+  msgs_.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    struct msghdr& msg = msgs_[i].msg_hdr;
+    msg = {};
+    msg.msg_name = reinterpret_cast<void*>(&addrStorage);
+    msg.msg_namelen = address_.getActualSize();
+    msg.msg_iov = const_cast<iovec*>(&datagrams[i]);
+    msg.msg_iovlen = 1;
+    msgs_[i].msg_len = 0;
+  }
+
+  size_t sent = 0;
+  while (sent < count) {
+    auto ret = ::sendmmsg(
+        socket_,
+        msgs_.data() + sent,
+        std::min(count - sent, kMaxDatagramsPerSyscall),
+        0);
+    if (ret <= 0) {
+      XLOG(DBG1) << "Failed sending " << count - sent << " sFlow packets to "
+                 << address_.describe()
+                 << " reason: " << folly::errnoStr(errno);
+      break;
+    }
+    sent += ret;
+  }
+  XLOG(DBG4) << "Sent " << sent << " sFlow packets to "
              << address_.describe();
-  return ret;
+  return sent;
 }
 
 BcmSflowExporter::~BcmSflowExporter() {
@@ -195,19 +239,35 @@ BcmSflowExporter::~BcmSflowExporter() {
   }
 }
 
+BcmSflowExporterTable::BcmSflowExporterTable(const HwSwitch* hw)
+    : hw_(hw), start_(std::chrono::steady_clock::now()) {
+  if (FLAGS_sflow_export_batch_size > 1) {
+    flushThread_ =
+        std::make_unique<folly::ScopedEventBaseThread>("SflowExportFlush");
+  }
+}
+
+BcmSflowExporterTable::~BcmSflowExporterTable() {
+  // Stop timed flushes before anything they use goes away
+  flushThread_.reset();
+}
+
 bool BcmSflowExporterTable::contains(
     const shared_ptr<SflowCollector>& c) const {
+  std::lock_guard<std::mutex> g(mutex_);
   auto iter = map_.find(c->getID());
   return iter != map_.end();
 }
 
 size_t BcmSflowExporterTable::size() const {
+  std::lock_guard<std::mutex> g(mutex_);
   return map_.size();
 }
 
 void BcmSflowExporterTable::addExporter(const shared_ptr<SflowCollector>& c) {
   try {
     auto exporter = make_unique<BcmSflowExporter>(c->getAddress());
+    std::lock_guard<std::mutex> g(mutex_);
     map_.emplace(c->getID(), move(exporter));
   } catch (const fboss::thrift::FbossBaseError& ex) {
     XLOG(ERR) << "Could not add exporter: "
@@ -222,6 +282,7 @@ void BcmSflowExporterTable::addExporter(const shared_ptr<SflowCollector>& c) {
 
 void BcmSflowExporterTable::removeExporter(const std::string& id) {
   XLOG(INFO) << "Removed sFlow exporter " << id;
+  std::lock_guard<std::mutex> g(mutex_);
   map_.erase(id);
 }
 
@@ -229,6 +290,9 @@ void BcmSflowExporterTable::updateSamplingRates(
     PortID id,
     int64_t inRate,
     int64_t outRate) {
+  // Look the address up before taking the lock, it may read a file
+  auto localIP = getLocalIPv6();
+  std::lock_guard<std::mutex> g(mutex_);
   std::pair<int64_t, int64_t> rates(inRate, outRate);
   auto it = port2samplingRates_.find(id);
   if (it != port2samplingRates_.end()) {
@@ -238,33 +302,197 @@ void BcmSflowExporterTable::updateSamplingRates(
   }
 
   // We piggyback the update of local IPv6
-  localIP_ = getLocalIPv6();
+  localIP_ = localIP;
 }
 
 void BcmSflowExporterTable::sendToAll(const SflowPacketInfo& info) {
+  std::lock_guard<std::mutex> g(mutex_);
   if (map_.empty()) {
     XLOG(DBG1)
         << "zero sFlow collectors with sflow enabled, skipping sample export";
     return;
   }
-  // Serialize info to a string and wrap it in an IOBuf for sending
-  string output;
+
+  if (pendingSamples_ == 0) {
+    firstPending_ = std::chrono::steady_clock::now();
+    armFlushTimer(std::chrono::milliseconds(FLAGS_sflow_export_flush_ms));
+  }
+  if (FLAGS_sflow_v5_datagrams) {
+    addV5Sample(info);
+  } else {
+    addThriftSample(info);
+  }
+  ++pendingSamples_;
+
+  if (pendingSamples_ >= FLAGS_sflow_export_batch_size) {
+    flush();
+  }
+}
+
+void BcmSflowExporterTable::addThriftSample(const SflowPacketInfo& info) {
+  if (thriftDatagrams_.size() <= numDatagrams_) {
+    thriftDatagrams_.resize(numDatagrams_ + 1);
+    samplesPerDatagram_.resize(numDatagrams_ + 1);
+  }
+  // Reuse the capacity of the string from earlier flushes
+  auto& output = thriftDatagrams_[numDatagrams_];
+  output.clear();
   apache::thrift::BinarySerializer::serialize(info, &output);
-  auto buf = folly::IOBuf::wrapBuffer(output.data(), output.length());
+  samplesPerDatagram_[numDatagrams_] = 1;
+  ++numDatagrams_;
+}
+
+void BcmSflowExporterTable::addV5Sample(const SflowPacketInfo& info) {
+  const uint32_t mtu = FLAGS_sflow_datagram_mtu;
+  const auto& packetData = *info.packetData_ref();
+
+  sflow::SampledHeader hdr;
+  hdr.protocol = sflow::HeaderProtocol::ETHERNET_ISO88023;
+  hdr.frameLength = *info.frameLength_ref() > 0 ? *info.frameLength_ref()
+                                                : packetData.size();
+  hdr.stripped = 0;
+  hdr.headerLength = packetData.size();
+  hdr.header = reinterpret_cast<const sflow::byte*>(packetData.data());
+
+  auto headerSize = [](const folly::IPAddress& agentAddress) {
+    sflow::SampleDatagram datagram;
+    datagram.datagramV5.agentAddress = agentAddress;
+    return datagram.size(0);
+  };
+  // Trim the sampled header if the sample would not fit even on its own
+  hdr.headerLength = 0;
+  auto maxHeaderLength = static_cast<int64_t>(mtu) - headerSize(localIP_) -
+      sflow::flowSampleRecordSize(hdr);
+  if (maxHeaderLength < 0) {
+    XLOG(DBG1) << "sFlow datagram MTU " << mtu
+               << " too small, dropping sample";
+    return;
+  }
+  hdr.headerLength = std::min<uint32_t>(
+      packetData.size(),
+      maxHeaderLength - maxHeaderLength % sflow::XDR_BASIC_BLOCK_SIZE);
+  auto recordSize = sflow::flowSampleRecordSize(hdr);
 
-  // Map the IOBuf to a Linux iovec like a champ
-  iovec vec[16] = {};
-  size_t iovec_len = buf->fillIov(vec, sizeof(vec) / sizeof(vec[0])).numIovecs;
-  if (UNLIKELY(iovec_len == 0)) {
-    buf->coalesce();
-    vec[0].iov_base = const_cast<uint8_t*>(buf->data());
-    vec[0].iov_len = buf->length();
-    iovec_len = 1;
+  if (v5Length_ > 0 && v5Length_ + recordSize > mtu) {
+    sealV5Datagram();
+  }
+  if (v5Length_ == 0) {
+    // Open a new datagram, leaving room for the header written when sealed
+    if (v5Datagrams_.size() <= numDatagrams_) {
+      v5Datagrams_.push_back(folly::IOBuf::create(mtu));
+      samplesPerDatagram_.resize(numDatagrams_ + 1);
+    }
+    auto& buf = v5Datagrams_[numDatagrams_];
+    if (buf->capacity() < mtu) {
+      buf = folly::IOBuf::create(mtu);
+    }
+    buf->clear();
+    buf->append(mtu);
+    v5AgentAddress_ = localIP_;
+    v5Length_ = headerSize(v5AgentAddress_);
+    samplesPerDatagram_[numDatagrams_] = 0;
   }
 
+  auto srcPort = *info.srcPort_ref();
+  auto dstPort = *info.dstPort_ref();
+  sflow::FlowSample sample;
+  sample.sequenceNumber = v5SampleSequence_++;
+  sample.sourceID = *info.ingressSampled_ref() ? srcPort : dstPort;
+  sample.samplingRate = 0;
+  auto rates = port2samplingRates_.find(PortID(sample.sourceID));
+  if (rates != port2samplingRates_.end()) {
+    sample.samplingRate = *info.ingressSampled_ref() ? rates->second.first
+                                                     : rates->second.second;
+  }
+  sample.samplePool = 0;
+  sample.drops = 0;
+  sample.input = srcPort;
+  sample.output = dstPort;
+
+  folly::io::RWPrivateCursor cursor(v5Datagrams_[numDatagrams_].get());
+  cursor.skip(v5Length_);
+  sflow::serializeFlowSampleRecord(&cursor, sample, hdr);
+  v5Length_ += recordSize;
+  ++samplesPerDatagram_[numDatagrams_];
+}
+
+void BcmSflowExporterTable::sealV5Datagram() {
+  sflow::SampleDatagram datagram;
+  datagram.datagramV5.agentAddress = v5AgentAddress_;
+  datagram.datagramV5.subAgentID = 0;
+  datagram.datagramV5.sequenceNumber = v5DatagramSequence_++;
+  datagram.datagramV5.uptime =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - start_)
+          .count();
+  datagram.datagramV5.samplesCnt = samplesPerDatagram_[numDatagrams_];
+
+  auto& buf = v5Datagrams_[numDatagrams_];
+  folly::io::RWPrivateCursor cursor(buf.get());
+  datagram.serializeHeader(&cursor);
+  buf->trimEnd(buf->length() - v5Length_);
+  v5Length_ = 0;
+  ++numDatagrams_;
+}
+
+void BcmSflowExporterTable::flush() {
+  if (v5Length_ > 0) {
+    sealV5Datagram();
+  }
+
+  iovecs_.resize(numDatagrams_);
+  for (size_t i = 0; i < numDatagrams_; ++i) {
+    if (FLAGS_sflow_v5_datagrams) {
+      iovecs_[i].iov_base = v5Datagrams_[i]->writableData();
+      iovecs_[i].iov_len = v5Datagrams_[i]->length();
+    } else {
+      iovecs_[i].iov_base = thriftDatagrams_[i].data();
+      iovecs_[i].iov_len = thriftDatagrams_[i].size();
+    }
+  }
   for (const auto& c : map_) {
     // TODO: prob need to handle ret code?
-    c.second->sendUDPDatagram(vec, iovec_len);
+    c.second->sendUDPDatagrams(iovecs_.data(), iovecs_.size());
+  }
+
+  auto stats = hw_->getSwitchStats();
+  for (size_t i = 0; i < numDatagrams_; ++i) {
+    stats->sflowDatagramSent(samplesPerDatagram_[i]);
+  }
+  stats->sflowSamplesFlushed(
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::steady_clock::now() - firstPending_)
+          .count());
+  numDatagrams_ = 0;
+  pendingSamples_ = 0;
+}
+
+void BcmSflowExporterTable::armFlushTimer(std::chrono::milliseconds delay) {
+  if (!flushThread_ || flushTimerArmed_) {
+    return;
+  }
+  flushTimerArmed_ = true;
+  auto evb = flushThread_->getEventBase();
+  evb->runInEventBaseThread([this, evb, delay]() {
+    evb->runAfterDelay([this]() { flushIfDue(); }, delay.count());
+  });
+}
+
+void BcmSflowExporterTable::flushIfDue() {
+  std::lock_guard<std::mutex> g(mutex_);
+  flushTimerArmed_ = false;
+  if (pendingSamples_ == 0) {
+    return;
+  }
+  // The samples the timer was armed for may have been sent with a full
+  // batch since, in which case wait for the oldest of those now pending.
+  auto flushAfter = std::chrono::milliseconds(FLAGS_sflow_export_flush_ms);
+  auto pendingFor = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - firstPending_);
+  if (pendingFor >= flushAfter) {
+    flush();
+  } else {
+    armFlushTimer(flushAfter - pendingFor);
   }
 }
 
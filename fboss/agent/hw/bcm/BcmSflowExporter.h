@@ -9,10 +9,17 @@
  */
 #pragma once
 
+#include <chrono>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
+
+#include <sys/socket.h>
 
 #include <folly/IPAddress.h>
 #include <folly/SocketAddress.h>
+#include <folly/io/IOBuf.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
 
 #include "fboss/agent/if/gen-cpp2/sflow_types.h"
 #include "fboss/agent/state/SflowCollector.h"
@@ -20,6 +27,8 @@
 
 namespace facebook::fboss {
 
+class HwSwitch;
+
 class BcmSflowExporter {
  public:
   /*
@@ -31,9 +40,10 @@ class BcmSflowExporter {
   ~BcmSflowExporter();
 
   /*
-   * Send out the data in vec using UDP.  Called after init().
+   * Send out each of the datagrams in one UDP datagram, with as few
+   * sendmmsg() calls as possible. Returns the number of datagrams sent.
    */
-  ssize_t sendUDPDatagram(iovec* vec, const size_t iovec_len);
+  size_t sendUDPDatagrams(const iovec* datagrams, const size_t count);
 
  private:
   // no copy or assignment
@@ -42,12 +52,24 @@ class BcmSflowExporter {
 
   const folly::SocketAddress address_;
   int socket_{-1};
+  std::vector<mmsghdr> msgs_;
 };
 
+/*
+ * Exports sFlow samples to all collectors.
+ *
+ * By default every sample is sent right away as a thrift serialized
+ * SflowPacketInfo, one per datagram. With --sflow_v5_datagrams samples are
+ * instead packed into sFlow v5 datagrams of up to --sflow_datagram_mtu bytes.
+ *
+ * With --sflow_export_batch_size above 1, samples are buffered and sent to
+ * each collector in one sendmmsg() call once that many are buffered, or once
+ * the oldest has been buffered for --sflow_export_flush_ms.
+ */
 class BcmSflowExporterTable {
  public:
-  BcmSflowExporterTable() = default;
-  ~BcmSflowExporterTable() = default;
+  explicit BcmSflowExporterTable(const HwSwitch* hw);
+  ~BcmSflowExporterTable();
 
   bool contains(const std::shared_ptr<SflowCollector>& collector) const;
   size_t size() const;
@@ -63,12 +85,55 @@ class BcmSflowExporterTable {
   BcmSflowExporterTable(BcmSflowExporterTable const&) = delete;
   BcmSflowExporterTable& operator=(BcmSflowExporterTable const&) = delete;
 
+  // Add the sample to the datagrams to send. Called with mutex_ held.
+  void addThriftSample(const SflowPacketInfo& info);
+  void addV5Sample(const SflowPacketInfo& info);
+
+  // Seal the sFlow v5 datagram being filled. Called with mutex_ held.
+  void sealV5Datagram();
+
+  // Send all pending datagrams to every collector. Called with mutex_ held.
+  void flush();
+  // Have flushIfDue() run after delay, unless it is already due to run.
+  // Called with mutex_ held.
+  void armFlushTimer(std::chrono::milliseconds delay);
+  void flushIfDue();
+
+  const HwSwitch* hw_;
+  const std::chrono::steady_clock::time_point start_;
+
+  // Protects everything below, sendToAll() may race with a timed flush
+  mutable std::mutex mutex_;
   std::unordered_map<std::string, std::unique_ptr<BcmSflowExporter>> map_;
   std::unordered_map<
       PortID,
       std::pair<int64_t /* ingress rate */, int64_t /* egress rate */>>
       port2samplingRates_;
   folly::IPAddress localIP_;
+
+  /*
+   * Buffers of the datagrams pending to be sent, reused across flushes.
+   * Thrift datagrams each live in a string of their own. sFlow v5 datagrams
+   * are written in place into MTU sized IOBufs, the last one being filled.
+   */
+  std::vector<std::string> thriftDatagrams_;
+  std::vector<std::unique_ptr<folly::IOBuf>> v5Datagrams_;
+  std::vector<uint32_t> samplesPerDatagram_;
+  size_t numDatagrams_{0};
+  size_t pendingSamples_{0};
+  std::chrono::steady_clock::time_point firstPending_;
+  std::vector<iovec> iovecs_;
+
+  // sFlow v5 datagram being filled
+  folly::IPAddress v5AgentAddress_;
+  uint32_t v5Length_{0};
+  uint32_t v5DatagramSequence_{0};
+  uint32_t v5SampleSequence_{0};
+
+  // Runs timed flushes, with --sflow_export_batch_size above 1. One timer is
+  // armed at a time, and kept armed while samples are pending.
+  std::unique_ptr<folly::ScopedEventBaseThread> flushThread_;
+  bool flushTimerArmed_{false};
 };
 
 } // namespace facebook::fboss
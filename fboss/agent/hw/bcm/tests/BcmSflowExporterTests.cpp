@@ -0,0 +1,214 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/bcm/BcmSflowExporter.h"
+#include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/state/SflowCollector.h"
+
+#include <folly/io/Cursor.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+DECLARE_bool(sflow_v5_datagrams);
+DECLARE_int32(sflow_export_batch_size);
+DECLARE_int32(sflow_export_flush_ms);
+DECLARE_int32(sflow_datagram_mtu);
+
+using namespace facebook::fboss;
+using namespace std::chrono_literals;
+
+namespace {
+
+// A collector on the loopback interface, receiving what is exported to it
+class TestCollector {
+ public:
+  TestCollector() {
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    CHECK_NE(socket_, -1);
+    // Bound to any free port
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    CHECK_EQ(
+        ::bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    socklen_t addrLen = sizeof(addr);
+    CHECK_EQ(
+        ::getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &addrLen),
+        0);
+    port_ = ntohs(addr.sin_port);
+  }
+  ~TestCollector() {
+    ::close(socket_);
+  }
+
+  std::shared_ptr<SflowCollector> collector() const {
+    return std::make_shared<SflowCollector>("127.0.0.1", port_);
+  }
+
+  // The next datagram, if one arrives within timeout
+  std::optional<std::string> receive(std::chrono::milliseconds timeout) {
+    timeval tv{};
+    tv.tv_sec = timeout.count() / 1000;
+    tv.tv_usec = (timeout.count() % 1000) * 1000;
+    CHECK_EQ(
+        ::setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)), 0);
+    std::string datagram(64 * 1024, '\0');
+    auto len = ::recv(socket_, datagram.data(), datagram.size(), 0);
+    if (len < 0) {
+      return std::nullopt;
+    }
+    datagram.resize(len);
+    return datagram;
+  }
+
+ private:
+  int socket_{-1};
+  uint16_t port_{0};
+};
+
+SflowPacketInfo makeSample(int16_t srcPort, size_t packetSize = 64) {
+  SflowPacketInfo info;
+  info.ingressSampled_ref() = true;
+  info.egressSampled_ref() = false;
+  info.srcPort_ref() = srcPort;
+  info.dstPort_ref() = 0;
+  info.packetData_ref() = std::string(packetSize, 'x');
+  info.frameLength_ref() = packetSize;
+  return info;
+}
+
+// Number of samples in an sFlow v5 datagram, read from its header
+uint32_t v5SampleCount(const std::string& datagram) {
+  auto buf = folly::IOBuf::wrapBuffer(datagram.data(), datagram.size());
+  folly::io::Cursor cursor(buf.get());
+  EXPECT_EQ(cursor.readBE<uint32_t>(), 5);
+  // IPv4 or IPv6 agent address
+  cursor.skip(cursor.readBE<uint32_t>() == 1 ? 4 : 16);
+  // Sub agent id, sequence number and uptime
+  cursor.skip(12);
+  return cursor.readBE<uint32_t>();
+}
+
+class BcmSflowExporterTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    FLAGS_sflow_v5_datagrams = false;
+    FLAGS_sflow_export_batch_size = 1;
+    FLAGS_sflow_export_flush_ms = 10;
+  }
+
+  // Flags are read when the table is created
+  std::unique_ptr<BcmSflowExporterTable> createTable() {
+    auto table =
+        std::make_unique<BcmSflowExporterTable>(platform_.getHwSwitch());
+    table->addExporter(collector_.collector());
+    table->updateSamplingRates(PortID(1), 1, 1);
+    return table;
+  }
+
+  gflags::FlagSaver flagSaver_;
+  ::testing::NiceMock<MockPlatform> platform_;
+  TestCollector collector_;
+};
+
+} // namespace
+
+TEST_F(BcmSflowExporterTest, batchSentOnceFull) {
+  FLAGS_sflow_export_batch_size = 4;
+  // Long enough for the timer not to send the batch in this test
+  FLAGS_sflow_export_flush_ms = 60 * 1000;
+  auto table = createTable();
+
+  for (int16_t i = 0; i < 3; ++i) {
+    table->sendToAll(makeSample(i));
+  }
+  EXPECT_FALSE(collector_.receive(100ms).has_value());
+
+  table->sendToAll(makeSample(3));
+  for (int16_t i = 0; i < 4; ++i) {
+    auto datagram = collector_.receive(5s);
+    ASSERT_TRUE(datagram.has_value());
+    auto info = apache::thrift::BinarySerializer::deserialize<SflowPacketInfo>(
+        *datagram);
+    EXPECT_EQ(*info.srcPort_ref(), i);
+  }
+}
+
+TEST_F(BcmSflowExporterTest, partialBatchSentByTimer) {
+  FLAGS_sflow_export_batch_size = 100;
+  FLAGS_sflow_export_flush_ms = 20;
+  auto table = createTable();
+
+  table->sendToAll(makeSample(1));
+  table->sendToAll(makeSample(2));
+  EXPECT_TRUE(collector_.receive(5s).has_value());
+  EXPECT_TRUE(collector_.receive(5s).has_value());
+}
+
+TEST_F(BcmSflowExporterTest, timerRearmedAfterFullBatch) {
+  FLAGS_sflow_export_batch_size = 2;
+  FLAGS_sflow_export_flush_ms = 200;
+  auto table = createTable();
+
+  // Sent as a full batch, before the timer armed for it fires
+  table->sendToAll(makeSample(1));
+  table->sendToAll(makeSample(2));
+  EXPECT_TRUE(collector_.receive(5s).has_value());
+  EXPECT_TRUE(collector_.receive(5s).has_value());
+
+  // Pending when that timer fires, but not yet for long enough
+  std::this_thread::sleep_for(100ms);
+  table->sendToAll(makeSample(3));
+  auto datagram = collector_.receive(5s);
+  ASSERT_TRUE(datagram.has_value());
+  auto info =
+      apache::thrift::BinarySerializer::deserialize<SflowPacketInfo>(*datagram);
+  EXPECT_EQ(*info.srcPort_ref(), 3);
+}
+
+TEST_F(BcmSflowExporterTest, v5DatagramsSplitAtMtu) {
+  constexpr auto kSamples = 10;
+  FLAGS_sflow_v5_datagrams = true;
+  FLAGS_sflow_datagram_mtu = 600;
+  FLAGS_sflow_export_batch_size = kSamples;
+  FLAGS_sflow_export_flush_ms = 60 * 1000;
+  auto table = createTable();
+
+  for (int16_t i = 0; i < kSamples; ++i) {
+    table->sendToAll(makeSample(1, 128));
+  }
+  uint32_t samples = 0;
+  int datagrams = 0;
+  while (samples < kSamples) {
+    auto datagram = collector_.receive(5s);
+    ASSERT_TRUE(datagram.has_value());
+    EXPECT_LE(datagram->size(), 600);
+    auto count = v5SampleCount(*datagram);
+    EXPECT_GT(count, 0);
+    samples += count;
+    ++datagrams;
+  }
+  EXPECT_EQ(samples, kSamples);
+  // More than one sample fits in a datagram, but not all of them
+  EXPECT_GT(datagrams, 1);
+  EXPECT_LT(datagrams, kSamples);
+}
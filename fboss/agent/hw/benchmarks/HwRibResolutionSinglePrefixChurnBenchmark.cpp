@@ -0,0 +1,97 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/rib/FibUpdateHelpers.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/test/RouteGeneratorTestUtils.h"
+#include "fboss/agent/test/RouteScaleGenerators.h"
+
+#include <folly/Benchmark.h>
+#include <folly/logging/xlog.h>
+
+DECLARE_bool(enable_standalone_rib);
+
+namespace facebook::fboss {
+
+/*
+ * Add and delete a single prefix against a ~200K route table. With
+ * incremental resolution the cost of each update should be proportional
+ * to the routes depending on the churned prefix, not the table size.
+ */
+BENCHMARK(RibResolutionSinglePrefixChurnBenchmark) {
+  folly::BenchmarkSuspender suspender;
+  FLAGS_enable_standalone_rib = true;
+  auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
+  auto config = utility::onePortPerVlanConfig(
+      ensemble->getHwSwitch(), ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+  utility::RouteDistributionGenerator gen(
+      ensemble->getProgrammedState(),
+      // v6 distribution
+      {
+          {48, 20000},
+          {64, 100000},
+          {128, 20000},
+      },
+      // v4 distribution
+      {
+          {24, 40000},
+          {32, 20000},
+      },
+      true,
+      utility::kDefaultChunkSize,
+      utility::kDefaulEcmpWidth);
+  auto rib = RoutingInformationBase::fromFollyDynamic(
+      ensemble->getRib()->toFollyDynamic(), nullptr);
+  for (const auto& routeChunk : gen.getThriftRoutes()) {
+    rib->update(
+        RouterID(0),
+        ClientID::BGPD,
+        AdminDistance::EBGP,
+        routeChunk,
+        {},
+        false,
+        "populate",
+        // Skip FIB computation, we only want to measure RIB resolution
+        noopFibUpdate,
+        nullptr);
+  }
+  const auto churnRoute = gen.getThriftRoutes().front().front();
+  constexpr auto kChurnIterations = 1000;
+  suspender.dismiss();
+  for (auto i = 0; i < kChurnIterations; ++i) {
+    rib->update(
+        RouterID(0),
+        ClientID::BGPD,
+        AdminDistance::EBGP,
+        {},
+        {*churnRoute.dest_ref()},
+        false,
+        "churn del",
+        noopFibUpdate,
+        nullptr);
+    rib->update(
+        RouterID(0),
+        ClientID::BGPD,
+        AdminDistance::EBGP,
+        {churnRoute},
+        {},
+        false,
+        "churn add",
+        noopFibUpdate,
+        nullptr);
+  }
+  suspender.rehire();
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/rib/FibUpdateHelpers.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
+#include "fboss/agent/test/RouteGeneratorTestUtils.h"
+#include "fboss/agent/test/RouteScaleGenerators.h"
+
+#include <folly/Benchmark.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <folly/logging/xlog.h>
+
+#include <iostream>
+
+DECLARE_bool(enable_standalone_rib);
+DECLARE_bool(json);
+
+namespace facebook::fboss {
+
+/*
+ * Sync fib with v4 and v6 routes using 1, 2, 4 and 8 resolution threads,
+ * and report the time taken with each along with the speedup over a single
+ * thread. With a single VRF, at most the two address families get resolved
+ * concurrently.
+ */
+BENCHMARK(RibSyncFibResolutionThreadsBenchmark) {
+  folly::BenchmarkSuspender suspender;
+  FLAGS_enable_standalone_rib = true;
+  auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
+  auto config = utility::onePortPerVlanConfig(
+      ensemble->getHwSwitch(), ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+  utility::THAlpmRouteScaleGenerator gen(
+      ensemble->getProgrammedState(), true, 50000);
+  const auto& routeChunks = gen.getThriftRoutes();
+  CHECK_EQ(1, routeChunks.size());
+  auto ribJson = ensemble->getRib()->toFollyDynamic();
+
+  folly::dynamic syncFibMsecs = folly::dynamic::object;
+  double singleThreadMsecs = 0;
+  for (auto threads : {1, 2, 4, 8}) {
+    // Resolution threads are picked up when the RIB is created
+    FLAGS_rib_resolution_threads = threads;
+    auto rib = RoutingInformationBase::fromFollyDynamic(ribJson, nullptr);
+    auto switchState = ensemble->getProgrammedState();
+    rib->update(
+        RouterID(0),
+        ClientID::BGPD,
+        AdminDistance::EBGP,
+        routeChunks[0],
+        {},
+        false,
+        "resolution only",
+        ribToSwitchStateUpdate,
+        static_cast<void*>(&switchState));
+    switchState = ensemble->getProgrammedState();
+    suspender.dismiss();
+    StopWatch timer(std::nullopt, FLAGS_json);
+    rib->update(
+        RouterID(0),
+        ClientID::BGPD,
+        AdminDistance::EBGP,
+        routeChunks[0],
+        {},
+        true,
+        "sync fib",
+        ribToSwitchStateUpdate,
+        static_cast<void*>(&switchState));
+    double msecs = timer.msecsElapsed().count();
+    suspender.rehire();
+    if (threads == 1) {
+      singleThreadMsecs = msecs;
+    }
+    auto key = folly::to<std::string>("threads_", threads);
+    syncFibMsecs[key + "_msecs"] = msecs;
+    syncFibMsecs[key + "_speedup"] = msecs ? singleThreadMsecs / msecs : 0;
+  }
+  if (FLAGS_json) {
+    std::cout << toPrettyJson(syncFibMsecs) << std::endl;
+  } else {
+    for (const auto& [key, value] : syncFibMsecs.items()) {
+      XLOG(INFO) << key.asString() << " : " << value.asDouble();
+    }
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleRouteUpdateWrapper.h"
+#include "fboss/agent/test/RouteDistributionGenerator.h"
+
+#include <folly/Benchmark.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+DECLARE_bool(json);
+
+namespace facebook::fboss {
+
+/*
+ * Add and then delete chunks of routes, one chunk per state update, while
+ * another thread collects stats back to back, and report the percentiles
+ * of the time each update took. Stats collection must not hold up route
+ * programming, so these should stay close to the latencies without it.
+ */
+BENCHMARK(HwRouteChurnWithStatsCollection) {
+  folly::BenchmarkSuspender suspender;
+  constexpr auto kEcmpWidth = 4;
+  constexpr auto kChunkSize = 100;
+  constexpr auto kNumChunks = 100;
+  auto ensemble = createHwEnsemble({HwSwitchEnsemble::LINKSCAN});
+  auto hwSwitch = ensemble->getHwSwitch();
+  auto config =
+      utility::onePortPerVlanConfig(hwSwitch, ensemble->masterLogicalPortIds());
+  ensemble->applyInitialConfig(config);
+  utility::RouteDistributionGenerator routeGenerator(
+      ensemble->getProgrammedState(),
+      {{64, kChunkSize * kNumChunks}},
+      {},
+      ensemble->isStandaloneRibEnabled(),
+      kChunkSize,
+      kEcmpWidth);
+  ensemble->applyNewState(
+      routeGenerator.resolveNextHops(ensemble->getProgrammedState()));
+  const auto& routeChunks = routeGenerator.getThriftRoutes();
+
+  std::atomic<bool> done{false};
+  std::atomic<int> statsCollections{0};
+  std::thread statsThread([hwSwitch, &done, &statsCollections]() {
+    SwitchStats dummy;
+    while (!done) {
+      hwSwitch->updateStats(&dummy);
+      ++statsCollections;
+    }
+  });
+
+  std::vector<double> updateMsecs;
+  updateMsecs.reserve(2 * routeChunks.size());
+  auto updater = ensemble->getRouteUpdater();
+  suspender.dismiss();
+  for (const auto& chunk : routeChunks) {
+    StopWatch timer(std::nullopt, FLAGS_json);
+    updater.programRoutes(RouterID(0), ClientID::BGPD, {chunk});
+    updateMsecs.push_back(timer.msecsElapsed().count());
+  }
+  for (const auto& chunk : routeChunks) {
+    StopWatch timer(std::nullopt, FLAGS_json);
+    updater.unprogramRoutes(RouterID(0), ClientID::BGPD, {chunk});
+    updateMsecs.push_back(timer.msecsElapsed().count());
+  }
+  suspender.rehire();
+  done = true;
+  statsThread.join();
+
+  std::sort(updateMsecs.begin(), updateMsecs.end());
+  auto percentile = [&updateMsecs](double pct) {
+    auto idx = static_cast<size_t>(pct / 100 * (updateMsecs.size() - 1));
+    return updateMsecs[idx];
+  };
+  if (FLAGS_json) {
+    folly::dynamic time = folly::dynamic::object;
+    time["route_update_p50_msecs"] = percentile(50);
+    time["route_update_p90_msecs"] = percentile(90);
+    time["route_update_p99_msecs"] = percentile(99);
+    time["route_update_max_msecs"] = updateMsecs.back();
+    time["stats_collections"] = statsCollections.load();
+    std::cout << toPrettyJson(time) << std::endl;
+  } else {
+    XLOG(INFO) << "route_update_p50_msecs : " << percentile(50)
+               << " route_update_p90_msecs : " << percentile(90)
+               << " route_update_p99_msecs : " << percentile(99)
+               << " route_update_max_msecs : " << updateMsecs.back()
+               << " stats_collections : " << statsCollections.load();
+  }
+}
+
+} // namespace facebook::fboss
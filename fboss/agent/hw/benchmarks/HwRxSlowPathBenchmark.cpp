@@ -9,6 +9,8 @@
  */
 
 #include "fboss/agent/Platform.h"
+#include "fboss/agent/RxPacket.h"
+#include "fboss/agent/RxPacketDispatcher.h"
 #include "fboss/agent/hw/test/ConfigFactory.h"
 #include "fboss/agent/hw/test/HwSwitchEnsemble.h"
 #include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
@@ -26,6 +28,9 @@
 #include <folly/init/Init.h>
 #include <folly/json.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iostream>
 #include <thread>
 
@@ -34,11 +39,87 @@ DEFINE_bool(
     setup_for_warmboot,
     false,
     "Set to true will prepare the device for warmboot");
+DEFINE_int32(
+    dispatch_threads,
+    2,
+    "Threads the trapped packets are dispatched to, as with "
+    "--rx_packet_dispatch_threads in the agent");
+DEFINE_int32(
+    dispatch_handling_usecs,
+    10,
+    "Time spent handling each dispatched packet, standing in for the agent "
+    "packet handlers");
+DEFINE_int32(
+    control_pkts_per_sec,
+    1000,
+    "Control protocol packets mixed in with the flood of trapped packets");
 
 namespace facebook::fboss {
 
 const std::string kDstIp = "2620:0:1cfe:face:b00c::4";
 
+namespace {
+
+/*
+ * A copy of a trapped packet, which the HwSwitch only lends to its observers
+ */
+class BenchmarkRxPacket : public RxPacket {
+ public:
+  explicit BenchmarkRxPacket(const RxPacket* pkt) {
+    buf_ = pkt->buf()->clone();
+    buf_->unshare();
+    srcPort_ = pkt->getSrcPort();
+    srcVlan_ = pkt->getSrcVlan();
+    len_ = pkt->getLength();
+  }
+  explicit BenchmarkRxPacket(std::unique_ptr<folly::IOBuf> buf) {
+    len_ = buf->computeChainDataLength();
+    buf_ = std::move(buf);
+  }
+};
+
+// LLDP frame, padded to the minimum ethernet frame length
+std::unique_ptr<RxPacket> makeControlPacket() {
+  constexpr auto kMinFrameLength = 64;
+  auto buf = folly::IOBuf::create(kMinFrameLength);
+  auto data = buf->writableData();
+  memset(data, 0, kMinFrameLength);
+  constexpr uint8_t kHeader[] = {
+      // Nearest bridge group address
+      0x01, 0x80, 0xc2, 0x00, 0x00, 0x0e,
+      // Source MAC
+      0xfa, 0xce, 0xb0, 0x00, 0x00, 0x0d,
+      // LLDP
+      0x88, 0xcc};
+  memcpy(data, kHeader, sizeof(kHeader));
+  buf->append(kMinFrameLength);
+  return std::make_unique<BenchmarkRxPacket>(std::move(buf));
+}
+
+/*
+ * Feeds the packets trapped to the CPU through an RxPacketDispatcher
+ */
+class RxDispatchObserver : public HwSwitchEnsemble::HwSwitchEventObserverIf {
+ public:
+  explicit RxDispatchObserver(RxPacketDispatcher* dispatcher)
+      : dispatcher_(dispatcher) {}
+
+  void packetReceived(RxPacket* pkt) noexcept override {
+    auto copy = std::make_unique<BenchmarkRxPacket>(pkt);
+    auto cls = RxPacketDispatcher::classify(copy.get());
+    dispatcher_->dispatch(std::move(copy), cls);
+  }
+  void linkStateChanged(PortID /*port*/, bool /*up*/) override {}
+  void l2LearningUpdateReceived(
+      L2Entry /*l2Entry*/,
+      L2EntryUpdateType /*l2EntryUpdateType*/) override {}
+
+ private:
+  RxPacketDispatcher* dispatcher_;
+};
+
+} // namespace
+
 void runRxSlowPathBenchmark() {
   constexpr int kEcmpWidth = 1;
   auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
@@ -76,18 +157,61 @@ void runRxSlowPathBenchmark() {
       8001);
   hwSwitch->sendPacketSwitchedSync(std::move(txPacket));
 
+  /*
+   * Dispatch the flood of trapped packets, with control packets mixed in at
+   * a steady rate, to measure how long control packets wait to be handled
+   */
+  RxPacketDispatcher dispatcher(
+      [](std::unique_ptr<RxPacket> /*pkt*/) {
+        auto end = std::chrono::steady_clock::now() +
+            std::chrono::microseconds(FLAGS_dispatch_handling_usecs);
+        while (std::chrono::steady_clock::now() < end) {
+        }
+      },
+      FLAGS_dispatch_threads,
+      1024);
+  RxDispatchObserver dispatchObserver(&dispatcher);
+  ensemble->addHwEventObserver(&dispatchObserver);
+  std::atomic<bool> done{false};
+  std::thread controlSender([&dispatcher, &done]() {
+    auto interval = std::chrono::microseconds(
+        1000000 / std::max(FLAGS_control_pkts_per_sec, 1));
+    while (!done) {
+      dispatcher.dispatch(
+          makeControlPacket(), RxPacketDispatcher::PacketClass::CONTROL);
+      std::this_thread::sleep_for(interval);
+    }
+  });
+
   constexpr auto kBurnIntevalInSeconds = 5;
   // Let the packet flood warm up
   std::this_thread::sleep_for(std::chrono::seconds(kBurnIntevalInSeconds));
   constexpr uint8_t kCpuQueue = 0;
   auto [pktsBefore, bytesBefore] =
       utility::getCpuQueueOutPacketsAndBytes(hwSwitch, kCpuQueue);
+  auto controlBefore =
+      dispatcher.getStats(RxPacketDispatcher::PacketClass::CONTROL);
+  auto floodBefore =
+      dispatcher.getStats(RxPacketDispatcher::PacketClass::DEFAULT);
   auto timeBefore = std::chrono::steady_clock::now();
   CHECK_NE(pktsBefore, 0);
   std::this_thread::sleep_for(std::chrono::seconds(kBurnIntevalInSeconds));
   auto [pktsAfter, bytesAfter] =
       utility::getCpuQueueOutPacketsAndBytes(hwSwitch, kCpuQueue);
+  auto controlAfter =
+      dispatcher.getStats(RxPacketDispatcher::PacketClass::CONTROL);
+  auto floodAfter =
+      dispatcher.getStats(RxPacketDispatcher::PacketClass::DEFAULT);
   auto timeAfter = std::chrono::steady_clock::now();
+  done = true;
+  controlSender.join();
+  ensemble->removeHwEventObserver(&dispatchObserver);
+
+  auto controlHandled = controlAfter.handled - controlBefore.handled;
+  uint64_t controlAvgLatencyUsecs = controlHandled
+      ? (controlAfter.totalLatencyUsecs - controlBefore.totalLatencyUsecs) /
+          controlHandled
+      : 0;
   std::chrono::duration<double, std::milli> durationMillseconds =
       timeAfter - timeBefore;
   uint32_t pps = (static_cast<double>(pktsAfter - pktsBefore) /
@@ -101,11 +225,21 @@ void runRxSlowPathBenchmark() {
     folly::dynamic cpuRxRateJson = folly::dynamic::object;
     cpuRxRateJson["cpu_rx_pps"] = pps;
     cpuRxRateJson["cpu_rx_bytes_per_sec"] = bytesPerSec;
+    cpuRxRateJson["control_avg_latency_usecs"] = controlAvgLatencyUsecs;
+    cpuRxRateJson["control_max_latency_usecs"] = controlAfter.maxLatencyUsecs;
+    cpuRxRateJson["control_drops"] =
+        controlAfter.dropped - controlBefore.dropped;
+    cpuRxRateJson["flood_drops"] = floodAfter.dropped - floodBefore.dropped;
     std::cout << toPrettyJson(cpuRxRateJson) << std::endl;
   } else {
     XLOG(INFO) << " Pkts before: " << pktsBefore << " Pkts after: " << pktsAfter
                << " interval ms: " << durationMillseconds.count()
-               << " pps: " << pps << " bytes per sec: " << bytesPerSec;
+               << " pps: " << pps << " bytes per sec: " << bytesPerSec
+               << " control avg latency usecs: " << controlAvgLatencyUsecs
+               << " control max latency usecs: "
+               << controlAfter.maxLatencyUsecs << " control drops: "
+               << controlAfter.dropped - controlBefore.dropped
+               << " flood drops: " << floodAfter.dropped - floodBefore.dropped;
   }
 }
 } // namespace facebook::fboss
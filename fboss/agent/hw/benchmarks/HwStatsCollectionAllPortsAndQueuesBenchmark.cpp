@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/Platform.h"
+#include "fboss/agent/hw/benchmarks/HwStatsCollectionBenchmarkHelper.h"
+#include "fboss/agent/hw/test/ConfigFactory.h"
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+#include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
+
+#include <folly/Benchmark.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::fboss {
+
+/*
+ * Same as HwStatsCollection, but with every port of the port groups broken
+ * out, up to 128 ports (all of them on fake SAI), each with its default
+ * queues. This is dominated by the cost of reading port and queue counters,
+ * rather than by the fixed per collection overhead.
+ */
+BENCHMARK_COUNTERS(HwStatsCollectionAllPortsAndQueues, counters) {
+  folly::BenchmarkSuspender suspender;
+  auto ensemble = createHwEnsemble({HwSwitchEnsemble::LINKSCAN});
+  auto hwSwitch = ensemble->getHwSwitch();
+  constexpr size_t kMaxPorts = 128;
+  std::vector<PortID> ports;
+  std::vector<std::vector<PortID>> portGroups;
+  for (auto masterPort : ensemble->masterLogicalPortIds()) {
+    auto group = ensemble->getAllPortsInGroup(masterPort);
+    if (ports.size() + group.size() > kMaxPorts) {
+      break;
+    }
+    ports.insert(ports.end(), group.begin(), group.end());
+    portGroups.push_back(std::move(group));
+  }
+  auto config = utility::onePortPerVlanConfig(hwSwitch, ports);
+  for (const auto& group : portGroups) {
+    utility::configurePortGroup(
+        *hwSwitch, config, cfg::PortSpeed::TWENTYFIVEG, group);
+  }
+  XLOG(INFO) << "Collecting stats of " << ports.size() << " ports";
+  utility::statsCollectionBenchmarkHelper(
+      ensemble.get(), config, counters, suspender);
+}
+
+} // namespace facebook::fboss
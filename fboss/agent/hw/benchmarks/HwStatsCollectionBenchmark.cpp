@@ -9,7 +9,7 @@
  */
 
 #include "fboss/agent/Platform.h"
-#include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/hw/benchmarks/HwStatsCollectionBenchmarkHelper.h"
 #include "fboss/agent/hw/test/ConfigFactory.h"
 #include "fboss/agent/hw/test/HwSwitchEnsemble.h"
 #include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
@@ -20,18 +20,9 @@
 namespace facebook::fboss {
 
 /*
- * Collect stats 10K times and benchmark that.
- * Using a fixed number rather than letting framework
- * pick a N for internal iteration, since
- * - We want a large enough number to notice any memory bloat
- *   in this code path. Relying on the framework to pick a large
- *   enough iteration for us is dicey
- * - Comparing 10K iterations of 2 versions of code seems sufficient
- *   for us. Having the framework be aware that we are doing internal
- *   iteration (by letting it pick number of iterations), and calculating
- *   cost of a single iterations does not seem to have more fidelity
+ * Collect stats of up to 48 ports, see statsCollectionBenchmarkHelper.
  */
-BENCHMARK(HwStatsCollection) {
+BENCHMARK_COUNTERS(HwStatsCollection, counters) {
   folly::BenchmarkSuspender suspender;
   auto ensemble = createHwEnsemble({HwSwitchEnsemble::LINKSCAN});
   auto hwSwitch = ensemble->getHwSwitch();
@@ -42,13 +33,8 @@ BENCHMARK(HwStatsCollection) {
   int numPortsToCollectStats = 48;
   ports.resize(std::min((int)ports.size(), numPortsToCollectStats));
   auto config = utility::onePortPerVlanConfig(hwSwitch, ports);
-  ensemble->applyInitialConfig(config);
-  SwitchStats dummy;
-  suspender.dismiss();
-  for (auto i = 0; i < 10'000; ++i) {
-    hwSwitch->updateStats(&dummy);
-  }
-  suspender.rehire();
+  utility::statsCollectionBenchmarkHelper(
+      ensemble.get(), config, counters, suspender);
 }
 
 } // namespace facebook::fboss
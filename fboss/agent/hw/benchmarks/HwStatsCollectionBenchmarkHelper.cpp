@@ -0,0 +1,49 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/benchmarks/HwStatsCollectionBenchmarkHelper.h"
+#include "fboss/agent/SwitchStats.h"
+
+#include <sys/resource.h>
+
+namespace facebook::fboss::utility {
+
+namespace {
+constexpr int kNumCollections = 10'000;
+
+int64_t cpuTimeUsec() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  auto toUsec = [](const timeval& tv) {
+    return int64_t(tv.tv_sec) * 1'000'000 + tv.tv_usec;
+  };
+  return toUsec(usage.ru_utime) + toUsec(usage.ru_stime);
+}
+} // namespace
+
+void statsCollectionBenchmarkHelper(
+    HwSwitchEnsemble* ensemble,
+    const cfg::SwitchConfig& config,
+    folly::UserCounters& counters,
+    folly::BenchmarkSuspender& suspender) {
+  auto hwSwitch = ensemble->getHwSwitch();
+  ensemble->applyInitialConfig(config);
+  SwitchStats dummy;
+  auto cpuTimeBefore = cpuTimeUsec();
+  suspender.dismiss();
+  for (auto i = 0; i < kNumCollections; ++i) {
+    hwSwitch->updateStats(&dummy);
+  }
+  suspender.rehire();
+  counters["cpu_usec_per_collection"] =
+      (cpuTimeUsec() - cpuTimeBefore) / kNumCollections;
+}
+
+} // namespace facebook::fboss::utility
@@ -0,0 +1,41 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include "fboss/agent/hw/test/HwSwitchEnsemble.h"
+
+#include <folly/Benchmark.h>
+#include "fboss/agent/gen-cpp2/switch_config_types.h"
+
+namespace facebook::fboss::utility {
+
+/*
+ * Apply config, then collect stats 10K times and benchmark that.
+ * Using a fixed number rather than letting framework
+ * pick a N for internal iteration, since
+ * - We want a large enough number to notice any memory bloat
+ *   in this code path. Relying on the framework to pick a large
+ *   enough iteration for us is dicey
+ * - Comparing 10K iterations of 2 versions of code seems sufficient
+ *   for us. Having the framework be aware that we are doing internal
+ *   iteration (by letting it pick number of iterations), and calculating
+ *   cost of a single iterations does not seem to have more fidelity
+ *
+ * Also reports the CPU time spent per collection, in the
+ * cpu_usec_per_collection counter.
+ */
+void statsCollectionBenchmarkHelper(
+    HwSwitchEnsemble* ensemble,
+    const cfg::SwitchConfig& config,
+    folly::UserCounters& counters,
+    folly::BenchmarkSuspender& suspender);
+
+} // namespace facebook::fboss::utility
@@ -8,14 +8,17 @@
  *
  */
 
+#include "fboss/agent/Constants.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/Utils.h"
+#include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
 #include "fboss/agent/hw/test/ConfigFactory.h"
 #include "fboss/agent/hw/test/HwSwitchEnsemble.h"
 #include "fboss/agent/hw/test/HwSwitchEnsembleFactory.h"
 #include "fboss/agent/hw/test/HwSwitchEnsembleRouteUpdateWrapper.h"
 #include "fboss/agent/hw/test/HwTestPacketUtils.h"
 #include "fboss/agent/platforms/common/PlatformProductInfo.h"
+#include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/EcmpSetupHelper.h"
 #include "fboss/agent/test/RouteScaleGenerators.h"
 
@@ -23,6 +26,7 @@
 #include <folly/dynamic.h>
 #include <folly/init/Init.h>
 #include <folly/json.h>
+#include <folly/logging/xlog.h>
 
 #include <chrono>
 #include <iostream>
@@ -35,6 +39,41 @@ DEFINE_bool(
 
 namespace facebook::fboss {
 
+/*
+ * Time encoding the warm boot switch state as JSON and as compact thrift,
+ * and decoding it back, as HwSwitchWarmBootHelper does on exit and on
+ * warm boot.
+ */
+void benchmarkWarmBootStateEncoding(const folly::dynamic& switchState) {
+  std::string json;
+  {
+    StopWatch timer("json_serialize_msecs", FLAGS_json);
+    json = toPrettyJson(switchState);
+  }
+  {
+    StopWatch timer("json_deserialize_msecs", FLAGS_json);
+    folly::parseJson(json);
+  }
+  std::string thrift;
+  {
+    StopWatch timer("thrift_serialize_msecs", FLAGS_json);
+    thrift = serializeWarmBootStateThrift(switchState);
+  }
+  {
+    StopWatch timer("thrift_deserialize_msecs", FLAGS_json);
+    deserializeWarmBootStateThrift(thrift);
+  }
+  if (FLAGS_json) {
+    folly::dynamic sizes = folly::dynamic::object;
+    sizes["json_bytes"] = json.size();
+    sizes["thrift_bytes"] = thrift.size();
+    std::cout << toPrettyJson(sizes) << std::endl;
+  } else {
+    XLOG(INFO) << "json_bytes : " << json.size()
+               << " thrift_bytes : " << thrift.size();
+  }
+}
+
 void runBenchmark() {
   auto ensemble = createHwEnsemble(HwSwitchEnsemble::getAllFeatures());
   auto hwSwitch = ensemble->getHwSwitch();
@@ -80,7 +119,9 @@ void runBenchmark() {
   }
   auto updater = ensemble->getRouteUpdater();
   updater.programRoutes(RouterID(0), ClientID::BGPD, routeChunks);
-  // Static such that the object destructor runs as late as possible. In
+  folly::dynamic switchState = folly::dynamic::object;
+  switchState[kSwSwitch] = ensemble->getProgrammedState()->toFollyDynamic();
+  benchmarkWarmBootStateEncoding(switchState);
   // Static such that the object destructor runs as late as possible. In
   // particular in this case, destructor (and thus the duration calculation)
   // will run at the time of program exit when static variable destructors run
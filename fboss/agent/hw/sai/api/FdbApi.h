@@ -105,6 +105,7 @@ struct IsSaiEntryStruct<SaiFdbTraits::FdbEntry> : public std::true_type {};
 class FdbApi : public SaiApi<FdbApi> {
  public:
   static constexpr sai_api_t ApiType = SAI_API_FDB;
+  using BulkWriteTraits = SaiFdbTraits;
   FdbApi() {
     sai_status_t status =
         sai_api_query(ApiType, reinterpret_cast<void**>(&api_));
@@ -132,7 +133,54 @@ class FdbApi : public SaiApi<FdbApi> {
     return api_->set_fdb_entry_attribute(fdbEntry.entry(), attr);
   }
 
+  sai_status_t _bulkCreate(
+      const std::vector<SaiFdbTraits::FdbEntry>& keys,
+      const uint32_t* attrCounts,
+      const sai_attribute_t** attrLists,
+      sai_status_t* statuses) {
+    if (!api_->create_fdb_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    auto entries = saiEntries<sai_fdb_entry_t>(keys);
+    return api_->create_fdb_entries(
+        entries.size(),
+        entries.data(),
+        attrCounts,
+        attrLists,
+        SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+        statuses);
+  }
+  sai_status_t _bulkRemove(
+      const std::vector<SaiFdbTraits::FdbEntry>& keys,
+      sai_status_t* statuses) {
+    if (!api_->remove_fdb_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    auto entries = saiEntries<sai_fdb_entry_t>(keys);
+    return api_->remove_fdb_entries(
+        entries.size(),
+        entries.data(),
+        SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+        statuses);
+  }
+  sai_status_t _bulkSetAttribute(
+      const std::vector<SaiFdbTraits::FdbEntry>& keys,
+      const sai_attribute_t* attrs,
+      sai_status_t* statuses) {
+    if (!api_->set_fdb_entries_attribute) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    auto entries = saiEntries<sai_fdb_entry_t>(keys);
+    return api_->set_fdb_entries_attribute(
+        entries.size(),
+        entries.data(),
+        attrs,
+        SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+        statuses);
+  }
+
   sai_fdb_api_t* api_;
+  SaiBulkWriteQueue<SaiFdbTraits> bulkWrites_;
   friend class SaiApi<FdbApi>;
 };
 
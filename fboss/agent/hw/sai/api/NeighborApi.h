@@ -15,6 +15,7 @@
 #include "fboss/agent/hw/sai/api/SaiAttribute.h"
 #include "fboss/agent/hw/sai/api/SaiAttributeDataTypes.h"
 #include "fboss/agent/hw/sai/api/SaiDefaultAttributeValues.h"
+#include "fboss/agent/hw/sai/api/SaiVersion.h"
 
 #include <folly/IPAddress.h>
 #include <folly/MacAddress.h>
@@ -106,6 +107,7 @@ struct IsSaiEntryStruct<SaiNeighborTraits::NeighborEntry>
 class NeighborApi : public SaiApi<NeighborApi> {
  public:
   static constexpr sai_api_t ApiType = SAI_API_NEIGHBOR;
+  using BulkWriteTraits = SaiNeighborTraits;
   NeighborApi() {
     sai_status_t status =
         sai_api_query(ApiType, reinterpret_cast<void**>(&api_));
@@ -133,7 +135,60 @@ class NeighborApi : public SaiApi<NeighborApi> {
     return api_->set_neighbor_entry_attribute(neighborEntry.entry(), attr);
   }
 
+  sai_status_t _bulkCreate(
+      const std::vector<SaiNeighborTraits::NeighborEntry>& keys,
+      const uint32_t* attrCounts,
+      const sai_attribute_t** attrLists,
+      sai_status_t* statuses) {
+#if SAI_API_VERSION >= SAI_VERSION(1, 8, 0)
+    if (api_->create_neighbor_entries) {
+      auto entries = saiEntries<sai_neighbor_entry_t>(keys);
+      return api_->create_neighbor_entries(
+          entries.size(),
+          entries.data(),
+          attrCounts,
+          attrLists,
+          SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+          statuses);
+    }
+#endif
+    return SAI_STATUS_NOT_IMPLEMENTED;
+  }
+  sai_status_t _bulkRemove(
+      const std::vector<SaiNeighborTraits::NeighborEntry>& keys,
+      sai_status_t* statuses) {
+#if SAI_API_VERSION >= SAI_VERSION(1, 8, 0)
+    if (api_->remove_neighbor_entries) {
+      auto entries = saiEntries<sai_neighbor_entry_t>(keys);
+      return api_->remove_neighbor_entries(
+          entries.size(),
+          entries.data(),
+          SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+          statuses);
+    }
+#endif
+    return SAI_STATUS_NOT_IMPLEMENTED;
+  }
+  sai_status_t _bulkSetAttribute(
+      const std::vector<SaiNeighborTraits::NeighborEntry>& keys,
+      const sai_attribute_t* attrs,
+      sai_status_t* statuses) {
+#if SAI_API_VERSION >= SAI_VERSION(1, 8, 0)
+    if (api_->set_neighbor_entries_attribute) {
+      auto entries = saiEntries<sai_neighbor_entry_t>(keys);
+      return api_->set_neighbor_entries_attribute(
+          entries.size(),
+          entries.data(),
+          attrs,
+          SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+          statuses);
+    }
+#endif
+    return SAI_STATUS_NOT_IMPLEMENTED;
+  }
+
   sai_neighbor_api_t* api_;
+  SaiBulkWriteQueue<SaiNeighborTraits> bulkWrites_;
   friend class SaiApi<NeighborApi>;
 };
 
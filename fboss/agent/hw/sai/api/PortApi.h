@@ -386,6 +386,7 @@ SAI_ATTRIBUTE_NAME(PortConnector, SystemSidePortId);
 class PortApi : public SaiApi<PortApi> {
  public:
   static constexpr sai_api_t ApiType = SAI_API_PORT;
+  using BulkStatsTraits = SaiPortTraits;
   PortApi() {
     sai_status_t status =
         sai_api_query(ApiType, reinterpret_cast<void**>(&api_));
@@ -472,6 +473,25 @@ class PortApi : public SaiApi<PortApi> {
               key, num_of_counters, counter_ids, mode, counters);
   }
 
+  sai_status_t _bulkGetStats(
+      sai_object_id_t switch_id,
+      const std::vector<PortSaiId>& keys,
+      uint32_t num_of_counters,
+      const sai_stat_id_t* counter_ids,
+      sai_stats_mode_t mode,
+      sai_status_t* object_statuses,
+      uint64_t* counters) const {
+    return saiBulkObjectGetStats(
+        switch_id,
+        SAI_OBJECT_TYPE_PORT,
+        keys,
+        num_of_counters,
+        counter_ids,
+        mode,
+        object_statuses,
+        counters);
+  }
+
   sai_status_t _clearStats(
       PortSaiId key,
       uint32_t num_of_counters,
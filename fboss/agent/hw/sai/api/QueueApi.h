@@ -99,6 +99,7 @@ struct SaiObjectHasStats<SaiQueueTraits> : public std::true_type {};
 class QueueApi : public SaiApi<QueueApi> {
  public:
   static constexpr sai_api_t ApiType = SAI_API_QUEUE;
+  using BulkStatsTraits = SaiQueueTraits;
   QueueApi() {
     sai_status_t status =
         sai_api_query(ApiType, reinterpret_cast<void**>(&api_));
@@ -141,6 +142,25 @@ class QueueApi : public SaiApi<QueueApi> {
               key, num_of_counters, counter_ids, mode, counters);
   }
 
+  sai_status_t _bulkGetStats(
+      sai_object_id_t switch_id,
+      const std::vector<QueueSaiId>& keys,
+      uint32_t num_of_counters,
+      const sai_stat_id_t* counter_ids,
+      sai_stats_mode_t mode,
+      sai_status_t* object_statuses,
+      uint64_t* counters) const {
+    return saiBulkObjectGetStats(
+        switch_id,
+        SAI_OBJECT_TYPE_QUEUE,
+        keys,
+        num_of_counters,
+        counter_ids,
+        mode,
+        object_statuses,
+        counters);
+  }
+
   sai_status_t _clearStats(
       QueueSaiId key,
       uint32_t num_of_counters,
@@ -103,6 +103,7 @@ SAI_ATTRIBUTE_NAME(Route, Metadata)
 class RouteApi : public SaiApi<RouteApi> {
  public:
   static constexpr sai_api_t ApiType = SAI_API_ROUTE;
+  using BulkWriteTraits = SaiRouteTraits;
   RouteApi() {
     sai_status_t status =
         sai_api_query(ApiType, reinterpret_cast<void**>(&api_));
@@ -130,7 +131,54 @@ class RouteApi : public SaiApi<RouteApi> {
     return api_->set_route_entry_attribute(routeEntry.entry(), attr);
   }
 
+  sai_status_t _bulkCreate(
+      const std::vector<SaiRouteTraits::RouteEntry>& keys,
+      const uint32_t* attrCounts,
+      const sai_attribute_t** attrLists,
+      sai_status_t* statuses) {
+    if (!api_->create_route_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    auto entries = saiEntries<sai_route_entry_t>(keys);
+    return api_->create_route_entries(
+        entries.size(),
+        entries.data(),
+        attrCounts,
+        attrLists,
+        SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+        statuses);
+  }
+  sai_status_t _bulkRemove(
+      const std::vector<SaiRouteTraits::RouteEntry>& keys,
+      sai_status_t* statuses) {
+    if (!api_->remove_route_entries) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    auto entries = saiEntries<sai_route_entry_t>(keys);
+    return api_->remove_route_entries(
+        entries.size(),
+        entries.data(),
+        SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+        statuses);
+  }
+  sai_status_t _bulkSetAttribute(
+      const std::vector<SaiRouteTraits::RouteEntry>& keys,
+      const sai_attribute_t* attrs,
+      sai_status_t* statuses) {
+    if (!api_->set_route_entries_attribute) {
+      return SAI_STATUS_NOT_IMPLEMENTED;
+    }
+    auto entries = saiEntries<sai_route_entry_t>(keys);
+    return api_->set_route_entries_attribute(
+        entries.size(),
+        entries.data(),
+        attrs,
+        SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+        statuses);
+  }
+
   sai_route_api_t* api_;
+  SaiBulkWriteQueue<SaiRouteTraits> bulkWrites_;
   friend class SaiApi<RouteApi>;
 };
 
@@ -12,6 +12,8 @@
 #include "fboss/agent/hw/sai/api/LoggingUtil.h"
 #include "fboss/agent/hw/sai/api/SaiApiError.h"
 #include "fboss/agent/hw/sai/api/SaiApiLock.h"
+#include "fboss/agent/hw/sai/api/SaiBulkWrites.h"
+#include "fboss/agent/hw/sai/api/SaiVersion.h"
 #include "fboss/agent/hw/sai/api/SaiAttribute.h"
 #include "fboss/agent/hw/sai/api/SaiAttributeDataTypes.h"
 #include "fboss/agent/hw/sai/api/Traits.h"
@@ -19,6 +21,7 @@
 #include "fboss/lib/TupleUtils.h"
 
 #include <folly/Format.h>
+#include <folly/ScopeGuard.h>
 #include <folly/logging/xlog.h>
 
 #include <algorithm>
@@ -38,8 +41,86 @@ namespace facebook::fboss {
 
 enum class HwWriteBehavior : int { FAIL, SKIP, WRITE };
 
+/*
+ * Apis whose adapter may implement sai_bulk_* calls for their entry struct
+ * objects declare the traits of those objects as BulkWriteTraits, and
+ * provide a SaiBulkWriteQueue<BulkWriteTraits> bulkWrites_ along with
+ * _bulkCreate, _bulkRemove and _bulkSetAttribute. None of these objects
+ * have stats, so getStats does not flush queued writes.
+ */
+template <typename ApiT, typename = void>
+struct ApiHasBulkWrites : std::false_type {};
+
+template <typename ApiT>
+struct ApiHasBulkWrites<ApiT, std::void_t<typename ApiT::BulkWriteTraits>>
+    : std::true_type {};
+
+/*
+ * Copy the sai entry structs out of a vector of entry struct AdapterKeys,
+ * as the sai_bulk_* calls take an array of them.
+ */
+template <typename SaiEntryT, typename AdapterKeyT>
+std::vector<SaiEntryT> saiEntries(const std::vector<AdapterKeyT>& keys) {
+  std::vector<SaiEntryT> entries;
+  entries.reserve(keys.size());
+  for (const auto& key : keys) {
+    entries.push_back(*key.entry());
+  }
+  return entries;
+}
+
+/*
+ * Apis whose objects' stats the adapter may read for many objects in one
+ * sai_bulk_object_get_stats call declare the traits of those objects as
+ * BulkStatsTraits, and provide _bulkGetStats (see saiBulkObjectGetStats).
+ */
+template <typename ApiT, typename = void>
+struct ApiHasBulkStats : std::false_type {};
+
 template <typename ApiT>
-class SaiApi {
+struct ApiHasBulkStats<ApiT, std::void_t<typename ApiT::BulkStatsTraits>>
+    : std::true_type {};
+
+/*
+ * Read the stats of objects of one type in a single call. The bulk stats
+ * call only exists from SAI 1.9 on, older adapters read object by object.
+ */
+template <typename AdapterKeyT>
+sai_status_t saiBulkObjectGetStats(
+    sai_object_id_t switchId,
+    sai_object_type_t objectType,
+    const std::vector<AdapterKeyT>& keys,
+    uint32_t numCounters,
+    const sai_stat_id_t* counterIds,
+    sai_stats_mode_t mode,
+    sai_status_t* statuses,
+    uint64_t* counters) {
+#if SAI_API_VERSION >= SAI_VERSION(1, 9, 0)
+  std::vector<sai_object_key_t> objectKeys(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    objectKeys[i].key.object_id = keys[i];
+  }
+  return sai_bulk_object_get_stats(
+      switchId,
+      objectType,
+      objectKeys.size(),
+      objectKeys.data(),
+      numCounters,
+      counterIds,
+      mode,
+      statuses,
+      counters);
+#else
+  return SAI_STATUS_NOT_IMPLEMENTED;
+#endif
+}
+
+template <typename ApiT>
+using BulkWriteOp =
+    typename SaiBulkWriteQueue<typename ApiT::BulkWriteTraits>::Op;
+
+template <typename ApiT>
+class SaiApi : public SaiBulkWriterIf {
  public:
   virtual ~SaiApi() = default;
   SaiApi() = default;
@@ -86,7 +167,8 @@ class SaiApi {
           "Attempting create SAI obj with {}, while hw writes are blocked",
           createAttributes);
     }
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    SaiBulkWriteScope::flushQueuedUnless(this);
+    std::lock_guard<std::mutex> g{apiLock()};
     sai_status_t status;
     {
       TIME_CALL;
@@ -114,14 +196,25 @@ class SaiApi {
     if (UNLIKELY(skipHwWrites())) {
       return;
     }
-    std::vector<sai_attribute_t> saiAttributeTs = saiAttrs(createAttributes);
     if (UNLIKELY(failHwWrites())) {
       XLOGF(
           FATAL,
           "Attempting create SAI obj with {}, while hw writes are blocked",
           createAttributes);
     }
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    SaiBulkWriteScope::flushQueuedUnless(this);
+    std::lock_guard<std::mutex> g{apiLock()};
+    if constexpr (ApiHasBulkWrites<ApiT>::value) {
+      if (auto* queue = bulkWriteQueueLocked(BulkWriteOp<ApiT>::CREATE)) {
+        queue->entries.push_back(entry);
+        queue->createAttributes.push_back(createAttributes);
+        XLOGF(DBG5, "queued create of SAI object: {}", entry);
+        flushFullBulkWriteQueueLocked();
+        return;
+      }
+    }
+    flushOwnBulkWritesLocked();
+    std::vector<sai_attribute_t> saiAttributeTs = saiAttrs(createAttributes);
     sai_status_t status;
     {
       TIME_CALL;
@@ -136,8 +229,14 @@ class SaiApi {
     XLOGF(DBG5, "created SAI object: {}: {}", entry, createAttributes);
   }
 
+  /*
+   * Removes of entry struct objects may be queued for a bulk call (see
+   * SaiBulkWriteScope), in which case errors are only thrown once the
+   * queue is flushed. Callers that need to handle errors of this remove
+   * themselves should pass allowBulk = false.
+   */
   template <typename AdapterKeyT>
-  void remove(const AdapterKeyT& key) {
+  void remove(const AdapterKeyT& key, bool allowBulk = true) {
     if (UNLIKELY(skipHwWrites())) {
       return;
     }
@@ -147,7 +246,24 @@ class SaiApi {
           "Attempting to remove SAI obj {} while hw writes are blocked",
           key);
     }
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    SaiBulkWriteScope::flushQueuedUnless(this);
+    std::lock_guard<std::mutex> g{apiLock()};
+    if constexpr (ApiHasBulkWrites<ApiT>::value) {
+      if constexpr (std::is_same_v<
+                        AdapterKeyT,
+                        typename ApiT::BulkWriteTraits::AdapterKey>) {
+        auto* queue =
+            allowBulk ? bulkWriteQueueLocked(BulkWriteOp<ApiT>::REMOVE)
+                      : nullptr;
+        if (queue) {
+          queue->entries.push_back(key);
+          XLOGF(DBG5, "queued remove of SAI object: {}", key);
+          flushFullBulkWriteQueueLocked();
+          return;
+        }
+      }
+    }
+    flushOwnBulkWritesLocked();
     sai_status_t status;
     {
       TIME_CALL;
@@ -181,7 +297,8 @@ class SaiApi {
         IsSaiAttribute<typename std::remove_reference<AttrT>::type>::value,
         "getAttribute must be called on a SaiAttribute or supported "
         "collection of SaiAttributes");
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    std::lock_guard<std::mutex> g{apiLock()};
+    flushOwnBulkWritesLocked();
     sai_status_t status;
     {
       TIME_CALL;
@@ -308,6 +425,23 @@ class SaiApi {
             key);
       }
     }
+    if constexpr (ApiHasBulkWrites<ApiT>::value) {
+      if constexpr (
+          std::is_same_v<
+              AdapterKeyT,
+              typename ApiT::BulkWriteTraits::AdapterKey> &&
+          !IsSaiExtensionAttribute<AttrT>::value &&
+          !IsVector<typename AttrT::ValueType>::value) {
+        if (auto* queue = bulkWriteQueueLocked(BulkWriteOp<ApiT>::SET)) {
+          queue->entries.push_back(key);
+          queue->setAttributes.push_back(*saiAttr(attr));
+          XLOGF(DBG5, "queued set of SAI attribute of {} to {}", key, attr);
+          flushFullBulkWriteQueueLocked();
+          return;
+        }
+      }
+    }
+    flushOwnBulkWritesLocked();
     sai_status_t status;
     {
       TIME_CALL;
@@ -321,7 +455,8 @@ class SaiApi {
   }
   template <typename AdapterKeyT, typename AttrT>
   void setAttribute(const AdapterKeyT& key, const AttrT& attr) {
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    SaiBulkWriteScope::flushQueuedUnless(this);
+    std::lock_guard<std::mutex> g{apiLock()};
     setAttributeUnlocked(key, attr);
   }
 
@@ -333,7 +468,7 @@ class SaiApi {
     static_assert(
         SaiObjectHasStats<SaiObjectTraits>::value,
         "getStats only supported for Sai objects with stats");
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    std::lock_guard<std::mutex> g{apiLock()};
     return getStatsImpl<SaiObjectTraits>(
         key, counterIds.data(), counterIds.size(), mode);
   }
@@ -344,7 +479,7 @@ class SaiApi {
     static_assert(
         SaiObjectHasStats<SaiObjectTraits>::value,
         "getStats only supported for Sai objects with stats");
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    std::lock_guard<std::mutex> g{apiLock()};
     XLOGF(DBG6, "got SAI stats for {}", key);
     return mode == SAI_STATS_MODE_READ
         ? getStatsImpl<SaiObjectTraits>(
@@ -359,6 +494,82 @@ class SaiApi {
               mode);
   }
 
+  /*
+   * The stats of many objects of one type, read with one bulk call where the
+   * adapter supports it and object by object otherwise. Object by object, the
+   * api lock is taken for each read only, so that other calls on this api are
+   * not held up behind the whole set. The counters of keys[i] start at
+   * counters[i * counterIds.size()].
+   */
+  template <typename SaiObjectTraits>
+  std::vector<uint64_t> bulkGetStats(
+      sai_object_id_t switchId,
+      const std::vector<typename SaiObjectTraits::AdapterKey>& keys,
+      const std::vector<sai_stat_id_t>& counterIds,
+      sai_stats_mode_t mode) const {
+    static_assert(
+        SaiObjectHasStats<SaiObjectTraits>::value,
+        "bulkGetStats only supported for Sai objects with stats");
+    std::vector<uint64_t> counters(keys.size() * counterIds.size());
+    if (counters.empty()) {
+      return counters;
+    }
+    if constexpr (ApiHasBulkStats<ApiT>::value) {
+      std::lock_guard<std::mutex> g{apiLock()};
+      if (bulkStatsSupported_) {
+        std::vector<sai_status_t> statuses(
+            keys.size(), SAI_STATUS_NOT_EXECUTED);
+        sai_status_t status;
+        {
+          TIME_CALL;
+          status = impl()._bulkGetStats(
+              switchId,
+              keys,
+              counterIds.size(),
+              counterIds.data(),
+              mode,
+              statuses.data(),
+              counters.data());
+        }
+        if (status != SAI_STATUS_NOT_IMPLEMENTED &&
+            status != SAI_STATUS_NOT_SUPPORTED) {
+          for (size_t i = 0; i < statuses.size(); ++i) {
+            if (statuses[i] != SAI_STATUS_SUCCESS) {
+              saiApiCheckError(
+                  statuses[i],
+                  apiType(),
+                  fmt::format("Failed to get stats {}", keys[i]));
+            }
+          }
+          saiApiCheckError(status, apiType(), "Failed to get bulk stats");
+          return counters;
+        }
+        XLOGF(
+            INFO,
+            "{} api does not support bulk stats, falling back to "
+            "reading stats one object at a time",
+            saiApiTypeToString(apiType()));
+        bulkStatsSupported_ = false;
+      }
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+      sai_status_t status;
+      {
+        std::lock_guard<std::mutex> g{apiLock()};
+        TIME_CALL;
+        status = impl()._getStats(
+            keys[i],
+            counterIds.size(),
+            counterIds.data(),
+            mode,
+            counters.data() + i * counterIds.size());
+      }
+      saiApiCheckError(
+          status, apiType(), fmt::format("Failed to get stats {}", keys[i]));
+    }
+    return counters;
+  }
+
   template <typename SaiObjectTraits>
   void clearStats(
       const typename SaiObjectTraits::AdapterKey& key,
@@ -366,7 +577,8 @@ class SaiApi {
     static_assert(
         SaiObjectHasStats<SaiObjectTraits>::value,
         "clearStats only supported for Sai objects with stats");
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    SaiBulkWriteScope::flushQueuedUnless(this);
+    std::lock_guard<std::mutex> g{apiLock()};
     clearStatsImpl<SaiObjectTraits>(key, counterIds.data(), counterIds.size());
   }
   template <typename SaiObjectTraits>
@@ -374,7 +586,8 @@ class SaiApi {
     static_assert(
         SaiObjectHasStats<SaiObjectTraits>::value,
         "clearStats only supported for Sai objects with stats");
-    std::lock_guard<std::mutex> g{SaiApiLock::getInstance()->lock};
+    SaiBulkWriteScope::flushQueuedUnless(this);
+    std::lock_guard<std::mutex> g{apiLock()};
     clearStatsImpl<SaiObjectTraits>(
         key,
         SaiObjectTraits::CounterIdsToRead.data(),
@@ -388,7 +601,176 @@ class SaiApi {
     return ApiT::ApiType;
   }
 
+  void flushBulkWrites() override {
+    std::lock_guard<std::mutex> g{apiLock()};
+    flushBulkWritesLocked();
+  }
+
  private:
+  std::mutex& apiLock() const {
+    return SaiApiLock::getInstance()->lockFor(ApiT::ApiType);
+  }
+
+  void flushOwnBulkWritesLocked() {
+    if (SaiBulkWriteScope::takeQueued(this)) {
+      flushBulkWritesLocked();
+    }
+  }
+
+  void flushBulkWritesLocked() {
+    if constexpr (ApiHasBulkWrites<ApiT>::value) {
+      auto& queue = impl().bulkWrites_;
+      if (queue.empty()) {
+        return;
+      }
+      SCOPE_EXIT {
+        queue.clear();
+      };
+      std::vector<sai_status_t> statuses(
+          queue.entries.size(), SAI_STATUS_NOT_EXECUTED);
+      sai_status_t status = SAI_STATUS_NOT_IMPLEMENTED;
+      if (queue.bulkSupported) {
+        TIME_CALL;
+        status = bulkWriteImpl(queue, statuses.data());
+      }
+      if (status == SAI_STATUS_NOT_IMPLEMENTED ||
+          status == SAI_STATUS_NOT_SUPPORTED) {
+        if (queue.bulkSupported) {
+          XLOGF(
+              INFO,
+              "{} api does not support bulk writes, falling back to "
+              "programming objects one at a time",
+              saiApiTypeToString(apiType()));
+          queue.bulkSupported = false;
+        }
+        writeOneByOneImpl(queue, statuses.data());
+        status = SAI_STATUS_SUCCESS;
+      }
+      // Report every failed write against its own object, rather than
+      // just the first one
+      std::vector<SaiBulkWriteError::Failure> failures;
+      for (size_t i = 0; i < statuses.size(); ++i) {
+        if (statuses[i] != SAI_STATUS_SUCCESS) {
+          failures.push_back(
+              {queue.op,
+               queue.entries[i].toFollyDynamic(),
+               bulkWriteDescription(queue, i),
+               statuses[i]});
+          saiLogError(
+              statuses[i], apiType(), "Failed ", failures.back().write);
+        }
+      }
+      if (!failures.empty()) {
+        throw SaiBulkWriteError(
+            apiType(), queue.entries.size(), std::move(failures));
+      }
+      saiApiCheckError(
+          status,
+          apiType(),
+          fmt::format("Failed bulk write of {} objects", queue.entries.size()));
+      XLOGF(
+          DBG5,
+          "programmed {} queued SAI {} writes",
+          queue.entries.size(),
+          saiApiTypeToString(apiType()));
+    }
+  }
+
+  /*
+   * The bulk write queue to add a write of kind op to, or nullptr if the
+   * write should be programmed right away. Called with SaiApiLock held.
+   */
+  template <typename OpT>
+  SaiBulkWriteQueue<typename ApiT::BulkWriteTraits>* bulkWriteQueueLocked(
+      OpT op) {
+    auto& queue = impl().bulkWrites_;
+    if (!SaiBulkWriteScope::active() || !queue.bulkSupported) {
+      return nullptr;
+    }
+    if (!queue.empty() && queue.op != op) {
+      flushBulkWritesLocked();
+    }
+    SaiBulkWriteScope::setQueued(this);
+    queue.op = op;
+    return &queue;
+  }
+
+  void flushFullBulkWriteQueueLocked() {
+    if (impl().bulkWrites_.entries.size() >=
+        static_cast<size_t>(FLAGS_sai_bulk_write_max_objects)) {
+      flushOwnBulkWritesLocked();
+    }
+  }
+
+  template <typename QueueT>
+  sai_status_t bulkWriteImpl(const QueueT& queue, sai_status_t* statuses) {
+    using Op = typename QueueT::Op;
+    switch (queue.op) {
+      case Op::CREATE: {
+        std::vector<std::vector<sai_attribute_t>> saiAttributeTs;
+        std::vector<uint32_t> attrCounts;
+        std::vector<const sai_attribute_t*> attrLists;
+        saiAttributeTs.reserve(queue.createAttributes.size());
+        for (const auto& createAttributes : queue.createAttributes) {
+          saiAttributeTs.push_back(saiAttrs(createAttributes));
+          attrCounts.push_back(saiAttributeTs.back().size());
+          attrLists.push_back(saiAttributeTs.back().data());
+        }
+        return impl()._bulkCreate(
+            queue.entries, attrCounts.data(), attrLists.data(), statuses);
+      }
+      case Op::REMOVE:
+        return impl()._bulkRemove(queue.entries, statuses);
+      case Op::SET:
+        return impl()._bulkSetAttribute(
+            queue.entries, queue.setAttributes.data(), statuses);
+    }
+    return SAI_STATUS_NOT_IMPLEMENTED;
+  }
+
+  template <typename QueueT>
+  void writeOneByOneImpl(const QueueT& queue, sai_status_t* statuses) {
+    using Op = typename QueueT::Op;
+    for (size_t i = 0; i < queue.entries.size(); ++i) {
+      TIME_CALL;
+      switch (queue.op) {
+        case Op::CREATE: {
+          auto saiAttributeTs = saiAttrs(queue.createAttributes[i]);
+          statuses[i] = impl()._create(
+              queue.entries[i], saiAttributeTs.size(), saiAttributeTs.data());
+          break;
+        }
+        case Op::REMOVE:
+          statuses[i] = impl()._remove(queue.entries[i]);
+          break;
+        case Op::SET:
+          statuses[i] = impl()._setAttribute(
+              queue.entries[i], &queue.setAttributes[i]);
+          break;
+      }
+    }
+  }
+
+  template <typename QueueT>
+  std::string bulkWriteDescription(const QueueT& queue, size_t index) const {
+    using Op = typename QueueT::Op;
+    switch (queue.op) {
+      case Op::CREATE:
+        return fmt::format(
+            "create of sai entity: {}: {}",
+            queue.entries[index],
+            queue.createAttributes[index]);
+      case Op::REMOVE:
+        return fmt::format("remove of sai object: {}", queue.entries[index]);
+      case Op::SET:
+        return fmt::format(
+            "set of attribute {} of {}",
+            queue.setAttributes[index].id,
+            queue.entries[index]);
+    }
+    return "";
+  }
+
   bool failHwWrites() const {
     return hwWriteBehavior_ == HwWriteBehavior::FAIL;
   }
@@ -446,6 +828,9 @@ class SaiApi {
     return static_cast<const ApiT&>(*this);
   }
   HwWriteBehavior hwWriteBehavior_{HwWriteBehavior::WRITE};
+  // Cleared once the adapter turns out not to implement bulk stats.
+  // Guarded by the api lock.
+  mutable bool bulkStatsSupported_{true};
 };
 
 } // namespace facebook::fboss
@@ -13,6 +13,12 @@
 #include <folly/Singleton.h>
 #include <mutex>
 
+DEFINE_bool(
+    sai_per_api_lock,
+    true,
+    "Serialize calls into the SAI adapter per api, rather than across all "
+    "apis with a single lock");
+
 namespace {
 struct singleton_tag_type {};
 } // namespace
@@ -9,11 +9,39 @@
  */
 #pragma once
 
+#include <gflags/gflags.h>
+
+#include <array>
 #include <memory>
 #include <mutex>
 
+extern "C" {
+#include <sai.h>
+}
+
+DECLARE_bool(sai_per_api_lock);
+
 class SaiApiLock {
  public:
   static std::shared_ptr<SaiApiLock> getInstance();
+
+  /*
+   * The lock serializing calls into the adapter for the given api. Each api
+   * (as named by the ApiType of its SaiApi) has its own lock, so that e.g.
+   * collecting port stats does not hold up programming routes. With
+   * --nosai_per_api_lock, all apis share one lock, for adapters that can
+   * not be called concurrently for different apis.
+   */
+  std::mutex& lockFor(sai_api_t apiType) {
+    if (!FLAGS_sai_per_api_lock ||
+        static_cast<size_t>(apiType) >= apiLocks_.size()) {
+      return lock;
+    }
+    return apiLocks_[apiType];
+  }
+
   std::mutex lock;
+
+ private:
+  std::array<std::mutex, SAI_API_MAX> apiLocks_;
 };
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/api/SaiBulkWrites.h"
+
+#include <fmt/format.h>
+#include <folly/logging/xlog.h>
+#include <glog/logging.h>
+
+DEFINE_bool(
+    enable_sai_bulk_writes,
+    false,
+    "Program routes, neighbors and FDB entries through the adapter's "
+    "sai_bulk_* calls when processing state deltas");
+DEFINE_int32(
+    sai_bulk_write_max_objects,
+    1024,
+    "Largest number of objects handed to the adapter in one bulk call");
+
+namespace {
+// Depth of nested SaiBulkWriteScopes on this thread
+thread_local int scopeDepth{0};
+// The api this thread has writes queued in, if any
+thread_local facebook::fboss::SaiBulkWriterIf* queuedWriter{nullptr};
+} // namespace
+
+namespace {
+std::string bulkWriteErrorMessage(
+    size_t numWrites,
+    const std::vector<facebook::fboss::SaiBulkWriteError::Failure>& failures) {
+  auto msg = fmt::format(
+      "Failed {} of {} queued writes: ", failures.size(), numWrites);
+  for (size_t i = 0; i < failures.size(); ++i) {
+    msg += fmt::format(
+        "{}{} ({})",
+        i ? "; " : "",
+        failures[i].write,
+        facebook::fboss::saiStatusToString(failures[i].status));
+  }
+  return msg;
+}
+} // namespace
+
+namespace facebook::fboss {
+
+SaiBulkWriteError::SaiBulkWriteError(
+    sai_api_t apiType,
+    size_t numWrites,
+    std::vector<Failure> failures)
+    : SaiApiError(
+          failures.front().status,
+          apiType,
+          bulkWriteErrorMessage(numWrites, failures)),
+      failures_(std::move(failures)) {}
+
+SaiBulkWriteScope::SaiBulkWriteScope() {
+  ++scopeDepth;
+}
+
+SaiBulkWriteScope::~SaiBulkWriteScope() {
+  --scopeDepth;
+  if (scopeDepth) {
+    return;
+  }
+  try {
+    flush();
+  } catch (const std::exception& ex) {
+    // Only reached while unwinding from an earlier error, as callers
+    // flush() before leaving the scope normally.
+    XLOG(ERR) << "Failed to flush queued SAI bulk writes: " << ex.what();
+  }
+}
+
+void SaiBulkWriteScope::flush() {
+  flushQueuedUnless(nullptr);
+}
+
+bool SaiBulkWriteScope::active() {
+  return scopeDepth > 0 && FLAGS_enable_sai_bulk_writes;
+}
+
+void SaiBulkWriteScope::flushQueuedUnless(const SaiBulkWriterIf* writer) {
+  if (!queuedWriter || queuedWriter == writer) {
+    return;
+  }
+  auto queued = queuedWriter;
+  queuedWriter = nullptr;
+  queued->flushBulkWrites();
+}
+
+bool SaiBulkWriteScope::takeQueued(const SaiBulkWriterIf* writer) {
+  if (queuedWriter != writer) {
+    return false;
+  }
+  queuedWriter = nullptr;
+  return true;
+}
+
+void SaiBulkWriteScope::setQueued(SaiBulkWriterIf* writer) {
+  DCHECK(!queuedWriter || queuedWriter == writer);
+  queuedWriter = writer;
+}
+
+} // namespace facebook::fboss
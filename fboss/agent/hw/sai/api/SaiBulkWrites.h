@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include "fboss/agent/hw/sai/api/SaiApiError.h"
+
+#include <folly/dynamic.h>
+#include <gflags/gflags.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <sai.h>
+}
+
+DECLARE_bool(enable_sai_bulk_writes);
+DECLARE_int32(sai_bulk_write_max_objects);
+
+namespace facebook::fboss {
+
+/*
+ * Implemented by SaiApi, so that the writes it has queued for a bulk call
+ * can be flushed by whoever needs them programmed first.
+ */
+class SaiBulkWriterIf {
+ public:
+  virtual ~SaiBulkWriterIf() = default;
+  // Takes the api's own SaiApiLock
+  virtual void flushBulkWrites() = 0;
+};
+
+/*
+ * While a SaiBulkWriteScope is alive on a thread, the creates, removes and
+ * attribute sets of entry struct objects (routes, neighbors, FDB entries)
+ * made from that thread are queued, and handed to the adapter through its
+ * sai_bulk_* calls rather than one object at a time.
+ *
+ * At most one api has writes queued by a thread at any time. Any other
+ * write from that thread (to another api, or of another kind to the same
+ * api) and any read of the queuing api flush the queue first, so the
+ * adapter sees writes in the order they were made. The queue is also
+ * flushed when it reaches FLAGS_sai_bulk_write_max_objects, and when the
+ * scope is flushed or destroyed.
+ *
+ * Errors in queued writes are thrown as a SaiBulkWriteError by whichever
+ * call flushes them, so callers should flush() at the end of each batch of
+ * related writes, for errors to surface there rather than from an
+ * unrelated write.
+ *
+ * The queues live in the apis, so only one thread (the one applying state
+ * deltas) may use SaiBulkWriteScopes at a time.
+ *
+ * Apis whose adapter does not implement the bulk calls program queued
+ * writes one at a time.
+ */
+class SaiBulkWriteScope {
+ public:
+  SaiBulkWriteScope();
+  ~SaiBulkWriteScope();
+
+  void flush();
+
+  // Whether writes made from this thread may be queued
+  static bool active();
+
+  // Flush whatever this thread has queued, unless it was queued by writer.
+  // Must be called without holding any SaiApiLock, as flushing takes the
+  // lock of the queuing api.
+  static void flushQueuedUnless(const SaiBulkWriterIf* writer);
+
+  // The following are called with writer's SaiApiLock held
+
+  // Whether this thread has writes of writer queued. If so, they are now
+  // the caller's to flush.
+  static bool takeQueued(const SaiBulkWriterIf* writer);
+  // Note that this thread queued writes of writer. Any writes it queued for
+  // another writer must have been flushed already.
+  static void setQueued(SaiBulkWriterIf* writer);
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  SaiBulkWriteScope(const SaiBulkWriteScope&) = delete;
+  SaiBulkWriteScope& operator=(const SaiBulkWriteScope&) = delete;
+};
+
+enum class SaiBulkWriteOp { CREATE, REMOVE, SET };
+
+/*
+ * Thrown when writes queued for a bulk call fail. Lists each object whose
+ * write failed, with the status the adapter returned for it. The status of
+ * the error itself is that of the first failure.
+ */
+class SaiBulkWriteError : public SaiApiError {
+ public:
+  struct Failure {
+    SaiBulkWriteOp op;
+    // The object's AdapterKey, as serialized in the warm boot state
+    folly::dynamic adapterKey;
+    // The write, for logging
+    std::string write;
+    sai_status_t status;
+  };
+
+  SaiBulkWriteError(
+      sai_api_t apiType,
+      size_t numWrites,
+      std::vector<Failure> failures);
+
+  const std::vector<Failure>& getFailures() const {
+    return failures_;
+  }
+
+ private:
+  std::vector<Failure> failures_;
+};
+
+/*
+ * Writes of one kind to entry struct objects of one type, waiting to be
+ * handed to the adapter in a single bulk call.
+ */
+template <typename SaiObjectTraits>
+struct SaiBulkWriteQueue {
+  using Op = SaiBulkWriteOp;
+
+  bool empty() const {
+    return entries.empty();
+  }
+  void clear() {
+    entries.clear();
+    createAttributes.clear();
+    setAttributes.clear();
+  }
+
+  Op op{Op::CREATE};
+  std::vector<typename SaiObjectTraits::AdapterKey> entries;
+  // For CREATE, one per entry
+  std::vector<typename SaiObjectTraits::CreateAttributes> createAttributes;
+  // For SET, one per entry. Bulk set is only used for attributes whose
+  // sai_attribute_t does not point to memory owned by the attribute.
+  std::vector<sai_attribute_t> setAttributes;
+  // Cleared once the adapter turns out not to implement the bulk calls
+  bool bulkSupported{true};
+};
+
+} // namespace facebook::fboss
@@ -10,9 +10,11 @@
 #pragma once
 
 #include "fboss/agent/hw/sai/api/SaiApiError.h"
+#include "fboss/agent/hw/sai/api/SaiApiLock.h"
 #include "fboss/agent/hw/sai/api/SaiVersion.h"
 #include "fboss/agent/hw/sai/api/Traits.h"
 
+#include <mutex>
 #include <type_traits>
 
 extern "C" {
@@ -23,6 +25,10 @@ extern "C" {
  * This library provide a wrapper around the facilities in sai_object.h for
  * bulk object and attribute traversal in SAI. These are primarily for use
  * during warm boot, but are not necessarily restricted to that use case.
+ *
+ * Object traversal does not belong to any one api, so it is serialized on
+ * the lock of SAI_API_UNSPECIFIED. The sai store reloads different apis
+ * from different threads.
  */
 
 namespace facebook::fboss {
@@ -44,16 +50,26 @@ typename std::enable_if_t<
 getAdapterKey(const sai_object_key_t& key) {
   return typename SaiObjectTraits::AdapterKey{key.key.object_id};
 }
-} // namespace detail
+
+inline std::mutex& objectApiLock() {
+  return SaiApiLock::getInstance()->lockFor(SAI_API_UNSPECIFIED);
+}
 
 template <typename SaiObjectTraits>
-uint32_t getObjectCount(sai_object_id_t switch_id) {
+uint32_t getObjectCountLocked(sai_object_id_t switch_id) {
   uint32_t count = 0;
   sai_status_t status =
       sai_get_object_count(switch_id, SaiObjectTraits::ObjectType, &count);
   saiCheckError(status, "Failed to get object count");
   return count;
 }
+} // namespace detail
+
+template <typename SaiObjectTraits>
+uint32_t getObjectCount(sai_object_id_t switch_id) {
+  std::lock_guard<std::mutex> g{detail::objectApiLock()};
+  return detail::getObjectCountLocked<SaiObjectTraits>(switch_id);
+}
 
 template <typename SaiObjectTraits>
 std::vector<typename SaiObjectTraits::AdapterKey> getObjectKeys(
@@ -63,11 +79,15 @@ std::vector<typename SaiObjectTraits::AdapterKey> getObjectKeys(
     return ret;
   }
   std::vector<sai_object_key_t> keys;
-  uint32_t c = getObjectCount<SaiObjectTraits>(switch_id);
-  keys.resize(c);
-  sai_status_t status = sai_get_object_key(
-      switch_id, SaiObjectTraits::ObjectType, &c, keys.data());
-  saiLogError(status, SAI_API_UNSPECIFIED, "Failed to get object key");
+  {
+    // Count and keys under one lock, so that they agree
+    std::lock_guard<std::mutex> g{detail::objectApiLock()};
+    uint32_t c = detail::getObjectCountLocked<SaiObjectTraits>(switch_id);
+    keys.resize(c);
+    sai_status_t status = sai_get_object_key(
+        switch_id, SaiObjectTraits::ObjectType, &c, keys.data());
+    saiLogError(status, SAI_API_UNSPECIFIED, "Failed to get object key");
+  }
   for (const auto k : keys) {
     ret.push_back(detail::getAdapterKey<SaiObjectTraits>(k));
   }
@@ -8,12 +8,14 @@
  *
  */
 #include "fboss/agent/hw/sai/api/RouteApi.h"
+#include "fboss/agent/hw/sai/api/SaiBulkWrites.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/fake/FakeSai.h"
 
 #include <folly/IPAddress.h>
 #include <folly/logging/xlog.h>
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
 #include <vector>
@@ -28,10 +30,13 @@ static constexpr folly::StringPiece strMac = "42:42:42:12:34:56";
 class RouteApiTest : public ::testing::Test {
  public:
   void SetUp() override {
+    // Off by default, the bulk tests below need it on
+    FLAGS_enable_sai_bulk_writes = true;
     fs = FakeSai::getInstance();
     sai_api_initialize(0, nullptr);
     routeApi = std::make_unique<RouteApi>();
   }
+  gflags::FlagSaver flagSaver;
   std::shared_ptr<FakeSai> fs;
   std::unique_ptr<RouteApi> routeApi;
   folly::IPAddress ip4{str4};
@@ -174,6 +179,99 @@ TEST_F(RouteApiTest, routeKeys) {
   EXPECT_EQ(routeKeys[0], r);
 }
 
+TEST_F(RouteApiTest, bulkCreateRoutes) {
+  SaiRouteTraits::Attributes::PacketAction packetActionAttribute{
+      SAI_PACKET_ACTION_FORWARD};
+  SaiRouteTraits::Attributes::NextHopId nextHopIdAttribute(5);
+  std::vector<SaiRouteTraits::RouteEntry> routes;
+  {
+    SaiBulkWriteScope bulkWrites;
+    for (uint8_t i = 0; i < 10; ++i) {
+      folly::CIDRNetwork prefix(folly::IPAddressV4::fromLongHBO(i << 8), 24);
+      routes.emplace_back(0, 0, prefix);
+      routeApi->create<SaiRouteTraits>(
+          routes.back(),
+          {packetActionAttribute, nextHopIdAttribute, std::nullopt});
+    }
+    // Queued until flushed
+    EXPECT_EQ(getObjectCount<SaiRouteTraits>(0), 0);
+    bulkWrites.flush();
+    EXPECT_EQ(getObjectCount<SaiRouteTraits>(0), 10);
+  }
+  for (const auto& r : routes) {
+    EXPECT_EQ(
+        routeApi->getAttribute(r, SaiRouteTraits::Attributes::NextHopId()),
+        5);
+  }
+}
+
+TEST_F(RouteApiTest, bulkWritesFlushedByRead) {
+  folly::CIDRNetwork prefix(ip4, 24);
+  SaiRouteTraits::RouteEntry r(0, 0, prefix);
+  SaiRouteTraits::Attributes::PacketAction packetActionAttribute{
+      SAI_PACKET_ACTION_FORWARD};
+  SaiBulkWriteScope bulkWrites;
+  routeApi->create<SaiRouteTraits>(
+      r, {packetActionAttribute, std::nullopt, std::nullopt});
+  routeApi->setAttribute(r, SaiRouteTraits::Attributes::NextHopId{42});
+  EXPECT_EQ(
+      routeApi->getAttribute(r, SaiRouteTraits::Attributes::NextHopId()), 42);
+}
+
+TEST_F(RouteApiTest, bulkRemoveRoutes) {
+  folly::CIDRNetwork prefix4(ip4, 24);
+  folly::CIDRNetwork prefix6(ip6, 64);
+  SaiRouteTraits::RouteEntry r4(0, 0, prefix4);
+  SaiRouteTraits::RouteEntry r6(0, 0, prefix6);
+  SaiRouteTraits::Attributes::PacketAction packetActionAttribute{
+      SAI_PACKET_ACTION_DROP};
+  routeApi->create<SaiRouteTraits>(
+      r4, {packetActionAttribute, std::nullopt, std::nullopt});
+  routeApi->create<SaiRouteTraits>(
+      r6, {packetActionAttribute, std::nullopt, std::nullopt});
+  SaiBulkWriteScope bulkWrites;
+  routeApi->remove(r4);
+  routeApi->remove(r6);
+  EXPECT_EQ(getObjectCount<SaiRouteTraits>(0), 2);
+  bulkWrites.flush();
+  EXPECT_EQ(getObjectCount<SaiRouteTraits>(0), 0);
+}
+
+TEST_F(RouteApiTest, bulkRemoveMissingRoute) {
+  folly::CIDRNetwork prefix(ip4, 24);
+  SaiRouteTraits::RouteEntry r(0, 0, prefix);
+  SaiBulkWriteScope bulkWrites;
+  routeApi->remove(r);
+  EXPECT_THROW(bulkWrites.flush(), SaiApiError);
+}
+
+TEST_F(RouteApiTest, bulkWriteFailuresListed) {
+  folly::CIDRNetwork prefix4(ip4, 24);
+  folly::CIDRNetwork prefix6(ip6, 64);
+  SaiRouteTraits::RouteEntry r4(0, 0, prefix4);
+  SaiRouteTraits::RouteEntry r6(0, 0, prefix6);
+  SaiRouteTraits::Attributes::PacketAction packetActionAttribute{
+      SAI_PACKET_ACTION_DROP};
+  routeApi->create<SaiRouteTraits>(
+      r4, {packetActionAttribute, std::nullopt, std::nullopt});
+  SaiBulkWriteScope bulkWrites;
+  routeApi->remove(r6);
+  routeApi->remove(r4);
+  try {
+    bulkWrites.flush();
+    FAIL() << "Queued remove of a missing route did not fail";
+  } catch (const SaiBulkWriteError& ex) {
+    // Only the missing route failed, and the other one was removed
+    ASSERT_EQ(ex.getFailures().size(), 1);
+    const auto& failure = ex.getFailures()[0];
+    EXPECT_EQ(failure.op, SaiBulkWriteOp::REMOVE);
+    EXPECT_EQ(failure.adapterKey, r6.toFollyDynamic());
+    EXPECT_EQ(failure.status, ex.getSaiStatus());
+    EXPECT_EQ(ex.getSaiApiType(), SAI_API_ROUTE);
+  }
+  EXPECT_EQ(getObjectCount<SaiRouteTraits>(0), 0);
+}
+
 TEST_F(RouteApiTest, formatRouteNextHopId) {
   SaiRouteTraits::Attributes::NextHopId nhid{42};
   std::string expected("NextHopId: 42");
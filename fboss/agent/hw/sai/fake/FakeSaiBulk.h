@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <exception>
+
+extern "C" {
+#include <sai.h>
+}
+
+namespace facebook::fboss {
+
+/*
+ * Implements a fake sai_bulk_* call in terms of writeFn(i), which performs
+ * the write of the i-th object and returns its status. Follows the SAI
+ * error modes: with SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, objects after a
+ * failed one are left SAI_STATUS_NOT_EXECUTED.
+ */
+template <typename WriteFn>
+sai_status_t fakeBulkWrite(
+    uint32_t object_count,
+    sai_bulk_op_error_mode_t mode,
+    sai_status_t* object_statuses,
+    WriteFn writeFn) {
+  bool failed = false;
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (failed && mode == SAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR) {
+      object_statuses[i] = SAI_STATUS_NOT_EXECUTED;
+      continue;
+    }
+    try {
+      object_statuses[i] = writeFn(i);
+    } catch (const std::exception&) {
+      object_statuses[i] = SAI_STATUS_FAILURE;
+    }
+    failed |= object_statuses[i] != SAI_STATUS_SUCCESS;
+  }
+  return failed ? SAI_STATUS_FAILURE : SAI_STATUS_SUCCESS;
+}
+
+} // namespace facebook::fboss
@@ -14,6 +14,8 @@
 
 #include <folly/logging/xlog.h>
 
+#include <algorithm>
+
 sai_status_t sai_get_object_count(
     sai_object_id_t /* switch_id */,
     sai_object_type_t object_type,
@@ -502,3 +504,47 @@ sai_status_t sai_get_object_key(
   }
   return SAI_STATUS_SUCCESS;
 }
+
+#if SAI_API_VERSION >= SAI_VERSION(1, 9, 0)
+/*
+ * There is no dataplane in fake sai, so like the per object stats calls,
+ * this reads all stats of ports and queues as 0.
+ */
+sai_status_t sai_bulk_object_get_stats(
+    sai_object_id_t /* switch_id */,
+    sai_object_type_t object_type,
+    uint32_t object_count,
+    const sai_object_key_t* object_key,
+    uint32_t number_of_counters,
+    const sai_stat_id_t* /* counter_ids */,
+    sai_stats_mode_t /* mode */,
+    sai_status_t* object_statuses,
+    uint64_t* counters) {
+  auto fs = facebook::fboss::FakeSai::getInstance();
+  auto exists = [&fs, object_type](sai_object_id_t id) {
+    switch (object_type) {
+      case SAI_OBJECT_TYPE_PORT:
+        return fs->portManager.exists(id);
+      case SAI_OBJECT_TYPE_QUEUE:
+        return fs->queueManager.exists(id);
+      default:
+        return false;
+    }
+  };
+  if (object_type != SAI_OBJECT_TYPE_PORT &&
+      object_type != SAI_OBJECT_TYPE_QUEUE) {
+    return SAI_STATUS_NOT_SUPPORTED;
+  }
+  sai_status_t status = SAI_STATUS_SUCCESS;
+  for (uint32_t i = 0; i < object_count; ++i) {
+    if (!exists(object_key[i].key.object_id)) {
+      object_statuses[i] = SAI_STATUS_INVALID_OBJECT_ID;
+      status = SAI_STATUS_FAILURE;
+      continue;
+    }
+    std::fill_n(counters + i * number_of_counters, number_of_counters, 0);
+    object_statuses[i] = SAI_STATUS_SUCCESS;
+  }
+  return status;
+}
+#endif
@@ -401,7 +401,9 @@ class SaiObject {
       auto& api = SaiApiTable::getInstance()
                       ->getApi<typename SaiObjectTraits::SaiApiT>();
       try {
-        api.remove(adapterKey_);
+        // A queued bulk remove would only report a missing entry once
+        // flushed, so program removes that may ignore it right away.
+        api.remove(adapterKey_, !ignoreMissingInHwOnDelete_);
       } catch (const SaiApiError& e) {
         if (ignoreMissingInHwOnDelete_ &&
             e.getSaiStatus() == SAI_STATUS_ITEM_NOT_FOUND) {
@@ -63,8 +63,35 @@ class SaiObjectWithCounters : public SaiObject<SaiObjectTraits> {
     fillInStats(counterIds.data(), counters);
   }
 
+  /*
+   * Update the given stats of many objects at once, with a single bulk read
+   * where the adapter supports it
+   */
   template <typename T = SaiObjectTraits>
-  const StatsMap getStats() const {
+  static void bulkUpdateStats(
+      sai_object_id_t switchId,
+      const std::vector<SaiObjectWithCounters*>& objects,
+      const std::vector<sai_stat_id_t>& counterIds,
+      sai_stats_mode_t mode) {
+    static_assert(SaiObjectHasStats<T>::value, "invalid traits for the api");
+    std::vector<typename T::AdapterKey> keys;
+    keys.reserve(objects.size());
+    for (const auto* object : objects) {
+      keys.push_back(object->adapterKey());
+    }
+    auto& api = SaiApiTable::getInstance()->getApi<typename T::SaiApiT>();
+    const auto& counters =
+        api.template bulkGetStats<T>(switchId, keys, counterIds, mode);
+    for (size_t i = 0; i < objects.size(); ++i) {
+      objects[i]->fillInStats(
+          counterIds.data(),
+          counters.data() + i * counterIds.size(),
+          counterIds.size());
+    }
+  }
+
+  template <typename T = SaiObjectTraits>
+  const StatsMap& getStats() const {
     static_assert(SaiObjectHasStats<T>::value, "invalid traits for the api");
     return counterId2Value_;
   }
@@ -87,7 +114,13 @@ class SaiObjectWithCounters : public SaiObject<SaiObjectTraits> {
   void fillInStats(
       const sai_stat_id_t* ids,
       const std::vector<uint64_t>& counters) {
-    for (auto i = 0; i < counters.size(); ++i) {
+    fillInStats(ids, counters.data(), counters.size());
+  }
+  void fillInStats(
+      const sai_stat_id_t* ids,
+      const uint64_t* counters,
+      size_t numCounters) {
+    for (size_t i = 0; i < numCounters; ++i) {
       counterId2Value_[ids[i]] = counters[i];
     }
   }
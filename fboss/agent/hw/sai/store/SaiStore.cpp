@@ -10,6 +10,20 @@
 
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
+DEFINE_int32(
+    sai_store_reload_threads,
+    4,
+    "Number of threads reloading the sai store. With more than one, object "
+    "types of different apis are reloaded concurrently");
+
 namespace facebook::fboss {
 
 SaiStore::SaiStore() {}
@@ -27,18 +41,75 @@ void SaiStore::setSwitchId(sai_object_id_t switchId) {
 void SaiStore::reload(
     const folly::dynamic* adapterKeysJson,
     const folly::dynamic* adapterKeys2AdapterHostKeyJson) {
+  /*
+   * Object stores only read from the adapter and from the json while
+   * reloading, and share no state. Those of the same api are reloaded one
+   * after the other, in the order they are declared in, as they would only
+   * contend for the lock of that api otherwise.
+   */
+  std::vector<std::function<void()>> reloads;
+  std::map<sai_api_t, std::vector<size_t>> reloadsByApi;
+  lastReloadTimes_.clear();
+  lastReloadTimes_.resize(std::tuple_size_v<decltype(stores_)>);
   tupleForEach(
-      [adapterKeysJson, adapterKeys2AdapterHostKeyJson](auto& store) {
+      [this,
+       adapterKeysJson,
+       adapterKeys2AdapterHostKeyJson,
+       &reloads,
+       &reloadsByApi](auto& store) {
+        using ObjectTraits =
+            typename std::decay_t<decltype(store)>::ObjectTraits;
         const folly::dynamic* adapterKeys = adapterKeysJson
             ? adapterKeysJson->get_ptr(store.objectTypeName())
             : nullptr;
         const folly::dynamic* adapterHostKeys = adapterKeys2AdapterHostKeyJson
             ? adapterKeys2AdapterHostKeyJson->get_ptr(store.objectTypeName())
             : nullptr;
-
-        store.reload(adapterKeys, adapterHostKeys);
+        auto* reloadTime = &lastReloadTimes_[reloads.size()];
+        reloadTime->first = store.objectTypeName().str();
+        reloadsByApi[ObjectTraits::SaiApiT::ApiType].push_back(reloads.size());
+        reloads.push_back(
+            [&store, adapterKeys, adapterHostKeys, reloadTime]() {
+              auto begin = std::chrono::steady_clock::now();
+              store.reload(adapterKeys, adapterHostKeys);
+              reloadTime->second =
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - begin);
+            });
       },
       stores_);
+
+  auto numThreads = std::min(
+      static_cast<size_t>(std::max(FLAGS_sai_store_reload_threads, 1)),
+      reloadsByApi.size());
+  if (numThreads < 2) {
+    for (const auto& reload : reloads) {
+      reload();
+    }
+  } else {
+    folly::CPUThreadPoolExecutor executor(
+        numThreads, std::make_shared<folly::NamedThreadFactory>("saiReload"));
+    std::vector<folly::Future<folly::Unit>> futures;
+    futures.reserve(reloadsByApi.size());
+    for (const auto& [api, indices] : reloadsByApi) {
+      futures.push_back(folly::via(
+          folly::getKeepAliveToken(executor),
+          [&reloads, &indices = indices]() {
+            for (auto index : indices) {
+              reloads[index]();
+            }
+          }));
+    }
+    // Rethrow the first failure, once no reload is still running
+    for (auto& result :
+         folly::collectAll(futures.begin(), futures.end()).get()) {
+      result.throwIfFailed();
+    }
+  }
+  for (const auto& [objectType, duration] : lastReloadTimes_) {
+    XLOG(DBG2) << "Reloaded " << objectType << " in " << duration.count()
+               << "us";
+  }
 }
 
 void SaiStore::release() {
@@ -126,6 +197,35 @@ void SaiStore::printWarmbootHandles() const {
       [](const auto& store) { store.printWarmBootHandles(); }, stores_);
 }
 
+void SaiStore::handleFailedBulkWrites(const SaiBulkWriteError& error) {
+  tupleForEach(
+      [&error](auto& store) {
+        using ObjectTraits =
+            typename std::decay_t<decltype(store)>::ObjectTraits;
+        using ApiT = typename ObjectTraits::SaiApiT;
+        if constexpr (ApiHasBulkWrites<ApiT>::value) {
+          if constexpr (std::is_same_v<
+                            ObjectTraits,
+                            typename ApiT::BulkWriteTraits>) {
+            if (error.getSaiApiType() != ApiT::ApiType) {
+              return;
+            }
+            for (const auto& failure : error.getFailures()) {
+              if (failure.op != SaiBulkWriteOp::CREATE) {
+                continue;
+              }
+              auto object = store.get(
+                  fromFollyDynamic<ObjectTraits>(failure.adapterKey));
+              if (object) {
+                object->setIgnoreMissingInHwOnDelete(true);
+              }
+            }
+          }
+        }
+      },
+      stores_);
+}
+
 void SaiStore::removeUnexpectedUnclaimedWarmbootHandles() {
   tupleForEach(
       [](auto& store) { store.removeUnexpectedUnclaimedWarmbootHandles(); },
@@ -12,6 +12,7 @@
 #include "fboss/agent/hw/sai/api/AdapterKeySerializers.h"
 #include "fboss/agent/hw/sai/api/LoggingUtil.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
+#include "fboss/agent/hw/sai/api/SaiBulkWrites.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/api/Traits.h"
 #include "fboss/agent/hw/sai/store/LoggingUtil.h"
@@ -21,16 +22,24 @@
 #include "fboss/lib/RefMap.h"
 
 #include <folly/dynamic.h>
+#include <gflags/gflags.h>
 
+#include <chrono>
 #include <memory>
 #include <optional>
 #include <sstream>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 extern "C" {
 #include <sai.h>
 }
 
+DECLARE_int32(sai_store_reload_threads);
+
 namespace facebook::fboss {
 
 inline constexpr auto kAdapterKey2AdapterHostKey = "adapterKey2AdapterHostKey";
@@ -142,8 +151,15 @@ class SaiObjectStore {
               }),
           keys.end());
     }
+    AdapterHostKeysJson adapterHostKeys;
+    if constexpr (!AdapterHostKeyWarmbootRecoverable<SaiObjectTraits>::value) {
+      if (adapterKeys2AdapterHostKey) {
+        adapterHostKeys = adapterHostKeysJson(*adapterKeys2AdapterHostKey);
+      }
+    }
     for (const auto k : keys) {
-      ObjectType obj = getObject(k, adapterKeys2AdapterHostKey);
+      ObjectType obj = getObject(
+          k, adapterKeys2AdapterHostKey ? &adapterHostKeys : nullptr);
       auto adapterHostKey = obj.adapterHostKey();
       XLOGF(DBG5, "SaiStore reloaded {}", obj);
       auto ins = objects_.refOrInsert(adapterHostKey, std::move(obj));
@@ -334,12 +350,17 @@ class SaiObjectStore {
   }
 
  private:
+  // Saved adapter host keys, by the adapter key they were saved with
+  using AdapterHostKeysJson = std::unordered_map<
+      typename SaiObjectTraits::AdapterKey,
+      const folly::dynamic*>;
+
   template <
       typename T = SaiObjectTraits,
       typename = std::enable_if_t<std::is_same_v<T, SaiLagTraits>>>
   ObjectType getObject(
       typename T::AdapterKey key,
-      const folly::dynamic* adapterKey2AdapterHostKey) {
+      const AdapterHostKeysJson* adapterKey2AdapterHostKey) {
     static_assert(
         !AdapterHostKeyWarmbootRecoverable<SaiObjectTraits>::value, "LAG!");
     auto ahk = getAdapterHostKey(key, adapterKey2AdapterHostKey);
@@ -356,7 +377,7 @@ class SaiObjectStore {
       typename = std::enable_if_t<!std::is_same_v<T, SaiLagTraits>>>
   ObjectType getObject(
       typename SaiObjectTraits::AdapterKey key,
-      const folly::dynamic* adapterKey2AdapterHostKey) {
+      const AdapterHostKeysJson* adapterKey2AdapterHostKey) {
     if constexpr (!AdapterHostKeyWarmbootRecoverable<SaiObjectTraits>::value) {
       if (auto ahk = getAdapterHostKey(key, adapterKey2AdapterHostKey)) {
         return ObjectType(key, ahk.value());
@@ -395,17 +416,38 @@ class SaiObjectStore {
                            : getObjectKeys<SaiObjectTraits>(switchId_.value());
   }
 
+  /*
+   * Index the saved adapter host keys by adapter key once, rather than
+   * formatting every reloaded adapter key to look it up in the json
+   */
+  static AdapterHostKeysJson adapterHostKeysJson(
+      const folly::dynamic& adapterKeys2AdapterHostKey) {
+    static_assert(
+        AdapterKeyIsObjectId<SaiObjectTraits>::value,
+        "adapter host keys are only saved for objects with object id keys");
+    AdapterHostKeysJson adapterHostKeys;
+    adapterHostKeys.reserve(adapterKeys2AdapterHostKey.size());
+    for (const auto& [key, adapterHostKey] :
+         adapterKeys2AdapterHostKey.items()) {
+      adapterHostKeys.emplace(
+          typename SaiObjectTraits::AdapterKey(
+              folly::to<sai_object_id_t>(key.asString())),
+          &adapterHostKey);
+    }
+    return adapterHostKeys;
+  }
+
   std::optional<typename SaiObjectTraits::AdapterHostKey> getAdapterHostKey(
       const typename SaiObjectTraits::AdapterKey& key,
-      const folly::dynamic* adapterKeys2AdapterHostKey) {
+      const AdapterHostKeysJson* adapterKeys2AdapterHostKey) {
     if (!adapterKeys2AdapterHostKey) {
       return std::nullopt;
     }
-    auto iter = adapterKeys2AdapterHostKey->find(folly::to<std::string>(key));
-    CHECK(iter != adapterKeys2AdapterHostKey->items().end());
+    auto iter = adapterKeys2AdapterHostKey->find(key);
+    CHECK(iter != adapterKeys2AdapterHostKey->end());
 
     return SaiObject<SaiObjectTraits>::follyDynamicToAdapterHostKey(
-        iter->second);
+        *iter->second);
   }
 
   std::optional<sai_object_id_t> switchId_;
@@ -447,11 +489,22 @@ class SaiStore {
 
   /*
    * Reload the SaiStore from the current SAI state via SAI api calls.
+   * Object stores of different apis are reloaded concurrently, see
+   * --sai_store_reload_threads.
    */
   void reload(
       const folly::dynamic* adapterKeys = nullptr,
       const folly::dynamic* adapterKeys2AdapterHostKey = nullptr);
 
+  /*
+   * How long the last reload() took for each object type, in the order the
+   * object stores are declared in
+   */
+  const std::vector<std::pair<std::string, std::chrono::microseconds>>&
+  getLastReloadTimes() const {
+    return lastReloadTimes_;
+  }
+
   /*
    *
    */
@@ -479,8 +532,17 @@ class SaiStore {
 
   void printWarmbootHandles() const;
 
+  /*
+   * Objects whose queued create failed (see SaiBulkWriteScope) are in the
+   * store, but not in the adapter. Do not have them removed from the
+   * adapter once they are released.
+   */
+  void handleFailedBulkWrites(const SaiBulkWriteError& error);
+
  private:
   sai_object_id_t switchId_{};
+  std::vector<std::pair<std::string, std::chrono::microseconds>>
+      lastReloadTimes_;
   std::tuple<
       SaiObjectStore<SaiAclTableGroupTraits>,
       SaiObjectStore<SaiAclTableGroupMemberTraits>,
@@ -14,6 +14,7 @@
 #include "fboss/agent/hw/sai/store/SaiStore.h"
 
 #include <folly/json.h>
+#include <gflags/gflags.h>
 #include "fboss/agent/hw/sai/store/tests/SaiStoreTest.h"
 
 using namespace facebook::fboss;
@@ -222,3 +223,41 @@ TEST_F(NextHopGroupStoreTest, nextHopGroupJson) {
   EXPECT_FALSE(nhgAk2AhkJson.items().end() == iter);
   EXPECT_EQ(iter->second, json);
 }
+
+TEST_F(NextHopGroupStoreTest, reloadNextHopGroupFromJson) {
+  gflags::FlagSaver flagSaver;
+  auto nextHopGroupId = createNextHopGroup();
+  folly::IPAddress ip1{"10.10.10.1"};
+  folly::IPAddress ip2{"10.10.10.2"};
+  createNextHopGroupMember(nextHopGroupId, createNextHop(ip1), std::nullopt);
+  createNextHopGroupMember(nextHopGroupId, createNextHop(ip2), std::nullopt);
+  SaiNextHopGroupTraits::AdapterHostKey k;
+  k.insert(SaiIpNextHopTraits::AdapterHostKey{42, ip1});
+  k.insert(SaiIpNextHopTraits::AdapterHostKey{42, ip2});
+
+  folly::dynamic adapterKeys;
+  folly::dynamic ak2AhkJson;
+  {
+    SaiStore s(0);
+    s.reload();
+    adapterKeys = s.adapterKeysFollyDynamic();
+    ak2AhkJson = s.adapterKeys2AdapterHostKeysFollyDynamic();
+    s.exitForWarmBoot();
+  }
+
+  for (auto threads : {1, 4}) {
+    FLAGS_sai_store_reload_threads = threads;
+    SaiStore s(0);
+    s.reload(&adapterKeys, &ak2AhkJson);
+    auto got = s.get<SaiNextHopGroupTraits>().get(k);
+    ASSERT_TRUE(got);
+    EXPECT_EQ(got->adapterKey(), nextHopGroupId);
+    const auto& reloadTimes = s.getLastReloadTimes();
+    EXPECT_TRUE(std::any_of(
+        reloadTimes.begin(), reloadTimes.end(), [](const auto& reloadTime) {
+          return reloadTime.first ==
+              saiObjectTypeToString(SAI_OBJECT_TYPE_NEXT_HOP_GROUP);
+        }));
+    s.exitForWarmBoot();
+  }
+}
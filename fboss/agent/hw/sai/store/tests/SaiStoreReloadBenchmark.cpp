@@ -0,0 +1,155 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Measures the warm boot reload of the sai store from the keys saved at
+ * exit, on fake SAI programmed with a large number of routes, neighbors and
+ * next hops: once reloading one object type after the other, and once
+ * reloading object types of different apis concurrently. Also reports how
+ * long each populated object type took to reload, in <type>_usec counters.
+ */
+
+#include "fboss/agent/hw/sai/fake/FakeSai.h"
+#include "fboss/agent/hw/sai/store/SaiStore.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddress.h>
+#include <folly/MacAddress.h>
+#include <folly/init/Init.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr auto kNumNextHops = 4096;
+constexpr auto kNumNextHopGroups = 512;
+constexpr auto kNextHopGroupWidth = 8;
+constexpr auto kNumRoutes = 32 * 1024;
+
+struct SavedStore {
+  folly::dynamic adapterKeys;
+  folly::dynamic adapterKeys2AdapterHostKey;
+};
+
+folly::IPAddress hostIp(uint32_t host) {
+  return folly::IPAddress(folly::IPAddressV4::fromLongHBO(0x0a000000 + host));
+}
+
+// Program the objects through the apis, then save the store as at exit
+SavedStore programAndSave() {
+  auto saiApiTable = SaiApiTable::getInstance();
+  auto& neighborApi = saiApiTable->neighborApi();
+  auto& nextHopApi = saiApiTable->nextHopApi();
+  auto& nextHopGroupApi = saiApiTable->nextHopGroupApi();
+  auto& routeApi = saiApiTable->routeApi();
+
+  std::vector<NextHopSaiId> nextHops;
+  for (auto i = 0; i < kNumNextHops; ++i) {
+    auto ip = hostIp(i + 1);
+    neighborApi.create<SaiNeighborTraits>(
+        SaiNeighborTraits::NeighborEntry(0, 0, ip),
+        {folly::MacAddress::fromHBO(0x020000000000 + i), std::nullopt});
+    nextHops.push_back(nextHopApi.create<SaiIpNextHopTraits>(
+        {SAI_NEXT_HOP_TYPE_IP, 42, ip, std::nullopt}, 0));
+  }
+  std::vector<NextHopGroupSaiId> nextHopGroups;
+  for (auto i = 0; i < kNumNextHopGroups; ++i) {
+    auto group = nextHopGroupApi.create<SaiNextHopGroupTraits>(
+        {SAI_NEXT_HOP_GROUP_TYPE_ECMP}, 0);
+    for (auto j = 0; j < kNextHopGroupWidth; ++j) {
+      auto nextHop = nextHops[(i + j * kNumNextHopGroups) % kNumNextHops];
+      nextHopGroupApi.create<SaiNextHopGroupMemberTraits>(
+          {group, nextHop, std::nullopt}, 0);
+    }
+    nextHopGroups.push_back(group);
+  }
+  for (auto i = 0; i < kNumRoutes; ++i) {
+    folly::CIDRNetwork prefix(
+        folly::IPAddressV4::fromLongHBO(0x14000000 + (i << 8)), 24);
+    routeApi.create<SaiRouteTraits>(
+        SaiRouteTraits::RouteEntry(0, 0, prefix),
+        {SAI_PACKET_ACTION_FORWARD,
+         nextHopGroups[i % kNumNextHopGroups],
+         std::nullopt});
+  }
+
+  SaiStore store(0);
+  store.reload();
+  SavedStore saved{
+      store.adapterKeysFollyDynamic(),
+      store.adapterKeys2AdapterHostKeysFollyDynamic()};
+  store.exitForWarmBoot();
+  return saved;
+}
+
+const SavedStore& savedStore() {
+  static const SavedStore saved = programAndSave();
+  return saved;
+}
+
+void reloadStore(folly::UserCounters& counters, int threads) {
+  folly::BenchmarkSuspender suspender;
+  const auto& saved = savedStore();
+  FLAGS_sai_store_reload_threads = threads;
+  SaiStore store(0);
+  suspender.dismiss();
+
+  store.reload(&saved.adapterKeys, &saved.adapterKeys2AdapterHostKey);
+
+  suspender.rehire();
+  std::set<std::string> programmed;
+  for (auto objectType :
+       {SAI_OBJECT_TYPE_NEIGHBOR_ENTRY,
+        SAI_OBJECT_TYPE_NEXT_HOP,
+        SAI_OBJECT_TYPE_NEXT_HOP_GROUP,
+        SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER,
+        SAI_OBJECT_TYPE_ROUTE_ENTRY}) {
+    programmed.insert(saiObjectTypeToString(objectType).str());
+  }
+  // Next hops of both types share a store name, report the slowest
+  std::map<std::string, int64_t> reloadUsecs;
+  for (const auto& [objectType, duration] : store.getLastReloadTimes()) {
+    if (programmed.count(objectType)) {
+      auto& usecs = reloadUsecs[objectType];
+      usecs = std::max<int64_t>(usecs, duration.count());
+    }
+  }
+  for (const auto& [objectType, usecs] : reloadUsecs) {
+    counters[objectType + "_usec"] = usecs;
+  }
+  // Leave the objects programmed for the next reload
+  store.exitForWarmBoot();
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(saiStoreReloadSerial, counters) {
+  reloadStore(counters, 1);
+}
+
+BENCHMARK_COUNTERS(saiStoreReloadConcurrent, counters) {
+  reloadStore(counters, 4);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  FakeSai::getInstance();
+  sai_api_initialize(0, nullptr);
+  auto saiApiTable = SaiApiTable::getInstance();
+  saiApiTable->queryApis(saiApiTable->getFullApiList());
+  folly::runBenchmarks();
+  return 0;
+}
@@ -666,14 +666,72 @@ void SaiPortManager::updateStats(PortID portId) {
   if (handlesItr == handles_.end()) {
     return;
   }
+  if (portStats_.find(portId) == portStats_.end()) {
+    // We don't maintain port stats for disabled ports.
+    return;
+  }
   auto now = duration_cast<seconds>(system_clock::now().time_since_epoch());
   auto* handle = handlesItr->second.get();
-  auto portStatItr = portStats_.find(portId);
-  if (portStatItr == portStats_.end()) {
-    // We don't maintain port stats for disabled ports.
+  handle->port->updateStats(supportedStats(), SAI_STATS_MODE_READ);
+  managerTable_->queueManager().updateStats(handle->configuredQueues);
+  publishStats(portId, handle, now);
+}
+
+void SaiPortManager::updateStats() {
+  std::vector<PortID> portIds;
+  portIds.reserve(handles_.size());
+  for (const auto& handle : handles_) {
+    portIds.push_back(handle.first);
+  }
+  updateStats(portIds, managerTable_->queueManager().watermarkStatsDue());
+}
+
+void SaiPortManager::updateStats(
+    const std::vector<PortID>& portIds,
+    bool updateWatermarks) {
+  auto now = duration_cast<seconds>(system_clock::now().time_since_epoch());
+  std::vector<std::pair<PortID, SaiPortHandle*>> portHandles;
+  std::vector<SaiPort*> ports;
+  std::vector<SaiQueueHandle*> queues;
+  portHandles.reserve(portIds.size());
+  ports.reserve(portIds.size());
+  for (auto portId : portIds) {
+    auto handlesItr = handles_.find(portId);
+    if (handlesItr == handles_.end()) {
+      continue;
+    }
+    if (portStats_.find(portId) == portStats_.end()) {
+      // We don't maintain port stats for disabled ports.
+      continue;
+    }
+    auto* handle = handlesItr->second.get();
+    portHandles.emplace_back(portId, handle);
+    ports.push_back(handle->port.get());
+    queues.insert(
+        queues.end(),
+        handle->configuredQueues.begin(),
+        handle->configuredQueues.end());
+  }
+  if (ports.empty()) {
     return;
   }
-  const auto& prevPortStats = portStatItr->second->portStats();
+  SaiPort::bulkUpdateStats(
+      managerTable_->switchManager().getSwitchSaiId(),
+      ports,
+      supportedStats(),
+      SAI_STATS_MODE_READ);
+  managerTable_->queueManager().updateStats(queues, updateWatermarks);
+  for (const auto& [portId, handle] : portHandles) {
+    publishStats(portId, handle, now);
+  }
+}
+
+void SaiPortManager::publishStats(
+    PortID portId,
+    const SaiPortHandle* handle,
+    std::chrono::seconds now) {
+  auto* portStat = portStats_.find(portId)->second.get();
+  const auto& prevPortStats = portStat->portStats();
   HwPortStats curPortStats{prevPortStats};
   // All stats start with a unitialized (-1) value. If there are no in
   // discards (first collection) we will just report that -1 as the monotonic
@@ -683,7 +741,6 @@ void SaiPortManager::updateStats(PortID portId) {
       ? 0
       : *curPortStats.inDiscards__ref();
   curPortStats.timestamp__ref() = now.count();
-  handle->port->updateStats(supportedStats(), SAI_STATS_MODE_READ);
   const auto& counters = handle->port->getStats();
   fillHwPortStats(counters, managerTable_->debugCounterManager(), curPortStats);
   std::vector<utility::CounterPrevAndCur> toSubtractFromInDiscardsRaw = {
@@ -693,9 +750,9 @@ void SaiPortManager::updateStats(PortID portId) {
   *curPortStats.inDiscards__ref() += utility::subtractIncrements(
       {*prevPortStats.inDiscardsRaw__ref(), *curPortStats.inDiscardsRaw__ref()},
       toSubtractFromInDiscardsRaw);
-  managerTable_->queueManager().updateStats(
+  managerTable_->queueManager().getStats(
       handle->configuredQueues, curPortStats);
-  portStats_[portId]->updateStats(curPortStats, now);
+  portStat->updateStats(curPortStats, now);
 }
 
 std::map<PortID, HwPortStats> SaiPortManager::getPortStats() const {
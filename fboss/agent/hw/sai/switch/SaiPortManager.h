@@ -26,6 +26,8 @@
 #include "folly/container/F14Map.h"
 #include "folly/container/F14Set.h"
 
+#include <chrono>
+
 namespace facebook::fboss {
 
 class ConcurrentIndices;
@@ -150,6 +152,15 @@ class SaiPortManager {
       SaiPortTraits::CreateAttributes attributees) const;
 
   void updateStats(PortID portID);
+  /*
+   * Update the stats of the given ports and their queues, reading the
+   * counters of these ports, then their queues, in one bulk call each where
+   * the adapter supports it. Ports that are gone or disabled are skipped.
+   * Queue watermarks are read only if updateWatermarks.
+   */
+  void updateStats(const std::vector<PortID>& portIds, bool updateWatermarks);
+  // As above, for all enabled ports
+  void updateStats();
 
   void clearStats(PortID portID);
 
@@ -168,6 +179,11 @@ class SaiPortManager {
   void addRemovedHandle(PortID portID);
   void removeRemovedHandleIf(PortID portID);
   void releasePorts();
+  // Publish the port and queue stats last read for portID
+  void publishStats(
+      PortID portID,
+      const SaiPortHandle* handle,
+      std::chrono::seconds now);
 
   void setQosMaps(
       QosMapSaiId dscpToTc,
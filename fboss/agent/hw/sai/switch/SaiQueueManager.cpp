@@ -212,34 +212,76 @@ SaiQueueHandles SaiQueueManager::loadQueues(
   return queueHandles;
 }
 
-void SaiQueueManager::updateStats(
-    const std::vector<SaiQueueHandle*>& queueHandles,
-    HwPortStats& hwPortStats) {
-  hwPortStats.outCongestionDiscardPkts__ref() = 0;
+bool SaiQueueManager::watermarkStatsDue() {
   auto now =
       std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-  bool updateWatermarks = now - watermarkStatsUpdateTime_ >=
-      FLAGS_update_watermark_stats_interval_s;
-  static std::vector<sai_stat_id_t> nonWatermarkStatsRead(
+  if (now - watermarkStatsUpdateTime_ <
+      FLAGS_update_watermark_stats_interval_s) {
+    return false;
+  }
+  watermarkStatsUpdateTime_ = now;
+  return true;
+}
+
+void SaiQueueManager::updateStats(
+    const std::vector<SaiQueueHandle*>& queueHandles) {
+  if (queueHandles.empty()) {
+    return;
+  }
+  updateStats(queueHandles, watermarkStatsDue());
+}
+
+void SaiQueueManager::updateStats(
+    const std::vector<SaiQueueHandle*>& queueHandles,
+    bool updateWatermarks) {
+  if (queueHandles.empty()) {
+    return;
+  }
+  static const std::vector<sai_stat_id_t> statsRead(
+      SaiQueueTraits::CounterIdsToRead.begin(),
+      SaiQueueTraits::CounterIdsToRead.end());
+  static const std::vector<sai_stat_id_t> statsReadAndClear(
+      SaiQueueTraits::CounterIdsToReadAndClear.begin(),
+      SaiQueueTraits::CounterIdsToReadAndClear.end());
+  static const std::vector<sai_stat_id_t> nonWatermarkStatsRead(
       SaiQueueTraits::NonWatermarkCounterIdsToRead.begin(),
       SaiQueueTraits::NonWatermarkCounterIdsToRead.end());
-  static std::vector<sai_stat_id_t> nonWatermarkStatsReadAndClear(
+  static const std::vector<sai_stat_id_t> nonWatermarkStatsReadAndClear(
       SaiQueueTraits::NonWatermarkCounterIdsToReadAndClear.begin(),
       SaiQueueTraits::NonWatermarkCounterIdsToReadAndClear.end());
+  std::vector<SaiQueue*> queues;
+  queues.reserve(queueHandles.size());
   for (auto queueHandle : queueHandles) {
-    if (updateWatermarks) {
-      queueHandle->queue->updateStats();
-      watermarkStatsUpdateTime_ = now;
-    } else {
-      queueHandle->queue->updateStats(
-          nonWatermarkStatsRead, SAI_STATS_MODE_READ);
-      queueHandle->queue->updateStats(
-          nonWatermarkStatsReadAndClear, SAI_STATS_MODE_READ_AND_CLEAR);
-    }
-    const auto& counters = queueHandle->queue->getStats();
-    auto queueId = SaiApiTable::getInstance()->queueApi().getAttribute(
-        queueHandle->queue->adapterKey(), SaiQueueTraits::Attributes::Index{});
-    fillHwQueueStats(queueId, counters, hwPortStats);
+    queues.push_back(queueHandle->queue.get());
+  }
+  auto switchId = managerTable_->switchManager().getSwitchSaiId();
+  SaiQueue::bulkUpdateStats(
+      switchId,
+      queues,
+      updateWatermarks ? statsRead : nonWatermarkStatsRead,
+      SAI_STATS_MODE_READ);
+  SaiQueue::bulkUpdateStats(
+      switchId,
+      queues,
+      updateWatermarks ? statsReadAndClear : nonWatermarkStatsReadAndClear,
+      SAI_STATS_MODE_READ_AND_CLEAR);
+}
+
+void SaiQueueManager::updateStats(
+    const std::vector<SaiQueueHandle*>& queueHandles,
+    HwPortStats& hwPortStats) {
+  updateStats(queueHandles);
+  getStats(queueHandles, hwPortStats);
+}
+
+void SaiQueueManager::getStats(
+    const std::vector<SaiQueueHandle*>& queueHandles,
+    HwPortStats& hwPortStats) const {
+  hwPortStats.outCongestionDiscardPkts__ref() = 0;
+  for (auto queueHandle : queueHandles) {
+    // The index is a create attribute, no need to ask the adapter for it
+    auto queueId = GET_ATTR(Queue, Index, queueHandle->queue->attributes());
+    fillHwQueueStats(queueId, queueHandle->queue->getStats(), hwPortStats);
   }
 }
 
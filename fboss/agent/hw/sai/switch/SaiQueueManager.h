@@ -65,6 +65,22 @@ class SaiQueueManager {
   void updateStats(
       const std::vector<SaiQueueHandle*>& queues,
       HwPortStats& stats);
+  // Read the stats of queues of any number of ports, in bulk
+  void updateStats(const std::vector<SaiQueueHandle*>& queues);
+  // As above, reading watermarks too only if updateWatermarks
+  void updateStats(
+      const std::vector<SaiQueueHandle*>& queues,
+      bool updateWatermarks);
+  /*
+   * Whether watermarks are due to be read, at most once every
+   * update_watermark_stats_interval_s. If so, they are taken as read now, so
+   * that one decision can cover queues read over several calls.
+   */
+  bool watermarkStatsDue();
+  // Fill in the stats of queues last read by updateStats
+  void getStats(
+      const std::vector<SaiQueueHandle*>& queues,
+      HwPortStats& hwPortStats) const;
   void getStats(SaiQueueHandles& queueHandles, HwPortStats& hwPortStats);
   QueueConfig getQueueSettings(const SaiQueueHandles& queueHandles) const;
 
@@ -23,6 +23,7 @@
 #include "fboss/agent/hw/sai/api/HostifApi.h"
 #include "fboss/agent/hw/sai/api/LoggingUtil.h"
 #include "fboss/agent/hw/sai/api/SaiApiTable.h"
+#include "fboss/agent/hw/sai/api/SaiBulkWrites.h"
 #include "fboss/agent/hw/sai/api/SaiObjectApi.h"
 #include "fboss/agent/hw/sai/api/Types.h"
 #include "fboss/agent/hw/sai/store/SaiStore.h"
@@ -61,6 +62,7 @@
 
 #include <folly/logging/xlog.h>
 
+#include <algorithm>
 #include <chrono>
 #include <optional>
 
@@ -104,6 +106,9 @@ const std::map<sai_fdb_event_t, facebook::fboss::L2EntryUpdateType>
         {SAI_FDB_EVENT_AGED,
          facebook::fboss::L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE},
 };
+
+// Ports whose stats are read under one hold of saiStatsMutex_
+constexpr size_t kPortStatsChunkSize = 16;
 } // namespace
 
 namespace facebook::fboss {
@@ -321,7 +326,10 @@ void SaiSwitch::rollback(
   // 2-4 are exactly the same as what we do for warmboot and piggy back
   // heavily on it for both code reuse and correctness
   try {
-    CoarseGrainedLockPolicy lockPolicy(saiSwitchMutex_);
+    // Managers and their handles are destroyed and recreated below, so
+    // keep stats collection, which only takes saiStatsMutex_, out
+    // throughout. The replayed stateChangedImpl() does not take it again.
+    CoarseGrainedLockPolicy lockPolicy(saiSwitchMutex_, saiStatsMutex_);
     auto hwSwitchJson = toFollyDynamicLocked(lockPolicy.lock());
     {
       HwWriteBehvaiorRAII writeBehavior{HwWriteBehavior::SKIP};
@@ -412,23 +420,28 @@ template <typename LockPolicyT>
 std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
     const StateDelta& delta,
     const LockPolicyT& lockPolicy) {
+  // Changes to ports, LAGs, hostif and resource usage also hold
+  // saiStatsMutex_, see updateStatsImpl
+  WithMutexLockPolicy<LockPolicyT> statsLockPolicy(
+      lockPolicy, saiStatsMutex_);
+
   // update switch settings first
   processSwitchSettingsChanged(delta, lockPolicy);
 
   processRemovedDelta(
       delta.getPortsDelta(),
       managerTable_->portManager(),
-      lockPolicy,
+      statsLockPolicy,
       &SaiPortManager::removePort);
   processChangedDelta(
       delta.getPortsDelta(),
       managerTable_->portManager(),
-      lockPolicy,
+      statsLockPolicy,
       &SaiPortManager::changePort);
   processAddedDelta(
       delta.getPortsDelta(),
       managerTable_->portManager(),
-      lockPolicy,
+      statsLockPolicy,
       &SaiPortManager::addPort);
   processDelta(
       delta.getVlansDelta(),
@@ -442,7 +455,7 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
   processDelta(
       delta.getAggregatePortsDelta(),
       managerTable_->lagManager(),
-      lockPolicy,
+      statsLockPolicy,
       &SaiLagManager::changeLag,
       &SaiLagManager::addLag,
       &SaiLagManager::removeLag);
@@ -453,7 +466,7 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
       [&](const std::shared_ptr<Port>& oldPort,
           const std::shared_ptr<Port>& newPort) {
         auto portID = oldPort->getID();
-        [[maybe_unused]] const auto& lock = lockPolicy.lock();
+        [[maybe_unused]] const auto& lock = statsLockPolicy.lock();
         if (managerTable_->lagManager().isLagMember(portID)) {
           // if port is member of lag, ignore it
           return;
@@ -464,7 +477,7 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
   DeltaFunctions::forEachAdded(
       delta.getPortsDelta(), [&](const std::shared_ptr<Port>& newPort) {
         auto portID = newPort->getID();
-        [[maybe_unused]] const auto& lock = lockPolicy.lock();
+        [[maybe_unused]] const auto& lock = statsLockPolicy.lock();
         if (managerTable_->lagManager().isLagMember(portID)) {
           // if port is member of lag, ignore it
           return;
@@ -476,23 +489,23 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
       delta.getAggregatePortsDelta(),
       [&](const std::shared_ptr<AggregatePort>& oldAggPort,
           const std::shared_ptr<AggregatePort>& newAggPort) {
-        [[maybe_unused]] const auto& lock = lockPolicy.lock();
+        [[maybe_unused]] const auto& lock = statsLockPolicy.lock();
         managerTable_->lagManager().changeBridgePort(oldAggPort, newAggPort);
       });
 
   DeltaFunctions::forEachAdded(
       delta.getAggregatePortsDelta(),
       [&](const std::shared_ptr<AggregatePort>& newAggPort) {
-        [[maybe_unused]] const auto& lock = lockPolicy.lock();
+        [[maybe_unused]] const auto& lock = statsLockPolicy.lock();
         managerTable_->lagManager().addBridgePort(newAggPort);
       });
 
   if (platform_->getAsic()->isSupported(HwAsic::Feature::QOS_MAP_GLOBAL)) {
     processDefaultDataPlanePolicyDelta(
-        delta, managerTable_->switchManager(), lockPolicy);
+        delta, managerTable_->switchManager(), statsLockPolicy);
   } else {
     processDefaultDataPlanePolicyDelta(
-        delta, managerTable_->portManager(), lockPolicy);
+        delta, managerTable_->portManager(), statsLockPolicy);
   }
 
   processDelta(
@@ -503,76 +516,98 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
       &SaiRouterInterfaceManager::addRouterInterface,
       &SaiRouterInterfaceManager::removeRouterInterface);
 
-  for (const auto& vlanDelta : delta.getVlansDelta()) {
-    processDelta(
-        vlanDelta.getArpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<ArpEntry>,
-        &SaiNeighborManager::addNeighbor<ArpEntry>,
-        &SaiNeighborManager::removeNeighbor<ArpEntry>);
-
-    processDelta(
-        vlanDelta.getNdpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<NdpEntry>,
-        &SaiNeighborManager::addNeighbor<NdpEntry>,
-        &SaiNeighborManager::removeNeighbor<NdpEntry>);
-
-    processDelta(
-        vlanDelta.getMacDelta(),
-        managerTable_->fdbManager(),
-        lockPolicy,
-        &SaiFdbManager::changeMac,
-        &SaiFdbManager::addMac,
-        &SaiFdbManager::removeMac);
-  }
-
-  auto processV4RoutesDelta = [this, &lockPolicy](
-                                  RouterID rid, const auto& routesDelta) {
-    processDelta(
-        routesDelta,
-        managerTable_->routeManager(),
-        lockPolicy,
-        &SaiRouteManager::changeRoute<folly::IPAddressV4>,
-        &SaiRouteManager::addRoute<folly::IPAddressV4>,
-        &SaiRouteManager::removeRoute<folly::IPAddressV4>,
-        rid);
-  };
-
-  auto processV6RoutesDelta = [this, &lockPolicy](
-                                  RouterID rid, const auto& routesDelta) {
-    processDelta(
-        routesDelta,
-        managerTable_->routeManager(),
-        lockPolicy,
-        &SaiRouteManager::changeRoute<folly::IPAddressV6>,
-        &SaiRouteManager::addRoute<folly::IPAddressV6>,
-        &SaiRouteManager::removeRoute<folly::IPAddressV6>,
-        rid);
-  };
-
   CHECK(FLAGS_enable_standalone_rib ? !legacyRibUsed(delta) : !fibUsed(delta));
 
-  for (const auto& routeDelta : delta.getFibsDelta()) {
-    auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
-                                        : routeDelta.getNew()->getID();
-    processV4RoutesDelta(
-        routerID, routeDelta.getFibDelta<folly::IPAddressV4>());
-    processV6RoutesDelta(
-        routerID, routeDelta.getFibDelta<folly::IPAddressV6>());
-  }
-  for (const auto& routeDelta : delta.getRouteTablesDelta()) {
-    auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
-                                        : routeDelta.getNew()->getID();
-    processV4RoutesDelta(routerID, routeDelta.getRoutesV4Delta());
-    processV6RoutesDelta(routerID, routeDelta.getRoutesV6Delta());
+  {
+    // Neighbor, FDB and route entries are the bulk of large deltas. Hand
+    // them to the adapter in bulk calls, see SaiBulkWriteScope.
+    SaiBulkWriteScope bulkWrites;
+    // Flushed at the end of each table's delta, so that errors in queued
+    // writes are thrown for the table whose objects they are. Objects whose
+    // create failed are not in the adapter, and must not be removed from
+    // it when the delta is rolled back.
+    auto flushBulkWrites = [this, &bulkWrites]() {
+      try {
+        bulkWrites.flush();
+      } catch (const SaiBulkWriteError& ex) {
+        saiStore_->handleFailedBulkWrites(ex);
+        throw;
+      }
+    };
+    for (const auto& vlanDelta : delta.getVlansDelta()) {
+      processDelta(
+          vlanDelta.getArpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::changeNeighbor<ArpEntry>,
+          &SaiNeighborManager::addNeighbor<ArpEntry>,
+          &SaiNeighborManager::removeNeighbor<ArpEntry>);
+      flushBulkWrites();
+
+      processDelta(
+          vlanDelta.getNdpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::changeNeighbor<NdpEntry>,
+          &SaiNeighborManager::addNeighbor<NdpEntry>,
+          &SaiNeighborManager::removeNeighbor<NdpEntry>);
+      flushBulkWrites();
+
+      processDelta(
+          vlanDelta.getMacDelta(),
+          managerTable_->fdbManager(),
+          lockPolicy,
+          &SaiFdbManager::changeMac,
+          &SaiFdbManager::addMac,
+          &SaiFdbManager::removeMac);
+      flushBulkWrites();
+    }
+
+    auto processV4RoutesDelta = [this, &lockPolicy, &flushBulkWrites](
+                                    RouterID rid, const auto& routesDelta) {
+      processDelta(
+          routesDelta,
+          managerTable_->routeManager(),
+          lockPolicy,
+          &SaiRouteManager::changeRoute<folly::IPAddressV4>,
+          &SaiRouteManager::addRoute<folly::IPAddressV4>,
+          &SaiRouteManager::removeRoute<folly::IPAddressV4>,
+          rid);
+      flushBulkWrites();
+    };
+
+    auto processV6RoutesDelta = [this, &lockPolicy, &flushBulkWrites](
+                                    RouterID rid, const auto& routesDelta) {
+      processDelta(
+          routesDelta,
+          managerTable_->routeManager(),
+          lockPolicy,
+          &SaiRouteManager::changeRoute<folly::IPAddressV6>,
+          &SaiRouteManager::addRoute<folly::IPAddressV6>,
+          &SaiRouteManager::removeRoute<folly::IPAddressV6>,
+          rid);
+      flushBulkWrites();
+    };
+
+    for (const auto& routeDelta : delta.getFibsDelta()) {
+      auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
+                                          : routeDelta.getNew()->getID();
+      processV4RoutesDelta(
+          routerID, routeDelta.getFibDelta<folly::IPAddressV4>());
+      processV6RoutesDelta(
+          routerID, routeDelta.getFibDelta<folly::IPAddressV6>());
+    }
+    for (const auto& routeDelta : delta.getRouteTablesDelta()) {
+      auto routerID = routeDelta.getOld() ? routeDelta.getOld()->getID()
+                                          : routeDelta.getNew()->getID();
+      processV4RoutesDelta(routerID, routeDelta.getRoutesV4Delta());
+      processV6RoutesDelta(routerID, routeDelta.getRoutesV6Delta());
+    }
   }
   {
     auto controlPlaneDelta = delta.getControlPlaneDelta();
     if (*controlPlaneDelta.getOld() != *controlPlaneDelta.getNew()) {
-      [[maybe_unused]] const auto& lock = lockPolicy.lock();
+      [[maybe_unused]] const auto& lock = statsLockPolicy.lock();
       managerTable_->hostifManager().processHostifDelta(controlPlaneDelta);
     }
   }
@@ -603,7 +638,7 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
 
   if (platform_->getAsic()->isSupported(
           HwAsic::Feature::RESOURCE_USAGE_STATS)) {
-    updateResourceUsage(lockPolicy);
+    updateResourceUsage(statsLockPolicy);
   }
 
   // Process link state change delta and update the LED status
@@ -731,38 +766,51 @@ bool SaiSwitch::sendPacketOutOfPortAsync(
 }
 
 void SaiSwitch::updateStatsImpl(SwitchStats* /* switchStats */) {
-  auto portsIter = concurrentIndices_->portIds.begin();
-  while (portsIter != concurrentIndices_->portIds.end()) {
-    {
-      std::lock_guard<std::mutex> locked(saiSwitchMutex_);
-      managerTable_->portManager().updateStats(portsIter->second);
-    }
-    ++portsIter;
+  // Ports' stats are read in bulk a chunk of ports at a time, releasing
+  // saiStatsMutex_ between chunks so that port changes are not held up
+  // behind all ports' stats, should the adapter only read them one port at a
+  // time. Whether to read queue watermarks is decided once for all chunks.
+  // Only port and queue api locks are taken, not saiSwitchMutex_.
+  bool updateWatermarks;
+  {
+    std::lock_guard<std::mutex> locked(saiStatsMutex_);
+    updateWatermarks = managerTable_->queueManager().watermarkStatsDue();
+  }
+  std::vector<PortID> portIds;
+  for (const auto& saiIdAndPortId : concurrentIndices_->portIds) {
+    portIds.push_back(saiIdAndPortId.second);
+  }
+  for (size_t start = 0; start < portIds.size();
+       start += kPortStatsChunkSize) {
+    auto end = std::min(start + kPortStatsChunkSize, portIds.size());
+    std::vector<PortID> chunk(portIds.begin() + start, portIds.begin() + end);
+    std::lock_guard<std::mutex> locked(saiStatsMutex_);
+    managerTable_->portManager().updateStats(chunk, updateWatermarks);
   }
   auto lagsIter = concurrentIndices_->aggregatePortIds.begin();
   while (lagsIter != concurrentIndices_->aggregatePortIds.end()) {
     {
-      std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+      std::lock_guard<std::mutex> locked(saiStatsMutex_);
       managerTable_->lagManager().updateStats(lagsIter->second);
     }
     ++lagsIter;
   }
   {
-    std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+    std::lock_guard<std::mutex> locked(saiStatsMutex_);
     managerTable_->hostifManager().updateStats();
   }
   {
-    std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+    std::lock_guard<std::mutex> locked(saiStatsMutex_);
     managerTable_->bufferManager().updateStats();
   }
   {
-    std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+    std::lock_guard<std::mutex> locked(saiStatsMutex_);
     HwResourceStatsPublisher().publish(hwResourceStats_);
   }
 }
 
 uint64_t SaiSwitch::getDeviceWatermarkBytes() const {
-  std::lock_guard<std::mutex> locked(saiSwitchMutex_);
+  std::lock_guard<std::mutex> locked(saiStatsMutex_);
   return getDeviceWatermarkBytesLocked(locked);
 }
 
@@ -772,7 +820,7 @@ uint64_t SaiSwitch::getDeviceWatermarkBytesLocked(
 }
 
 folly::F14FastMap<std::string, HwPortStats> SaiSwitch::getPortStats() const {
-  std::lock_guard<std::mutex> lock(saiSwitchMutex_);
+  std::lock_guard<std::mutex> lock(saiStatsMutex_);
   return getPortStatsLocked(lock);
 }
 
@@ -793,6 +841,7 @@ void SaiSwitch::fetchL2Table(std::vector<L2EntryThrift>* l2Table) const {
 
 void SaiSwitch::gracefulExit(folly::dynamic& switchState) {
   std::lock_guard<std::mutex> lock(saiSwitchMutex_);
+  std::lock_guard<std::mutex> statsLock(saiStatsMutex_);
   gracefulExitLocked(switchState, lock);
 }
 
@@ -857,7 +906,7 @@ void SaiSwitch::clearPortStats(
     const std::unique_ptr<std::vector<int32_t>>& ports) {
   auto& portManager = managerTable_->portManager();
   for (auto port : *ports) {
-    std::lock_guard<std::mutex> lock(saiSwitchMutex_);
+    std::lock_guard<std::mutex> lock(saiStatsMutex_);
     portManager.clearStats(static_cast<PortID>(port));
   }
 }
@@ -934,7 +983,7 @@ void SaiSwitch::linkStateChangedCallbackBottomHalf(
        * guaranteed to have the link be ready for packet transmission, since we
        * already resolved neighbors over that link.
        */
-      std::lock_guard<std::mutex> lock{saiSwitchMutex_};
+      std::scoped_lock lock{saiSwitchMutex_, saiStatsMutex_};
       if (swAggPort) {
         // member of lag is gone down. unbundle it from LAG
         // once link comes back up LACP engine in SwSwitch will bundle it again
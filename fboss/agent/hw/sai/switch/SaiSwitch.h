@@ -201,7 +201,8 @@ class SaiSwitch : public HwSwitch {
    *
    * The private methods take an additional argument -- a const ref to
    * lock_guard -- which ensures that a lock is held during the call.
-   * While it could be any lock, there is only saiSwitchMutex_ in this context.
+   * This is saiSwitchMutex_, except for the stats getters, which take
+   * saiStatsMutex_.
    *
    * The public methods take saiSwitchMutex_ with an std::lock_guard and then
    * call the Locked version passing the const lock_guard ref. The Locked
@@ -410,6 +411,16 @@ class SaiSwitch : public HwSwitch {
    * performance by 2000 pps.
    */
   mutable std::mutex saiSwitchMutex_;
+  /*
+   * Stats collection (5) only takes saiStatsMutex_, and only for all the
+   * ports, one LAG or one manager at a time, so it never holds up
+   * programming routes, neighbors or anything else that only takes
+   * saiSwitchMutex_. Everything that changes what stats collection reads
+   * (ports, LAGs, hostif queues, buffer pools, resource usage) holds
+   * saiStatsMutex_ as well, always locking it after saiSwitchMutex_.
+   * Rollback, which recreates all managers, holds it throughout.
+   */
+  mutable std::mutex saiStatsMutex_;
   std::unique_ptr<ConcurrentIndices> concurrentIndices_;
 
   SaiPlatform* platform_;
@@ -317,6 +317,39 @@ TEST_F(PortManagerTest, updateStats) {
   }
 }
 
+TEST_F(PortManagerTest, updateAllPortStats) {
+  std::shared_ptr<Port> port0 = makePort(p0);
+  std::shared_ptr<Port> port1 = makePort(p1);
+  saiManagerTable->portManager().addPort(port0);
+  saiManagerTable->portManager().addPort(port1);
+  saiManagerTable->portManager().updateStats();
+  for (const auto& swPort : {port0, port1}) {
+    auto portStat =
+        saiManagerTable->portManager().getLastPortStat(swPort->getID());
+    ASSERT_NE(portStat, nullptr);
+    for (auto statKey : HwPortFb303Stats::kPortStatKeys()) {
+      EXPECT_EQ(
+          portStat->getCounterLastIncrement(
+              HwPortFb303Stats::statName(statKey, swPort->getName())),
+          0);
+    }
+  }
+}
+
+TEST_F(PortManagerTest, updatePortStatsChunkSkipsRemovedPorts) {
+  std::shared_ptr<Port> port0 = makePort(p0);
+  std::shared_ptr<Port> port1 = makePort(p1);
+  saiManagerTable->portManager().addPort(port0);
+  saiManagerTable->portManager().addPort(port1);
+  saiManagerTable->portManager().removePort(port1);
+  saiManagerTable->portManager().updateStats(
+      {port0->getID(), port1->getID()}, true);
+  EXPECT_NE(
+      saiManagerTable->portManager().getLastPortStat(port0->getID()), nullptr);
+  EXPECT_EQ(
+      saiManagerTable->portManager().getLastPortStat(port1->getID()), nullptr);
+}
+
 TEST_F(PortManagerTest, portDisableStopsCounterExport) {
   std::shared_ptr<Port> swPort = makePort(p0);
   CHECK(swPort->isEnabled());
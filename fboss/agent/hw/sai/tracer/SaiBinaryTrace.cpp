@@ -0,0 +1,458 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <thread>
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/SysError.h"
+#include "fboss/agent/hw/sai/api/SaiVersion.h"
+
+#include <folly/FileUtil.h>
+#include <folly/ScopeGuard.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::fboss {
+
+namespace {
+
+// All SAI lists are a uint32_t count followed by a pointer to the elements
+struct SaiList {
+  uint32_t count;
+  void* list;
+};
+static_assert(offsetof(SaiList, list) == offsetof(sai_object_list_t, list));
+static_assert(offsetof(SaiList, list) == offsetof(sai_u32_list_t, list));
+static_assert(offsetof(SaiList, list) == offsetof(sai_s32_list_t, list));
+static_assert(offsetof(SaiList, list) == offsetof(sai_s8_list_t, list));
+static_assert(offsetof(SaiList, list) == offsetof(sai_qos_map_list_t, list));
+
+constexpr SaiAttrListField kObjectList{
+    offsetof(sai_attribute_value_t, objlist),
+    sizeof(sai_object_id_t)};
+constexpr SaiAttrListField kU32List{
+    offsetof(sai_attribute_value_t, u32list),
+    sizeof(sai_uint32_t)};
+constexpr SaiAttrListField kS32List{
+    offsetof(sai_attribute_value_t, s32list),
+    sizeof(sai_int32_t)};
+constexpr SaiAttrListField kS8List{
+    offsetof(sai_attribute_value_t, s8list),
+    sizeof(sai_int8_t)};
+constexpr SaiAttrListField kQosMapList{
+    offsetof(sai_attribute_value_t, qosmap),
+    sizeof(sai_qos_map_t)};
+constexpr SaiAttrListField kAclActionObjectList{
+    offsetof(sai_attribute_value_t, aclaction.parameter.objlist),
+    sizeof(sai_object_id_t)};
+
+SaiList* listOf(sai_attribute_t* attr, const SaiAttrListField& field) {
+  return reinterpret_cast<SaiList*>(
+      reinterpret_cast<uint8_t*>(&attr->value) + field.offset);
+}
+
+const SaiList* listOf(
+    const sai_attribute_t* attr,
+    const SaiAttrListField& field) {
+  return reinterpret_cast<const SaiList*>(
+      reinterpret_cast<const uint8_t*>(&attr->value) + field.offset);
+}
+
+void append(std::vector<uint8_t>* data, const void* src, size_t size) {
+  auto bytes = static_cast<const uint8_t*>(src);
+  data->insert(data->end(), bytes, bytes + size);
+}
+
+int64_t nowUsecs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+} // namespace
+
+std::optional<SaiAttrListField> getSaiAttrListField(
+    sai_object_type_t objectType,
+    sai_attr_id_t id) {
+  switch (objectType) {
+    case SAI_OBJECT_TYPE_ACL_ENTRY:
+      switch (id) {
+        case SAI_ACL_ENTRY_ATTR_ACTION_MIRROR_INGRESS:
+        case SAI_ACL_ENTRY_ATTR_ACTION_MIRROR_EGRESS:
+          return kAclActionObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_ACL_TABLE:
+      switch (id) {
+        case SAI_ACL_TABLE_ATTR_ACL_BIND_POINT_TYPE_LIST:
+        case SAI_ACL_TABLE_ATTR_ACL_ACTION_TYPE_LIST:
+          return kS32List;
+        case SAI_ACL_TABLE_ATTR_ENTRY_LIST:
+          return kObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_ACL_TABLE_GROUP:
+      switch (id) {
+        case SAI_ACL_TABLE_GROUP_ATTR_ACL_BIND_POINT_TYPE_LIST:
+          return kS32List;
+        case SAI_ACL_TABLE_GROUP_ATTR_MEMBER_LIST:
+          return kObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_BRIDGE:
+      if (id == SAI_BRIDGE_ATTR_PORT_LIST) {
+        return kObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_DEBUG_COUNTER:
+      if (id == SAI_DEBUG_COUNTER_ATTR_IN_DROP_REASON_LIST) {
+        return kS32List;
+      }
+      break;
+    case SAI_OBJECT_TYPE_HASH:
+      switch (id) {
+        case SAI_HASH_ATTR_NATIVE_HASH_FIELD_LIST:
+          return kS32List;
+        case SAI_HASH_ATTR_UDF_GROUP_LIST:
+          return kObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_LAG:
+      if (id == SAI_LAG_ATTR_PORT_LIST) {
+        return kObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_NEXT_HOP:
+      if (id == SAI_NEXT_HOP_ATTR_LABELSTACK) {
+        return kU32List;
+      }
+      break;
+    case SAI_OBJECT_TYPE_NEXT_HOP_GROUP:
+      if (id == SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_MEMBER_LIST) {
+        return kObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_PORT:
+      switch (id) {
+        case SAI_PORT_ATTR_HW_LANE_LIST:
+        case SAI_PORT_ATTR_SERDES_PREEMPHASIS:
+          return kU32List;
+        case SAI_PORT_ATTR_QOS_QUEUE_LIST:
+        case SAI_PORT_ATTR_EGRESS_MIRROR_SESSION:
+        case SAI_PORT_ATTR_INGRESS_MIRROR_SESSION:
+#if SAI_API_VERSION >= SAI_VERSION(1, 7, 0)
+        case SAI_PORT_ATTR_EGRESS_SAMPLE_MIRROR_SESSION:
+        case SAI_PORT_ATTR_INGRESS_SAMPLE_MIRROR_SESSION:
+#endif
+          return kObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_PORT_SERDES:
+      switch (id) {
+        case SAI_PORT_SERDES_ATTR_PREEMPHASIS:
+        case SAI_PORT_SERDES_ATTR_IDRIVER:
+        case SAI_PORT_SERDES_ATTR_TX_FIR_PRE1:
+        case SAI_PORT_SERDES_ATTR_TX_FIR_PRE2:
+        case SAI_PORT_SERDES_ATTR_TX_FIR_MAIN:
+        case SAI_PORT_SERDES_ATTR_TX_FIR_POST1:
+        case SAI_PORT_SERDES_ATTR_TX_FIR_POST2:
+        case SAI_PORT_SERDES_ATTR_TX_FIR_POST3:
+          return kU32List;
+      }
+      break;
+    case SAI_OBJECT_TYPE_QOS_MAP:
+      if (id == SAI_QOS_MAP_ATTR_MAP_TO_VALUE_LIST) {
+        return kQosMapList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_SWITCH:
+      switch (id) {
+        case SAI_SWITCH_ATTR_PORT_LIST:
+        case SAI_SWITCH_ATTR_TAM_OBJECT_ID:
+        case SAI_SWITCH_ATTR_PORT_CONNECTOR_LIST:
+        case SAI_SWITCH_ATTR_SYSTEM_PORT_CONFIG_LIST:
+          return kObjectList;
+        case SAI_SWITCH_ATTR_SWITCH_HARDWARE_INFO:
+        case SAI_SWITCH_ATTR_FIRMWARE_PATH_NAME:
+          return kS8List;
+      }
+      break;
+    case SAI_OBJECT_TYPE_TAM:
+      switch (id) {
+        case SAI_TAM_ATTR_EVENT_OBJECTS_LIST:
+          return kObjectList;
+        case SAI_TAM_ATTR_TAM_BIND_POINT_TYPE_LIST:
+          return kS32List;
+      }
+      break;
+    case SAI_OBJECT_TYPE_TAM_EVENT:
+      switch (id) {
+        case SAI_TAM_EVENT_ATTR_ACTION_LIST:
+        case SAI_TAM_EVENT_ATTR_COLLECTOR_LIST:
+          return kObjectList;
+      }
+      break;
+    case SAI_OBJECT_TYPE_VLAN:
+      if (id == SAI_VLAN_ATTR_MEMBER_LIST) {
+        return kObjectList;
+      }
+      break;
+    default:
+      break;
+  }
+  return std::nullopt;
+}
+
+SaiBinaryTraceWriter::SaiBinaryTraceWriter(
+    const std::string& filePath,
+    std::chrono::milliseconds flushInterval)
+    : flushInterval_(flushInterval),
+      file_(filePath, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND) {
+  SaiBinaryTraceFileHeader header{};
+  header.magic = kSaiBinaryTraceMagic;
+  header.version = kSaiBinaryTraceVersion;
+  if (folly::writeFull(file_.fd(), &header, sizeof(header)) < 0) {
+    throw SysError(errno, "error writing binary trace header to ", filePath);
+  }
+
+  flushScheduler_.setThreadName("SaiTraceFlush");
+  flushScheduler_.addFunction(
+      [this]() { flushIdleBuffers(); }, flushInterval_, "flushIdleBuffers");
+  flushScheduler_.start();
+}
+
+SaiBinaryTraceWriter::~SaiBinaryTraceWriter() {
+  flushScheduler_.shutdown();
+  // Tracing has stopped by now, so no thread touches its buffer anymore
+  for (auto& buffer : buffers_.accessAllThreads()) {
+    flush(&buffer);
+  }
+  fsync(file_.fd());
+}
+
+void SaiBinaryTraceWriter::flushIdleBuffers() {
+  auto now = std::chrono::steady_clock::now();
+  // Threads can not come and go while their buffers are being accessed
+  for (auto& buffer : buffers_.accessAllThreads()) {
+    if (!buffer.tryClaim(BufferState::FLUSHING)) {
+      // Tracing a call, so not idle
+      continue;
+    }
+    if (!buffer.data.empty() && now - buffer.firstPending >= flushInterval_) {
+      try {
+        flush(&buffer);
+      } catch (const std::exception& ex) {
+        XLOG(ERR) << "Failed to flush binary trace: " << ex.what();
+      }
+    }
+    buffer.release();
+  }
+}
+
+SaiBinaryTraceWriter::ThreadBuffer::~ThreadBuffer() {
+  // Only contended while the flush thread writes this buffer out, which it
+  // is soon done with
+  while (!tryClaim(BufferState::TRACING)) {
+    std::this_thread::yield();
+  }
+  try {
+    writer->flush(this);
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Dropping " << data.size()
+              << " bytes of binary trace: " << ex.what();
+  }
+}
+
+void SaiBinaryTraceWriter::writeCall(
+    SaiBinaryTraceOp op,
+    int32_t objectType,
+    sai_object_id_t objectId,
+    sai_object_id_t switchId,
+    folly::ByteRange key,
+    uint32_t attrCount,
+    const sai_attribute_t* attrList,
+    sai_status_t rv) {
+  auto buffer = buffers_.get();
+  if (!buffer) {
+    buffer = new ThreadBuffer(this);
+    buffers_.reset(buffer);
+    buffer->data.reserve(kFlushBytes * 2);
+  }
+  if (!buffer->tryClaim(BufferState::TRACING)) {
+    // The flush thread is writing the buffer out, so don't wait for it
+    std::vector<uint8_t> record;
+    appendRecord(
+        &record,
+        op,
+        objectType,
+        objectId,
+        switchId,
+        key,
+        attrCount,
+        attrList,
+        rv);
+    writeOut(record);
+    return;
+  }
+  SCOPE_EXIT {
+    buffer->release();
+  };
+  auto now = std::chrono::steady_clock::now();
+  if (buffer->data.empty()) {
+    buffer->firstPending = now;
+  }
+  appendRecord(
+      &buffer->data,
+      op,
+      objectType,
+      objectId,
+      switchId,
+      key,
+      attrCount,
+      attrList,
+      rv);
+  if (buffer->data.size() >= kFlushBytes ||
+      now - buffer->firstPending >= flushInterval_) {
+    flush(buffer);
+  }
+}
+
+void SaiBinaryTraceWriter::appendRecord(
+    std::vector<uint8_t>* data,
+    SaiBinaryTraceOp op,
+    int32_t objectType,
+    sai_object_id_t objectId,
+    sai_object_id_t switchId,
+    folly::ByteRange key,
+    uint32_t attrCount,
+    const sai_attribute_t* attrList,
+    sai_status_t rv) {
+  SaiBinaryTraceRecordHeader header{};
+  header.op = op;
+  header.sequence = sequence_.fetch_add(1, std::memory_order_relaxed);
+  header.timeUsecs = nowUsecs();
+  header.objectType = objectType;
+  header.rv = rv;
+  header.objectId = objectId;
+  header.switchId = switchId;
+  header.attrCount = attrCount;
+  header.keySize = key.size();
+
+  auto start = data->size();
+  data->resize(start + sizeof(header));
+  append(data, key.data(), key.size());
+  append(data, attrList, attrCount * sizeof(sai_attribute_t));
+  for (uint32_t i = 0; i < attrCount; ++i) {
+    auto field = getSaiAttrListField(
+        static_cast<sai_object_type_t>(objectType), attrList[i].id);
+    if (!field) {
+      continue;
+    }
+    auto list = listOf(&attrList[i], *field);
+    uint32_t size = list->list
+        ? static_cast<uint32_t>(list->count * field->elemSize)
+        : kSaiBinaryTraceNullList;
+    append(data, &size, sizeof(size));
+    if (list->list) {
+      append(data, list->list, size);
+    }
+  }
+  header.size = data->size() - start;
+  std::memcpy(data->data() + start, &header, sizeof(header));
+}
+
+void SaiBinaryTraceWriter::writeOut(const std::vector<uint8_t>& data) {
+  // Appends are atomic, so records written by different threads can't
+  // interleave
+  if (folly::writeFull(file_.fd(), data.data(), data.size()) < 0) {
+    throw SysError(
+        errno, "error writing ", data.size(), " bytes of binary trace");
+  }
+}
+
+void SaiBinaryTraceWriter::flush(ThreadBuffer* buffer) {
+  if (buffer->data.empty()) {
+    return;
+  }
+  writeOut(buffer->data);
+  buffer->data.clear();
+}
+
+std::vector<SaiBinaryTraceRecord> readSaiBinaryTrace(const std::string& path) {
+  std::string trace;
+  if (!folly::readFile(path.c_str(), trace)) {
+    throw SysError(errno, "error reading binary trace ", path);
+  }
+
+  SaiBinaryTraceFileHeader fileHeader;
+  if (trace.size() < sizeof(fileHeader)) {
+    throw FbossError("binary trace ", path, " is too short for its header");
+  }
+  std::memcpy(&fileHeader, trace.data(), sizeof(fileHeader));
+  if (fileHeader.magic != kSaiBinaryTraceMagic ||
+      fileHeader.version != kSaiBinaryTraceVersion) {
+    throw FbossError(
+        path, " is not a binary trace of version ", kSaiBinaryTraceVersion);
+  }
+
+  std::vector<SaiBinaryTraceRecord> records;
+  folly::ByteRange remaining(
+      reinterpret_cast<const uint8_t*>(trace.data()) + sizeof(fileHeader),
+      trace.size() - sizeof(fileHeader));
+  auto take = [&](void* dst, size_t size) {
+    if (remaining.size() < size) {
+      throw FbossError(
+          "binary trace ", path, " ends within record ", records.size());
+    }
+    std::memcpy(dst, remaining.data(), size);
+    remaining.advance(size);
+  };
+  while (!remaining.empty()) {
+    SaiBinaryTraceRecord record;
+    auto recordStart = remaining.size();
+    take(&record.header, sizeof(record.header));
+    record.key.resize(record.header.keySize);
+    take(record.key.data(), record.key.size());
+    record.attrs.resize(record.header.attrCount);
+    take(record.attrs.data(), record.attrs.size() * sizeof(sai_attribute_t));
+    for (auto& attr : record.attrs) {
+      auto field = getSaiAttrListField(
+          static_cast<sai_object_type_t>(record.header.objectType), attr.id);
+      if (!field) {
+        continue;
+      }
+      uint32_t size;
+      take(&size, sizeof(size));
+      auto list = listOf(&attr, *field);
+      if (size == kSaiBinaryTraceNullList) {
+        list->list = nullptr;
+        continue;
+      }
+      record.lists.push_back(std::make_unique<uint8_t[]>(size));
+      take(record.lists.back().get(), size);
+      list->list = record.lists.back().get();
+    }
+    if (recordStart - remaining.size() != record.header.size) {
+      throw FbossError(
+          "binary trace ", path, " has a malformed record ", records.size());
+    }
+    records.push_back(std::move(record));
+  }
+
+  std::sort(records.begin(), records.end(), [](const auto& a, const auto& b) {
+    return a.header.sequence < b.header.sequence;
+  });
+  return records;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <folly/File.h>
+#include <folly/Range.h>
+#include <folly/ThreadLocal.h>
+#include <folly/experimental/FunctionScheduler.h>
+
+extern "C" {
+#include <sai.h>
+}
+
+namespace facebook::fboss {
+
+/*
+ * Binary SAI call trace, an alternative to formatting every traced call into
+ * C code on the calling thread. Calls are recorded as they are made, and
+ * converted into the same replayable C code offline by sai_replayer_gen.
+ *
+ * The trace is a header followed by records, each being a
+ * SaiBinaryTraceRecordHeader followed by
+ *  - keySize bytes of call specific data: the function name for calls on
+ *    objects with ids, the raw sai_*_entry_t for calls on entries, the
+ *    profile key/value strings for sai_api_initialize() and the packet for
+ *    send_hostif_packet()
+ *  - attrCount raw sai_attribute_t
+ *  - for each attribute holding a list (see getSaiAttrListField()), in
+ *    attribute order, a uint32_t byte count followed by the list elements.
+ *    A count of kSaiBinaryTraceNullList stands for a null list pointer.
+ *
+ * Records of different threads are interleaved as their buffers are flushed,
+ * so they are ordered by their sequence number rather than by their position
+ * in the trace. Values are in host byte order: traces are meant to be
+ * converted on a machine of the same architecture.
+ */
+constexpr uint64_t kSaiBinaryTraceMagic = 0x4352545f49415346; // FSAI_TRC
+constexpr uint32_t kSaiBinaryTraceVersion = 1;
+constexpr uint32_t kSaiBinaryTraceNullList = 0xffffffff;
+
+enum class SaiBinaryTraceOp : uint8_t {
+  API_INITIALIZE,
+  API_QUERY,
+  CREATE,
+  REMOVE,
+  SET_ATTRIBUTE,
+  SEND_HOSTIF_PACKET,
+};
+
+struct SaiBinaryTraceFileHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t reserved;
+};
+
+struct SaiBinaryTraceRecordHeader {
+  // Size of the whole record, this header included
+  uint32_t size;
+  SaiBinaryTraceOp op;
+  uint8_t reserved[3];
+  uint64_t sequence;
+  // Microseconds since the epoch, of the system clock
+  int64_t timeUsecs;
+  // sai_api_t for API_QUERY, sai_object_type_t otherwise
+  int32_t objectType;
+  sai_status_t rv;
+  sai_object_id_t objectId;
+  sai_object_id_t switchId;
+  uint32_t attrCount;
+  uint32_t keySize;
+};
+
+/*
+ * Where in sai_attribute_value_t an attribute keeps its list, for those
+ * whose value points to a list: a uint32_t count followed by the pointer
+ * to count elements of elemSize bytes.
+ */
+struct SaiAttrListField {
+  size_t offset;
+  size_t elemSize;
+};
+
+// Must cover every list attribute the set*Attributes() tracer functions handle
+std::optional<SaiAttrListField> getSaiAttrListField(
+    sai_object_type_t objectType,
+    sai_attr_id_t id);
+
+/*
+ * Appends records to the calling thread's own buffer, which is written out
+ * once it holds kFlushBytes, once its oldest record is older than the flush
+ * interval, or when the thread or the writer goes away. Tracing a call so
+ * takes no formatting, just copying the call arguments, and no lock.
+ *
+ * A flush thread writes out the buffers of threads that have stopped
+ * tracing calls, once their oldest record is older than the flush
+ * interval. Either thread claims a buffer with a compare-and-swap, and
+ * neither waits for the other: the flush thread skips a buffer in use, and
+ * a call traced while the flush thread writes its buffer out is written
+ * out on its own. The trace is opened for appending and each buffer goes
+ * out in a single write, so no lock is needed around the file either.
+ */
+class SaiBinaryTraceWriter {
+ public:
+  static constexpr size_t kFlushBytes = 64 * 1024;
+
+  SaiBinaryTraceWriter(
+      const std::string& filePath,
+      std::chrono::milliseconds flushInterval);
+  ~SaiBinaryTraceWriter();
+
+  void writeCall(
+      SaiBinaryTraceOp op,
+      int32_t objectType,
+      sai_object_id_t objectId,
+      sai_object_id_t switchId,
+      folly::ByteRange key,
+      uint32_t attrCount,
+      const sai_attribute_t* attrList,
+      sai_status_t rv);
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  SaiBinaryTraceWriter(SaiBinaryTraceWriter const&) = delete;
+  SaiBinaryTraceWriter& operator=(SaiBinaryTraceWriter const&) = delete;
+
+  enum class BufferState : uint8_t { IDLE, TRACING, FLUSHING };
+
+  struct ThreadBuffer {
+    explicit ThreadBuffer(SaiBinaryTraceWriter* writer) : writer(writer) {}
+    ~ThreadBuffer();
+
+    bool tryClaim(BufferState claimant) {
+      auto idle = BufferState::IDLE;
+      return state.compare_exchange_strong(
+          idle, claimant, std::memory_order_acquire);
+    }
+    void release() {
+      state.store(BufferState::IDLE, std::memory_order_release);
+    }
+
+    SaiBinaryTraceWriter* const writer;
+    // TRACING while the owning thread appends to data, FLUSHING while the
+    // flush thread writes it out
+    std::atomic<BufferState> state{BufferState::IDLE};
+    std::vector<uint8_t> data;
+    std::chrono::steady_clock::time_point firstPending;
+  };
+  class ThreadBufferTag;
+
+  void appendRecord(
+      std::vector<uint8_t>* data,
+      SaiBinaryTraceOp op,
+      int32_t objectType,
+      sai_object_id_t objectId,
+      sai_object_id_t switchId,
+      folly::ByteRange key,
+      uint32_t attrCount,
+      const sai_attribute_t* attrList,
+      sai_status_t rv);
+  void writeOut(const std::vector<uint8_t>& data);
+  // Must be called with the buffer claimed
+  void flush(ThreadBuffer* buffer);
+  void flushIdleBuffers();
+
+  const std::chrono::milliseconds flushInterval_;
+  std::atomic<uint64_t> sequence_{0};
+  folly::File file_;
+  folly::ThreadLocalPtr<ThreadBuffer, ThreadBufferTag> buffers_;
+  folly::FunctionScheduler flushScheduler_;
+};
+
+/*
+ * A record read back from a binary trace, with its attributes pointing to
+ * lists of its own.
+ */
+struct SaiBinaryTraceRecord {
+  SaiBinaryTraceRecordHeader header;
+  std::string key;
+  std::vector<sai_attribute_t> attrs;
+  std::vector<std::unique_ptr<uint8_t[]>> lists;
+};
+
+// Read all records of a binary trace, ordered by sequence number
+std::vector<SaiBinaryTraceRecord> readSaiBinaryTrace(const std::string& path);
+
+} // namespace facebook::fboss
@@ -8,11 +8,13 @@
  *
  */
 #include <chrono>
+#include <cstring>
 #include <ctime>
 #include <iomanip>
 #include <ostream>
 #include <tuple>
 
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/SysError.h"
 #include "fboss/agent/hw/sai/tracer/AclApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/BridgeApiTracer.h"
@@ -33,6 +35,7 @@
 #include "fboss/agent/hw/sai/tracer/QueueApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/RouteApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/RouterInterfaceApiTracer.h"
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
 #include "fboss/agent/hw/sai/tracer/SaiTracer.h"
 #include "fboss/agent/hw/sai/tracer/SamplePacketApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/SchedulerApiTracer.h"
@@ -69,6 +72,18 @@ DEFINE_string(
     "/var/facebook/logs/fboss/sdk/sai_replayer.log",
     "File path to the SAI Replayer logs");
 
+DEFINE_bool(
+    enable_binary_replayer_log,
+    false,
+    "Record traced calls in a binary trace at --sai_binary_log instead of "
+    "formatting them into C code on the calling thread. The trace is turned "
+    "into the same C code offline by sai_replayer_gen.");
+
+DEFINE_string(
+    sai_binary_log,
+    "/var/facebook/logs/fboss/sdk/sai_replayer.bin",
+    "File path to the SAI Replayer binary trace");
+
 DEFINE_int32(
     default_list_size,
     1024,
@@ -312,12 +327,35 @@ namespace {
 
 folly::Singleton<facebook::fboss::SaiTracer> _saiTracer;
 
+template <typename Entry>
+folly::ByteRange bytesOf(const Entry* entry) {
+  return folly::ByteRange(
+      reinterpret_cast<const uint8_t*>(entry), sizeof(Entry));
+}
+
+template <typename Entry>
+Entry entryOf(const std::string& key) {
+  Entry entry;
+  if (key.size() != sizeof(Entry)) {
+    throw facebook::fboss::FbossError(
+        "Binary trace entry of ",
+        key.size(),
+        " bytes, expected ",
+        sizeof(Entry));
+  }
+  std::memcpy(&entry, key.data(), sizeof(Entry));
+  return entry;
+}
+
 } // namespace
 
 namespace facebook::fboss {
 
 SaiTracer::SaiTracer() {
-  if (FLAGS_enable_replayer) {
+  if (FLAGS_enable_replayer && FLAGS_enable_binary_replayer_log) {
+    binaryWriter_ = std::make_unique<SaiBinaryTraceWriter>(
+        FLAGS_sai_binary_log, std::chrono::milliseconds(FLAGS_log_timeout));
+  } else if (FLAGS_enable_replayer) {
     asyncLogger_ = std::make_unique<AsyncLogger>(
         FLAGS_sai_log, FLAGS_log_timeout, AsyncLogger::SAI_REPLAYER);
 
@@ -330,7 +368,9 @@ SaiTracer::SaiTracer() {
 }
 
 SaiTracer::~SaiTracer() {
-  if (FLAGS_enable_replayer) {
+  if (binaryWriter_) {
+    binaryWriter_.reset();
+  } else if (FLAGS_enable_replayer) {
     writeFooter();
     asyncLogger_->forceFlush();
     asyncLogger_->stopFlushThread();
@@ -361,6 +401,25 @@ void SaiTracer::logApiInitialize(
     const char** variables,
     const char** values,
     int size) {
+  if (binaryWriter_) {
+    // Profile keys and values, each null terminated
+    string profile;
+    for (int i = 0; i < size; ++i) {
+      profile.append(variables[i]).push_back('\0');
+      profile.append(values[i]).push_back('\0');
+    }
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::API_INITIALIZE,
+        SAI_OBJECT_TYPE_NULL,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        folly::ByteRange(folly::StringPiece(profile)),
+        0,
+        nullptr,
+        SAI_STATUS_SUCCESS);
+    return;
+  }
+
   vector<string> lines;
 
   for (int i = 0; i < size; ++i) {
@@ -396,6 +455,19 @@ void SaiTracer::logApiQuery(sai_api_t api_id, const std::string& api_var) {
 
   init_api_.emplace(api_id, api_var);
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::API_QUERY,
+        api_id,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        folly::ByteRange(folly::StringPiece(api_var)),
+        0,
+        nullptr,
+        SAI_STATUS_SUCCESS);
+    return;
+  }
+
   writeToFile(
       {to<string>("sai_", api_var, "_t* ", api_var),
        to<string>(
@@ -411,6 +483,19 @@ void SaiTracer::logSwitchCreateFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_SWITCH,
+        *switch_id,
+        SAI_NULL_OBJECT_ID,
+        folly::ByteRange(),
+        attr_count,
+        attr_list,
+        rv);
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_SWITCH);
@@ -453,6 +538,19 @@ void SaiTracer::logRouteEntryCreateFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_ROUTE_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(route_entry),
+        attr_count,
+        attr_list,
+        rv);
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_ROUTE_ENTRY);
@@ -489,6 +587,19 @@ void SaiTracer::logNeighborEntryCreateFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_NEIGHBOR_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(neighbor_entry),
+        attr_count,
+        attr_list,
+        rv);
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_NEIGHBOR_ENTRY);
@@ -525,6 +636,19 @@ void SaiTracer::logFdbEntryCreateFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_FDB_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(fdb_entry),
+        attr_count,
+        attr_list,
+        rv);
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_FDB_ENTRY);
@@ -561,6 +685,19 @@ void SaiTracer::logInsegEntryCreateFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_INSEG_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(inseg_entry),
+        attr_count,
+        attr_list,
+        rv);
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_INSEG_ENTRY);
@@ -600,6 +737,19 @@ void SaiTracer::logCreateFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::CREATE,
+        object_type,
+        *create_object_id,
+        switch_id,
+        folly::ByteRange(folly::StringPiece(fn_name)),
+        attr_count,
+        attr_list,
+        rv);
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines = setAttrList(attr_list, attr_count, object_type);
 
@@ -629,6 +779,18 @@ void SaiTracer::logRouteEntryRemoveFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::REMOVE,
+        SAI_OBJECT_TYPE_ROUTE_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(route_entry),
+        0, nullptr,
+        rv);
+    return;
+  }
+
   vector<string> lines{};
   setRouteEntry(route_entry, lines);
 
@@ -656,6 +818,18 @@ void SaiTracer::logNeighborEntryRemoveFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::REMOVE,
+        SAI_OBJECT_TYPE_NEIGHBOR_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(neighbor_entry),
+        0, nullptr,
+        rv);
+    return;
+  }
+
   vector<string> lines{};
   setNeighborEntry(neighbor_entry, lines);
 
@@ -683,6 +857,18 @@ void SaiTracer::logFdbEntryRemoveFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::REMOVE,
+        SAI_OBJECT_TYPE_FDB_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(fdb_entry),
+        0, nullptr,
+        rv);
+    return;
+  }
+
   vector<string> lines{};
   setFdbEntry(fdb_entry, lines);
 
@@ -710,6 +896,18 @@ void SaiTracer::logInsegEntryRemoveFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::REMOVE,
+        SAI_OBJECT_TYPE_INSEG_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(inseg_entry),
+        0, nullptr,
+        rv);
+    return;
+  }
+
   vector<string> lines{};
   setInsegEntry(inseg_entry, lines);
 
@@ -739,6 +937,19 @@ void SaiTracer::logRemoveFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::REMOVE,
+        object_type,
+        remove_object_id,
+        SAI_NULL_OBJECT_ID,
+        folly::ByteRange(folly::StringPiece(fn_name)),
+        0,
+        nullptr,
+        rv);
+    return;
+  }
+
   vector<string> lines{};
 
   // Log current timestamp, object id and return value
@@ -771,6 +982,18 @@ void SaiTracer::logRouteEntrySetAttrFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::SET_ATTRIBUTE,
+        SAI_OBJECT_TYPE_ROUTE_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(route_entry),
+        1, attr,
+        rv);
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, SAI_OBJECT_TYPE_ROUTE_ENTRY);
 
@@ -802,6 +1025,18 @@ void SaiTracer::logNeighborEntrySetAttrFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::SET_ATTRIBUTE,
+        SAI_OBJECT_TYPE_NEIGHBOR_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(neighbor_entry),
+        1, attr,
+        rv);
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, SAI_OBJECT_TYPE_NEIGHBOR_ENTRY);
 
@@ -833,6 +1068,18 @@ void SaiTracer::logFdbEntrySetAttrFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::SET_ATTRIBUTE,
+        SAI_OBJECT_TYPE_FDB_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(fdb_entry),
+        1, attr,
+        rv);
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, SAI_OBJECT_TYPE_FDB_ENTRY);
 
@@ -864,6 +1111,18 @@ void SaiTracer::logInsegEntrySetAttrFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::SET_ATTRIBUTE,
+        SAI_OBJECT_TYPE_INSEG_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        bytesOf(inseg_entry),
+        1, attr,
+        rv);
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, SAI_OBJECT_TYPE_INSEG_ENTRY);
 
@@ -897,6 +1156,19 @@ void SaiTracer::logSetAttrFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::SET_ATTRIBUTE,
+        object_type,
+        set_object_id,
+        SAI_NULL_OBJECT_ID,
+        folly::ByteRange(folly::StringPiece(fn_name)),
+        1,
+        attr,
+        rv);
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, object_type);
 
@@ -930,6 +1202,19 @@ void SaiTracer::logSendHostifPacketFn(
     return;
   }
 
+  if (binaryWriter_) {
+    binaryWriter_->writeCall(
+        SaiBinaryTraceOp::SEND_HOSTIF_PACKET,
+        SAI_OBJECT_TYPE_HOSTIF_PACKET,
+        hostif_id,
+        SAI_NULL_OBJECT_ID,
+        folly::ByteRange(buffer, buffer_size),
+        attr_count,
+        attr_list,
+        rv);
+    return;
+  }
+
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_HOSTIF_PACKET);
 
@@ -1305,7 +1590,8 @@ string SaiTracer::rvCheck(sai_status_t rv) {
 }
 
 string SaiTracer::logTimeAndRv(sai_status_t rv, sai_object_id_t object_id) {
-  auto now = std::chrono::system_clock::now();
+  // Calls converted from a binary trace are logged with their original time
+  auto now = callTime_.value_or(std::chrono::system_clock::now());
   auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                     now.time_since_epoch()) %
       1000;
@@ -1395,6 +1681,145 @@ void SaiTracer::setupGlobals() {
   numCalls_ = 0;
 }
 
+void SaiTracer::logBinaryTraceRecord(const SaiBinaryTraceRecord& record) {
+  const auto& header = record.header;
+  callTime_ = std::chrono::system_clock::time_point(
+      std::chrono::microseconds(header.timeUsecs));
+  auto objectType = static_cast<sai_object_type_t>(header.objectType);
+  auto attrList = record.attrs.data();
+  auto attrCount = static_cast<uint32_t>(record.attrs.size());
+  auto objectId = header.objectId;
+
+  switch (header.op) {
+    case SaiBinaryTraceOp::API_INITIALIZE: {
+      // Keys and values are null terminated, so point right into the key
+      vector<const char*> strings;
+      size_t pos = 0;
+      while (pos < record.key.size()) {
+        strings.push_back(record.key.c_str() + pos);
+        pos = record.key.find('\0', pos);
+        if (pos == string::npos) {
+          break;
+        }
+        ++pos;
+      }
+      vector<const char*> variables;
+      vector<const char*> values;
+      for (size_t i = 0; i + 1 < strings.size(); i += 2) {
+        variables.push_back(strings[i]);
+        values.push_back(strings[i + 1]);
+      }
+      logApiInitialize(
+          variables.data(), values.data(), static_cast<int>(variables.size()));
+      break;
+    }
+    case SaiBinaryTraceOp::API_QUERY:
+      logApiQuery(static_cast<sai_api_t>(header.objectType), record.key);
+      break;
+    case SaiBinaryTraceOp::CREATE:
+      switch (objectType) {
+        case SAI_OBJECT_TYPE_SWITCH:
+          logSwitchCreateFn(&objectId, attrCount, attrList, header.rv);
+          break;
+        case SAI_OBJECT_TYPE_ROUTE_ENTRY: {
+          auto entry = entryOf<sai_route_entry_t>(record.key);
+          logRouteEntryCreateFn(&entry, attrCount, attrList, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_NEIGHBOR_ENTRY: {
+          auto entry = entryOf<sai_neighbor_entry_t>(record.key);
+          logNeighborEntryCreateFn(&entry, attrCount, attrList, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_FDB_ENTRY: {
+          auto entry = entryOf<sai_fdb_entry_t>(record.key);
+          logFdbEntryCreateFn(&entry, attrCount, attrList, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_INSEG_ENTRY: {
+          auto entry = entryOf<sai_inseg_entry_t>(record.key);
+          logInsegEntryCreateFn(&entry, attrCount, attrList, header.rv);
+          break;
+        }
+        default:
+          logCreateFn(
+              record.key,
+              &objectId,
+              header.switchId,
+              attrCount,
+              attrList,
+              objectType,
+              header.rv);
+      }
+      break;
+    case SaiBinaryTraceOp::REMOVE:
+      switch (objectType) {
+        case SAI_OBJECT_TYPE_ROUTE_ENTRY: {
+          auto entry = entryOf<sai_route_entry_t>(record.key);
+          logRouteEntryRemoveFn(&entry, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_NEIGHBOR_ENTRY: {
+          auto entry = entryOf<sai_neighbor_entry_t>(record.key);
+          logNeighborEntryRemoveFn(&entry, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_FDB_ENTRY: {
+          auto entry = entryOf<sai_fdb_entry_t>(record.key);
+          logFdbEntryRemoveFn(&entry, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_INSEG_ENTRY: {
+          auto entry = entryOf<sai_inseg_entry_t>(record.key);
+          logInsegEntryRemoveFn(&entry, header.rv);
+          break;
+        }
+        default:
+          logRemoveFn(record.key, objectId, objectType, header.rv);
+      }
+      break;
+    case SaiBinaryTraceOp::SET_ATTRIBUTE:
+      switch (objectType) {
+        case SAI_OBJECT_TYPE_ROUTE_ENTRY: {
+          auto entry = entryOf<sai_route_entry_t>(record.key);
+          logRouteEntrySetAttrFn(&entry, attrList, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_NEIGHBOR_ENTRY: {
+          auto entry = entryOf<sai_neighbor_entry_t>(record.key);
+          logNeighborEntrySetAttrFn(&entry, attrList, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_FDB_ENTRY: {
+          auto entry = entryOf<sai_fdb_entry_t>(record.key);
+          logFdbEntrySetAttrFn(&entry, attrList, header.rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_INSEG_ENTRY: {
+          auto entry = entryOf<sai_inseg_entry_t>(record.key);
+          logInsegEntrySetAttrFn(&entry, attrList, header.rv);
+          break;
+        }
+        default:
+          logSetAttrFn(record.key, objectId, attrList, objectType, header.rv);
+      }
+      break;
+    case SaiBinaryTraceOp::SEND_HOSTIF_PACKET:
+      logSendHostifPacketFn(
+          objectId,
+          record.key.size(),
+          reinterpret_cast<const uint8_t*>(record.key.data()),
+          attrCount,
+          attrList,
+          header.rv);
+      break;
+    default:
+      throw FbossError(
+          "Unknown binary trace op ", static_cast<int>(header.op));
+  }
+  callTime_.reset();
+}
+
 void SaiTracer::writeFooter() {
   string footer = "free(s_a);\n}\n} // namespace facebook::fboss";
 
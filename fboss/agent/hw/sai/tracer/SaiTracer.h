@@ -9,12 +9,15 @@
  */
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <tuple>
 
 #include "fboss/agent/AsyncLogger.h"
 #include "fboss/agent/hw/sai/api/SaiVersion.h"
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
 
 #include <folly/File.h>
 #include <folly/String.h>
@@ -27,6 +30,7 @@ extern "C" {
 
 DECLARE_bool(enable_replayer);
 DECLARE_bool(enable_packet_log);
+DECLARE_bool(enable_binary_replayer_log);
 
 namespace facebook::fboss {
 
@@ -137,6 +141,9 @@ class SaiTracer {
       const sai_attribute_t* attr_list,
       sai_status_t rv);
 
+  // Log a call read back from a binary trace as C code
+  void logBinaryTraceRecord(const SaiBinaryTraceRecord& record);
+
   std::string getVariable(sai_object_id_t object_id);
 
   uint32_t
@@ -225,6 +232,10 @@ class SaiTracer {
   uint32_t maxListCount_;
   uint32_t numCalls_;
   std::unique_ptr<AsyncLogger> asyncLogger_;
+  // Set instead of asyncLogger_ when recording a binary trace
+  std::unique_ptr<SaiBinaryTraceWriter> binaryWriter_;
+  // Time of the binary trace record being logged
+  std::optional<std::chrono::system_clock::time_point> callTime_;
 
   // Variables mappings in generated C code
   // varCounts map from object type to the current counter
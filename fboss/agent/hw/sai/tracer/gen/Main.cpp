@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Turns a binary trace recorded with --enable_binary_replayer_log into the
+ * C code the tracer would have logged while tracing.
+ */
+
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
+#include "fboss/agent/hw/sai/tracer/SaiTracer.h"
+
+#include <folly/init/Init.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+DEFINE_string(
+    binary_log,
+    "/var/facebook/logs/fboss/sdk/sai_replayer.bin",
+    "Binary trace to convert");
+
+DEFINE_string(
+    output_log,
+    "sai_replayer.log",
+    "File path to write the replayable C code to");
+
+DECLARE_string(sai_log);
+
+using namespace facebook::fboss;
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+
+  // Have the tracer log to the output, in text
+  FLAGS_enable_replayer = true;
+  FLAGS_enable_binary_replayer_log = false;
+  FLAGS_enable_packet_log = true;
+  FLAGS_sai_log = FLAGS_output_log;
+
+  auto records = readSaiBinaryTrace(FLAGS_binary_log);
+  auto tracer = SaiTracer::getInstance();
+  for (const auto& record : records) {
+    tracer->logBinaryTraceRecord(record);
+  }
+  XLOG(INFO) << "Converted " << records.size() << " calls from "
+             << FLAGS_binary_log << " to " << FLAGS_output_log;
+  return 0;
+}
@@ -0,0 +1,212 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
+#include "fboss/agent/hw/sai/tracer/SaiTracer.h"
+
+#include <folly/FileUtil.h>
+#include <folly/Range.h>
+#include <folly/synchronization/Baton.h>
+#include <folly/testing/TestUtil.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+DECLARE_string(sai_log);
+DECLARE_string(sai_binary_log);
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr sai_object_id_t kSwitchId = 0x21000000000000;
+constexpr sai_object_id_t kPortId = 0x1000000000001;
+
+sai_route_entry_t routeEntry() {
+  sai_route_entry_t entry{};
+  entry.switch_id = kSwitchId;
+  entry.vr_id = 0x3000000000000;
+  entry.destination.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+  entry.destination.addr.ip4 = 0x0a000000;
+  entry.destination.mask.ip4 = 0xffffff00;
+  return entry;
+}
+
+// Calls of each kind the binary trace records, with and without lists
+void traceCalls(SaiTracer& tracer) {
+  sai_object_id_t switchId = kSwitchId;
+  sai_attribute_t switchAttr{};
+  switchAttr.id = SAI_SWITCH_ATTR_INIT_SWITCH;
+  switchAttr.value.booldata = true;
+  tracer.logSwitchCreateFn(&switchId, 1, &switchAttr, SAI_STATUS_SUCCESS);
+
+  uint32_t lanes[] = {1, 2, 3, 4};
+  sai_attribute_t portAttrs[2]{};
+  portAttrs[0].id = SAI_PORT_ATTR_HW_LANE_LIST;
+  portAttrs[0].value.u32list.count = 4;
+  portAttrs[0].value.u32list.list = lanes;
+  portAttrs[1].id = SAI_PORT_ATTR_SPEED;
+  portAttrs[1].value.u32 = 100000;
+  sai_object_id_t portId = kPortId;
+  tracer.logCreateFn(
+      "create_port",
+      &portId,
+      kSwitchId,
+      2,
+      portAttrs,
+      SAI_OBJECT_TYPE_PORT,
+      SAI_STATUS_SUCCESS);
+
+  sai_attribute_t adminState{};
+  adminState.id = SAI_PORT_ATTR_ADMIN_STATE;
+  adminState.value.booldata = true;
+  tracer.logSetAttrFn(
+      "set_port_attribute",
+      kPortId,
+      &adminState,
+      SAI_OBJECT_TYPE_PORT,
+      SAI_STATUS_SUCCESS);
+
+  auto entry = routeEntry();
+  sai_attribute_t routeAttrs[2]{};
+  routeAttrs[0].id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
+  routeAttrs[0].value.s32 = SAI_PACKET_ACTION_FORWARD;
+  routeAttrs[1].id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
+  routeAttrs[1].value.oid = 0x5000000000001;
+  tracer.logRouteEntryCreateFn(&entry, 2, routeAttrs, SAI_STATUS_SUCCESS);
+  tracer.logRouteEntryRemoveFn(&entry, SAI_STATUS_SUCCESS);
+
+  tracer.logRemoveFn(
+      "remove_port", kPortId, SAI_OBJECT_TYPE_PORT, SAI_STATUS_SUCCESS);
+}
+
+std::string readWithoutTimes(const std::string& path) {
+  std::string contents;
+  EXPECT_TRUE(folly::readFile(path.c_str(), contents));
+  // Calls are traced at different times in each run
+  static const std::regex kTime(
+      "[0-9]{4}-[0-9]{2}-[0-9]{2} [0-9]{2}:[0-9]{2}:[0-9]{2}(\\.[0-9]+)?");
+  return std::regex_replace(contents, kTime, "<time>");
+}
+
+void writeRouteCreate(SaiBinaryTraceWriter& writer, uint32_t ip4) {
+  auto entry = routeEntry();
+  entry.destination.addr.ip4 = ip4;
+  writer.writeCall(
+      SaiBinaryTraceOp::CREATE,
+      SAI_OBJECT_TYPE_ROUTE_ENTRY,
+      SAI_NULL_OBJECT_ID,
+      SAI_NULL_OBJECT_ID,
+      folly::ByteRange(reinterpret_cast<const uint8_t*>(&entry), sizeof(entry)),
+      0,
+      nullptr,
+      SAI_STATUS_SUCCESS);
+}
+
+} // namespace
+
+TEST(SaiBinaryTraceTest, convertedTraceMatchesTextTrace) {
+  gflags::FlagSaver flagSaver;
+  folly::test::TemporaryDirectory tmpDir;
+  auto binaryLog = (tmpDir.path() / "trace.bin").string();
+  auto textLog = (tmpDir.path() / "text.log").string();
+  auto convertedLog = (tmpDir.path() / "converted.log").string();
+  FLAGS_enable_replayer = true;
+
+  FLAGS_enable_binary_replayer_log = true;
+  FLAGS_sai_binary_log = binaryLog;
+  {
+    SaiTracer tracer;
+    traceCalls(tracer);
+  }
+
+  FLAGS_enable_binary_replayer_log = false;
+  FLAGS_sai_log = textLog;
+  {
+    SaiTracer tracer;
+    traceCalls(tracer);
+  }
+
+  // What sai_replayer_gen does
+  FLAGS_sai_log = convertedLog;
+  {
+    SaiTracer tracer;
+    for (const auto& record : readSaiBinaryTrace(binaryLog)) {
+      tracer.logBinaryTraceRecord(record);
+    }
+  }
+
+  auto text = readWithoutTimes(textLog);
+  EXPECT_NE(std::string::npos, text.find("create_route_entry"));
+  EXPECT_EQ(text, readWithoutTimes(convertedLog));
+}
+
+TEST(SaiBinaryTraceTest, idleThreadBufferFlushed) {
+  folly::test::TemporaryDirectory tmpDir;
+  auto binaryLog = (tmpDir.path() / "trace.bin").string();
+  SaiBinaryTraceWriter writer(binaryLog, std::chrono::milliseconds(10));
+
+  // The thread traces a single call, then stays alive without tracing any
+  // more, so only the flush thread can write its buffer out
+  folly::Baton<> traced;
+  folly::Baton<> done;
+  std::thread idleThread([&]() {
+    writeRouteCreate(writer, 0x0a000000);
+    traced.post();
+    done.wait();
+  });
+  traced.wait();
+
+  size_t records = 0;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (records == 0 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    records = readSaiBinaryTrace(binaryLog).size();
+  }
+  done.post();
+  idleThread.join();
+  EXPECT_EQ(1, records);
+}
+
+TEST(SaiBinaryTraceTest, recordsKeptWhileFlushThreadRuns) {
+  constexpr auto kThreads = 4;
+  constexpr auto kCallsPerThread = 10000;
+  folly::test::TemporaryDirectory tmpDir;
+  auto binaryLog = (tmpDir.path() / "trace.bin").string();
+  {
+    // Short enough for the flush thread to contend with tracing threads
+    SaiBinaryTraceWriter writer(binaryLog, std::chrono::milliseconds(1));
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < kThreads; ++i) {
+      threads.emplace_back([&writer]() {
+        for (auto call = 0; call < kCallsPerThread; ++call) {
+          writeRouteCreate(writer, call);
+          if (call % 1000 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  auto records = readSaiBinaryTrace(binaryLog);
+  ASSERT_EQ(kThreads * kCallsPerThread, records.size());
+  for (size_t i = 0; i < records.size(); ++i) {
+    EXPECT_EQ(i, records[i].header.sequence);
+  }
+}
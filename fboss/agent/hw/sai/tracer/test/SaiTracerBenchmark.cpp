@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Measures what tracing a route entry creation costs the calling thread:
+ * with tracing off, formatting the call into C code, and recording it in a
+ * binary trace.
+ */
+
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
+#include "fboss/agent/hw/sai/tracer/SaiTracer.h"
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <chrono>
+#include <memory>
+
+DECLARE_string(sai_log);
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr auto kTextLog = "/tmp/sai_tracer_benchmark.log";
+constexpr auto kBinaryLog = "/tmp/sai_tracer_benchmark.bin";
+
+struct RouteCreate {
+  RouteCreate() {
+    entry.switch_id = 0x21000000000000;
+    entry.vr_id = 0x3000000000000;
+    entry.destination.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    entry.destination.addr.ip4 = 0x0a000000;
+    entry.destination.mask.ip4 = 0xffffff00;
+    attrs[0].id = SAI_ROUTE_ENTRY_ATTR_PACKET_ACTION;
+    attrs[0].value.s32 = SAI_PACKET_ACTION_FORWARD;
+    attrs[1].id = SAI_ROUTE_ENTRY_ATTR_NEXT_HOP_ID;
+    attrs[1].value.oid = 0x5000000000001;
+  }
+
+  sai_route_entry_t entry{};
+  sai_attribute_t attrs[2]{};
+};
+
+void traceRouteCreates(size_t iters, bool enabled) {
+  folly::BenchmarkSuspender suspender;
+  RouteCreate call;
+  auto tracer = SaiTracer::getInstance();
+  FLAGS_enable_replayer = enabled;
+  suspender.dismiss();
+
+  for (size_t i = 0; i < iters; ++i) {
+    call.entry.destination.addr.ip4 = 0x0a000000 + (i << 8);
+    tracer->logRouteEntryCreateFn(
+        &call.entry, 2, call.attrs, SAI_STATUS_SUCCESS);
+  }
+
+  suspender.rehire();
+  FLAGS_enable_replayer = true;
+}
+
+} // namespace
+
+BENCHMARK(routeCreateTraceOff, n) {
+  traceRouteCreates(n, false /* enabled */);
+}
+
+BENCHMARK_RELATIVE(routeCreateTraceText, n) {
+  traceRouteCreates(n, true /* enabled */);
+}
+
+BENCHMARK_RELATIVE(routeCreateTraceBinary, n) {
+  folly::BenchmarkSuspender suspender;
+  RouteCreate call;
+  auto writer = std::make_unique<SaiBinaryTraceWriter>(
+      kBinaryLog, std::chrono::milliseconds(100));
+  suspender.dismiss();
+
+  for (size_t i = 0; i < n; ++i) {
+    call.entry.destination.addr.ip4 = 0x0a000000 + (i << 8);
+    writer->writeCall(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_ROUTE_ENTRY,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        folly::ByteRange(
+            reinterpret_cast<const uint8_t*>(&call.entry), sizeof(call.entry)),
+        2,
+        call.attrs,
+        SAI_STATUS_SUCCESS);
+  }
+
+  // Writing out what is still buffered is part of the cost
+  writer.reset();
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  // The tracer is created on first use, in text mode
+  FLAGS_enable_replayer = true;
+  FLAGS_enable_binary_replayer_log = false;
+  FLAGS_sai_log = kTextLog;
+  folly::runBenchmarks();
+  return 0;
+}
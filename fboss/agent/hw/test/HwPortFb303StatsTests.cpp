@@ -80,22 +80,25 @@ void updateStats(HwPortFb303Stats& portStats) {
   portStats.updateStats(getInitedStats(), now);
 }
 
-void verifyUpdatedStats(const HwPortFb303Stats& portStats) {
+void verifyUpdatedStats(
+    const HwPortFb303Stats& portStats,
+    folly::StringPiece portName = kPortName,
+    const HwPortFb303Stats::QueueId2Name& queue2Name = kQueue2Name) {
   auto curValue{1};
   for (auto counterName : HwPortFb303Stats::kPortStatKeys()) {
     // +1 because first initialization is to -1
     EXPECT_EQ(
         portStats.getCounterLastIncrement(
-            HwPortFb303Stats::statName(counterName, kPortName)),
+            HwPortFb303Stats::statName(counterName, portName)),
         curValue++ + 1);
   }
   curValue = 1;
   for (auto counterName : HwPortFb303Stats::kQueueStatKeys()) {
-    for (const auto& queueIdAndName : kQueue2Name) {
+    for (const auto& queueIdAndName : queue2Name) {
       EXPECT_EQ(
           portStats.getCounterLastIncrement(HwPortFb303Stats::statName(
               counterName,
-              kPortName,
+              portName,
               queueIdAndName.first,
               queueIdAndName.second)),
           curValue);
@@ -280,3 +283,18 @@ TEST(HwPortFb303Stats, queueNameChangeResetsValue) {
     }
   }
 }
+
+TEST(HwPortFb303Stats, UpdateStatsAfterReInit) {
+  HwPortFb303Stats portStats(kPortName, kQueue2Name);
+  updateStats(portStats);
+  // Renames, and removing then adding back queues, move the handles
+  // updateStats writes through
+  constexpr auto kNewPortName = "fab1/1/1";
+  portStats.portNameChanged(kNewPortName);
+  portStats.queueChanged(1, "platinum");
+  portStats.queueRemoved(2);
+  portStats.queueChanged(2, "bronze");
+  updateStats(portStats);
+  verifyUpdatedStats(
+      portStats, kNewPortName, {{1, "platinum"}, {2, "bronze"}});
+}
@@ -22,6 +22,7 @@ void hwSwitchFibUpdate(
     facebook::fboss::RouterID vrf,
     const facebook::fboss::IPv4NetworkToRouteMap& v4NetworkToRoute,
     const facebook::fboss::IPv6NetworkToRouteMap& v6NetworkToRoute,
+    const facebook::fboss::RibRouteDelta* ribDelta,
     void* cookie);
 
 class HwSwitchEnsembleRouteUpdateWrapper : public RouteUpdateWrapper {
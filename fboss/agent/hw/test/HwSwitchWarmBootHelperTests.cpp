@@ -0,0 +1,65 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwSwitchWarmBootHelper.h"
+
+#include <folly/FileUtil.h>
+#include <folly/json.h>
+#include <folly/testing/TestUtil.h>
+#include <gflags/gflags.h>
+#include <gtest/gtest.h>
+
+#include <sys/time.h>
+
+using namespace facebook::fboss;
+
+TEST(HwSwitchWarmBootHelperTests, ThriftStateRoundTrip) {
+  folly::dynamic state = folly::dynamic::object;
+  state["swSwitch"] = folly::dynamic::object("bool", true)("int", -42)(
+      "double", 0.5)("string", "fboss")("null", nullptr)(
+      "list", folly::dynamic::array(1, "two", folly::dynamic::array()))(
+      "object", folly::dynamic::object());
+  state["hwSwitch"] = folly::dynamic::object("routes", folly::dynamic::array());
+
+  auto decoded =
+      deserializeWarmBootStateThrift(serializeWarmBootStateThrift(state));
+  EXPECT_EQ(state, decoded);
+  // Unlike a JSON round trip, types are kept as is
+  EXPECT_TRUE(decoded["swSwitch"]["double"].isDouble());
+  EXPECT_TRUE(decoded["swSwitch"]["int"].isInt());
+}
+
+TEST(HwSwitchWarmBootHelperTests, ThriftStateNonStringKey) {
+  folly::dynamic state = folly::dynamic::object(1, "one");
+  EXPECT_THROW(serializeWarmBootStateThrift(state), folly::TypeError);
+}
+
+TEST(HwSwitchWarmBootHelperTests, StaleThriftStateIgnored) {
+  gflags::FlagSaver flagSaver;
+  folly::test::TemporaryDirectory tmpDir;
+  auto thriftState = folly::dynamic::object("format", "thrift");
+  auto jsonState = folly::dynamic::object("format", "json");
+  {
+    HwSwitchWarmBootHelper helper(0, tmpDir.path().string(), "");
+    FLAGS_thrift_warm_boot_state = true;
+    ASSERT_TRUE(helper.storeWarmBootState(thriftState));
+    EXPECT_EQ(thriftState, helper.getWarmBootState());
+  }
+  // Written after a rollback to an agent that only knows of the JSON state
+  auto thriftFile = (tmpDir.path() / "thrift_switch_state").string();
+  timeval past[2] = {{1, 0}, {1, 0}};
+  ASSERT_EQ(0, utimes(thriftFile.c_str(), past));
+  ASSERT_TRUE(folly::writeFile(
+      folly::toJson(jsonState),
+      (tmpDir.path() / "switch_state").string().c_str()));
+
+  HwSwitchWarmBootHelper helper(0, tmpDir.path().string(), "");
+  EXPECT_EQ(jsonState, helper.getWarmBootState());
+}
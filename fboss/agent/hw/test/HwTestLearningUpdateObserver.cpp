@@ -49,24 +49,32 @@ void HwTestLearningUpdateObserver::l2LearningUpdateReceived(
    * another state update or else we will try to acquire same lock and hang.
    * To avoid, schedule state delta processing in a different context.
    */
-  applyStateUpdateEventBase_.runInEventBaseThread(
-      [this, l2Entry, l2EntryUpdateType]() {
-        this->applyStateUpdateHelper(l2Entry, l2EntryUpdateType);
-      });
+  pendingUpdates_.emplace_back(l2Entry, l2EntryUpdateType);
+  if (!applyScheduled_) {
+    // Like MacTableManager, apply all updates received by the time this
+    // runs as a single state update.
+    applyScheduled_ = true;
+    applyStateUpdateEventBase_.runInEventBaseThread(
+        [this]() { this->applyStateUpdateHelper(); });
+  }
 
   data_.push_back(std::make_pair(l2Entry, l2EntryUpdateType));
 
   cv_.notify_all();
 }
 
-void HwTestLearningUpdateObserver::applyStateUpdateHelper(
-    L2Entry l2Entry,
-    L2EntryUpdateType l2EntryUpdateType) {
+void HwTestLearningUpdateObserver::applyStateUpdateHelper() {
   CHECK(applyStateUpdateEventBase_.inRunningEventBaseThread());
 
+  std::vector<std::pair<L2Entry, L2EntryUpdateType>> updates;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    updates.swap(pendingUpdates_);
+    applyScheduled_ = false;
+  }
+
   auto state1 = ensemble_->getProgrammedState();
-  auto state2 =
-      MacTableUtils::updateMacTable(state1, l2Entry, l2EntryUpdateType);
+  auto state2 = MacTableUtils::updateMacTable(state1, updates);
   ensemble_->applyNewState(state2);
 }
 
@@ -34,14 +34,16 @@ class HwTestLearningUpdateObserver
   void packetReceived(RxPacket* /*pkt*/) noexcept override {}
   void linkStateChanged(PortID /*port*/, bool /*up*/) override {}
 
-  void applyStateUpdateHelper(
-      L2Entry l2Entry,
-      L2EntryUpdateType l2EntryUpdateType);
+  void applyStateUpdateHelper();
 
   HwSwitchEnsemble* ensemble_{nullptr};
   std::mutex mtx_;
   std::condition_variable cv_;
   std::vector<std::pair<L2Entry, L2EntryUpdateType>> data_;
+  // Updates received but not yet applied, and whether their application
+  // has been scheduled. Protected by mtx_.
+  std::vector<std::pair<L2Entry, L2EntryUpdateType>> pendingUpdates_;
+  bool applyScheduled_{false};
 
   std::unique_ptr<std::thread> applyStateUpdateThread_;
   folly::EventBase applyStateUpdateEventBase_;
@@ -33,6 +33,8 @@
 #include <folly/IPAddress.h>
 #include <folly/Optional.h>
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <set>
 #include <vector>
@@ -669,6 +671,67 @@ TEST_F(HwMacSwLearningModeTest, VerifyCallbacksOnMacEntryChange) {
   verifyAcrossWarmBoots(setup, verify);
 }
 
+// Intent of this test is to deliver a burst of learning callbacks, as after a
+// host migration, and measure how long it takes for all of them to be
+// reflected in the switch state and programmed to the L2 table. The callbacks
+// are injected directly, so this runs on the fake SAI as well.
+TEST_F(HwMacSwLearningModeTest, VerifySwLearningBurstThroughput) {
+  constexpr auto kNumMacs = 10000;
+  std::vector<folly::MacAddress> macs;
+  auto generator = utility::MacAddressGenerator();
+  generator.startOver(kSourceMac().u64HBO());
+  for (auto i = 0; i < kNumMacs; ++i) {
+    macs.emplace_back(generator.getNext());
+  }
+
+  auto allMacsInSwitchState = [this, &macs]() {
+    auto vlan = getProgrammedState()->getVlans()->getVlanIf(kVlanID());
+    auto* macTable = vlan->getMacTable().get();
+    return std::all_of(macs.begin(), macs.end(), [macTable](auto mac) {
+      return macTable->getNodeIf(mac) != nullptr;
+    });
+  };
+
+  auto setup = [this, &macs, &allMacsInSwitchState]() {
+    setupHelper(cfg::L2LearningMode::SOFTWARE, physPortDescr());
+    // Disable aging, so entries stay in L2 table when we verify.
+    utility::setMacAgeTimerSeconds(getHwSwitchEnsemble(), 0);
+
+    l2LearningObserver_.reset();
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& mac : macs) {
+      getHwSwitchEnsemble()->l2LearningUpdateReceived(
+          L2Entry(
+              mac,
+              kVlanID(),
+              physPortDescr(),
+              L2Entry::L2EntryType::L2_ENTRY_TYPE_VALIDATED),
+          L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD);
+    }
+    int retries = 30;
+    while (!allMacsInSwitchState() && retries--) {
+      /* sleep override */
+      usleep(100000);
+    }
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    XLOG(INFO) << "Applied " << macs.size() << " learning callbacks in "
+               << elapsedMs << "ms";
+  };
+
+  auto verify = [this, &macs, &allMacsInSwitchState]() {
+    EXPECT_TRUE(allMacsInSwitchState());
+    auto l2TableMacs =
+        getMacsForPort(getHwSwitch(), masterLogicalPortIds()[0], false);
+    for (const auto& mac : macs) {
+      EXPECT_TRUE(l2TableMacs.find(mac) != l2TableMacs.end());
+    }
+  };
+
+  verifyAcrossWarmBoots(setup, verify);
+}
+
 class HwMacLearningMacMoveTest : public HwMacLearningTest {
  protected:
   cfg::SwitchConfig initialConfig() const override {
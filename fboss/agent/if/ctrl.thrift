@@ -377,6 +377,35 @@ struct NdpEntryThrift {
   8: i32 classID,
 }
 
+/*
+ * Changes to the route table of one VRF, as streamed to subscribers of
+ * subscribeToRouteTableUpdates. The table as of subscription is sent
+ * first, as updates with snapshot set, the last of which also has
+ * endOfSnapshot set.
+ */
+struct RouteTableUpdate {
+  1: i32 vrf,
+  2: list<RouteDetails> addedOrChanged,
+  3: list<IpPrefix> removed,
+  4: bool snapshot,
+  5: bool endOfSnapshot,
+}
+
+/*
+ * Changes to the ARP and NDP tables, as streamed to subscribers of
+ * subscribeToNeighborTableUpdates. As for RouteTableUpdate, the tables as
+ * of subscription are sent first. Entries come from the switch state, so
+ * ttl is not filled in and state is either REACHABLE or PENDING.
+ */
+struct NeighborTableUpdate {
+  1: list<ArpEntryThrift> arpAddedOrChanged,
+  2: list<ArpEntryThrift> arpRemoved,
+  3: list<NdpEntryThrift> ndpAddedOrChanged,
+  4: list<NdpEntryThrift> ndpRemoved,
+  5: bool snapshot,
+  6: bool endOfSnapshot,
+}
+
 enum BootType {
   UNINITIALIZED = 0,
   COLD_BOOT = 1,
@@ -724,6 +753,18 @@ service FbossCtrl extends fb303.FacebookService {
     throws (1: fboss.FbossBaseError error)
   list<RouteDetails> getRouteTableDetails()
     throws (1: fboss.FbossBaseError error)
+  /*
+   * Same as getRouteTableDetails, but streamed in pages of at most
+   * pageSize routes, all taken from the same switch state
+   */
+  stream<list<RouteDetails>> streamRouteTableDetails(1: i32 pageSize)
+    throws (1: fboss.FbossBaseError error)
+  /*
+   * Stream the route table in pages of at most pageSize routes, followed by
+   * the routes changed by each later state update
+   */
+  stream<RouteTableUpdate> subscribeToRouteTableUpdates(1: i32 pageSize)
+    throws (1: fboss.FbossBaseError error)
   InterfaceDetail getInterfaceDetail(1: i32 interfaceId)
     throws (1: fboss.FbossBaseError error)
 
@@ -839,6 +880,21 @@ service FbossCtrl extends fb303.FacebookService {
     throws (1: fboss.FbossBaseError error)
   list<NdpEntryThrift> getNdpTable()
     throws (1: fboss.FbossBaseError error)
+  /*
+   * The ARP and NDP tables in pages of at most pageSize entries. Entries
+   * come from the switch state, as for subscribeToNeighborTableUpdates.
+   */
+  stream<list<ArpEntryThrift>> streamArpTable(1: i32 pageSize)
+    throws (1: fboss.FbossBaseError error)
+  stream<list<NdpEntryThrift>> streamNdpTable(1: i32 pageSize)
+    throws (1: fboss.FbossBaseError error)
+  /*
+   * Stream the ARP and NDP tables in pages of at most pageSize entries,
+   * followed by the entries changed by each later state update
+   */
+  stream<NeighborTableUpdate> subscribeToNeighborTableUpdates(
+    1: i32 pageSize,
+  ) throws (1: fboss.FbossBaseError error)
   list<L2EntryThrift> getL2Table()
     throws (1: fboss.FbossBaseError error)
   list<AclEntryThrift> getAclTable()
@@ -10,6 +10,8 @@
 
 #include "fboss/agent/packet/SflowStructs.h"
 
+#include <array>
+
 using namespace folly;
 using namespace folly::io;
 
@@ -17,14 +19,28 @@ namespace facebook::fboss {
 
 namespace sflow {
 
+namespace {
+constexpr std::array<byte, XDR_BASIC_BLOCK_SIZE> kXdrPadding{};
+}
+
+uint32_t xdrPadding(uint32_t len) {
+  return (XDR_BASIC_BLOCK_SIZE - len % XDR_BASIC_BLOCK_SIZE) %
+      XDR_BASIC_BLOCK_SIZE;
+}
+
+void serializeXdrPadding(RWPrivateCursor* cursor, uint32_t len) {
+  cursor->push(kXdrPadding.data(), xdrPadding(len));
+}
+
 void serializeIP(RWPrivateCursor* cursor, folly::IPAddress ip) {
   // We first push the address type
-  cursor->writeBE<uint32_t>(static_cast<uint32_t>(AddressType::IP_V6));
+  cursor->writeBE<uint32_t>(static_cast<uint32_t>(
+      ip.isV4() ? AddressType::IP_V4 : AddressType::IP_V6));
   // then push the address in bytes
   cursor->push(ip.bytes(), ip.byteCount());
 }
 
-uint32_t sizeIP(folly::IPAddress const& ip) {
+uint32_t sizeIP(folly::IPAddress ip) {
   return 4 + ip.byteCount();
 }
 
@@ -45,12 +61,7 @@ void FlowRecord::serialize(RWPrivateCursor* cursor) const {
   // serialize XDR opaque sFlow flow_data
   cursor->writeBE<uint32_t>(this->flowDataLen);
   cursor->push(this->flowData, this->flowDataLen);
-  if (this->flowDataLen % XDR_BASIC_BLOCK_SIZE != 0) {
-    int fillCnt =
-        XDR_BASIC_BLOCK_SIZE - this->flowDataLen % XDR_BASIC_BLOCK_SIZE;
-    std::vector<byte> crud(XDR_BASIC_BLOCK_SIZE, 0);
-    cursor->push(crud.data(), fillCnt);
-  }
+  serializeXdrPadding(cursor, this->flowDataLen);
 }
 
 uint32_t FlowRecord::size() const {
@@ -84,36 +95,40 @@ void SampleRecord::serialize(RWPrivateCursor* cursor) const {
   cursor->writeBE<uint32_t>(this->sampleDataLen);
   // Serialize XDR opaque sFlow sample_data
   cursor->push(this->sampleData, this->sampleDataLen);
-  if (this->sampleDataLen % XDR_BASIC_BLOCK_SIZE > 0) {
-    int fillCnt =
-        XDR_BASIC_BLOCK_SIZE - this->sampleDataLen % XDR_BASIC_BLOCK_SIZE;
-    std::vector<byte> crud(XDR_BASIC_BLOCK_SIZE, 0);
-    cursor->push(crud.data(), fillCnt);
-  }
+  serializeXdrPadding(cursor, this->sampleDataLen);
 }
 
 uint32_t SampleRecord::size() const {
   return 4 /* sampleType */ + 4 /* sampleDataLen */ + this->sampleDataLen;
 }
 
-void SampleDatagramV5::serialize(RWPrivateCursor* cursor) const {
+void SampleDatagramV5::serializeHeader(RWPrivateCursor* cursor) const {
   serializeIP(cursor, this->agentAddress);
 
   cursor->writeBE<uint32_t>(this->subAgentID);
   cursor->writeBE<uint32_t>(this->sequenceNumber);
   cursor->writeBE<uint32_t>(this->uptime);
   cursor->writeBE<uint32_t>(this->samplesCnt);
+}
+
+void SampleDatagramV5::serialize(RWPrivateCursor* cursor) const {
+  serializeHeader(cursor);
   for (int i = 0; i < this->samplesCnt; i++) {
     this->samples[i].serialize(cursor);
   }
 }
 
 uint32_t SampleDatagramV5::size(const uint32_t recordsSize) const {
-  return this->agentAddress.byteCount() + 4 /* subAgentID */ +
+  return sizeIP(this->agentAddress) + 4 /* subAgentID */ +
       4 /*sequenceNumber */ + 4 /*uptime*/
       + 4 /*samplesCnt */ + recordsSize;
 }
 
+void SampleDatagram::serializeHeader(RWPrivateCursor* cursor) const {
+  cursor->writeBE<uint32_t>(SampleDatagram::VERSION5);
+  this->datagramV5.serializeHeader(cursor);
+}
+
 void SampleDatagram::serialize(RWPrivateCursor* cursor) const {
   cursor->writeBE<uint32_t>(SampleDatagram::VERSION5);
   this->datagramV5.serialize(cursor);
@@ -129,12 +144,7 @@ void SampledHeader::serialize(RWPrivateCursor* cursor) const {
   cursor->writeBE<uint32_t>(this->stripped);
   cursor->writeBE<uint32_t>(this->headerLength);
   cursor->push(this->header, this->headerLength);
-  if (this->headerLength % XDR_BASIC_BLOCK_SIZE > 0) {
-    int fillCnt =
-        XDR_BASIC_BLOCK_SIZE - this->headerLength % XDR_BASIC_BLOCK_SIZE;
-    std::vector<byte> crud(XDR_BASIC_BLOCK_SIZE, 0);
-    cursor->push(crud.data(), fillCnt);
-  }
+  serializeXdrPadding(cursor, this->headerLength);
 }
 
 uint32_t SampledHeader::size() const {
@@ -142,6 +152,40 @@ uint32_t SampledHeader::size() const {
       4 /* headerLength */ + this->headerLength;
 }
 
+namespace {
+uint32_t flowSampleSize(const SampledHeader& hdr) {
+  auto flowDataLen = hdr.size() + xdrPadding(hdr.headerLength);
+  FlowSample sample;
+  return sample.size(4 /* flowFormat */ + 4 /* flowDataLen */ + flowDataLen);
+}
+} // namespace
+
+void serializeFlowSampleRecord(
+    RWPrivateCursor* cursor,
+    const FlowSample& sample,
+    const SampledHeader& hdr) {
+  // SampleRecord
+  serializeDataFormat(cursor, FLOW_SAMPLE_FORMAT);
+  cursor->writeBE<uint32_t>(flowSampleSize(hdr));
+  // FlowSample
+  cursor->writeBE<uint32_t>(sample.sequenceNumber);
+  serializeSflowDataSource(cursor, sample.sourceID);
+  cursor->writeBE<uint32_t>(sample.samplingRate);
+  cursor->writeBE<uint32_t>(sample.samplePool);
+  cursor->writeBE<uint32_t>(sample.drops);
+  serializeSflowPort(cursor, sample.input);
+  serializeSflowPort(cursor, sample.output);
+  cursor->writeBE<uint32_t>(1 /* flowRecordsCnt */);
+  // FlowRecord
+  serializeDataFormat(cursor, SAMPLED_HEADER_FORMAT);
+  cursor->writeBE<uint32_t>(hdr.size() + xdrPadding(hdr.headerLength));
+  hdr.serialize(cursor);
+}
+
+uint32_t flowSampleRecordSize(const SampledHeader& hdr) {
+  return 4 /* sampleType */ + 4 /* sampleDataLen */ + flowSampleSize(hdr);
+}
+
 } // namespace sflow
 
 } // namespace facebook::fboss
@@ -23,6 +23,10 @@ constexpr int XDR_BASIC_BLOCK_SIZE = 4; // XDR basic block size is 4 bytes
 // aliases
 using byte = uint8_t;
 
+/* Bytes of padding after an XDR opaque of len bytes */
+uint32_t xdrPadding(uint32_t len);
+void serializeXdrPadding(folly::io::RWPrivateCursor* cursor, uint32_t len);
+
 /*
  *  Below is the (partial) implementation of the structs representing the
  *  sFlow Datagram Format as defined in Section 5 of the sFlow V5 spec.
@@ -38,6 +42,10 @@ uint32_t sizeIP(folly::IPAddress ip);
 using DataFormat = uint32_t;
 void serializeDataFormat(folly::io::RWPrivateCursor* cursor, DataFormat fmt);
 
+/* Formats of a flow sample, and of its raw packet header flow record */
+constexpr DataFormat FLOW_SAMPLE_FORMAT = 1;
+constexpr DataFormat SAMPLED_HEADER_FORMAT = 1;
+
 /* sFlowDataSource */
 using SflowDataSource = uint32_t;
 void serializeSflowDataSource(
@@ -125,6 +133,9 @@ struct SampleDatagramV5 {
 
   void serialize(folly::io::RWPrivateCursor* cursor) const;
   uint32_t size(const uint32_t recordsSize) const;
+
+  /* Everything but the samples, which are to follow */
+  void serializeHeader(folly::io::RWPrivateCursor* cursor) const;
 };
 
 // Here we skip sample_datagram_type, since only v5 is used
@@ -135,6 +146,8 @@ struct SampleDatagram {
 
   void serialize(folly::io::RWPrivateCursor* cursor) const;
   uint32_t size(const uint32_t recordsSize) const;
+
+  void serializeHeader(folly::io::RWPrivateCursor* cursor) const;
 };
 
 /* Proposed standard sFlow data formats (draft 14) */
@@ -171,6 +184,19 @@ struct SampledHeader {
 
 // .. We omit the spec definition below (including) "Ethernet Frame Data" on p36
 
+/*
+ * Writes a SampleRecord holding `sample`, with `hdr` as its only flow record,
+ * straight into cursor. The bytes are the same as serializing hdr into a
+ * FlowRecord, then the FlowSample into a SampleRecord, then the SampleRecord,
+ * without the intermediate buffers. sample.flowRecordsCnt and
+ * sample.flowRecords are ignored.
+ */
+void serializeFlowSampleRecord(
+    folly::io::RWPrivateCursor* cursor,
+    const FlowSample& sample,
+    const SampledHeader& hdr);
+uint32_t flowSampleRecordSize(const SampledHeader& hdr);
+
 } // namespace sflow
 
 } // namespace facebook::fboss
@@ -220,3 +220,63 @@ TEST(SflowStructsTest, Serialize) {
     EXPECT_EQ(b.at(i), data[i]);
   }
 }
+
+TEST(SflowStructsTest, SerializeFlowSampleRecordInPlace) {
+  int bufSize = 1024;
+  std::vector<uint8_t> dataBuf(11);
+  memset(dataBuf.data(), 15, dataBuf.size());
+
+  sflow::SampledHeader hdr;
+  hdr.protocol = sflow::HeaderProtocol::ETHERNET_ISO88023;
+  hdr.frameLength = 1500;
+  hdr.stripped = 4;
+  hdr.headerLength = dataBuf.size();
+  hdr.header = dataBuf.data();
+
+  sflow::FlowSample fsample;
+  fsample.sequenceNumber = 7;
+  fsample.sourceID = 0;
+  fsample.samplingRate = 123;
+  fsample.samplePool = 0;
+  fsample.drops = 0;
+  fsample.input = 56;
+  fsample.output = 6;
+
+  // Serialize the nested records into buffers of their own first
+  std::vector<uint8_t> hb(bufSize);
+  auto hbuf = folly::IOBuf::wrapBuffer(hb.data(), bufSize);
+  folly::io::RWPrivateCursor hc(hbuf.get());
+  hdr.serialize(&hc);
+
+  sflow::FlowRecord frecord;
+  frecord.flowFormat = sflow::SAMPLED_HEADER_FORMAT;
+  frecord.flowDataLen = bufSize - hc.length();
+  frecord.flowData = hb.data();
+  fsample.flowRecordsCnt = 1;
+  fsample.flowRecords = &frecord;
+
+  std::vector<uint8_t> fsb(bufSize);
+  auto fbuf = folly::IOBuf::wrapBuffer(fsb.data(), bufSize);
+  folly::io::RWPrivateCursor fc(fbuf.get());
+  fsample.serialize(&fc);
+
+  sflow::SampleRecord record;
+  record.sampleType = sflow::FLOW_SAMPLE_FORMAT;
+  record.sampleDataLen = bufSize - fc.length();
+  record.sampleData = fsb.data();
+
+  std::vector<uint8_t> expected(bufSize);
+  auto ebuf = folly::IOBuf::wrapBuffer(expected.data(), bufSize);
+  folly::io::RWPrivateCursor ec(ebuf.get());
+  record.serialize(&ec);
+  expected.resize(bufSize - ec.length());
+
+  std::vector<uint8_t> b(bufSize);
+  auto buf = folly::IOBuf::wrapBuffer(b.data(), bufSize);
+  folly::io::RWPrivateCursor cursor(buf.get());
+  sflow::serializeFlowSampleRecord(&cursor, fsample, hdr);
+  b.resize(bufSize - cursor.length());
+
+  EXPECT_EQ(expected.size(), sflow::flowSampleRecordSize(hdr));
+  EXPECT_EQ(expected, b);
+}
@@ -25,7 +25,8 @@ ConfigApplier::ConfigApplier(
     folly::Range<StaticRouteNoNextHopsIterator> staticCpuRouteRange,
     folly::Range<StaticRouteNoNextHopsIterator> staticDropRouteRange,
     folly::Range<StaticRouteWithNextHopsIterator> staticRouteRange,
-    folly::Range<StaticIp2MplsRouteIterator> staticIp2MplsRouteRange)
+    folly::Range<StaticIp2MplsRouteIterator> staticIp2MplsRouteRange,
+    folly::Executor* executor)
     : vrf_(vrf),
       v4NetworkToRoute_(v4NetworkToRoute),
       v6NetworkToRoute_(v6NetworkToRoute),
@@ -33,13 +34,15 @@ ConfigApplier::ConfigApplier(
       staticCpuRouteRange_(staticCpuRouteRange),
       staticDropRouteRange_(staticDropRouteRange),
       staticRouteRange_(staticRouteRange),
-      staticIp2MplsRouteRange_(staticIp2MplsRouteRange) {
+      staticIp2MplsRouteRange_(staticIp2MplsRouteRange),
+      executor_(executor) {
   CHECK_NOTNULL(v4NetworkToRoute_);
   CHECK_NOTNULL(v6NetworkToRoute_);
 }
 
 void ConfigApplier::apply() {
-  RibRouteUpdater updater(v4NetworkToRoute_, v6NetworkToRoute_);
+  RibRouteUpdater updater(
+      v4NetworkToRoute_, v6NetworkToRoute_, nullptr, executor_);
 
   // Update static routes
   std::vector<RibRouteUpdater::RouteEntry> staticRoutes;
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <boost/container/flat_map.hpp>
+#include <folly/Executor.h>
 #include <folly/IPAddress.h>
 #include <folly/Range.h>
 #include <functional>
@@ -52,8 +53,10 @@ class ConfigApplier {
       folly::Range<StaticRouteNoNextHopsIterator> staticCpuRouteRange,
       folly::Range<StaticRouteNoNextHopsIterator> staticDropRouteRange,
       folly::Range<StaticRouteWithNextHopsIterator> staticRouteRange,
-      folly::Range<StaticIp2MplsRouteIterator> staticIp2MplsRouteRange);
+      folly::Range<StaticIp2MplsRouteIterator> staticIp2MplsRouteRange,
+      folly::Executor* executor = nullptr);
 
+  // Resolves routes on executor too, if any. See RibRouteUpdater.
   void apply();
 
  private:
@@ -65,6 +68,7 @@ class ConfigApplier {
   folly::Range<StaticRouteNoNextHopsIterator> staticDropRouteRange_;
   folly::Range<StaticRouteWithNextHopsIterator> staticRouteRange_;
   folly::Range<StaticIp2MplsRouteIterator> staticIp2MplsRouteRange_;
+  folly::Executor* executor_;
 };
 
 } // namespace facebook::fboss
@@ -11,6 +11,7 @@
 #include "fboss/agent/types.h"
 
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/RouteUpdater.h"
 
 #include <memory>
 
@@ -22,11 +23,13 @@ std::shared_ptr<SwitchState> ribToSwitchStateUpdate(
     RouterID vrf,
     const IPv4NetworkToRouteMap& v4NetworkToRoute,
     const IPv6NetworkToRouteMap& v6NetworkToRoute,
+    const RibRouteDelta* ribDelta,
     void* cookie);
 
 std::shared_ptr<SwitchState> noopFibUpdate(
     RouterID vrf,
     const IPv4NetworkToRouteMap& v4NetworkToRoute,
     const IPv6NetworkToRouteMap& v6NetworkToRoute,
+    const RibRouteDelta* ribDelta,
     void* cookie);
 } // namespace facebook::fboss
@@ -19,16 +19,19 @@
 #include <folly/logging/xlog.h>
 
 #include <algorithm>
+#include <vector>
 
 namespace facebook::fboss {
 
 ForwardingInformationBaseUpdater::ForwardingInformationBaseUpdater(
     RouterID vrf,
     const IPv4NetworkToRouteMap& v4NetworkToRoute,
-    const IPv6NetworkToRouteMap& v6NetworkToRoute)
+    const IPv6NetworkToRouteMap& v6NetworkToRoute,
+    const RibRouteDelta* ribDelta)
     : vrf_(vrf),
       v4NetworkToRoute_(v4NetworkToRoute),
-      v6NetworkToRoute_(v6NetworkToRoute) {}
+      v6NetworkToRoute_(v6NetworkToRoute),
+      ribDelta_(ribDelta) {}
 
 std::shared_ptr<SwitchState> ForwardingInformationBaseUpdater::operator()(
     const std::shared_ptr<SwitchState>& state) {
@@ -49,11 +52,23 @@ std::shared_ptr<SwitchState> ForwardingInformationBaseUpdater::operator()(
     previousFibContainer = nextState->getFibs()->getFibContainerIf(vrf_);
   }
   CHECK(previousFibContainer);
-  auto newFibV4 =
-      createUpdatedFib(v4NetworkToRoute_, previousFibContainer->getFibV4());
-
-  auto newFibV6 =
-      createUpdatedFib(v6NetworkToRoute_, previousFibContainer->getFibV6());
+  std::shared_ptr<ForwardingInformationBaseV4> newFibV4;
+  std::shared_ptr<ForwardingInformationBaseV6> newFibV6;
+  if (ribDelta_) {
+    newFibV4 = applyRibDelta(
+        v4NetworkToRoute_,
+        ribDelta_->v4Prefixes,
+        previousFibContainer->getFibV4());
+    newFibV6 = applyRibDelta(
+        v6NetworkToRoute_,
+        ribDelta_->v6Prefixes,
+        previousFibContainer->getFibV6());
+  } else {
+    newFibV4 =
+        createUpdatedFib(v4NetworkToRoute_, previousFibContainer->getFibV4());
+    newFibV6 =
+        createUpdatedFib(v6NetworkToRoute_, previousFibContainer->getFibV6());
+  }
 
   if (!newFibV4 && !newFibV6) {
     // return nextState in case we modified state above to insert new VRF
@@ -77,8 +92,12 @@ ForwardingInformationBaseUpdater::createUpdatedFib(
     const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
     const std::shared_ptr<facebook::fboss::ForwardingInformationBase<AddressT>>&
         fib) {
-  typename facebook::fboss::ForwardingInformationBase<
-      AddressT>::Base::NodeContainer updatedFib;
+  // Collect the new routes and build the container from them in one go
+  std::vector<std::pair<
+      facebook::fboss::RoutePrefix<AddressT>,
+      std::shared_ptr<facebook::fboss::Route<AddressT>>>>
+      updatedRoutes;
+  size_t numRetainedRoutes = 0;
 
   bool updated = false;
   for (const auto& entry : rib) {
@@ -96,6 +115,7 @@ ForwardingInformationBaseUpdater::createUpdatedFib(
     std::shared_ptr<facebook::fboss::Route<AddressT>> fibRoute =
         fib->getNodeIf(fibPrefix);
     if (fibRoute) {
+      ++numRetainedRoutes;
       if (fibRoute == ribRoute || fibRoute->isSame(ribRoute.get())) {
         // Pointer or contents are same, reuse existing route
       } else {
@@ -108,18 +128,25 @@ ForwardingInformationBaseUpdater::createUpdatedFib(
       updated = true;
     }
     CHECK(fibRoute->isPublished());
-    updatedFib.emplace_hint(updatedFib.cend(), fibPrefix, fibRoute);
+    updatedRoutes.emplace_back(fibPrefix, std::move(fibRoute));
   }
   // Check for deleted routes. Routes that were in the previous FIB
   // and have now been removed
-  for (const auto& fibEntry : *fib) {
-    const auto& prefix = fibEntry->prefix();
-    if (updatedFib.find(prefix) == updatedFib.end()) {
-      updated = true;
-      break;
-    }
+  if (numRetainedRoutes != fib->size()) {
+    updated = true;
+  }
+  if (!updated) {
+    return nullptr;
   }
 
+  std::sort(
+      updatedRoutes.begin(),
+      updatedRoutes.end(),
+      [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  typename facebook::fboss::ForwardingInformationBase<
+      AddressT>::Base::NodeContainer updatedFib(
+      updatedRoutes.begin(), updatedRoutes.end());
+
   DCHECK_EQ(
       updatedFib.size(),
       std::count_if(
@@ -130,9 +157,49 @@ ForwardingInformationBaseUpdater::createUpdatedFib(
             return entry.value()->isResolved();
           }));
 
-  return updated ? std::make_shared<ForwardingInformationBase<AddressT>>(
-                       std::move(updatedFib))
-                 : nullptr;
+  return std::make_shared<ForwardingInformationBase<AddressT>>(
+      std::move(updatedFib));
+}
+
+template <typename AddressT>
+std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
+ForwardingInformationBaseUpdater::applyRibDelta(
+    const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
+    const std::vector<RoutePrefix<AddressT>>& changedPrefixes,
+    const std::shared_ptr<facebook::fboss::ForwardingInformationBase<AddressT>>&
+        fib) {
+  std::shared_ptr<ForwardingInformationBase<AddressT>> updatedFib;
+  auto writableFib = [&updatedFib, &fib]() {
+    if (!updatedFib) {
+      updatedFib = fib->isPublished() ? fib->clone() : fib;
+    }
+    return updatedFib.get();
+  };
+  for (const auto& prefix : changedPrefixes) {
+    auto ritr = rib.exactMatch(prefix.network, prefix.mask);
+    auto fibRoute = fib->getNodeIf(prefix);
+    // The recursive resolution algorithm considers a next-hop TO_CPU or
+    // DROP to be resolved.
+    if (ritr == rib.end() || !ritr->value()->isResolved()) {
+      if (fibRoute) {
+        writableFib()->removeNode(prefix);
+      }
+      continue;
+    }
+    const auto& ribRoute = ritr->value();
+    if (fibRoute &&
+        (fibRoute == ribRoute || fibRoute->isSame(ribRoute.get()))) {
+      // Pointer or contents are same, reuse existing route
+      continue;
+    }
+    CHECK(ribRoute->isPublished());
+    if (fibRoute) {
+      writableFib()->updateNode(ribRoute);
+    } else {
+      writableFib()->addNode(ribRoute);
+    }
+  }
+  return updatedFib;
 }
 
 } // namespace facebook::fboss
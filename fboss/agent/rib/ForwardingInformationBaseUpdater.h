@@ -10,6 +10,7 @@
 #pragma once
 
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/RouteUpdater.h"
 
 #include "fboss/agent/state/ForwardingInformationBase.h"
 #include "fboss/agent/state/RouteTypes.h"
@@ -23,10 +24,16 @@ class SwitchState;
 
 class ForwardingInformationBaseUpdater {
  public:
+  /*
+   * If ribDelta is given, the FIB is assumed to be in sync with the RIB
+   * for all other prefixes and only prefixes in ribDelta are updated.
+   * Otherwise the FIB is rebuilt from the whole RIB.
+   */
   ForwardingInformationBaseUpdater(
       RouterID vrf,
       const IPv4NetworkToRouteMap& v4NetworkToRoute,
-      const IPv6NetworkToRouteMap& v6NetworkToRoute);
+      const IPv6NetworkToRouteMap& v6NetworkToRoute,
+      const RibRouteDelta* ribDelta = nullptr);
 
   std::shared_ptr<SwitchState> operator()(
       const std::shared_ptr<SwitchState>& state);
@@ -42,9 +49,22 @@ class ForwardingInformationBaseUpdater {
       const std::shared_ptr<
           facebook::fboss::ForwardingInformationBase<AddressT>>& fib);
 
+  /*
+   * Return FIB with just the prefixes in delta updated on change,
+   * null otherwise
+   */
+  template <typename AddressT>
+  std::shared_ptr<typename facebook::fboss::ForwardingInformationBase<AddressT>>
+  applyRibDelta(
+      const facebook::fboss::NetworkToRouteMap<AddressT>& rib,
+      const std::vector<RoutePrefix<AddressT>>& changedPrefixes,
+      const std::shared_ptr<
+          facebook::fboss::ForwardingInformationBase<AddressT>>& fib);
+
   RouterID vrf_;
   const IPv4NetworkToRouteMap& v4NetworkToRoute_;
   const IPv6NetworkToRouteMap& v6NetworkToRoute_;
+  const RibRouteDelta* ribDelta_;
 };
 
 } // namespace facebook::fboss
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/rib/NextHopDependencyIndex.h"
+
+namespace facebook::fboss {
+
+void NextHopDependencyIndex::invalidate() {
+  v4NextHopToDependents_.clear();
+  v6NextHopToDependents_.clear();
+  prefixToNextHops_.clear();
+  valid_ = false;
+}
+
+void NextHopDependencyIndex::setDependencies(
+    const folly::CIDRNetwork& prefix,
+    const std::vector<folly::IPAddress>& nhops) {
+  auto it = prefixToNextHops_.find(prefix);
+  if (it != prefixToNextHops_.end()) {
+    if (it->second == nhops) {
+      return;
+    }
+    for (const auto& nhop : it->second) {
+      removeDependent(nhop, prefix);
+    }
+    if (nhops.empty()) {
+      prefixToNextHops_.erase(it);
+      return;
+    }
+    it->second = nhops;
+  } else if (nhops.empty()) {
+    return;
+  } else {
+    prefixToNextHops_.emplace(prefix, nhops);
+  }
+  for (const auto& nhop : nhops) {
+    addDependent(nhop, prefix);
+  }
+}
+
+void NextHopDependencyIndex::addDependent(
+    const folly::IPAddress& nhop,
+    const folly::CIDRNetwork& prefix) {
+  if (nhop.isV4()) {
+    v4NextHopToDependents_[nhop.asV4()].insert(prefix);
+  } else {
+    v6NextHopToDependents_[nhop.asV6()].insert(prefix);
+  }
+}
+
+void NextHopDependencyIndex::removeDependent(
+    const folly::IPAddress& nhop,
+    const folly::CIDRNetwork& prefix) {
+  auto removeImpl = [&prefix](auto& nhopToDependents, const auto& addr) {
+    auto it = nhopToDependents.find(addr);
+    if (it == nhopToDependents.end()) {
+      return;
+    }
+    it->second.erase(prefix);
+    if (it->second.empty()) {
+      nhopToDependents.erase(it);
+    }
+  };
+  if (nhop.isV4()) {
+    removeImpl(v4NextHopToDependents_, nhop.asV4());
+  } else {
+    removeImpl(v6NextHopToDependents_, nhop.asV6());
+  }
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/IPAddress.h>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * NextHopDependencyIndex is the reverse of the recursive resolution graph
+ * of a route table. For every unresolved next hop address used by the best
+ * entry of some route, it records the prefixes of those routes.
+ *
+ * A route's resolution only depends on the longest prefix match of each of
+ * its next hops. That LPM can only change if a route covering the next hop
+ * is added, removed or changes its own forwarding info. So given a changed
+ * prefix P, the routes that need re-resolution are the dependents of every
+ * next hop within P, and transitively the dependents of those routes'
+ * prefixes. This lets RibRouteUpdater re-resolve just that set rather than
+ * the whole table.
+ *
+ * The index is only meaningful while it is in sync with the route tables
+ * it was built from. Anything that rewrites the tables wholesale (config
+ * application, rollback, warm boot) must invalidate() it, after which
+ * the next RibRouteUpdater pass does a full resolution and rebuilds it.
+ */
+class NextHopDependencyIndex {
+ public:
+  bool isValid() const {
+    return valid_;
+  }
+  void setValid() {
+    valid_ = true;
+  }
+  void invalidate();
+
+  /*
+   * Replace the set of next hops that prefix depends on. An empty
+   * next hop list removes prefix from the index.
+   */
+  void setDependencies(
+      const folly::CIDRNetwork& prefix,
+      const std::vector<folly::IPAddress>& nhops);
+  void removeDependencies(const folly::CIDRNetwork& prefix) {
+    setDependencies(prefix, {});
+  }
+
+  /*
+   * Invoke fn on the prefix of every route that has a next hop within
+   * the covering network.
+   */
+  template <typename Fn>
+  void forEachDependent(const folly::CIDRNetwork& covering, Fn fn) const {
+    if (covering.first.isV4()) {
+      forEachDependentImpl(
+          v4NextHopToDependents_, covering.first.asV4(), covering.second, fn);
+    } else {
+      forEachDependentImpl(
+          v6NextHopToDependents_, covering.first.asV6(), covering.second, fn);
+    }
+  }
+
+  size_t numDependentPrefixes() const {
+    return prefixToNextHops_.size();
+  }
+  size_t numNextHops() const {
+    return v4NextHopToDependents_.size() + v6NextHopToDependents_.size();
+  }
+
+ private:
+  template <typename AddrT>
+  using NextHopToDependents = std::map<AddrT, std::set<folly::CIDRNetwork>>;
+
+  template <typename AddrT, typename Fn>
+  static void forEachDependentImpl(
+      const NextHopToDependents<AddrT>& nhopToDependents,
+      const AddrT& network,
+      uint8_t mask,
+      Fn& fn) {
+    // Next hops within network form a contiguous range in address order
+    for (auto it = nhopToDependents.lower_bound(network.mask(mask));
+         it != nhopToDependents.end() && it->first.inSubnet(network, mask);
+         ++it) {
+      for (const auto& dependent : it->second) {
+        fn(dependent);
+      }
+    }
+  }
+  void addDependent(
+      const folly::IPAddress& nhop,
+      const folly::CIDRNetwork& prefix);
+  void removeDependent(
+      const folly::IPAddress& nhop,
+      const folly::CIDRNetwork& prefix);
+
+  NextHopToDependents<folly::IPAddressV4> v4NextHopToDependents_;
+  NextHopToDependents<folly::IPAddressV6> v6NextHopToDependents_;
+  std::map<folly::CIDRNetwork, std::vector<folly::IPAddress>> prefixToNextHops_;
+  bool valid_{false};
+};
+
+} // namespace facebook::fboss
@@ -15,6 +15,7 @@
 #include <boost/container/flat_map.hpp>
 #include <boost/container/flat_set.hpp>
 #include <boost/integer/common_factor.hpp>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 
 #include "fboss/agent/FbossError.h"
@@ -38,13 +39,52 @@ static const RoutePrefixV6 kIPv6LinkLocalPrefix{
     folly::IPAddressV6("fe80::"),
     64};
 static const auto kInterfaceRouteClientId = ClientID::INTERFACE_ROUTE;
+// Below this many routes to resolve in either family, handing one family
+// off to another thread costs more than it saves
+static constexpr size_t kMinRoutesPerFamilyToResolveConcurrently = 1024;
+
+namespace {
+template <typename AddressT>
+AddressT toAddress(const folly::IPAddress& addr);
+
+template <>
+IPAddressV4 toAddress<IPAddressV4>(const folly::IPAddress& addr) {
+  return addr.asV4();
+}
+
+template <>
+IPAddressV6 toAddress<IPAddressV6>(const folly::IPAddress& addr) {
+  return addr.asV6();
+}
+
+template <typename AddressT>
+bool hasCrossFamilyNextHop(const std::shared_ptr<Route<AddressT>>& route) {
+  const auto bestEntry = route->getBestEntry().second;
+  if (bestEntry->getAction() != RouteForwardAction::NEXTHOPS) {
+    return false;
+  }
+  for (const auto& nh : bestEntry->getNextHopSet()) {
+    // Next hops with an interface are resolved without any lookup
+    if (!nh.intfID().has_value() &&
+        nh.addr().isV4() != std::is_same_v<AddressT, IPAddressV4>) {
+      return true;
+    }
+  }
+  return false;
+}
+} // namespace
 
 RibRouteUpdater::RibRouteUpdater(
     IPv4NetworkToRouteMap* v4Routes,
-    IPv6NetworkToRouteMap* v6Routes)
-    : v4Routes_(v4Routes), v6Routes_(v6Routes) {}
-
-void RibRouteUpdater::update(
+    IPv6NetworkToRouteMap* v6Routes,
+    NextHopDependencyIndex* nhopDependencies,
+    folly::Executor* executor)
+    : v4Routes_(v4Routes),
+      v6Routes_(v6Routes),
+      nhopDependencies_(nhopDependencies),
+      executor_(executor) {}
+
+std::optional<RibRouteDelta> RibRouteUpdater::update(
     const std::map<ClientID, std::vector<RouteEntry>>& toAdd,
     const std::map<ClientID, std::vector<folly::CIDRNetwork>>& toDel,
     const std::set<ClientID>& resetClientsRoutesFor) {
@@ -66,7 +106,7 @@ void RibRouteUpdater::update(
                                : delItr->second),
         resetClientsRoutesFor.find(client) != resetClientsRoutesFor.end());
   }
-  updateDone();
+  return updateDone();
 }
 
 void RibRouteUpdater::updateImpl(
@@ -104,10 +144,12 @@ void RibRouteUpdater::addOrReplaceRouteImpl(
     if (!existingRouteForClient || !(*existingRouteForClient == entry)) {
       route = writableRoute<AddressT>(it);
       route->update(clientID, entry);
+      recordChange(prefix);
     }
     return;
   }
 
+  recordChange(prefix);
   routes->insert(
       prefix.network,
       prefix.mask,
@@ -145,6 +187,7 @@ void RibRouteUpdater::delRouteImpl(
   if (!clientNhopEntry) {
     return;
   }
+  recordChange(prefix);
   if (route->numClientEntries() == 1) {
     // If this client's the only entry, simply erase
     XLOG(DBG3) << "Deleting route: " << route->str();
@@ -184,6 +227,7 @@ void RibRouteUpdater::removeAllRoutesFromClientImpl(
     if (!nhopEntry) {
       continue;
     }
+    recordChange(route->prefix());
     if (route->numClientEntries() == 1) {
       // This client's is the only entry avoid unnecessary cloning
       // we are going to prune the route anyways
@@ -482,8 +526,9 @@ template <typename AddressT>
 std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
     typename NetworkToRouteMap<AddressT>::Iterator ritr) {
   auto& route = ritr->value();
+  auto& resolution = resolutionState<AddressT>();
   // Starting resolution for this route, remove from resolution queue
-  needsResolution_.erase(route.get());
+  resolution.needsResolution.erase(route.get());
 
   bool hasToCpu{false};
   bool hasDrop{false};
@@ -498,8 +543,9 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
   } else if (action == RouteForwardAction::TO_CPU) {
     hasToCpu = true;
   } else {
-    auto fwItr = unresolvedToResolvedNhops_.find(bestEntry->getNextHopSet());
-    if (fwItr == unresolvedToResolvedNhops_.end()) {
+    auto& resolvedNhops = resolution.unresolvedToResolvedNhops;
+    auto fwItr = resolvedNhops.find(bestEntry->getNextHopSet());
+    if (fwItr == resolvedNhops.end()) {
       NextHopForwardInfos nhToFwds;
       // loop through all nexthops to find out the forward info
       for (const auto& nh : bestEntry->getNextHopSet()) {
@@ -538,7 +584,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
         }
       }
 
-      fwItr = unresolvedToResolvedNhops_
+      fwItr = resolvedNhops
                   .insert(
                       {bestEntry->getNextHopSet(),
                        mergeForwardInfos(nhToFwds, route)})
@@ -614,27 +660,204 @@ void RibRouteUpdater::resolve(NetworkToRouteMap<AddressT>* routes) {
   }
 }
 
+template <typename AddressT>
+void RibRouteUpdater::resolve(
+    NetworkToRouteMap<AddressT>* routes,
+    const std::vector<std::pair<RoutePrefix<AddressT>, void*>>& toResolve,
+    std::vector<RoutePrefix<AddressT>>* resolutionChanged) {
+  for (const auto& [prefix, route] : toResolve) {
+    auto ritr = routes->exactMatch(prefix.network, prefix.mask);
+    // Route may already have been resolved recursively via getFwdInfoFromNhop
+    if (ritr != routes->end() && needResolve(ritr->value())) {
+      resolveOne<AddressT>(ritr);
+    }
+  }
+  // Routes are cloned on write, so a route whose resolution changed
+  // is no longer the object we marked
+  for (const auto& [prefix, route] : toResolve) {
+    auto ritr = routes->exactMatch(prefix.network, prefix.mask);
+    if (ritr != routes->end() && ritr->value().get() != route) {
+      resolutionChanged->push_back(prefix);
+    }
+  }
+}
+
 template <typename AddressT>
 bool RibRouteUpdater::needResolve(
-    const std::shared_ptr<Route<AddressT>>& route) const {
-  return needsResolution_.find(route.get()) != needsResolution_.end();
+    const std::shared_ptr<Route<AddressT>>& route) {
+  const auto& needsResolution = resolutionState<AddressT>().needsResolution;
+  return needsResolution.find(route.get()) != needsResolution.end();
+}
+
+template <typename V4Fn, typename V6Fn>
+void RibRouteUpdater::forEachFamily(const V4Fn& v4Fn, const V6Fn& v6Fn) {
+  if (!executor_ || crossFamilyNextHops_ ||
+      std::min(
+          v4Resolution_.needsResolution.size(),
+          v6Resolution_.needsResolution.size()) <
+          kMinRoutesPerFamilyToResolveConcurrently) {
+    v4Fn();
+    v6Fn();
+    return;
+  }
+  auto v4Done = folly::via(folly::getKeepAliveToken(executor_), v4Fn);
+  auto v6Result = folly::makeTryWith(v6Fn);
+  // v4Fn must be done before anything it uses goes away
+  std::move(v4Done).get();
+  v6Result.throwIfFailed();
+}
+
+template <typename AddressT>
+void RibRouteUpdater::updateDependencies(
+    const std::shared_ptr<Route<AddressT>>& route) {
+  std::vector<folly::IPAddress> nhops;
+  const auto bestEntry = route->getBestEntry().second;
+  if (bestEntry->getAction() == RouteForwardAction::NEXTHOPS) {
+    for (const auto& nh : bestEntry->getNextHopSet()) {
+      // Next hops with an interface are resolved as is, so they
+      // don't depend on any other route
+      if (!nh.intfID().has_value()) {
+        nhops.push_back(nh.addr());
+      }
+    }
+  }
+  nhopDependencies_->setDependencies(route->prefix().toCidrNetwork(), nhops);
+}
+
+void RibRouteUpdater::rebuildDependencies() {
+  nhopDependencies_->invalidate();
+  std::for_each(v4Routes_->begin(), v4Routes_->end(), [this](const auto& r) {
+    updateDependencies(r.value());
+  });
+  std::for_each(v6Routes_->begin(), v6Routes_->end(), [this](const auto& r) {
+    updateDependencies(r.value());
+  });
+  nhopDependencies_->setValid();
+}
+
+template <typename AddressT>
+void RibRouteUpdater::markForResolution(
+    const std::shared_ptr<Route<AddressT>>& route) {
+  resolutionState<AddressT>().needsResolution.insert(route.get());
+  if (!crossFamilyNextHops_ && hasCrossFamilyNextHop(route)) {
+    crossFamilyNextHops_ = true;
+  }
 }
 
-void RibRouteUpdater::updateDone() {
+template <typename AddressT>
+void RibRouteUpdater::markForResolution(
+    NetworkToRouteMap<AddressT>* routes,
+    const folly::CIDRNetwork& prefix,
+    std::vector<std::pair<RoutePrefix<AddressT>, void*>>* toResolve) {
+  RoutePrefix<AddressT> routePrefix{
+      toAddress<AddressT>(prefix.first), prefix.second};
+  auto it = routes->exactMatch(routePrefix.network, routePrefix.mask);
+  if (it != routes->end()) {
+    markForResolution(it->value());
+    toResolve->emplace_back(routePrefix, it->value().get());
+  }
+}
+
+void RibRouteUpdater::resolveAll() {
   // Record all routes as needing resolution
-  auto markForResolution = [this](const auto& routes) {
+  auto markAllForResolution = [this](const auto& routes) {
     std::for_each(routes->begin(), routes->end(), [this](const auto& route) {
-      needsResolution_.insert(route.value().get());
+      markForResolution(route.value());
     });
   };
-  markForResolution(v4Routes_);
-  markForResolution(v6Routes_);
+  markAllForResolution(v4Routes_);
+  markAllForResolution(v6Routes_);
+  forEachFamily(
+      [this]() { resolve(v4Routes_); }, [this]() { resolve(v6Routes_); });
+}
+
+RibRouteDelta RibRouteUpdater::resolveChanged() {
+  // Bring the dependency index up to date with the changed routes
+  for (const auto& prefix : changedPrefixes_) {
+    if (prefix.first.isV4()) {
+      auto it = v4Routes_->exactMatch(prefix.first.asV4(), prefix.second);
+      if (it != v4Routes_->end()) {
+        updateDependencies(it->value());
+        continue;
+      }
+    } else {
+      auto it = v6Routes_->exactMatch(prefix.first.asV6(), prefix.second);
+      if (it != v6Routes_->end()) {
+        updateDependencies(it->value());
+        continue;
+      }
+    }
+    nhopDependencies_->removeDependencies(prefix);
+  }
+  // Walk the reverse dependency graph from the changed prefixes. Any route
+  // with a next hop inside a visited prefix may now resolve differently,
+  // and so may everything that resolves through that route in turn.
+  std::set<folly::CIDRNetwork> visited;
+  std::vector<folly::CIDRNetwork> worklist(
+      changedPrefixes_.begin(), changedPrefixes_.end());
+  std::vector<std::pair<RoutePrefixV4, void*>> v4ToResolve;
+  std::vector<std::pair<RoutePrefixV6, void*>> v6ToResolve;
+  while (!worklist.empty()) {
+    auto prefix = worklist.back();
+    worklist.pop_back();
+    if (!visited.insert(prefix).second) {
+      continue;
+    }
+    if (prefix.first.isV4()) {
+      markForResolution(v4Routes_, prefix, &v4ToResolve);
+    } else {
+      markForResolution(v6Routes_, prefix, &v6ToResolve);
+    }
+    nhopDependencies_->forEachDependent(
+        prefix, [&visited, &worklist](const folly::CIDRNetwork& dependent) {
+          if (visited.find(dependent) == visited.end()) {
+            worklist.push_back(dependent);
+          }
+        });
+  }
+  XLOG(DBG3) << "Incremental resolution of " << changedPrefixes_.size()
+             << " changed prefixes, re-resolving "
+             << v4ToResolve.size() + v6ToResolve.size() << " routes";
+  RibRouteDelta delta;
+  forEachFamily(
+      [&]() { resolve(v4Routes_, v4ToResolve, &delta.v4Prefixes); },
+      [&]() { resolve(v6Routes_, v6ToResolve, &delta.v6Prefixes); });
+  // Routes added, modified or deleted by this update always make it
+  // to the delta, whether or not their resolution changed
+  for (const auto& prefix : changedPrefixes_) {
+    if (prefix.first.isV4()) {
+      delta.v4Prefixes.push_back(
+          RoutePrefixV4{prefix.first.asV4(), prefix.second});
+    } else {
+      delta.v6Prefixes.push_back(
+          RoutePrefixV6{prefix.first.asV6(), prefix.second});
+    }
+  }
+  auto dedup = [](auto& prefixes) {
+    std::sort(prefixes.begin(), prefixes.end());
+    prefixes.erase(
+        std::unique(prefixes.begin(), prefixes.end()), prefixes.end());
+  };
+  dedup(delta.v4Prefixes);
+  dedup(delta.v6Prefixes);
+  return delta;
+}
+
+std::optional<RibRouteDelta> RibRouteUpdater::updateDone() {
   SCOPE_EXIT {
-    needsResolution_.clear();
-    unresolvedToResolvedNhops_.clear();
+    v4Resolution_ = ResolutionState();
+    v6Resolution_ = ResolutionState();
+    crossFamilyNextHops_ = false;
+    changedPrefixes_.clear();
   };
-  resolve(v4Routes_);
-  resolve(v6Routes_);
+  if (nhopDependencies_ && nhopDependencies_->isValid()) {
+    return resolveChanged();
+  }
+  resolveAll();
+  if (nhopDependencies_) {
+    rebuildDependencies();
+  }
+  return std::nullopt;
 }
 
 } // namespace facebook::fboss
@@ -13,11 +13,45 @@
 #include "fboss/agent/types.h"
 
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/NextHopDependencyIndex.h"
 
+#include <folly/Executor.h>
 #include <folly/IPAddress.h>
 
+#include <optional>
+#include <set>
+#include <type_traits>
+
 namespace facebook::fboss {
 
+/*
+ * Prefixes whose route was added, changed or removed in the RIB by an
+ * update, post resolution. Consumers look up each prefix in the RIB to
+ * learn its new state - a prefix missing from the RIB was removed.
+ */
+struct RibRouteDelta {
+  std::vector<RoutePrefixV4> v4Prefixes;
+  std::vector<RoutePrefixV6> v6Prefixes;
+
+  bool empty() const {
+    return v4Prefixes.empty() && v6Prefixes.empty();
+  }
+  template <typename AddressT>
+  const std::vector<RoutePrefix<AddressT>>& prefixes() const;
+};
+
+template <>
+inline const std::vector<RoutePrefixV4>&
+RibRouteDelta::prefixes<folly::IPAddressV4>() const {
+  return v4Prefixes;
+}
+
+template <>
+inline const std::vector<RoutePrefixV6>&
+RibRouteDelta::prefixes<folly::IPAddressV6>() const {
+  return v6Prefixes;
+}
+
 /**
  * Expected behavior of RibRouteUpdater::resolve():
  *
@@ -41,12 +75,25 @@ namespace facebook::fboss {
  *    only IP nexthops will be in the final ECMP group.
  * 5. If and only if TO_CPU is the only nexthop (directly or indirectly) of
  *    a route, TO_CPU action will be only path in the resolved ECMP group.
+ *
+ * When constructed with a valid NextHopDependencyIndex, resolve() is
+ * incremental: only the prefixes changed by this update and the routes
+ * that (transitively) resolve through them are re-resolved. Without an
+ * index, or with an invalidated one, every route is re-resolved and the
+ * index (if any) is rebuilt from scratch.
+ *
+ * When given an executor, v4 and v6 routes are resolved concurrently, one
+ * family on the executor and the other on the calling thread. This is
+ * only done when no route being resolved has a next hop of the other
+ * family, as resolving such a route reads the other family's routes.
  */
 class RibRouteUpdater {
  public:
   RibRouteUpdater(
       IPv4NetworkToRouteMap* v4Routes,
-      IPv6NetworkToRouteMap* v6Routes);
+      IPv6NetworkToRouteMap* v6Routes,
+      NextHopDependencyIndex* nhopDependencies = nullptr,
+      folly::Executor* executor = nullptr);
 
   struct RouteEntry {
     folly::CIDRNetwork prefix;
@@ -54,27 +101,32 @@ class RibRouteUpdater {
   };
   /*
    * Update routes for a clients and trigger
-   * resolution
+   * resolution. Returns the routes that changed as a result, if
+   * resolution was incremental. std::nullopt means any route may have
+   * changed.
    */
-  void update(
+  std::optional<RibRouteDelta> update(
       ClientID client,
       const std::vector<RouteEntry>& toAdd,
       const std::vector<folly::CIDRNetwork>& toDel,
       bool resetClientsRoutes) {
     updateImpl(client, toAdd, toDel, resetClientsRoutes);
-    updateDone();
+    return updateDone();
   }
   /*
    * Update routes for multiple clients and trigger
    * resolution
    */
 
-  void update(
+  std::optional<RibRouteDelta> update(
       const std::map<ClientID, std::vector<RouteEntry>>& toAdd,
       const std::map<ClientID, std::vector<folly::CIDRNetwork>>& toDel,
       const std::set<ClientID>& resetClientsRoutesFor);
 
  private:
+  template <typename AddressT>
+  using Prefix = RoutePrefix<AddressT>;
+
   void updateImpl(
       ClientID client,
       const std::vector<RouteEntry>& toAdd,
@@ -85,15 +137,28 @@ class RibRouteUpdater {
       uint8_t mask,
       ClientID clientID,
       RouteNextHopEntry entry);
-  void updateDone();
+  std::optional<RibRouteDelta> updateDone();
+  void resolveAll();
+  RibRouteDelta resolveChanged();
+  void rebuildDependencies();
+  template <typename AddressT>
+  void updateDependencies(const std::shared_ptr<Route<AddressT>>& route);
+  template <typename AddressT>
+  void markForResolution(const std::shared_ptr<Route<AddressT>>& route);
+  template <typename AddressT>
+  void markForResolution(
+      NetworkToRouteMap<AddressT>* routes,
+      const folly::CIDRNetwork& prefix,
+      std::vector<std::pair<RoutePrefix<AddressT>, void*>>* toResolve);
+  template <typename AddressT>
+  void recordChange(const Prefix<AddressT>& prefix) {
+    changedPrefixes_.insert(prefix.toCidrNetwork());
+  }
 
   void
   delRoute(const folly::IPAddress& network, uint8_t mask, ClientID clientID);
   void removeAllRoutesForClient(ClientID clientID);
 
-  template <typename AddressT>
-  using Prefix = RoutePrefix<AddressT>;
-
   template <typename AddressT>
   void addOrReplaceRouteImpl(
       const Prefix<AddressT>& prefix,
@@ -112,6 +177,11 @@ class RibRouteUpdater {
 
   template <typename AddressT>
   void resolve(NetworkToRouteMap<AddressT>* routes);
+  template <typename AddressT>
+  void resolve(
+      NetworkToRouteMap<AddressT>* routes,
+      const std::vector<std::pair<RoutePrefix<AddressT>, void*>>& toResolve,
+      std::vector<RoutePrefix<AddressT>>* resolutionChanged);
 
   template <typename AddressT>
   std::shared_ptr<Route<AddressT>> resolveOne(
@@ -131,20 +201,50 @@ class RibRouteUpdater {
       RouteNextHopSet& fwd);
 
   template <typename AddressT>
-  bool needResolve(const std::shared_ptr<Route<AddressT>>& route) const;
+  bool needResolve(const std::shared_ptr<Route<AddressT>>& route);
+
+  template <typename V4Fn, typename V6Fn>
+  void forEachFamily(const V4Fn& v4Fn, const V6Fn& v6Fn);
 
   using NextHopIpToForwardInfo =
       std::unordered_map<folly::IPAddress, RouteNextHopSet>;
 
+  /*
+   * Resolution state of one address family. Kept apart, so that v4 and
+   * v6 routes can be resolved concurrently.
+   */
+  struct ResolutionState {
+    std::unordered_set<void*> needsResolution;
+    /*
+     * Cache for next hop to FWD informatio. For our use case
+     * its pretty common for the same next hops to repeat, so
+     * cache resolution
+     */
+    std::map<RouteNextHopSet, RouteNextHopSet> unresolvedToResolvedNhops;
+  };
+  template <typename AddressT>
+  ResolutionState& resolutionState() {
+    if constexpr (std::is_same_v<AddressT, folly::IPAddressV4>) {
+      return v4Resolution_;
+    } else {
+      return v6Resolution_;
+    }
+  }
+
   IPv4NetworkToRouteMap* v4Routes_{nullptr};
   IPv6NetworkToRouteMap* v6Routes_{nullptr};
-  std::unordered_set<void*> needsResolution_;
+  NextHopDependencyIndex* nhopDependencies_{nullptr};
+  folly::Executor* executor_{nullptr};
+  ResolutionState v4Resolution_;
+  ResolutionState v6Resolution_;
+  // Whether a route marked for resolution has a next hop of the other
+  // address family
+  bool crossFamilyNextHops_{false};
   /*
-   * Cache for next hop to FWD informatio. For our use case
-   * its pretty common for the same next hops to repeat, so
-   * cache resolution
+   * Prefixes added, removed or modified by this update. Seeds incremental
+   * resolution when nhopDependencies_ is valid.
    */
-  std::map<RouteNextHopSet, RouteNextHopSet> unresolvedToResolvedNhops_;
+  std::set<folly::CIDRNetwork> changedPrefixes_;
 };
 
 } // namespace facebook::fboss
@@ -30,8 +30,17 @@
 #include <utility>
 
 #include <folly/ScopeGuard.h>
+#include <folly/executors/thread_factory/NamedThreadFactory.h>
+#include <folly/futures/Future.h>
 #include <folly/logging/xlog.h>
 
+DEFINE_int32(
+    rib_resolution_threads,
+    2,
+    "Number of threads resolving RIB routes. With more than one, the routes "
+    "of different VRFs, and the v4 and v6 routes of a VRF, are resolved "
+    "concurrently");
+
 namespace facebook::fboss {
 
 namespace {
@@ -52,6 +61,30 @@ class Timer {
   std::chrono::time_point<std::chrono::steady_clock> start_;
 };
 
+/*
+ * Call fn(i) for each i in [0, count), concurrently on executor if there is
+ * one. Once all calls are done, rethrow the first exception any of them
+ * threw.
+ */
+template <typename Fn>
+void forEachConcurrently(folly::Executor* executor, size_t count, Fn fn) {
+  if (!executor || count < 2) {
+    for (size_t i = 0; i < count; ++i) {
+      fn(i);
+    }
+    return;
+  }
+  std::vector<folly::Future<folly::Unit>> futures;
+  futures.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    futures.push_back(
+        folly::via(folly::getKeepAliveToken(executor), [&fn, i]() { fn(i); }));
+  }
+  for (auto& result : folly::collectAll(futures.begin(), futures.end()).get()) {
+    result.throwIfFailed();
+  }
+}
+
 template <typename AddressT>
 void reconstructRibFromFib(
     const std::shared_ptr<ForwardingInformationBase<AddressT>>& fib,
@@ -82,6 +115,14 @@ void reconstructRibFromFib(
 }
 } // namespace
 
+RibRouteTables::RibRouteTables() {
+  if (FLAGS_rib_resolution_threads > 1) {
+    resolutionExecutor_ = std::make_unique<folly::CPUThreadPoolExecutor>(
+        FLAGS_rib_resolution_threads,
+        std::make_shared<folly::NamedThreadFactory>("ribResolution"));
+  }
+}
+
 template <typename RibUpdateFn>
 void RibRouteTables::updateRib(RouterID vrf, const RibUpdateFn& updateRibFn) {
   auto lockedRouteTables = synchronizedRouteTables_.wlock();
@@ -121,61 +162,88 @@ void RibRouteTables::reconfigure(
 
   std::vector<RouterID> existingVrfs = getVrfList();
 
-  auto configureRoutesForVrf =
-      [&](RouterID vrf, const PrefixToInterfaceIDAndIP& interfaceRoutes) {
-        // A ConfigApplier object should be independent of the VRF whose
-        // routes it is processing. However, because interface and static
-        // routes for _all_ VRFs are passed to ConfigApplier, the vrf
-        // argument is needed to identify the subset of those routes which
-        // should be processed.
-
-        // ConfigApplier can be made independent of the VRF whose routes it
-        // is processing by the use of boost::filter_iterator.
-        updateRib(vrf, [&](auto& routeTable) {
-          ConfigApplier configApplier(
-              vrf,
-              &(routeTable.v4NetworkToRoute),
-              &(routeTable.v6NetworkToRoute),
-              folly::range(interfaceRoutes.cbegin(), interfaceRoutes.cend()),
-              folly::range(
-                  staticRoutesToCpu.cbegin(), staticRoutesToCpu.cend()),
-              folly::range(
-                  staticRoutesToNull.cbegin(), staticRoutesToNull.cend()),
-              folly::range(
-                  staticRoutesWithNextHops.cbegin(),
-                  staticRoutesWithNextHops.cend()),
-              folly::range(
-                  staticIp2MplsRoutes.cbegin(), staticIp2MplsRoutes.cend()));
-          // Apply config
-          configApplier.apply();
-        });
-        updateFib(vrf, updateFibCallback, cookie);
-      };
-  // Because of this sequential loop over each VRF, config application scales
-  // linearly with the number of VRFs. If FBOSS is run in a multi-VRF routing
-  // architecture in the future, this slow-down can be avoided by
-  // parallelizing this loop. Converting this loop to use task-level
-  // parallelism should be straightfoward because it has been written to avoid
-  // dependencies across different iterations of the loop.
+  // Configure routes of each of vrfs, given the interface routes of each
+  auto configureRoutesForVrfs = [&](const std::vector<RouterID>& vrfs,
+                                    const auto& interfaceRoutesFor) {
+    {
+      auto lockedRouteTables = synchronizedRouteTables_.wlock();
+      std::vector<RouteTable*> routeTables;
+      for (auto vrf : vrfs) {
+        auto it = lockedRouteTables->find(vrf);
+        if (it == lockedRouteTables->end()) {
+          throw FbossError("VRF ", vrf, " not configured");
+        }
+        routeTables.push_back(&it->second);
+      }
+      // VRFs are independent of each other, so they are configured
+      // concurrently. When there is just one, its address families
+      // are resolved concurrently instead.
+      auto executor = vrfs.size() == 1 ? resolutionExecutor_.get() : nullptr;
+      forEachConcurrently(
+          resolutionExecutor_.get(), vrfs.size(), [&](size_t idx) {
+            auto vrf = vrfs[idx];
+            auto& routeTable = *routeTables[idx];
+            const auto& interfaceRoutes = interfaceRoutesFor(vrf);
+            // A ConfigApplier object should be independent of the VRF whose
+            // routes it is processing. However, because interface and
+            // static routes for _all_ VRFs are passed to ConfigApplier, the
+            // vrf argument is needed to identify the subset of those routes
+            // which should be processed.
+
+            // ConfigApplier can be made independent of the VRF whose routes
+            // it is processing by the use of boost::filter_iterator.
+            ConfigApplier configApplier(
+                vrf,
+                routeTable.writableV4(),
+                routeTable.writableV6(),
+                folly::range(interfaceRoutes.cbegin(), interfaceRoutes.cend()),
+                folly::range(
+                    staticRoutesToCpu.cbegin(), staticRoutesToCpu.cend()),
+                folly::range(
+                    staticRoutesToNull.cbegin(), staticRoutesToNull.cend()),
+                folly::range(
+                    staticRoutesWithNextHops.cbegin(),
+                    staticRoutesWithNextHops.cend()),
+                folly::range(
+                    staticIp2MplsRoutes.cbegin(), staticIp2MplsRoutes.cend()),
+                executor);
+            // Apply config
+            configApplier.apply();
+            // Config application resets interface and static routes
+            // wholesale, let the next update rebuild dependencies
+            routeTable.nhopDependencies.invalidate();
+          });
+    }
+    // FIB updates go one VRF at a time, each building on the state the
+    // previous one returned
+    for (auto vrf : vrfs) {
+      updateFib(vrf, updateFibCallback, cookie);
+    }
+  };
+  // First handle the VRFs for which no interface routes exist
+  std::vector<RouterID> vrfsWithoutInterfaceRoutes;
   for (auto vrf : existingVrfs) {
-    // First handle the VRFs for which no interface routes exist
-    if (configRouterIDToInterfaceRoutes.find(vrf) !=
+    if (configRouterIDToInterfaceRoutes.find(vrf) ==
         configRouterIDToInterfaceRoutes.end()) {
-      continue;
+      vrfsWithoutInterfaceRoutes.push_back(vrf);
     }
-    configureRoutesForVrf(
-        vrf, {} /* No interface routes*/
-    );
   }
+  const PrefixToInterfaceIDAndIP noInterfaceRoutes;
+  configureRoutesForVrfs(
+      vrfsWithoutInterfaceRoutes,
+      [&noInterfaceRoutes](RouterID /*vrf*/)
+          -> const PrefixToInterfaceIDAndIP& { return noInterfaceRoutes; });
   {
     auto lockedRouteTables = synchronizedRouteTables_.wlock();
     *lockedRouteTables = constructRouteTables(
         lockedRouteTables, configRouterIDToInterfaceRoutes);
   }
-  for (auto& vrf : getVrfList()) {
-    const auto& interfaceRoutes = configRouterIDToInterfaceRoutes.at(vrf);
-    configureRoutesForVrf(vrf, interfaceRoutes);
-  }
+  configureRoutesForVrfs(
+      getVrfList(),
+      [&configRouterIDToInterfaceRoutes](RouterID vrf)
+          -> const PrefixToInterfaceIDAndIP& {
+        return configRouterIDToInterfaceRoutes.at(vrf);
+      });
 }
 
 void RibRouteTables::update(
@@ -188,23 +256,34 @@ void RibRouteTables::update(
     folly::StringPiece updateType,
     const FibUpdateFunction& fibUpdateCallback,
     void* cookie) {
+  std::optional<RibRouteDelta> ribDelta;
   updateRib(routerID, [&](auto& routeTable) {
     RibRouteUpdater updater(
-        &(routeTable.v4NetworkToRoute), &(routeTable.v6NetworkToRoute));
-    updater.update(clientID, toAddRoutes, toDelPrefixes, resetClientsRoutes);
+        routeTable.writableV4(),
+        routeTable.writableV6(),
+        &(routeTable.nhopDependencies),
+        resolutionExecutor_.get());
+    ribDelta = updater.update(
+        clientID, toAddRoutes, toDelPrefixes, resetClientsRoutes);
   });
-  updateFib(routerID, fibUpdateCallback, cookie);
+  updateFib(routerID, fibUpdateCallback, cookie, ribDelta);
 }
 
 void RibRouteTables::updateFib(
     RouterID vrf,
     const FibUpdateFunction& fibUpdateCallback,
-    void* cookie) {
+    void* cookie,
+    const std::optional<RibRouteDelta>& ribDelta) {
   try {
-    auto lockedRouteTables = synchronizedRouteTables_.rlock();
-    auto& routeTable = lockedRouteTables->find(vrf)->second;
+    // Program FIB from a snapshot, so as not to hold the RIB lock meanwhile
+    auto snapshot = getSnapshot(vrf);
+    CHECK(snapshot);
     fibUpdateCallback(
-        vrf, routeTable.v4NetworkToRoute, routeTable.v6NetworkToRoute, cookie);
+        vrf,
+        *snapshot->v4NetworkToRoute,
+        *snapshot->v6NetworkToRoute,
+        ribDelta ? &(*ribDelta) : nullptr,
+        cookie);
   } catch (const FbossHwUpdateError& hwUpdateError) {
     {
       SCOPE_FAIL {
@@ -214,11 +293,18 @@ void RibRouteTables::updateFib(
       auto lockedRouteTables = synchronizedRouteTables_.wlock();
       auto& routeTable = lockedRouteTables->find(vrf)->second;
       reconstructRibFromFib<folly::IPAddressV4>(
-          fib->getFibV4(), &routeTable.v4NetworkToRoute);
+          fib->getFibV4(), routeTable.writableV4());
       reconstructRibFromFib<folly::IPAddressV6>(
-          fib->getFibV6(), &routeTable.v6NetworkToRoute);
+          fib->getFibV6(), routeTable.writableV6());
+      routeTable.nhopDependencies.invalidate();
     }
     throw;
+  } catch (const std::exception&) {
+    // FIB may not reflect this update, so the next one must sync
+    // the whole RIB rather than just its delta
+    auto lockedRouteTables = synchronizedRouteTables_.wlock();
+    lockedRouteTables->find(vrf)->second.nhopDependencies.invalidate();
+    throw;
   }
 }
 
@@ -231,7 +317,8 @@ void RibRouteTables::ensureVrf(RouterID rid) {
 
 std::vector<RouterID> RibRouteTables::getVrfList() const {
   auto lockedRouteTables = synchronizedRouteTables_.rlock();
-  std::vector<RouterID> res(lockedRouteTables->size());
+  std::vector<RouterID> res;
+  res.reserve(lockedRouteTables->size());
   for (const auto& entry : *lockedRouteTables) {
     res.push_back(entry.first);
   }
@@ -244,28 +331,47 @@ void RibRouteTables::setClassID(
     FibUpdateFunction fibUpdateCallback,
     std::optional<cfg::AclLookupClass> classId,
     void* cookie) {
+  // Class ID does not affect resolution, so just the updated routes change.
+  // Deltas are only usable while FIB is known to be in sync with RIB, which
+  // is tracked by the validity of the dependency index.
+  std::optional<RibRouteDelta> ribDelta;
   updateRib(rid, [&](auto& routeTable) {
+    if (routeTable.nhopDependencies.isValid()) {
+      ribDelta = RibRouteDelta();
+    }
     // Update rib
-    auto updateRoute = [&classId](auto& rib, auto ip, uint8_t mask) {
-      auto ritr = rib.exactMatch(ip, mask);
-      if (ritr == rib.end() || ritr->value()->getClassID() == classId) {
-        return;
-      }
-      ritr->value() = ritr->value()->clone();
-      ritr->value()->updateClassID(classId);
-      ritr->value()->publish();
-    };
-    auto& v4Rib = routeTable.v4NetworkToRoute;
-    auto& v6Rib = routeTable.v6NetworkToRoute;
+    auto updateRoute =
+        [&classId](auto& rib, auto ip, uint8_t mask, auto* changed) {
+          auto ritr = rib.exactMatch(ip, mask);
+          if (ritr == rib.end() || ritr->value()->getClassID() == classId) {
+            return;
+          }
+          ritr->value() = ritr->value()->clone();
+          ritr->value()->updateClassID(classId);
+          ritr->value()->publish();
+          if (changed) {
+            changed->push_back(ritr->value()->prefix());
+          }
+        };
+    auto& v4Rib = *routeTable.writableV4();
+    auto& v6Rib = *routeTable.writableV6();
     for (auto& prefix : prefixes) {
       if (prefix.first.isV4()) {
-        updateRoute(v4Rib, prefix.first.asV4(), prefix.second);
+        updateRoute(
+            v4Rib,
+            prefix.first.asV4(),
+            prefix.second,
+            ribDelta ? &ribDelta->v4Prefixes : nullptr);
       } else {
-        updateRoute(v6Rib, prefix.first.asV6(), prefix.second);
+        updateRoute(
+            v6Rib,
+            prefix.first.asV6(),
+            prefix.second,
+            ribDelta ? &ribDelta->v6Prefixes : nullptr);
       }
     }
   });
-  updateFib(rid, fibUpdateCallback, cookie);
+  updateFib(rid, fibUpdateCallback, cookie, ribDelta);
 }
 
 template <typename AddressT>
@@ -471,16 +577,22 @@ template <typename Filter>
 folly::dynamic RibRouteTables::toFollyDynamicImpl(const Filter& filter) const {
   folly::dynamic rib = folly::dynamic::object;
 
-  auto lockedRouteTables = synchronizedRouteTables_.rlock();
-  for (const auto& routeTable : *lockedRouteTables) {
-    auto routerIdStr =
-        folly::to<std::string>(static_cast<uint32_t>(routeTable.first));
+  // Serialize snapshots, so that route updates can go on meanwhile
+  std::vector<std::pair<RouterID, RouteTableSnapshot>> snapshots;
+  {
+    auto lockedRouteTables = synchronizedRouteTables_.rlock();
+    for (const auto& routeTable : *lockedRouteTables) {
+      snapshots.emplace_back(routeTable.first, routeTable.second.snapshot());
+    }
+  }
+  for (const auto& [vrf, snapshot] : snapshots) {
+    auto routerIdStr = folly::to<std::string>(static_cast<uint32_t>(vrf));
     rib[routerIdStr] = folly::dynamic::object;
-    rib[routerIdStr][kRouterId] = static_cast<uint32_t>(routeTable.first);
+    rib[routerIdStr][kRouterId] = static_cast<uint32_t>(vrf);
     rib[routerIdStr][kRibV4] =
-        routeTable.second.v4NetworkToRoute.toFollyDynamic(filter);
+        snapshot.v4NetworkToRoute->toFollyDynamic(filter);
     rib[routerIdStr][kRibV6] =
-        routeTable.second.v6NetworkToRoute.toFollyDynamic(filter);
+        snapshot.v6NetworkToRoute->toFollyDynamic(filter);
   }
 
   return rib;
@@ -496,9 +608,12 @@ RibRouteTables RibRouteTables::fromFollyDynamic(
     lockedRouteTables->insert(std::make_pair(
         vrf,
         RouteTable{
-            IPv4NetworkToRouteMap::fromFollyDynamic(routeTable.second[kRibV4]),
-            IPv6NetworkToRouteMap::fromFollyDynamic(
-                routeTable.second[kRibV6])}));
+            std::make_shared<IPv4NetworkToRouteMap>(
+                IPv4NetworkToRouteMap::fromFollyDynamic(
+                    routeTable.second[kRibV4])),
+            std::make_shared<IPv6NetworkToRouteMap>(
+                IPv6NetworkToRouteMap::fromFollyDynamic(
+                    routeTable.second[kRibV6]))}));
   }
 
   if (fibs) {
@@ -522,8 +637,8 @@ RibRouteTables RibRouteTables::fromFollyDynamic(
     };
     for (auto& fib : *fibs) {
       auto& routeTables = (*lockedRouteTables)[fib->getID()];
-      importRoutes(fib->getFibV6(), &routeTables.v6NetworkToRoute);
-      importRoutes(fib->getFibV4(), &routeTables.v4NetworkToRoute);
+      importRoutes(fib->getFibV6(), routeTables.writableV6());
+      importRoutes(fib->getFibV4(), routeTables.writableV4());
     }
   }
   return rib;
@@ -541,24 +656,32 @@ RoutingInformationBase::fromFollyDynamic(
 std::vector<RouteDetails> RibRouteTables::getRouteTableDetails(
     RouterID rid) const {
   std::vector<RouteDetails> routeDetails;
-  SYNCHRONIZED_CONST(synchronizedRouteTables_) {
-    const auto it = synchronizedRouteTables_.find(rid);
-    if (it != synchronizedRouteTables_.end()) {
-      for (auto rit = it->second.v4NetworkToRoute.begin();
-           rit != it->second.v4NetworkToRoute.end();
-           ++rit) {
-        routeDetails.emplace_back(rit->value()->toRouteDetails());
-      }
-      for (auto rit = it->second.v6NetworkToRoute.begin();
-           rit != it->second.v6NetworkToRoute.end();
-           ++rit) {
-        routeDetails.emplace_back(rit->value()->toRouteDetails());
-      }
+  // Read a snapshot, so as not to hold up route updates meanwhile
+  auto snapshot = getSnapshot(rid);
+  if (snapshot) {
+    routeDetails.reserve(
+        snapshot->v4NetworkToRoute->size() +
+        snapshot->v6NetworkToRoute->size());
+    for (const auto& node : *snapshot->v4NetworkToRoute) {
+      routeDetails.emplace_back(node.value()->toRouteDetails());
+    }
+    for (const auto& node : *snapshot->v6NetworkToRoute) {
+      routeDetails.emplace_back(node.value()->toRouteDetails());
     }
   }
   return routeDetails;
 }
 
+std::optional<RibRouteTables::RouteTableSnapshot> RibRouteTables::getSnapshot(
+    RouterID vrf) const {
+  auto lockedRouteTables = synchronizedRouteTables_.rlock();
+  auto it = lockedRouteTables->find(vrf);
+  if (it == lockedRouteTables->end()) {
+    return std::nullopt;
+  }
+  return it->second.snapshot();
+}
+
 template std::shared_ptr<Route<folly::IPAddressV4>>
 RibRouteTables::longestMatch(const folly::IPAddressV4& address, RouterID vrf)
     const;
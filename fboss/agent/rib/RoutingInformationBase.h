@@ -16,20 +16,32 @@
 #include "fboss/agent/types.h"
 
 #include <folly/Synchronized.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
+#include <gflags/gflags.h>
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <vector>
 
+DECLARE_int32(rib_resolution_threads);
+
 namespace facebook::fboss {
 class SwitchState;
 class ForwardingInformationBaseMap;
 
+/*
+ * ribDelta, when non null, holds the only prefixes that changed in the RIB
+ * since the previous FIB update for this VRF. Callbacks that keep FIB in
+ * sync with RIB across updates can use it to only update those prefixes.
+ * Otherwise the FIB needs to be synced against the whole RIB.
+ */
 using FibUpdateFunction = std::function<std::shared_ptr<SwitchState>(
     RouterID vrf,
     const IPv4NetworkToRouteMap& v4NetworkToRoute,
     const IPv6NetworkToRouteMap& v6NetworkToRoute,
+    const RibRouteDelta* ribDelta,
     void* cookie)>;
 
 /*
@@ -40,6 +52,8 @@ using FibUpdateFunction = std::function<std::shared_ptr<SwitchState>(
  */
 class RibRouteTables {
  public:
+  RibRouteTables();
+
   void update(
       RouterID routerID,
       ClientID clientID,
@@ -104,41 +118,87 @@ class RibRouteTables {
  private:
   template <typename Filter>
   folly::dynamic toFollyDynamicImpl(const Filter& filter) const;
+
+  /*
+   * A VRF's routes as of some point in time. Routes in the RIB are cloned
+   * on write, so a snapshot stays consistent while the RIB goes on being
+   * updated, and can be read without holding the RIB lock.
+   */
+  struct RouteTableSnapshot {
+    std::shared_ptr<const IPv4NetworkToRouteMap> v4NetworkToRoute;
+    std::shared_ptr<const IPv6NetworkToRouteMap> v6NetworkToRoute;
+  };
+
   struct RouteTable {
-    IPv4NetworkToRouteMap v4NetworkToRoute;
-    IPv6NetworkToRouteMap v6NetworkToRoute;
+    /*
+     * Shared with any snapshots of this table, so that taking a snapshot
+     * is O(1). Changes must go through writableV4()/writableV6(), which
+     * first copy a map that a snapshot still holds.
+     */
+    std::shared_ptr<IPv4NetworkToRouteMap> v4NetworkToRoute{
+        std::make_shared<IPv4NetworkToRouteMap>()};
+    std::shared_ptr<IPv6NetworkToRouteMap> v6NetworkToRoute{
+        std::make_shared<IPv6NetworkToRouteMap>()};
+    /*
+     * Reverse next hop dependencies of the routes above, used for
+     * incremental resolution. Derived state, so not part of equality.
+     */
+    NextHopDependencyIndex nhopDependencies;
 
     bool operator==(const RouteTable& other) const {
-      return v4NetworkToRoute == other.v4NetworkToRoute &&
-          v6NetworkToRoute == other.v6NetworkToRoute;
+      return *v4NetworkToRoute == *other.v4NetworkToRoute &&
+          *v6NetworkToRoute == *other.v6NetworkToRoute;
     }
     bool operator!=(const RouteTable& other) const {
       return !(*this == other);
     }
+    RouteTableSnapshot snapshot() const {
+      return {v4NetworkToRoute, v6NetworkToRoute};
+    }
+    IPv4NetworkToRouteMap* writableV4() {
+      return unshare(&v4NetworkToRoute);
+    }
+    IPv6NetworkToRouteMap* writableV6() {
+      return unshare(&v6NetworkToRoute);
+    }
     std::shared_ptr<Route<folly::IPAddressV4>> longestMatch(
         const folly::IPAddressV4& addr) const {
-      auto it = v4NetworkToRoute.longestMatch(addr, addr.bitCount());
-      return it == v4NetworkToRoute.end() ? nullptr : it->value();
+      auto it = v4NetworkToRoute->longestMatch(addr, addr.bitCount());
+      return it == v4NetworkToRoute->end() ? nullptr : it->value();
     }
     std::shared_ptr<Route<folly::IPAddressV6>> longestMatch(
         const folly::IPAddressV6& addr) const {
-      auto it = v6NetworkToRoute.longestMatch(addr, addr.bitCount());
-      return it == v6NetworkToRoute.end() ? nullptr : it->value();
+      auto it = v6NetworkToRoute->longestMatch(addr, addr.bitCount());
+      return it == v6NetworkToRoute->end() ? nullptr : it->value();
+    }
+
+   private:
+    // Called with the RIB write locked, so no snapshot can be taken
+    // meanwhile. Only the radix tree is copied, routes are shared.
+    template <typename NetworkToRouteMapT>
+    static NetworkToRouteMapT* unshare(
+        std::shared_ptr<NetworkToRouteMapT>* map) {
+      if (map->use_count() > 1) {
+        *map = std::make_shared<NetworkToRouteMapT>((*map)->clone());
+      }
+      return map->get();
     }
   };
 
+  // Snapshot of vrf's routes, nullopt if vrf is not configured
+  std::optional<RouteTableSnapshot> getSnapshot(RouterID vrf) const;
+
   void updateFib(
       RouterID vrf,
       const FibUpdateFunction& fibUpdateCallback,
-      void* cookie);
+      void* cookie,
+      const std::optional<RibRouteDelta>& ribDelta = std::nullopt);
   template <typename RibUpdateFn>
   void updateRib(RouterID vrf, const RibUpdateFn& updateRib);
   /*
-   * Currently, route updates to separate VRFs are made to be sequential. In the
-   * event FBOSS has to operate in a routing architecture with numerous VRFs,
-   * we can avoid a slow down by a factor of number of VRFs by parallelizing
-   * route updates across VRFs. This can be accomplished simply by associating
-   * the mutex implicit in folly::Synchronized with an individual RouteTable.
+   * Route updates come in one VRF at a time, and are applied sequentially.
+   * Config is applied to all VRFs at once, with the VRFs resolved
+   * concurrently on resolutionExecutor_.
    */
   using RouterIDToRouteTable = boost::container::flat_map<RouterID, RouteTable>;
   using SynchronizedRouteTables = folly::Synchronized<RouterIDToRouteTable>;
@@ -149,6 +209,8 @@ class RibRouteTables {
           configRouterIDToInterfaceRoutes) const;
 
   SynchronizedRouteTables synchronizedRouteTables_;
+  // Null unless FLAGS_rib_resolution_threads is above 1
+  std::unique_ptr<folly::CPUThreadPoolExecutor> resolutionExecutor_;
 };
 
 class RoutingInformationBase {
@@ -14,6 +14,7 @@
 #include "fboss/agent/if/gen-cpp2/ctrl_types.h"
 #include "fboss/agent/rib/ForwardingInformationBaseUpdater.h"
 #include "fboss/agent/rib/NetworkToRouteMap.h"
+#include "fboss/agent/rib/RouteUpdater.h"
 
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/state/ForwardingInformationBase.h"
@@ -100,6 +101,74 @@ TEST(ForwardingInformationBaseUpdater, ModifyUnpublishedSwitchState) {
                    ->isPublished());
 }
 
+TEST(ForwardingInformationBaseUpdater, ApplyRibDelta) {
+  auto vrf = RouterID(0);
+  IPv4NetworkToRouteMap v4Rib;
+  IPv6NetworkToRouteMap v6Rib;
+  NextHopDependencyIndex nhopDependencies;
+  auto update = [&](ClientID client,
+                    const std::vector<RibRouteUpdater::RouteEntry>& toAdd,
+                    const std::vector<folly::CIDRNetwork>& toDel) {
+    return RibRouteUpdater(&v4Rib, &v6Rib, &nhopDependencies)
+        .update(client, toAdd, toDel, false);
+  };
+  auto nhops = [](const std::string& ip) {
+    return RouteNextHopEntry(
+        UnresolvedNextHop(folly::IPAddress(ip), ECMP_WEIGHT),
+        kDefaultAdminDistance);
+  };
+
+  // First update does a full resolution, so there is no delta
+  EXPECT_FALSE(update(
+      ClientID::INTERFACE_ROUTE,
+      {{{folly::IPAddress("1.1.1.0"), 24},
+        RouteNextHopEntry(
+            ResolvedNextHop(
+                folly::IPAddress("1.1.1.1"),
+                InterfaceID(1),
+                UCMP_DEFAULT_WEIGHT),
+            AdminDistance::DIRECTLY_CONNECTED)}},
+      {}));
+  auto state = std::make_shared<SwitchState>();
+  state = ForwardingInformationBaseUpdater(vrf, v4Rib, v6Rib)(state);
+  state->publish();
+
+  auto delta = update(
+      ClientID::BGPD,
+      {{{folly::IPAddress("10.0.0.0"), 8}, nhops("1.1.1.10")},
+       {{folly::IPAddress("20.0.0.0"), 8}, nhops("10.0.0.1")},
+       {{folly::IPAddress("2401::"), 64}, nhops("1.1.1.11")}},
+      {});
+  ASSERT_TRUE(delta);
+  EXPECT_EQ(2, delta->v4Prefixes.size());
+  EXPECT_EQ(1, delta->v6Prefixes.size());
+  auto deltaState =
+      ForwardingInformationBaseUpdater(vrf, v4Rib, v6Rib, &(*delta))(state);
+  auto fullState = ForwardingInformationBaseUpdater(vrf, v4Rib, v6Rib)(state);
+  deltaState->publish();
+
+  // Removing the route 20/8 resolves through pulls it out of FIB as well
+  delta = update(ClientID::BGPD, {}, {{folly::IPAddress("10.0.0.0"), 8}});
+  ASSERT_TRUE(delta);
+  EXPECT_EQ(2, delta->v4Prefixes.size());
+  EXPECT_TRUE(delta->v6Prefixes.empty());
+  deltaState = ForwardingInformationBaseUpdater(vrf, v4Rib, v6Rib, &(*delta))(
+      deltaState);
+  fullState = ForwardingInformationBaseUpdater(vrf, v4Rib, v6Rib)(state);
+
+  auto deltaFibs = deltaState->getFibs()->getFibContainer(vrf);
+  auto fullFibs = fullState->getFibs()->getFibContainer(vrf);
+  EXPECT_EQ(1, deltaFibs->getFibV4()->size());
+  EXPECT_EQ(fullFibs->getFibV4()->size(), deltaFibs->getFibV4()->size());
+  EXPECT_EQ(fullFibs->getFibV6()->size(), deltaFibs->getFibV6()->size());
+  for (const auto& route : *fullFibs->getFibV4()) {
+    EXPECT_EQ(route, deltaFibs->getFibV4()->exactMatch(route->prefix()));
+  }
+  for (const auto& route : *fullFibs->getFibV6()) {
+    EXPECT_EQ(route, deltaFibs->getFibV6()->exactMatch(route->prefix()));
+  }
+}
+
 namespace {
 template <typename AddressT>
 std::shared_ptr<facebook::fboss::Route<AddressT>> getRoute(
@@ -15,8 +15,10 @@
 
 #include "fboss/agent/rib/RouteUpdater.h"
 
+#include <folly/Format.h>
 #include <folly/IPAddress.h>
 #include <folly/dynamic.h>
+#include <folly/executors/CPUThreadPoolExecutor.h>
 #include <folly/logging/xlog.h>
 
 #include <gtest/gtest.h>
@@ -146,4 +148,135 @@ TEST(Route, serializeRouteTable) {
   EXPECT_ROUTES_MATCH(origV6Routes, &newV6Routes);
 }
 
+TEST(Route, incrementalResolutionMatchesFullResolution) {
+  // Routes resolved incrementally via a dependency index
+  IPv4NetworkToRouteMap v4Routes;
+  IPv6NetworkToRouteMap v6Routes;
+  NextHopDependencyIndex nhopDependencies;
+  // Same routes, fully resolved on every update
+  IPv4NetworkToRouteMap v4RoutesFull;
+  IPv6NetworkToRouteMap v6RoutesFull;
+
+  auto update = [&](ClientID client,
+                    const std::vector<RibRouteUpdater::RouteEntry>& toAdd,
+                    const std::vector<folly::CIDRNetwork>& toDel) {
+    RibRouteUpdater(&v4Routes, &v6Routes, &nhopDependencies)
+        .update(client, toAdd, toDel, false);
+    RibRouteUpdater(&v4RoutesFull, &v6RoutesFull)
+        .update(client, toAdd, toDel, false);
+    EXPECT_TRUE(nhopDependencies.isValid());
+    EXPECT_ROUTES_MATCH(&v4RoutesFull, &v4Routes);
+    EXPECT_ROUTES_MATCH(&v6RoutesFull, &v6Routes);
+  };
+  auto interfaceRoute = [](const std::string& network,
+                           uint8_t mask,
+                           const std::string& intfAddr,
+                           InterfaceID intf) {
+    return RibRouteUpdater::RouteEntry{
+        {IPAddress(network), mask},
+        RouteNextHopEntry(
+            ResolvedNextHop(IPAddress(intfAddr), intf, UCMP_DEFAULT_WEIGHT),
+            AdminDistance::DIRECTLY_CONNECTED)};
+  };
+
+  update(
+      ClientID::INTERFACE_ROUTE,
+      {interfaceRoute("1.1.1.0", 24, "1.1.1.1", InterfaceID(1)),
+       interfaceRoute("2.2.2.0", 24, "2.2.2.1", InterfaceID(2)),
+       interfaceRoute("1001::", 64, "1001::1", InterfaceID(1))},
+      {});
+  // Recursive chain: 30/8 -> 10.1.1/24 -> 1.1.1/24, v6 via v4 next hop
+  update(
+      kClientA,
+      {{{IPAddress("10.1.1.0"), 24},
+        RouteNextHopEntry(makeNextHops({"1.1.1.10"}), kDistance)},
+       {{IPAddress("30.0.0.0"), 8},
+        RouteNextHopEntry(makeNextHops({"10.1.1.5"}), kDistance)},
+       {{IPAddress("2001::"), 48},
+        RouteNextHopEntry(makeNextHops({"10.1.1.6", "1001::10"}), kDistance)}},
+      {});
+  EXPECT_EQ(3, nhopDependencies.numDependentPrefixes());
+  EXPECT_TRUE(
+      v4Routes.exactMatch(IPAddressV4("30.0.0.0"), 8)->value()->isResolved());
+
+  // A more specific route for a next hop re-resolves the whole chain
+  update(
+      kClientB,
+      {{{IPAddress("10.1.1.4"), 30},
+        RouteNextHopEntry(makeNextHops({"2.2.2.10"}), kDistance)}},
+      {});
+  // Removing the connected route the chain resolves through
+  update(ClientID::INTERFACE_ROUTE, {}, {{IPAddress("2.2.2.0"), 24}});
+  EXPECT_FALSE(
+      v4Routes.exactMatch(IPAddressV4("30.0.0.0"), 8)->value()->isResolved());
+  // Default route resolves everything again
+  update(
+      kClientB,
+      {{{IPAddress("0.0.0.0"), 0},
+        RouteNextHopEntry(makeNextHops({"1.1.1.20"}), kDistance)}},
+      {});
+  EXPECT_TRUE(
+      v4Routes.exactMatch(IPAddressV4("30.0.0.0"), 8)->value()->isResolved());
+  update(kClientB, {}, {{IPAddress("10.1.1.4"), 30}});
+  EXPECT_EQ(4, nhopDependencies.numDependentPrefixes());
+}
+
+TEST(Route, concurrentResolutionMatchesSequential) {
+  folly::CPUThreadPoolExecutor executor(1);
+  // Routes resolved with v4 and v6 routes resolved concurrently
+  IPv4NetworkToRouteMap v4Routes;
+  IPv6NetworkToRouteMap v6Routes;
+  // Same routes, resolved on the calling thread alone
+  IPv4NetworkToRouteMap v4RoutesSeq;
+  IPv6NetworkToRouteMap v6RoutesSeq;
+
+  auto update = [&](const std::vector<RibRouteUpdater::RouteEntry>& toAdd) {
+    std::map<ClientID, std::vector<RibRouteUpdater::RouteEntry>> clientRoutes{
+        {ClientID::INTERFACE_ROUTE,
+         {{{IPAddress("1.1.1.0"), 24},
+           RouteNextHopEntry(
+               ResolvedNextHop(
+                   IPAddress("1.1.1.1"), InterfaceID(1), UCMP_DEFAULT_WEIGHT),
+               AdminDistance::DIRECTLY_CONNECTED)},
+          {{IPAddress("1001::"), 64},
+           RouteNextHopEntry(
+               ResolvedNextHop(
+                   IPAddress("1001::1"), InterfaceID(1), UCMP_DEFAULT_WEIGHT),
+               AdminDistance::DIRECTLY_CONNECTED)}}},
+        {kClientA, toAdd}};
+    RibRouteUpdater(&v4Routes, &v6Routes, nullptr, &executor)
+        .update(clientRoutes, {}, {});
+    RibRouteUpdater(&v4RoutesSeq, &v6RoutesSeq).update(clientRoutes, {}, {});
+    EXPECT_ROUTES_MATCH(&v4RoutesSeq, &v4Routes);
+    EXPECT_ROUTES_MATCH(&v6RoutesSeq, &v6Routes);
+  };
+
+  // Enough routes of each family for them to be resolved concurrently
+  std::vector<RibRouteUpdater::RouteEntry> routes;
+  for (auto i = 0; i < 2048; ++i) {
+    auto nhop = 2 + i % 200;
+    routes.push_back(
+        {{IPAddress(folly::sformat("20.{}.{}.0", i / 256, i % 256)), 24},
+         RouteNextHopEntry(
+             makeNextHops({folly::sformat("1.1.1.{}", nhop)}), kDistance)});
+    routes.push_back(
+        {{IPAddress(folly::sformat("2001:db8:{:x}::", i)), 64},
+         RouteNextHopEntry(
+             makeNextHops({folly::sformat("1001::{:x}", nhop)}), kDistance)});
+  }
+  update(routes);
+  EXPECT_TRUE(
+      v6Routes.exactMatch(IPAddressV6("2001:db8:7ff::"), 64)
+          ->value()
+          ->isResolved());
+
+  // A v6 route with a v4 next hop makes resolution sequential again
+  routes.push_back(
+      {{IPAddress("2002::"), 64},
+       RouteNextHopEntry(makeNextHops({"20.0.1.1"}), kDistance)});
+  update(routes);
+  EXPECT_TRUE(
+      v6Routes.exactMatch(IPAddressV6("2002::"), 64)->value()->isResolved());
+}
+
 } // namespace facebook::fboss
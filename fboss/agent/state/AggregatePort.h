@@ -306,7 +306,7 @@ class AggregatePort : public NodeBaseT<AggregatePort, AggregatePortFields> {
   AggregatePort* modify(std::shared_ptr<SwitchState>* state);
 
   static bool isIngressValid(
-      const std::shared_ptr<SwitchState>& state,
+      const SwitchState& state,
       const std::unique_ptr<RxPacket>& packet);
 
   bool isUp() const;
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "fboss/agent/state/NodeMap.h"
+#include "fboss/agent/state/PersistentNodeContainer.h"
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteTypes.h"
 
@@ -23,7 +24,9 @@ using ForwardingInformationBaseTraits = NodeMapTraits<
     RoutePrefix<AddressT>,
     Route<AddressT>,
     NodeMapNoExtraFields,
-    std::map<RoutePrefix<AddressT>, std::shared_ptr<Route<AddressT>>>>;
+    PersistentNodeContainer<
+        RoutePrefix<AddressT>,
+        std::shared_ptr<Route<AddressT>>>>;
 
 template <typename AddressT>
 class ForwardingInformationBase
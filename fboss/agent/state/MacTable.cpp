@@ -61,7 +61,7 @@ void MacTable::updateEntry(
   if (type) {
     entry->setType(type.value());
   }
-  it->second = entry;
+  nodes.insert_or_assign(it, mac, entry);
 }
 
 FBOSS_INSTANTIATE_NODE_MAP(MacTable, MacTableTraits);
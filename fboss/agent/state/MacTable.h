@@ -12,6 +12,7 @@
 #include "fboss/agent/state/MacEntry.h"
 #include "fboss/agent/state/NodeMap.h"
 #include "fboss/agent/state/NodeMapDelta.h"
+#include "fboss/agent/state/PersistentNodeContainer.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/types.h"
 
@@ -19,7 +20,11 @@
 
 namespace facebook::fboss {
 
-using MacTableTraits = NodeMapTraits<folly::MacAddress, MacEntry>;
+using MacTableTraits = NodeMapTraits<
+    folly::MacAddress,
+    MacEntry,
+    NodeMapNoExtraFields,
+    PersistentNodeContainer<folly::MacAddress, std::shared_ptr<MacEntry>>>;
 
 class MacTable : public NodeMapT<MacTable, MacTableTraits> {
  public:
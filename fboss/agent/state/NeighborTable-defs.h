@@ -96,7 +96,7 @@ void NeighborTable<IPADDR, ENTRY, SUBCLASS>::updateEntry(
   entry->setIntfID(intfID);
   entry->setState(NeighborState::REACHABLE);
   entry->setClassID(classID);
-  it->second = entry;
+  nodes.insert_or_assign(it, ip, entry);
 }
 
 template <typename IPADDR, typename ENTRY, typename SUBCLASS>
@@ -108,7 +108,7 @@ void NeighborTable<IPADDR, ENTRY, SUBCLASS>::updateEntry(
   if (it == nodes.end()) {
     throw FbossError("Neighbor entry for ", ip, " does not exist");
   }
-  it->second = newEntry;
+  nodes.insert_or_assign(it, ip, newEntry);
   return;
 }
 
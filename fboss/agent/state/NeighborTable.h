@@ -14,6 +14,7 @@
 #include <folly/json.h>
 #include "fboss/agent/state/NeighborEntry.h"
 #include "fboss/agent/state/NodeMap.h"
+#include "fboss/agent/state/PersistentNodeContainer.h"
 #include "fboss/agent/state/PortDescriptor.h"
 
 namespace {
@@ -31,7 +32,7 @@ struct NeighborTableTraits {
   using Node = ENTRY;
   using ExtraFields = NodeMapNoExtraFields;
   using NodeContainer =
-      boost::container::flat_map<KeyType, std::shared_ptr<Node>>;
+      PersistentNodeContainer<KeyType, std::shared_ptr<Node>>;
 
   static KeyType getKey(const std::shared_ptr<Node>& entry) {
     return entry->getIP();
@@ -64,7 +64,9 @@ void NodeMapT<MapTypeT, TraitsT>::updateNode(
   if (it == nodes.end()) {
     throw FbossError("node ID ", TraitsT::getKey(node), " does not exist");
   }
-  it->second = node;
+  // Not it->second = node: containers like PersistentNodeContainer only
+  // hand out read-only iterators
+  nodes.insert_or_assign(it, TraitsT::getKey(node), node);
 }
 
 template <typename MapTypeT, typename TraitsT>
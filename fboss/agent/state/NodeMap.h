@@ -13,6 +13,7 @@
 
 #include "fboss/agent/state/NodeBase.h"
 #include "fboss/agent/state/NodeMapIterator.h"
+#include "fboss/agent/state/PersistentNodeContainer.h"
 
 namespace facebook::fboss {
 
@@ -33,8 +34,13 @@ struct NodeMapFields {
 
   template <typename Fn>
   void forEachChild(Fn fn) {
-    for (const auto& nodePtr : nodes) {
-      fn(nodePtr.second.get());
+    if constexpr (IsPersistentNodeContainer<NodeContainer>::value) {
+      // Only visits the nodes changed since the container was published
+      nodes.publish([&fn](const auto& nodePtr) { fn(nodePtr.get()); });
+    } else {
+      for (const auto& nodePtr : nodes) {
+        fn(nodePtr.second.get());
+      }
     }
     extra.forEachChild(fn);
   }
@@ -59,7 +65,9 @@ struct NodeMapNoExtraFields {
 /* Traits provide flexibility on customizing NodeMap. While there
  * is a fair amount of flexibility in most fields, for NodeContainer
  * we are restricted to sorted map containers - boost::flat_map,
- * std::map etc. The sorted property is leveraged in delta calculation
+ * std::map etc. The sorted property is leveraged in delta calculation.
+ * Large maps that are cloned often should use PersistentNodeContainer,
+ * which makes clone() O(1) and updates O(log N).
  */
 template <
     typename KeyT,
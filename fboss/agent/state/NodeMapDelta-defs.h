@@ -11,6 +11,7 @@
 
 #include <glog/logging.h>
 #include "fboss/agent/state/NodeMapDelta.h"
+#include "fboss/agent/state/PersistentNodeContainer.h"
 
 namespace facebook::fboss {
 
@@ -30,11 +31,7 @@ NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::Iterator(
       newMap_(newMap),
       value_(nullNode_, nullNode_) {
   // Advance to the first difference
-  while (oldIt_ != oldMap_->end() && newIt_ != newMap_->end() &&
-         *oldIt_ == *newIt_) {
-    ++oldIt_;
-    ++newIt_;
-  }
+  skipUnchanged();
   updateValue();
 }
 
@@ -101,12 +98,24 @@ void NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::advance() {
   }
 
   // Advance past any unchanged nodes.
-  while (oldIt_ != oldMap_->end() && newIt_ != newMap_->end() &&
-         *oldIt_ == *newIt_) {
-    ++oldIt_;
-    ++newIt_;
-  }
+  skipUnchanged();
   updateValue();
 }
 
+template <typename MAP, typename VALUE, typename MAPPOINTERTRAITS>
+void NodeMapDelta<MAP, VALUE, MAPPOINTERTRAITS>::Iterator::skipUnchanged() {
+  using NodeContainer = typename MapType::NodeContainer;
+  if constexpr (IsPersistentNodeContainer<NodeContainer>::value) {
+    // Jumps over subtrees the two maps share, rather than comparing the
+    // nodes in them one by one
+    NodeContainer::skipUnchanged(oldIt_.base(), newIt_.base());
+  } else {
+    while (oldIt_ != oldMap_->end() && newIt_ != newMap_->end() &&
+           *oldIt_ == *newIt_) {
+      ++oldIt_;
+      ++newIt_;
+    }
+  }
+}
+
 } // namespace facebook::fboss
@@ -52,6 +52,11 @@ class NodeMapIterator
     return it_ != other.it_;
   }
 
+  // The underlying NodeContainer iterator
+  typename NodeContainer::const_iterator& base() {
+    return it_;
+  }
+
  private:
   typename NodeContainer::const_iterator it_;
 };
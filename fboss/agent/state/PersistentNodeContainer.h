@@ -0,0 +1,582 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <boost/container/small_vector.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * PersistentNodeContainer is a sorted map with structural sharing, for use
+ * as the NodeContainer of large NodeMaps (FIB, MAC and neighbor tables).
+ *
+ * Modifying a published NodeMap clones it, and cloning copies the node
+ * container. For flat_map and std::map that copy is O(N), even when only a
+ * single entry is about to change. This container is an AVL tree whose tree
+ * nodes are never modified once shared: copying it copies just the root
+ * pointer, and an update copies only the O(log N) tree nodes on the path to
+ * the changed entry. Tree nodes owned by a single container are updated in
+ * place, so building up an unpublished map does not pay for path copying.
+ *
+ * Because a modified copy shares every untouched subtree with the original,
+ * skipUnchanged() lets NodeMapDelta step over those subtrees without
+ * visiting their entries, and publish() only visits the entries changed
+ * since the last publish.
+ *
+ * Iterators are read-only. Replace an entry with insert_or_assign() rather
+ * than by assigning through an iterator. Any modification invalidates all
+ * iterators into the container.
+ */
+template <typename KeyT, typename ValueT, typename CompareT = std::less<KeyT>>
+class PersistentNodeContainer {
+  struct TreeNode;
+  using TreeNodePtr = std::shared_ptr<TreeNode>;
+
+ public:
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = std::pair<const KeyT, ValueT>;
+  using size_type = size_t;
+  using key_compare = CompareT;
+
+  class const_iterator {
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = PersistentNodeContainer::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = const value_type&;
+
+    const_iterator() {}
+
+    reference operator*() const {
+      return path_.back()->value;
+    }
+    pointer operator->() const {
+      return &path_.back()->value;
+    }
+
+    const_iterator& operator++() {
+      increment();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp(*this);
+      increment();
+      return tmp;
+    }
+    const_iterator& operator--() {
+      decrement();
+      return *this;
+    }
+    const_iterator operator--(int) {
+      const_iterator tmp(*this);
+      decrement();
+      return tmp;
+    }
+
+    bool operator==(const const_iterator& other) const {
+      return current() == other.current();
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !operator==(other);
+    }
+
+   private:
+    friend class PersistentNodeContainer;
+
+    // AVL trees with up to ~2M entries are at most 30 levels deep
+    static constexpr size_t kInlineDepth = 32;
+
+    explicit const_iterator(const TreeNode* root) : root_(root) {}
+
+    const TreeNode* current() const {
+      return path_.empty() ? nullptr : path_.back();
+    }
+    void descendLeftmost(const TreeNode* node) {
+      for (; node; node = node->left.get()) {
+        path_.push_back(node);
+      }
+    }
+    void descendRightmost(const TreeNode* node) {
+      for (; node; node = node->right.get()) {
+        path_.push_back(node);
+      }
+    }
+    void increment() {
+      const TreeNode* node = path_.back();
+      if (node->right) {
+        descendLeftmost(node->right.get());
+      } else {
+        skipRightSubtree();
+      }
+    }
+    void decrement() {
+      if (path_.empty()) {
+        // --end() is the last entry
+        descendRightmost(root_);
+        return;
+      }
+      const TreeNode* node = path_.back();
+      if (node->left) {
+        descendRightmost(node->left.get());
+        return;
+      }
+      path_.pop_back();
+      while (!path_.empty() && path_.back()->left.get() == node) {
+        node = path_.back();
+        path_.pop_back();
+      }
+    }
+    /*
+     * Move to the first entry after the current node's right subtree, i.e.
+     * the nearest ancestor we reached through its left child, or end().
+     */
+    void skipRightSubtree() {
+      const TreeNode* node = path_.back();
+      path_.pop_back();
+      while (!path_.empty() && path_.back()->right.get() == node) {
+        node = path_.back();
+        path_.pop_back();
+      }
+    }
+
+    const TreeNode* root_{nullptr};
+    // Root to current node; empty at end()
+    boost::container::small_vector<const TreeNode*, kInlineDepth> path_;
+  };
+  using iterator = const_iterator;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using reverse_iterator = const_reverse_iterator;
+
+  PersistentNodeContainer() {}
+  /*
+   * Build from a range of (key, value) pairs. A range sorted by key is
+   * built into a balanced tree in O(N); otherwise entries are inserted one
+   * at a time. As with std::map, the first of several equal keys wins.
+   */
+  template <typename InputIt>
+  PersistentNodeContainer(InputIt first, InputIt last) {
+    std::vector<TreeNodePtr> sorted;
+    for (; first != last; ++first) {
+      if (!sorted.empty() && !comp_(sorted.back()->value.first, first->first)) {
+        break;
+      }
+      sorted.push_back(std::make_shared<TreeNode>(first->first, first->second));
+    }
+    root_ = buildBalanced(sorted, 0, sorted.size());
+    size_ = sorted.size();
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  const_iterator begin() const {
+    const_iterator it(root_.get());
+    it.descendLeftmost(root_.get());
+    return it;
+  }
+  const_iterator end() const {
+    return const_iterator(root_.get());
+  }
+  const_iterator cbegin() const {
+    return begin();
+  }
+  const_iterator cend() const {
+    return end();
+  }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  size_type size() const {
+    return size_;
+  }
+  bool empty() const {
+    return size_ == 0;
+  }
+  void clear() {
+    root_.reset();
+    size_ = 0;
+  }
+
+  const_iterator find(const KeyT& key) const {
+    const_iterator it(root_.get());
+    const TreeNode* node = root_.get();
+    while (node) {
+      it.path_.push_back(node);
+      if (comp_(key, node->value.first)) {
+        node = node->left.get();
+      } else if (comp_(node->value.first, key)) {
+        node = node->right.get();
+      } else {
+        return it;
+      }
+    }
+    return end();
+  }
+  size_type count(const KeyT& key) const {
+    return contains(key) ? 1 : 0;
+  }
+  const_iterator lower_bound(const KeyT& key) const {
+    return bound(key, [this](const KeyT& k, const KeyT& nodeKey) {
+      return !comp_(nodeKey, k);
+    });
+  }
+  const_iterator upper_bound(const KeyT& key) const {
+    return bound(key, [this](const KeyT& k, const KeyT& nodeKey) {
+      return comp_(k, nodeKey);
+    });
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    // Check first so a duplicate does not copy a shared path
+    if (contains(value.first)) {
+      return std::make_pair(find(value.first), false);
+    }
+    insertImpl(root_, value.first, value.second, false);
+    ++size_;
+    return std::make_pair(find(value.first), true);
+  }
+  template <typename... Args>
+  iterator emplace_hint(const_iterator /*hint*/, Args&&... args) {
+    return insert(value_type(std::forward<Args>(args)...)).first;
+  }
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const KeyT& key, M&& mapped) {
+    bool inserted = insertImpl(root_, key, std::forward<M>(mapped), true);
+    if (inserted) {
+      ++size_;
+    }
+    return std::make_pair(find(key), inserted);
+  }
+  template <typename M>
+  iterator
+  insert_or_assign(const_iterator /*hint*/, const KeyT& key, M&& mapped) {
+    return insert_or_assign(key, std::forward<M>(mapped)).first;
+  }
+
+  size_type erase(const KeyT& key) {
+    if (!contains(key)) {
+      return 0;
+    }
+    eraseImpl(root_, key);
+    --size_;
+    return 1;
+  }
+  iterator erase(const_iterator pos) {
+    KeyT key = pos->first;
+    eraseImpl(root_, key);
+    --size_;
+    return upper_bound(key);
+  }
+
+  /*
+   * Invoke fn on the value of every entry added or replaced since the last
+   * publish(), then mark all entries as published. Tree nodes track this
+   * themselves: a published tree node only has published descendants, so
+   * the walk stops at the first one on each path. Like the rest of
+   * NodeMapT's publish(), this must not race with readers of the container.
+   */
+  template <typename Fn>
+  void publish(Fn fn) {
+    publishImpl(root_.get(), fn);
+  }
+
+  /*
+   * Advance a pair of iterators, one into each of two containers, past the
+   * entries they have in common: stop at the first position where the
+   * current entries' keys or values differ, or either iterator hits end().
+   * This is equivalent to incrementing both while *oldIt == *newIt, but
+   * subtrees shared by the two containers are skipped without visiting
+   * their entries. Diffing a container against a modified copy of itself
+   * then costs O(changes * log N) rather than O(N).
+   */
+  static void skipUnchanged(const_iterator& oldIt, const_iterator& newIt) {
+    while (!oldIt.path_.empty() && !newIt.path_.empty()) {
+      const TreeNode* oldNode = oldIt.path_.back();
+      const TreeNode* newNode = newIt.path_.back();
+      if (oldNode != newNode && !sameEntry(oldNode, newNode)) {
+        return;
+      }
+      // The right subtrees hold the next entries in both traversals
+      const TreeNode* oldRight = oldNode->right.get();
+      const TreeNode* newRight = newNode->right.get();
+      if (oldRight == newRight) {
+        oldIt.skipRightSubtree();
+        newIt.skipRightSubtree();
+      } else if (oldRight && newRight) {
+        descendUnshared(oldIt, oldRight, newIt, newRight);
+      } else {
+        oldIt.increment();
+        newIt.increment();
+      }
+    }
+  }
+
+ private:
+  struct TreeNode {
+    template <typename M>
+    TreeNode(const KeyT& key, M&& mapped)
+        : value(key, std::forward<M>(mapped)) {}
+    // Copies are made to be modified, so they start out unpublished
+    TreeNode(const TreeNode& other)
+        : value(other.value),
+          left(other.left),
+          right(other.right),
+          height(other.height) {}
+
+    value_type value;
+    TreeNodePtr left;
+    TreeNodePtr right;
+    int height{1};
+    bool published{false};
+  };
+
+  template <typename Fn>
+  static void publishImpl(TreeNode* node, Fn& fn) {
+    for (; node && !node->published; node = node->right.get()) {
+      node->published = true;
+      fn(node->value.second);
+      publishImpl(node->left.get(), fn);
+    }
+  }
+
+  static bool sameEntry(const TreeNode* oldNode, const TreeNode* newNode) {
+    CompareT comp;
+    return !comp(oldNode->value.first, newNode->value.first) &&
+        !comp(newNode->value.first, oldNode->value.first) &&
+        oldNode->value.second == newNode->value.second;
+  }
+
+  /*
+   * Walk down to the leftmost entries of two subtrees in lockstep. If at
+   * some level both remaining left subtrees are the same object, their
+   * entries are common to both traversals and we stop right after them.
+   */
+  static void descendUnshared(
+      const_iterator& oldIt,
+      const TreeNode* oldNode,
+      const_iterator& newIt,
+      const TreeNode* newNode) {
+    while (true) {
+      oldIt.path_.push_back(oldNode);
+      newIt.path_.push_back(newNode);
+      const TreeNode* oldLeft = oldNode->left.get();
+      const TreeNode* newLeft = newNode->left.get();
+      if (oldLeft == newLeft) {
+        return;
+      }
+      if (!oldLeft || !newLeft) {
+        oldIt.descendLeftmost(oldLeft);
+        newIt.descendLeftmost(newLeft);
+        return;
+      }
+      oldNode = oldLeft;
+      newNode = newLeft;
+    }
+  }
+
+  template <typename IsAtOrPastBound>
+  const_iterator bound(const KeyT& key, IsAtOrPastBound isAtOrPastBound)
+      const {
+    const_iterator it(root_.get());
+    size_t boundDepth = 0;
+    const TreeNode* node = root_.get();
+    while (node) {
+      it.path_.push_back(node);
+      if (isAtOrPastBound(key, node->value.first)) {
+        boundDepth = it.path_.size();
+        node = node->left.get();
+      } else {
+        node = node->right.get();
+      }
+    }
+    // The bound is the deepest node we went left from, if any
+    it.path_.resize(boundDepth);
+    return it;
+  }
+
+  static TreeNodePtr
+  buildBalanced(const std::vector<TreeNodePtr>& sorted, size_t lo, size_t hi) {
+    if (lo == hi) {
+      return nullptr;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    const auto& node = sorted[mid];
+    node->left = buildBalanced(sorted, lo, mid);
+    node->right = buildBalanced(sorted, mid + 1, hi);
+    updateHeight(*node);
+    return node;
+  }
+
+  static int height(const TreeNodePtr& node) {
+    return node ? node->height : 0;
+  }
+  static void updateHeight(TreeNode& node) {
+    node.height = 1 + std::max(height(node.left), height(node.right));
+  }
+
+  /*
+   * Make node safe to modify. A tree node referenced from anywhere else
+   * may be shared with another container, so it is copied first. Callers
+   * must make a parent writable before its children: the parent's copy
+   * holds a second reference to each child, forcing them to be copied too.
+   * Every modification goes through here top down, which is what keeps
+   * published tree nodes from having unpublished descendants.
+   */
+  static void makeWritable(TreeNodePtr& node) {
+    if (node.use_count() > 1) {
+      node = std::make_shared<TreeNode>(*node);
+    } else {
+      node->published = false;
+    }
+  }
+
+  // node must be writable
+  static void rotateLeft(TreeNodePtr& node) {
+    makeWritable(node->right);
+    TreeNodePtr pivot = std::move(node->right);
+    node->right = std::move(pivot->left);
+    updateHeight(*node);
+    pivot->left = std::move(node);
+    updateHeight(*pivot);
+    node = std::move(pivot);
+  }
+  static void rotateRight(TreeNodePtr& node) {
+    makeWritable(node->left);
+    TreeNodePtr pivot = std::move(node->left);
+    node->left = std::move(pivot->right);
+    updateHeight(*node);
+    pivot->right = std::move(node);
+    updateHeight(*pivot);
+    node = std::move(pivot);
+  }
+  static void rebalance(TreeNodePtr& node) {
+    updateHeight(*node);
+    int balance = height(node->left) - height(node->right);
+    if (balance > 1) {
+      if (height(node->left->left) < height(node->left->right)) {
+        makeWritable(node->left);
+        rotateLeft(node->left);
+      }
+      rotateRight(node);
+    } else if (balance < -1) {
+      if (height(node->right->right) < height(node->right->left)) {
+        makeWritable(node->right);
+        rotateRight(node->right);
+      }
+      rotateLeft(node);
+    }
+  }
+
+  /*
+   * Returns true if key was not present before. An existing entry is only
+   * replaced if assign is set; otherwise the tree is left untouched.
+   */
+  template <typename M>
+  bool
+  insertImpl(TreeNodePtr& node, const KeyT& key, M&& mapped, bool assign) {
+    if (!node) {
+      node = std::make_shared<TreeNode>(key, std::forward<M>(mapped));
+      return true;
+    }
+    bool goLeft = comp_(key, node->value.first);
+    if (!goLeft && !comp_(node->value.first, key)) {
+      if (assign) {
+        makeWritable(node);
+        node->value.second = std::forward<M>(mapped);
+      }
+      return false;
+    }
+    makeWritable(node);
+    TreeNodePtr& child = goLeft ? node->left : node->right;
+    bool inserted = insertImpl(child, key, std::forward<M>(mapped), assign);
+    if (inserted) {
+      rebalance(node);
+    }
+    return inserted;
+  }
+
+  bool contains(const KeyT& key) const {
+    const TreeNode* node = root_.get();
+    while (node) {
+      if (comp_(key, node->value.first)) {
+        node = node->left.get();
+      } else if (comp_(node->value.first, key)) {
+        node = node->right.get();
+      } else {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // key must be present
+  void eraseImpl(TreeNodePtr& node, const KeyT& key) {
+    makeWritable(node);
+    if (comp_(key, node->value.first)) {
+      eraseImpl(node->left, key);
+    } else if (comp_(node->value.first, key)) {
+      eraseImpl(node->right, key);
+    } else if (!node->left) {
+      node = std::move(node->right);
+      return;
+    } else if (!node->right) {
+      node = std::move(node->left);
+      return;
+    } else {
+      // Replace node with its in-order successor
+      TreeNodePtr successor = takeMin(node->right);
+      successor->left = std::move(node->left);
+      successor->right = std::move(node->right);
+      node = std::move(successor);
+    }
+    rebalance(node);
+  }
+
+  // Detach and return the (writable) leftmost tree node under node
+  static TreeNodePtr takeMin(TreeNodePtr& node) {
+    makeWritable(node);
+    if (!node->left) {
+      TreeNodePtr min = std::move(node);
+      node = std::move(min->right);
+      return min;
+    }
+    TreeNodePtr min = takeMin(node->left);
+    rebalance(node);
+    return min;
+  }
+
+  TreeNodePtr root_;
+  size_type size_{0};
+  CompareT comp_;
+};
+
+template <typename T>
+struct IsPersistentNodeContainer : std::false_type {};
+
+template <typename KeyT, typename ValueT, typename CompareT>
+struct IsPersistentNodeContainer<
+    PersistentNodeContainer<KeyT, ValueT, CompareT>> : std::true_type {};
+
+} // namespace facebook::fboss
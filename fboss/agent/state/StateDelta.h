@@ -39,6 +39,13 @@ class ControlPlane;
 /*
  * StateDelta contains code for examining the differences between two
  * SwitchStates.
+ *
+ * Differences are computed as the delta is iterated, and anything shared by
+ * the two states is skipped. The large NodeMaps (FIB, MAC and neighbor
+ * tables) use PersistentNodeContainer, whose copies share every unchanged
+ * subtree, so walking their deltas costs time proportional to the number
+ * of changed entries rather than to the table size. The same StateDelta
+ * can be handed to the HwSwitch and to every StateObserver.
  */
 class StateDelta {
  public:
@@ -65,6 +65,16 @@ class StateUpdate {
    * changes to the state.  (This may occur in cases where the update would
    * have caused changes when it was first scheduled, but no longer results in
    * changes by the time it is actually applied.)
+   *
+   * With --pipeline_state_updates, applyUpdate() may be called from the state
+   * prepare thread rather than the update thread, and may be called again
+   * with a different origState when the updates ahead of it did not get
+   * applied to HW as is. Only the result of the last call is used. The flag
+   * is therefore only safe to enable once every update function scheduled
+   * in the agent meets both conditions:
+   *  - it does not need to run on the update thread
+   *  - calling it again applies the same change, i.e. it does not consume
+   *    anything on its first call
    */
   virtual std::shared_ptr<SwitchState> applyUpdate(
       const std::shared_ptr<SwitchState>& origState) = 0;
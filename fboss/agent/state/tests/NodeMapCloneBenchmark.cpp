@@ -0,0 +1,201 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Measures the copy-on-write cycle that every state update goes through
+ * for the largest NodeMaps: clone a published map, replace one entry,
+ * publish the clone and walk the delta against the original. The tables
+ * now backed by PersistentNodeContainer are compared against the same
+ * NodeMap on the container they used before (flat_map for the MAC and NDP
+ * tables, std::map for the FIB).
+ */
+
+#include "fboss/agent/state/ForwardingInformationBase.h"
+#include "fboss/agent/state/MacTable.h"
+#include "fboss/agent/state/NdpTable.h"
+#include "fboss/agent/state/NodeBase-defs.h"
+#include "fboss/agent/state/NodeMap-defs.h"
+#include "fboss/agent/state/NodeMapDelta-defs.h"
+#include "fboss/agent/state/Route.h"
+
+#include <boost/container/flat_map.hpp>
+#include <folly/Benchmark.h>
+#include <folly/IPAddressV6.h>
+#include <folly/MacAddress.h>
+#include <folly/init/Init.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr size_t kMacTableSize = 64 * 1024;
+constexpr size_t kNdpTableSize = 16 * 1024;
+constexpr size_t kFibSize = 200 * 1000;
+
+folly::MacAddress nodeKey(const MacEntry& entry) {
+  return entry.getMac();
+}
+folly::IPAddressV6 nodeKey(const NdpEntry& entry) {
+  return entry.getIP();
+}
+RoutePrefixV6 nodeKey(const RouteV6& route) {
+  return route.prefix();
+}
+
+template <typename KeyT, typename NodeT, typename NodeContainerT>
+struct BaselineMapTraits
+    : NodeMapTraits<KeyT, NodeT, NodeMapNoExtraFields, NodeContainerT> {
+  static KeyT getKey(const std::shared_ptr<NodeT>& node) {
+    return nodeKey(*node);
+  }
+};
+
+// A NodeMap identical to the real table except for its NodeContainer
+template <typename KeyT, typename NodeT, typename NodeContainerT>
+class BaselineMap : public NodeMapT<
+                        BaselineMap<KeyT, NodeT, NodeContainerT>,
+                        BaselineMapTraits<KeyT, NodeT, NodeContainerT>> {
+ public:
+  using Base = NodeMapT<
+      BaselineMap<KeyT, NodeT, NodeContainerT>,
+      BaselineMapTraits<KeyT, NodeT, NodeContainerT>>;
+  BaselineMap() {}
+
+ private:
+  using Base::Base;
+  friend class CloneAllocator;
+};
+
+template <typename KeyT, typename NodeT>
+using FlatMapBaseline = BaselineMap<
+    KeyT,
+    NodeT,
+    boost::container::flat_map<KeyT, std::shared_ptr<NodeT>>>;
+template <typename KeyT, typename NodeT>
+using StdMapBaseline =
+    BaselineMap<KeyT, NodeT, std::map<KeyT, std::shared_ptr<NodeT>>>;
+
+folly::IPAddressV6 makeV6Address(uint32_t high, uint32_t low) {
+  folly::ByteArray16 bytes{};
+  bytes[0] = 0x24;
+  bytes[1] = 0x01;
+  for (int i = 0; i < 4; ++i) {
+    bytes[4 + i] = (high >> (24 - 8 * i)) & 0xff;
+    bytes[12 + i] = (low >> (24 - 8 * i)) & 0xff;
+  }
+  return folly::IPAddressV6(bytes);
+}
+
+const std::vector<std::shared_ptr<MacEntry>>& macEntries() {
+  static const auto entries = [] {
+    std::vector<std::shared_ptr<MacEntry>> entries;
+    for (uint64_t i = 0; i < kMacTableSize; ++i) {
+      entries.push_back(std::make_shared<MacEntry>(
+          folly::MacAddress::fromHBO(0x020000000000 + i),
+          PortDescriptor(PortID(1 + i % 64))));
+    }
+    return entries;
+  }();
+  return entries;
+}
+
+const std::vector<std::shared_ptr<NdpEntry>>& ndpEntries() {
+  static const auto entries = [] {
+    std::vector<std::shared_ptr<NdpEntry>> entries;
+    for (uint32_t i = 0; i < kNdpTableSize; ++i) {
+      entries.push_back(std::make_shared<NdpEntry>(
+          makeV6Address(0, i),
+          folly::MacAddress::fromHBO(0x020000000000 + i),
+          PortDescriptor(PortID(1 + i % 64)),
+          InterfaceID(1)));
+    }
+    return entries;
+  }();
+  return entries;
+}
+
+const std::vector<std::shared_ptr<RouteV6>>& fibRoutes() {
+  static const auto routes = [] {
+    std::vector<std::shared_ptr<RouteV6>> routes;
+    for (uint32_t i = 0; i < kFibSize; ++i) {
+      RoutePrefixV6 prefix{makeV6Address(i, 0), 64};
+      routes.push_back(std::make_shared<RouteV6>(
+          RouteFields<folly::IPAddressV6>(prefix)));
+    }
+    return routes;
+  }();
+  return routes;
+}
+
+template <typename MapT>
+void cloneUpdateAndDiff(
+    size_t iters,
+    const std::vector<std::shared_ptr<typename MapT::Node>>& nodes) {
+  folly::BenchmarkSuspender suspender;
+  auto map = std::make_shared<MapT>();
+  for (const auto& node : nodes) {
+    map->addNode(node);
+  }
+  map->publish();
+  suspender.dismiss();
+
+  size_t numChanged = 0;
+  for (size_t i = 0; i < iters; ++i) {
+    auto newMap = map->clone();
+    newMap->updateNode(nodes[(i * 7919) % nodes.size()]->clone());
+    newMap->publish();
+    for (const auto& delta : NodeMapDelta<MapT>(map.get(), newMap.get())) {
+      folly::doNotOptimizeAway(delta);
+      ++numChanged;
+    }
+    // Each update builds on the last, as consecutive SwitchStates do
+    map = std::move(newMap);
+  }
+  CHECK_EQ(iters, numChanged);
+}
+
+} // namespace
+
+BENCHMARK(MacTableFlatMap, iters) {
+  cloneUpdateAndDiff<FlatMapBaseline<folly::MacAddress, MacEntry>>(
+      iters, macEntries());
+}
+
+BENCHMARK_RELATIVE(MacTablePersistent, iters) {
+  cloneUpdateAndDiff<MacTable>(iters, macEntries());
+}
+
+BENCHMARK(NdpTableFlatMap, iters) {
+  cloneUpdateAndDiff<FlatMapBaseline<folly::IPAddressV6, NdpEntry>>(
+      iters, ndpEntries());
+}
+
+BENCHMARK_RELATIVE(NdpTablePersistent, iters) {
+  cloneUpdateAndDiff<NdpTable>(iters, ndpEntries());
+}
+
+BENCHMARK(FibStdMap, iters) {
+  cloneUpdateAndDiff<StdMapBaseline<RoutePrefixV6, RouteV6>>(
+      iters, fibRoutes());
+}
+
+BENCHMARK_RELATIVE(FibPersistent, iters) {
+  cloneUpdateAndDiff<ForwardingInformationBaseV6>(iters, fibRoutes());
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return EXIT_SUCCESS;
+}
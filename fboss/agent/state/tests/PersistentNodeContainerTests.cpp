@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/PersistentNodeContainer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Container =
+    facebook::fboss::PersistentNodeContainer<int, std::shared_ptr<int>>;
+using Reference = std::map<int, std::shared_ptr<int>>;
+
+void expectSame(const Container& container, const Reference& reference) {
+  ASSERT_EQ(reference.size(), container.size());
+  auto it = container.begin();
+  for (const auto& entry : reference) {
+    ASSERT_NE(container.end(), it);
+    EXPECT_EQ(entry.first, it->first);
+    EXPECT_EQ(entry.second, it->second);
+    ++it;
+  }
+  EXPECT_EQ(container.end(), it);
+
+  auto rit = container.rbegin();
+  for (auto refIt = reference.rbegin(); refIt != reference.rend(); ++refIt) {
+    ASSERT_NE(container.rend(), rit);
+    EXPECT_EQ(refIt->first, rit->first);
+    ++rit;
+  }
+  EXPECT_EQ(container.rend(), rit);
+}
+
+// Keys of the entries that differ between two containers
+std::vector<int> changedKeys(const Container& oldC, const Container& newC) {
+  std::vector<int> changed;
+  auto oldIt = oldC.begin();
+  auto newIt = newC.begin();
+  while (oldIt != oldC.end() || newIt != newC.end()) {
+    Container::skipUnchanged(oldIt, newIt);
+    if (oldIt == oldC.end() && newIt == newC.end()) {
+      break;
+    }
+    if (newIt == newC.end() ||
+        (oldIt != oldC.end() && oldIt->first < newIt->first)) {
+      changed.push_back((oldIt++)->first);
+    } else if (oldIt == oldC.end() || newIt->first < oldIt->first) {
+      changed.push_back((newIt++)->first);
+    } else {
+      changed.push_back(oldIt->first);
+      ++oldIt;
+      ++newIt;
+    }
+  }
+  return changed;
+}
+
+} // namespace
+
+TEST(PersistentNodeContainer, MatchesStdMap) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> keys(0, 2000);
+  Container container;
+  Reference reference;
+  for (int i = 0; i < 20000; ++i) {
+    int key = keys(gen);
+    switch (gen() % 4) {
+      case 0: {
+        auto value = std::make_shared<int>(i);
+        auto ret = container.insert(std::make_pair(key, value));
+        EXPECT_EQ(
+            reference.insert(std::make_pair(key, value)).second, ret.second);
+        EXPECT_EQ(key, ret.first->first);
+        break;
+      }
+      case 1: {
+        auto value = std::make_shared<int>(i);
+        container.insert_or_assign(key, value);
+        reference[key] = value;
+        break;
+      }
+      case 2:
+        EXPECT_EQ(reference.erase(key), container.erase(key));
+        break;
+      case 3: {
+        auto refIt = reference.lower_bound(key);
+        auto it = container.lower_bound(key);
+        if (refIt == reference.end()) {
+          EXPECT_EQ(container.end(), it);
+        } else {
+          ASSERT_NE(container.end(), it);
+          EXPECT_EQ(refIt->first, it->first);
+          auto next = container.erase(it);
+          refIt = reference.erase(refIt);
+          if (refIt == reference.end()) {
+            EXPECT_EQ(container.end(), next);
+          } else {
+            EXPECT_EQ(refIt->first, next->first);
+          }
+        }
+        break;
+      }
+    }
+  }
+  expectSame(container, reference);
+}
+
+TEST(PersistentNodeContainer, CopiesAreIndependent) {
+  Container original;
+  for (int i = 0; i < 1000; ++i) {
+    original.insert(std::make_pair(i, std::make_shared<int>(i)));
+  }
+  Container copy(original);
+  copy.erase(500);
+  copy.insert_or_assign(10, std::make_shared<int>(-10));
+  copy.insert(std::make_pair(5000, std::make_shared<int>(5000)));
+
+  EXPECT_EQ(1000, original.size());
+  EXPECT_EQ(1, original.count(500));
+  EXPECT_EQ(10, *original.find(10)->second);
+  EXPECT_EQ(original.end(), original.find(5000));
+
+  EXPECT_EQ(1000, copy.size());
+  EXPECT_EQ(copy.end(), copy.find(500));
+  EXPECT_EQ(-10, *copy.find(10)->second);
+  EXPECT_EQ(5000, *copy.find(5000)->second);
+}
+
+TEST(PersistentNodeContainer, SkipUnchanged) {
+  std::mt19937 gen(7);
+  Container original;
+  for (int i = 0; i < 5000; i += 2) {
+    original.insert(std::make_pair(i, std::make_shared<int>(i)));
+  }
+  EXPECT_TRUE(changedKeys(original, Container(original)).empty());
+  EXPECT_TRUE(changedKeys(original, original).empty());
+
+  for (int round = 0; round < 50; ++round) {
+    Container modified(original);
+    for (int i = 0; i < 20; ++i) {
+      int key = gen() % 5000;
+      switch (gen() % 3) {
+        case 0:
+          modified.erase(key);
+          break;
+        case 1:
+          modified.insert_or_assign(key, std::make_shared<int>(key));
+          break;
+        case 2: {
+          // Restoring the original value is not a change
+          auto it = original.find(key);
+          if (it != original.end()) {
+            modified.insert_or_assign(key, it->second);
+          }
+          break;
+        }
+      }
+    }
+    std::vector<int> expected;
+    Reference oldEntries(original.begin(), original.end());
+    Reference newEntries(modified.begin(), modified.end());
+    for (const auto& entry : oldEntries) {
+      auto it = newEntries.find(entry.first);
+      if (it == newEntries.end() || it->second != entry.second) {
+        expected.push_back(entry.first);
+      }
+    }
+    for (const auto& entry : newEntries) {
+      if (!oldEntries.count(entry.first)) {
+        expected.push_back(entry.first);
+      }
+    }
+    std::sort(expected.begin(), expected.end());
+    auto changed = changedKeys(original, modified);
+    EXPECT_EQ(expected, changed);
+    EXPECT_EQ(changed, changedKeys(modified, original));
+  }
+}
+
+TEST(PersistentNodeContainer, RangeConstructor) {
+  std::vector<std::pair<int, std::shared_ptr<int>>> entries;
+  for (int i = 0; i < 1000; ++i) {
+    entries.emplace_back(i, std::make_shared<int>(i));
+  }
+  Reference reference(entries.begin(), entries.end());
+  expectSame(Container(entries.begin(), entries.end()), reference);
+
+  std::shuffle(entries.begin(), entries.end(), std::mt19937(3));
+  entries.emplace_back(5, std::make_shared<int>(-5));
+  Reference unsortedReference(entries.begin(), entries.end());
+  expectSame(Container(entries.begin(), entries.end()), unsortedReference);
+}
+
+TEST(PersistentNodeContainer, PublishVisitsChangedEntries) {
+  Container original;
+  for (int i = 0; i < 1000; ++i) {
+    original.insert(std::make_pair(i, std::make_shared<int>(i)));
+  }
+  std::vector<int> visited;
+  auto visit = [&visited](const std::shared_ptr<int>& value) {
+    visited.push_back(*value);
+  };
+  original.publish(visit);
+  EXPECT_EQ(1000, visited.size());
+
+  visited.clear();
+  Container copy(original);
+  copy.insert_or_assign(10, std::make_shared<int>(-10));
+  copy.insert(std::make_pair(5000, std::make_shared<int>(5000)));
+  copy.erase(500);
+  copy.publish(visit);
+  EXPECT_NE(visited.end(), std::find(visited.begin(), visited.end(), -10));
+  EXPECT_NE(visited.end(), std::find(visited.begin(), visited.end(), 5000));
+  // Only the entries on modified paths are revisited
+  EXPECT_GT(100, visited.size());
+
+  visited.clear();
+  copy.publish(visit);
+  original.publish(visit);
+  EXPECT_TRUE(visited.empty());
+}
@@ -0,0 +1,147 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/state/AclEntry.h"
+#include "fboss/agent/state/AclMap.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/Conv.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+using std::make_shared;
+using std::shared_ptr;
+
+namespace {
+
+cfg::SwitchConfig configWithAcl(const std::string& dstIp) {
+  auto config = testConfigA();
+  config.acls_ref()->resize(1);
+  *config.acls_ref()[0].name_ref() = "acl1";
+  *config.acls_ref()[0].actionType_ref() = cfg::AclActionType::DENY;
+  config.acls_ref()[0].dstIp_ref() = dstIp;
+  return config;
+}
+
+shared_ptr<SwitchState> initialState(const cfg::SwitchConfig& config) {
+  auto state = make_shared<SwitchState>();
+  for (const auto& port : *config.ports_ref()) {
+    state->registerPort(
+        PortID(*port.logicalID_ref()),
+        folly::to<std::string>("port", *port.logicalID_ref()));
+  }
+  state->publish();
+  return state;
+}
+
+shared_ptr<SwitchState> applyWithCache(
+    const shared_ptr<SwitchState>& state,
+    const cfg::SwitchConfig& config,
+    const Platform* platform,
+    ThriftConfigApplyCache* cache) {
+  state->publish();
+  return applyThriftConfig(
+      state,
+      &config,
+      platform,
+      static_cast<RoutingInformationBase*>(nullptr),
+      cache);
+}
+
+bool skipped(const ThriftConfigApplyCache& cache, const std::string& section) {
+  return cache.getLastApplyStats().at(section).skipped;
+}
+
+} // namespace
+
+TEST(ThriftConfigApplyCache, skipsUnchangedSections) {
+  auto platform = createMockPlatform();
+  auto config = configWithAcl("192.168.0.0/24");
+  ThriftConfigApplyCache cache;
+
+  auto stateV1 =
+      applyWithCache(initialState(config), config, platform.get(), &cache);
+  ASSERT_NE(nullptr, stateV1);
+  EXPECT_FALSE(skipped(cache, "ports"));
+  EXPECT_FALSE(skipped(cache, "acls"));
+
+  EXPECT_EQ(nullptr, applyWithCache(stateV1, config, platform.get(), &cache));
+  EXPECT_TRUE(skipped(cache, "ports"));
+  EXPECT_TRUE(skipped(cache, "vlans"));
+  EXPECT_TRUE(skipped(cache, "acls"));
+  // Later sections depend on what these collect, so they always run
+  EXPECT_FALSE(skipped(cache, "interfaces"));
+  EXPECT_FALSE(skipped(cache, "routes"));
+}
+
+TEST(ThriftConfigApplyCache, appliesChangedSection) {
+  auto platform = createMockPlatform();
+  auto config = configWithAcl("192.168.0.0/24");
+  ThriftConfigApplyCache cache;
+  auto stateV1 =
+      applyWithCache(initialState(config), config, platform.get(), &cache);
+  ASSERT_NE(nullptr, stateV1);
+
+  auto newConfig = configWithAcl("10.0.0.0/8");
+  auto stateV2 = applyWithCache(stateV1, newConfig, platform.get(), &cache);
+  ASSERT_NE(nullptr, stateV2);
+  EXPECT_FALSE(skipped(cache, "acls"));
+  EXPECT_TRUE(skipped(cache, "ports"));
+  EXPECT_EQ(
+      folly::CIDRNetwork(folly::IPAddress("10.0.0.0"), 8),
+      stateV2->getAcl("acl1")->getDstIp());
+  EXPECT_EQ(
+      *applyThriftConfig(stateV1, &newConfig, platform.get())
+           ->getAcl("acl1"),
+      *stateV2->getAcl("acl1"));
+}
+
+TEST(ThriftConfigApplyCache, appliesSectionWithReplacedState) {
+  auto platform = createMockPlatform();
+  auto config = configWithAcl("192.168.0.0/24");
+  ThriftConfigApplyCache cache;
+  auto stateV1 =
+      applyWithCache(initialState(config), config, platform.get(), &cache);
+  ASSERT_NE(nullptr, stateV1);
+
+  // Drop the ACL behind the back of the config
+  auto stateV2 = stateV1->clone();
+  stateV2->resetAcls(make_shared<AclMap>());
+
+  auto stateV3 = applyWithCache(stateV2, config, platform.get(), &cache);
+  ASSERT_NE(nullptr, stateV3);
+  EXPECT_FALSE(skipped(cache, "acls"));
+  EXPECT_TRUE(skipped(cache, "ports"));
+  EXPECT_NE(nullptr, stateV3->getAcl("acl1"));
+}
+
+TEST(ThriftConfigApplyCache, appliesAllSectionsOfUnpublishedState) {
+  auto platform = createMockPlatform();
+  auto config = configWithAcl("192.168.0.0/24");
+  ThriftConfigApplyCache cache;
+  auto stateV1 =
+      applyWithCache(initialState(config), config, platform.get(), &cache);
+  ASSERT_NE(nullptr, stateV1);
+
+  // Nodes of an unpublished state may still be modified in place
+  ASSERT_FALSE(stateV1->isPublished());
+  applyThriftConfig(
+      stateV1,
+      &config,
+      platform.get(),
+      static_cast<RoutingInformationBase*>(nullptr),
+      &cache);
+  for (const auto& [section, stats] : cache.getLastApplyStats()) {
+    EXPECT_FALSE(stats.skipped) << section;
+  }
+}
@@ -87,3 +87,17 @@ struct PortFields {
  24: optional switch_config.PortPfc pfc
  25: optional list<PortPgFields> pgConfigs
 }
+
+/*
+ * The warm boot switch state, i.e. the folly::dynamic made of the SwSwitch
+ * and HwSwitch state, encoded in thrift so that it can be written with the
+ * compact protocol rather than as JSON. A value with no field set is null.
+ */
+union WarmbootValue {
+ 1: bool boolValue
+ 2: i64 intValue
+ 3: double doubleValue
+ 4: string stringValue
+ 5: list<WarmbootValue> listValue
+ 6: map<string, WarmbootValue> objectValue
+}
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Measures what reapplying a large config costs when nothing, or only a
+ * single ACL, changed in it: once applying every section of the config, and
+ * once skipping the sections left unchanged through a ThriftConfigApplyCache.
+ */
+
+#include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/test/TestUtils.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/init/Init.h>
+
+#include <memory>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr auto kNumPorts = 256;
+constexpr auto kPortsPerVlan = 4;
+constexpr auto kNumAcls = 1024;
+
+cfg::SwitchConfig largeConfig() {
+  cfg::SwitchConfig config;
+  config.ports_ref()->resize(kNumPorts);
+  config.vlanPorts_ref()->resize(kNumPorts);
+  for (int p = 0; p < kNumPorts; ++p) {
+    config.ports_ref()[p].logicalID_ref() = p + 1;
+    config.ports_ref()[p].name_ref() = folly::to<std::string>("port", p + 1);
+    config.ports_ref()[p].state_ref() = cfg::PortState::ENABLED;
+    config.vlanPorts_ref()[p].logicalPort_ref() = p + 1;
+    config.vlanPorts_ref()[p].vlanID_ref() = p / kPortsPerVlan + 1;
+  }
+
+  auto numVlans = kNumPorts / kPortsPerVlan;
+  config.vlans_ref()->resize(numVlans);
+  config.interfaces_ref()->resize(numVlans);
+  for (int v = 0; v < numVlans; ++v) {
+    config.vlans_ref()[v].id_ref() = v + 1;
+    config.vlans_ref()[v].name_ref() = folly::to<std::string>("Vlan", v + 1);
+    config.vlans_ref()[v].intfID_ref() = v + 1;
+
+    auto& intf = config.interfaces_ref()[v];
+    intf.intfID_ref() = v + 1;
+    intf.routerID_ref() = 0;
+    intf.vlanID_ref() = v + 1;
+    intf.name_ref() = folly::to<std::string>("interface", v + 1);
+    intf.mac_ref() = "00:02:00:00:00:01";
+    intf.mtu_ref() = 9000;
+    intf.ipAddresses_ref()->resize(2);
+    intf.ipAddresses_ref()[0] = folly::to<std::string>("10.0.", v, ".1/24");
+    intf.ipAddresses_ref()[1] =
+        folly::to<std::string>("2401:db00:2110:", v, "::1/64");
+  }
+
+  config.acls_ref()->resize(kNumAcls);
+  for (int a = 0; a < kNumAcls; ++a) {
+    auto& acl = config.acls_ref()[a];
+    acl.name_ref() = folly::to<std::string>("acl", a);
+    acl.actionType_ref() = cfg::AclActionType::DENY;
+    acl.dstIp_ref() =
+        folly::to<std::string>("10.", a / 256, ".", a % 256, ".0/24");
+    acl.l4DstPort_ref() = 1000 + a;
+  }
+  return config;
+}
+
+void reapplyConfig(size_t iters, bool changeAcl, bool incremental) {
+  folly::BenchmarkSuspender suspender;
+  auto platform = createMockPlatform();
+  auto config = largeConfig();
+  auto state = std::make_shared<SwitchState>();
+  for (int p = 1; p <= kNumPorts; ++p) {
+    state->registerPort(PortID(p), folly::to<std::string>("port", p));
+  }
+  ThriftConfigApplyCache cache;
+  state->publish();
+  state = applyThriftConfig(
+      state,
+      &config,
+      platform.get(),
+      static_cast<RoutingInformationBase*>(nullptr),
+      &cache);
+  state->publish();
+
+  auto newConfig = config;
+  if (changeAcl) {
+    newConfig.acls_ref()[kNumAcls / 2].l4DstPort_ref() = 1;
+  }
+  suspender.dismiss();
+
+  for (size_t i = 0; i < iters; ++i) {
+    auto newState = applyThriftConfig(
+        state,
+        &newConfig,
+        platform.get(),
+        static_cast<RoutingInformationBase*>(nullptr),
+        incremental ? &cache : nullptr);
+    CHECK_EQ(changeAcl, newState != nullptr);
+    folly::doNotOptimizeAway(newState);
+  }
+}
+
+} // namespace
+
+BENCHMARK(reapplyUnchangedConfig, n) {
+  reapplyConfig(n, false /* changeAcl */, false /* incremental */);
+}
+
+BENCHMARK_RELATIVE(reapplyUnchangedConfigIncremental, n) {
+  reapplyConfig(n, false /* changeAcl */, true /* incremental */);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(reapplyConfigWithOneAclChanged, n) {
+  reapplyConfig(n, true /* changeAcl */, false /* incremental */);
+}
+
+BENCHMARK_RELATIVE(reapplyConfigWithOneAclChangedIncremental, n) {
+  reapplyConfig(n, true /* changeAcl */, true /* incremental */);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv);
+  folly::runBenchmarks();
+  return EXIT_SUCCESS;
+}
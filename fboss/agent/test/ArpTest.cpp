@@ -14,6 +14,7 @@
 #include "fboss/agent/AddressUtil.h"
 #include "fboss/agent/ArpHandler.h"
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/NeighborStateUpdateBatcher.h"
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/SwitchStats.h"
@@ -957,6 +958,57 @@ TEST(ArpTest, PendingArp) {
   EXPECT_EQ(entry->isPending(), false);
 };
 
+TEST(ArpTest, ResolvedEntriesBatched) {
+  gflags::FlagSaver flagSaver;
+  // Keep the batch open until waitForPendingUpdates() flushes it
+  FLAGS_neighbor_update_batch_interval_ms = 60 * 1000;
+  auto handle = setupTestHandle(std::chrono::seconds(0), 5);
+  auto sw = handle->getSw();
+
+  VlanID vlanID(1);
+  std::vector<std::string> targetIPs;
+  for (int i = 2; i < 12; ++i) {
+    targetIPs.push_back(folly::to<std::string>("10.0.0.", i));
+  }
+
+  // All of the entries are added in a single state update
+  EXPECT_HW_CALL(sw, stateChanged(_)).Times(1);
+  for (const auto& ip : targetIPs) {
+    sendArpReply(handle.get(), ip, "02:10:20:30:40:22", 1);
+  }
+  sw->getNeighborUpdater()->waitForPendingUpdates();
+  waitForStateUpdates(sw);
+
+  for (const auto& ip : targetIPs) {
+    auto entry = getArpEntry(sw, IPAddressV4(ip), vlanID);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_FALSE(entry->isPending());
+  }
+}
+
+TEST(ArpTest, PendingEntryNotBatched) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_neighbor_update_batch_interval_ms = 60 * 1000;
+  auto handle = setupTestHandle(std::chrono::seconds(0), 5);
+  auto sw = handle->getSw();
+
+  VlanID vlanID(1);
+  // The batch holding the resolved entry is flushed ahead of the pending
+  // entry, which gets a state update of its own
+  EXPECT_HW_CALL(sw, stateChanged(_)).Times(2);
+  sendArpReply(handle.get(), "10.0.0.2", "02:10:20:30:40:22", 1);
+  sw->getNeighborUpdater()->sentArpRequest(vlanID, IPAddressV4("10.0.0.3"));
+  sw->getNeighborUpdater()->waitForPendingUpdates();
+  waitForStateUpdates(sw);
+
+  auto resolved = getArpEntry(sw, IPAddressV4("10.0.0.2"), vlanID);
+  ASSERT_NE(resolved, nullptr);
+  EXPECT_FALSE(resolved->isPending());
+  auto pending = getArpEntry(sw, IPAddressV4("10.0.0.3"), vlanID);
+  ASSERT_NE(pending, nullptr);
+  EXPECT_TRUE(pending->isPending());
+}
+
 TEST(ArpTest, PendingArpCleanup) {
   auto handle = setupTestHandle(std::chrono::seconds(1));
   auto sw = handle->getSw();
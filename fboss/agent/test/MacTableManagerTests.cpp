@@ -19,6 +19,9 @@
 
 #include <folly/MacAddress.h>
 
+#include <utility>
+#include <vector>
+
 namespace facebook::fboss {
 
 class MacTableManagerTest : public ::testing::Test {
@@ -77,6 +80,27 @@ class MacTableManagerTest : public ::testing::Test {
     });
   }
 
+  /*
+   * Deliver the callbacks back to back, as during a learning burst, and only
+   * then wait for the resulting state updates.
+   */
+  void triggerMacCbBurst(
+      const std::vector<std::pair<folly::MacAddress, L2EntryUpdateType>>&
+          macAndUpdateTypes) {
+    for (const auto& [mac, l2EntryUpdateType] : macAndUpdateTypes) {
+      sw_->l2LearningUpdateReceived(
+          L2Entry(
+              mac,
+              kVlan(),
+              PortDescriptor(kPortID()),
+              L2Entry::L2EntryType::L2_ENTRY_TYPE_PENDING),
+          l2EntryUpdateType);
+    }
+
+    waitForBackgroundThread(sw_);
+    waitForStateUpdates(sw_);
+  }
+
   void verifyMacIsDeleted() {
     verifyStateUpdate([=]() {
       auto vlan = sw_->getState()->getVlans()->getVlan(kVlan());
@@ -142,4 +166,43 @@ TEST_F(MacTableManagerTest, SameMacAgedCbTwice) {
   verifyMacIsDeleted();
 }
 
+TEST_F(MacTableManagerTest, MacLearnedAgedLearnedInBurst) {
+  triggerMacCbBurst({
+      {kMacAddress(), L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD},
+      {kMacAddress(), L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE},
+      {kMacAddress(), L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD},
+  });
+
+  verifyMacIsAdded();
+}
+
+TEST_F(MacTableManagerTest, MacLearnedAgedInBurst) {
+  triggerMacCbBurst({
+      {kMacAddress(), L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD},
+      {kMacAddress(), L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_DELETE},
+  });
+
+  verifyMacIsDeleted();
+}
+
+TEST_F(MacTableManagerTest, ManyMacsLearnedInBurst) {
+  constexpr size_t kNumMacs = 1000;
+  std::vector<std::pair<folly::MacAddress, L2EntryUpdateType>> burst;
+  for (size_t i = 0; i < kNumMacs; ++i) {
+    burst.emplace_back(
+        folly::MacAddress::fromHBO(kMacAddress().u64HBO() + i),
+        L2EntryUpdateType::L2_ENTRY_UPDATE_TYPE_ADD);
+  }
+  triggerMacCbBurst(burst);
+
+  verifyStateUpdate([=]() {
+    auto vlan = sw_->getState()->getVlans()->getVlan(kVlan());
+    auto* macTable = vlan->getMacTable().get();
+    EXPECT_EQ(kNumMacs, macTable->size());
+    for (const auto& [mac, l2EntryUpdateType] : burst) {
+      EXPECT_NE(nullptr, macTable->getNodeIf(mac));
+    }
+  });
+}
+
 } // namespace facebook::fboss
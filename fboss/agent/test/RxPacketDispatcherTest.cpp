@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/RxPacketDispatcher.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+
+#include <folly/Conv.h>
+#include <folly/Synchronized.h>
+#include <folly/synchronization/Baton.h>
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+using PacketClass = RxPacketDispatcher::PacketClass;
+
+namespace {
+
+std::unique_ptr<MockRxPacket> makePacket(folly::StringPiece ethertypeAndL3) {
+  return MockRxPacket::fromHex(folly::to<std::string>(
+      // dst mac, src mac
+      "02 00 01 00 00 01  02 00 02 00 00 02"
+      // 802.1q, VLAN 1
+      "81 00  00 01",
+      ethertypeAndL3));
+}
+
+std::unique_ptr<MockRxPacket> makeLldpPacket() {
+  return makePacket("88 cc  02 07 04 02 00 02 00 00 02");
+}
+
+std::unique_ptr<MockRxPacket> makeUdpPacket() {
+  return makePacket(
+      "08 00"
+      "45 00  00 1c  00 00  40 00  40  11  26 cf"
+      "0a 00 00 02  0a 00 00 01"
+      // Source port 8000, destination port 8001
+      "1f 40  1f 41  00 08  00 00");
+}
+
+} // unnamed namespace
+
+TEST(RxPacketDispatcherTest, Classify) {
+  EXPECT_EQ(
+      PacketClass::CONTROL,
+      RxPacketDispatcher::classify(makeLldpPacket().get()));
+  // LACP
+  EXPECT_EQ(
+      PacketClass::CONTROL,
+      RxPacketDispatcher::classify(makePacket("88 09  01 01").get()));
+  // IPv4 TCP to port 179
+  EXPECT_EQ(
+      PacketClass::CONTROL,
+      RxPacketDispatcher::classify(
+          makePacket("08 00"
+                     "45 00  00 28  00 00  40 00  40  06  00 00"
+                     "0a 00 00 02  0a 00 00 01"
+                     "c3 50  00 b3  00 00 00 00  00 00 00 00")
+              .get()));
+  // IPv6 TCP from port 179
+  EXPECT_EQ(
+      PacketClass::CONTROL,
+      RxPacketDispatcher::classify(
+          makePacket("86 dd"
+                     "60 00 00 00  00 14  06  ff"
+                     "fe 80 00 00 00 00 00 00  00 00 00 00 00 00 00 02"
+                     "fe 80 00 00 00 00 00 00  00 00 00 00 00 00 00 01"
+                     "00 b3  c3 50  00 00 00 00  00 00 00 00")
+              .get()));
+  // ARP
+  EXPECT_EQ(
+      PacketClass::NEIGHBOR,
+      RxPacketDispatcher::classify(
+          makePacket("08 06  00 01 08 00 06 04 00 01").get()));
+  // Neighbor solicitation
+  EXPECT_EQ(
+      PacketClass::NEIGHBOR,
+      RxPacketDispatcher::classify(
+          makePacket("86 dd"
+                     "60 00 00 00  00 20  3a  ff"
+                     "fe 80 00 00 00 00 00 00  00 00 00 00 00 00 00 02"
+                     "ff 02 00 00 00 00 00 00  00 00 00 01 ff 00 00 01"
+                     "87 00 00 00")
+              .get()));
+  EXPECT_EQ(
+      PacketClass::DEFAULT,
+      RxPacketDispatcher::classify(makeUdpPacket().get()));
+  // Truncated IPv6 header
+  EXPECT_EQ(
+      PacketClass::DEFAULT,
+      RxPacketDispatcher::classify(makePacket("86 dd  60 00").get()));
+}
+
+TEST(RxPacketDispatcherTest, ControlPacketsFirst) {
+  folly::Baton<> blocked;
+  folly::Baton<> unblock;
+  folly::Synchronized<std::vector<PacketClass>> handled;
+  RxPacketDispatcher dispatcher(
+      [&](std::unique_ptr<RxPacket> pkt) {
+        if (!blocked.ready()) {
+          blocked.post();
+          unblock.wait();
+          return;
+        }
+        handled.wlock()->push_back(RxPacketDispatcher::classify(pkt.get()));
+      },
+      1 /* numThreads */,
+      4 /* queueSize */);
+
+  // Hold up the only worker, then queue packets behind it
+  EXPECT_TRUE(dispatcher.dispatch(makeUdpPacket(), PacketClass::DEFAULT));
+  blocked.wait();
+  for (auto i = 0; i < 5; ++i) {
+    auto queued = dispatcher.dispatch(makeUdpPacket(), PacketClass::DEFAULT);
+    // The default queue only has room for 4
+    EXPECT_EQ(i < 4, queued);
+  }
+  EXPECT_TRUE(dispatcher.dispatch(makeLldpPacket(), PacketClass::CONTROL));
+  unblock.post();
+
+  while (dispatcher.getStats(PacketClass::DEFAULT).handled < 5) {
+    std::this_thread::yield();
+  }
+  auto order = handled.copy();
+  ASSERT_EQ(5, order.size());
+  EXPECT_EQ(PacketClass::CONTROL, order[0]);
+  for (size_t i = 1; i < order.size(); ++i) {
+    EXPECT_EQ(PacketClass::DEFAULT, order[i]);
+  }
+  EXPECT_EQ(1, dispatcher.getStats(PacketClass::DEFAULT).dropped);
+  EXPECT_EQ(5, dispatcher.getStats(PacketClass::DEFAULT).enqueued);
+  EXPECT_EQ(1, dispatcher.getStats(PacketClass::CONTROL).handled);
+}
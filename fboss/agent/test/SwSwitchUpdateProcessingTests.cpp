@@ -11,7 +11,9 @@
 #include <gtest/gtest.h>
 
 #include "fboss/agent/FbossHwUpdateError.h"
+#include "fboss/agent/StateObserver.h"
 #include "fboss/agent/SwitchStats.h"
+#include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
 #include "fboss/agent/test/CounterCache.h"
 #include "fboss/agent/test/HwTestHandle.h"
@@ -20,19 +22,27 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/MacAddress.h>
+#include <folly/synchronization/Baton.h>
 
 #include <algorithm>
+#include <vector>
+
+DECLARE_bool(async_state_observers);
+DECLARE_bool(pipeline_state_updates);
 
 using namespace facebook::fboss;
 using std::string;
 using ::testing::_;
 using ::testing::ByRef;
 using ::testing::Eq;
+using ::testing::Invoke;
 using ::testing::Return;
 
 class SwSwitchUpdateProcessingTest : public ::testing::TestWithParam<bool> {
  public:
   void SetUp() override {
+    // Read when the update threads are started
+    FLAGS_pipeline_state_updates = true;
     // Setup a default state object
     auto state = testStateA();
     state->publish();
@@ -59,6 +69,7 @@ class SwSwitchUpdateProcessingTest : public ::testing::TestWithParam<bool> {
     }
   }
 
+  gflags::FlagSaver flagSaver_;
   SwSwitch* sw{nullptr};
   std::unique_ptr<HwTestHandle> handle{nullptr};
 };
@@ -204,6 +215,170 @@ TEST_P(
   waitForStateUpdates(sw);
 }
 
+TEST_P(SwSwitchUpdateProcessingTest, NextUpdatePreparedDuringHwApply) {
+  auto startState = sw->getState();
+  startState->publish();
+  auto state1 = startState->clone();
+  state1->publish();
+  auto state2 = state1->clone();
+  folly::Baton<> updatesQueued;
+  folly::Baton<> update2Prepared;
+  // Hold the update thread until both updates are queued, so that update 2
+  // is waiting by the time update 1 goes to HW
+  sw->getUpdateEvb()->runInEventBaseThread(
+      [&updatesQueued]() { updatesQueued.wait(); });
+  EXPECT_HW_CALL(sw, stateChanged(_))
+      .WillOnce(Invoke([&update2Prepared](const StateDelta& delta) {
+        EXPECT_TRUE(update2Prepared.try_wait_for(std::chrono::seconds(10)));
+        return delta.newState();
+      }))
+      .WillOnce(Invoke([](const StateDelta& delta) {
+        return delta.newState();
+      }));
+  sw->updateStateNoCoalescing(
+      "Update 1", [=](const std::shared_ptr<SwitchState>& state) {
+        EXPECT_EQ(state, startState);
+        return state1;
+      });
+  sw->updateStateNoCoalescing(
+      "Update 2", [=, &update2Prepared](
+                      const std::shared_ptr<SwitchState>& state) {
+        EXPECT_EQ(state, state1);
+        update2Prepared.post();
+        return state2;
+      });
+  updatesQueued.post();
+  waitForStateUpdates(sw);
+  EXPECT_EQ(state2, sw->getState());
+}
+
+TEST_P(SwSwitchUpdateProcessingTest, AsyncObserverSeesMergedDelta) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_async_state_observers = true;
+
+  class BlockingObserver : public StateObserver {
+   public:
+    void stateUpdated(const StateDelta& delta) override {
+      if (deltas.empty()) {
+        started.post();
+        release.wait();
+      }
+      deltas.emplace_back(delta.oldState(), delta.newState());
+      if (deltas.size() == 2) {
+        caughtUp.post();
+      }
+    }
+    folly::Baton<> started;
+    folly::Baton<> release;
+    folly::Baton<> caughtUp;
+    std::vector<std::pair<
+        std::shared_ptr<SwitchState>,
+        std::shared_ptr<SwitchState>>>
+        deltas;
+  } observer;
+  sw->registerStateObserver(
+      &observer,
+      "BlockingObserver",
+      SwSwitch::StateObserverDispatch::ASYNC);
+
+  auto startState = sw->getState();
+  startState->publish();
+  std::vector<std::shared_ptr<SwitchState>> states;
+  EXPECT_HW_CALL(sw, stateChanged(_))
+      .WillRepeatedly(
+          Invoke([](const StateDelta& delta) { return delta.newState(); }));
+  for (auto i = 0; i < 3; ++i) {
+    auto newState = sw->getState()->clone();
+    newState->publish();
+    states.push_back(newState);
+    sw->updateStateNoCoalescing(
+        "Update", [=](const std::shared_ptr<SwitchState>&) {
+          return newState;
+        });
+    waitForStateUpdates(sw);
+    if (i == 0) {
+      // The observer being stuck on the first delta must not hold up the
+      // ones after it
+      EXPECT_TRUE(observer.started.try_wait_for(std::chrono::seconds(10)));
+    }
+  }
+  EXPECT_EQ(states.back(), sw->getState());
+
+  observer.release.post();
+  // The last two deltas reach the observer merged into one
+  EXPECT_TRUE(observer.caughtUp.try_wait_for(std::chrono::seconds(10)));
+  sw->unregisterStateObserver(&observer);
+  ASSERT_EQ(2, observer.deltas.size());
+  EXPECT_EQ(startState, observer.deltas[0].first);
+  EXPECT_EQ(states[0], observer.deltas[0].second);
+  EXPECT_EQ(states[0], observer.deltas[1].first);
+  EXPECT_EQ(states[2], observer.deltas[1].second);
+}
+
+TEST_P(SwSwitchUpdateProcessingTest, NextUpdatePreparedAgainAfterPartialHw) {
+  auto startState = sw->getState();
+  startState->publish();
+  auto desiredState = startState->clone();
+  desiredState->publish();
+  // What HW is left with after reverting part of the update
+  auto partialState = startState->clone();
+  partialState->publish();
+  folly::Baton<> updatesQueued;
+  folly::Baton<> update2Prepared;
+  sw->getUpdateEvb()->runInEventBaseThread(
+      [&updatesQueued]() { updatesQueued.wait(); });
+  auto partialApply = [&update2Prepared, partialState](const StateDelta&) {
+    EXPECT_TRUE(update2Prepared.try_wait_for(std::chrono::seconds(10)));
+    return partialState;
+  };
+  auto fullApply = [](const StateDelta& delta) { return delta.newState(); };
+  if (sw->getHw()->transactionsSupported()) {
+    EXPECT_HW_CALL(sw, stateChangedTransaction(_))
+        .WillOnce(Invoke(partialApply));
+    EXPECT_HW_CALL(sw, stateChanged(_)).WillOnce(Invoke(fullApply));
+  } else {
+    EXPECT_HW_CALL(sw, stateChanged(_))
+        .WillOnce(Invoke(partialApply))
+        .WillOnce(Invoke(fullApply));
+  }
+
+  auto update1Result = std::make_shared<BlockingUpdateResult>();
+  sw->updateState(std::make_unique<BlockingStateUpdate>(
+      "Update 1",
+      [=](const std::shared_ptr<SwitchState>& state) {
+        EXPECT_EQ(state, startState);
+        return desiredState;
+      },
+      update1Result,
+      static_cast<int>(StateUpdate::BehaviorFlags::NON_COALESCING) |
+          static_cast<int>(StateUpdate::BehaviorFlags::HW_FAILURE_PROTECTION)));
+  // Called on the prepare thread, then on the update thread once the
+  // former is done
+  std::vector<std::shared_ptr<SwitchState>> update2OrigStates;
+  std::vector<std::shared_ptr<SwitchState>> update2NewStates;
+  sw->updateStateNoCoalescing(
+      "Update 2",
+      [&update2OrigStates, &update2NewStates, &update2Prepared](
+          const std::shared_ptr<SwitchState>& state) {
+        update2OrigStates.push_back(state);
+        update2NewStates.push_back(state->clone());
+        if (!update2Prepared.ready()) {
+          update2Prepared.post();
+        }
+        return update2NewStates.back();
+      });
+  updatesQueued.post();
+  EXPECT_THROW(update1Result->wait(), FbossHwUpdateError);
+  waitForStateUpdates(sw);
+
+  // Update 2 was prepared on top of update 1 while HW applied it, then
+  // again on top of what HW was left with
+  ASSERT_EQ(update2OrigStates.size(), 2);
+  EXPECT_EQ(desiredState, update2OrigStates[0]);
+  EXPECT_EQ(partialState, update2OrigStates[1]);
+  EXPECT_EQ(update2NewStates[1], sw->getState());
+}
+
 INSTANTIATE_TEST_CASE_P(
     SwSwitchUpdateProcessingTest,
     SwSwitchUpdateProcessingTest,
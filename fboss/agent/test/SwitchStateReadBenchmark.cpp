@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Compares the cost of looking up the applied SwitchState from several rx
+ * threads at once through SwSwitch::getState() (spinlock plus shared_ptr
+ * copy) and SwSwitch::getStateReadGuard() (RCU read lock), while the update
+ * thread keeps publishing new states as it would under route churn.
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/hw/sim/SimPlatform.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+using folly::MacAddress;
+using std::make_shared;
+using std::make_unique;
+using std::shared_ptr;
+using std::unique_ptr;
+
+namespace {
+
+const VlanID kVlan(1);
+
+unique_ptr<SwSwitch> sw;
+
+unique_ptr<SwSwitch> setupSwitch() {
+  MacAddress localMac("02:00:01:00:00:01");
+  auto sw = make_unique<SwSwitch>(make_unique<SimPlatform>(localMac, 10));
+  sw->init(nullptr /* No custom TunManager */);
+
+  auto updateFn = [&](const shared_ptr<SwitchState>& oldState) {
+    auto state = oldState->clone();
+    auto vlan1 = make_shared<Vlan>(kVlan, "Vlan1");
+    for (int idx = 1; idx < 10; ++idx) {
+      vlan1->addPort(PortID(idx), false);
+    }
+    state->addVlan(vlan1);
+    return state;
+  };
+  sw->updateStateBlocking("setup", updateFn);
+  return sw;
+}
+
+/*
+ * Run numReaders threads that each look up VLAN 1 iters times through
+ * getStateFn, while this thread keeps publishing new SwitchStates until
+ * they are all done.
+ */
+template <typename GetStateFn>
+void readStateUnderUpdates(
+    size_t iters,
+    size_t numReaders,
+    GetStateFn getStateFn) {
+  std::atomic<size_t> readersDone{0};
+  std::atomic<size_t> vlansFound{0};
+  std::vector<std::thread> readers;
+  for (size_t i = 0; i < numReaders; ++i) {
+    readers.emplace_back([&] {
+      size_t found = 0;
+      for (size_t n = 0; n < iters; ++n) {
+        auto state = getStateFn();
+        found += state->getVlans()->getVlanIf(kVlan) != nullptr;
+      }
+      vlansFound += found;
+      ++readersDone;
+    });
+  }
+
+  size_t generation = 0;
+  while (readersDone.load() < numReaders) {
+    sw->updateStateBlocking(
+        "benchmark update", [&](const shared_ptr<SwitchState>& oldState) {
+          auto state = oldState->clone();
+          state->getVlans()->getVlan(kVlan)->modify(&state)->setName(
+              folly::to<std::string>("Vlan1-", ++generation));
+          return state;
+        });
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  CHECK_EQ(iters * numReaders, vlansFound.load());
+}
+
+void getStateSharedPtr(size_t iters, size_t numReaders) {
+  readStateUnderUpdates(iters, numReaders, [] { return sw->getState(); });
+}
+
+void getStateReadGuard(size_t iters, size_t numReaders) {
+  readStateUnderUpdates(
+      iters, numReaders, [] { return sw->getStateReadGuard(); });
+}
+
+} // unnamed namespace
+
+BENCHMARK_PARAM(getStateSharedPtr, 1)
+BENCHMARK_RELATIVE_PARAM(getStateReadGuard, 1)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(getStateSharedPtr, 4)
+BENCHMARK_RELATIVE_PARAM(getStateReadGuard, 4)
+BENCHMARK_DRAW_LINE();
+BENCHMARK_PARAM(getStateSharedPtr, 16)
+BENCHMARK_RELATIVE_PARAM(getStateReadGuard, 16)
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // As in ArpBenchmark, set up the switch once up front rather than in
+  // every benchmark function.
+  sw = setupSwitch();
+
+  folly::runBenchmarks();
+  sw.reset();
+  return 0;
+}
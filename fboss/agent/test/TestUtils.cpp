@@ -14,6 +14,7 @@
 
 #include "fboss/agent/AgentConfig.h"
 #include "fboss/agent/ApplyThriftConfig.h"
+#include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/RxPacket.h"
 #include "fboss/agent/TunManager.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
@@ -292,8 +293,8 @@ void waitForBackgroundThread(SwSwitch* sw) {
 }
 
 void waitForNeighborCacheThread(SwSwitch* sw) {
-  auto* evb = sw->getNeighborCacheEvb();
-  evb->runInEventBaseThreadAndWait([]() { return; });
+  // Also hands batched neighbor state changes to the SwSwitch
+  sw->getNeighborUpdater()->waitForPendingUpdates();
 }
 
 void waitForRibUpdates(SwSwitch* sw) {
@@ -15,18 +15,28 @@
 #include "fboss/agent/ThriftHandler.h"
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/hw/mock/MockPlatform.h"
+#include "fboss/agent/state/ArpTable.h"
 #include "fboss/agent/state/Port.h"
 #include "fboss/agent/state/Route.h"
 #include "fboss/agent/state/RouteUpdater.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+#include "fboss/agent/state/VlanMap.h"
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/RouteScaleGenerators.h"
 #include "fboss/agent/test/TestUtils.h"
 
 #include <folly/IPAddress.h>
+#include <folly/MacAddress.h>
+#include <folly/Synchronized.h>
+#include <folly/io/async/ScopedEventBaseThread.h>
 #include <gtest/gtest.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 
+#include <chrono>
+#include <limits>
+#include <thread>
+
 using namespace facebook::fboss;
 using apache::thrift::TEnumTraits;
 using cfg::PortSpeed;
@@ -57,6 +67,99 @@ IpPrefix ipPrefix(const folly::CIDRNetwork& nw) {
   result.prefixLength_ref() = nw.second;
   return result;
 }
+
+/*
+ * Reads a stream returned by the handler, the way a thrift client would.
+ * The subscription is cancelled when the reader goes away.
+ */
+template <typename T>
+class StreamReader {
+ public:
+  explicit StreamReader(apache::thrift::ServerStream<T> stream)
+      : subscription_(
+            std::move(stream)
+                .toClientStreamUnsafeDoNotUse(evbThread_.getEventBase())
+                .subscribeExTry(
+                    folly::getKeepAliveToken(evbThread_.getEventBase()),
+                    [this](folly::Try<T>&& item) {
+                      auto received = received_.lock();
+                      if (item.hasValue()) {
+                        received->items.push_back(std::move(*item));
+                      } else {
+                        received->ended = true;
+                      }
+                    })) {}
+
+  ~StreamReader() {
+    subscription_.cancel();
+    std::move(subscription_).join();
+  }
+
+  // Wait for count items to be read, or for the stream to end, and return
+  // the items read so far
+  std::vector<T> waitFor(size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline) {
+      {
+        auto received = received_.lock();
+        if (received->items.size() >= count || received->ended) {
+          return received->items;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return received_.lock()->items;
+  }
+
+  std::vector<T> readAll() {
+    return waitFor(std::numeric_limits<size_t>::max());
+  }
+
+ private:
+  struct Received {
+    std::vector<T> items;
+    bool ended{false};
+  };
+  folly::ScopedEventBaseThread evbThread_;
+  folly::Synchronized<Received, std::mutex> received_;
+  typename apache::thrift::ClientBufferedStream<T>::Subscription subscription_;
+};
+
+template <typename EntryT>
+std::vector<EntryT> concatPages(
+    const std::vector<std::vector<EntryT>>& pages,
+    size_t pageSize) {
+  std::vector<EntryT> entries;
+  for (const auto& page : pages) {
+    EXPECT_LE(page.size(), pageSize);
+    entries.insert(entries.end(), page.begin(), page.end());
+  }
+  return entries;
+}
+
+folly::IPAddressV4 arpEntryIp(int i) {
+  return folly::IPAddressV4::fromLongHBO(
+      folly::IPAddressV4("10.0.0.100").toLongHBO() + i);
+}
+
+void addArpEntries(SwSwitch* sw, int begin, int end) {
+  sw->updateStateBlocking(
+      "add arp entries",
+      [begin, end](const std::shared_ptr<SwitchState>& state) {
+        auto newState = state->clone();
+        auto vlan = state->getVlans()->getVlan(VlanID(1));
+        auto arpTable = vlan->getArpTable()->modify(VlanID(1), &newState);
+        for (auto i = begin; i < end; ++i) {
+          arpTable->addEntry(
+              arpEntryIp(i),
+              folly::MacAddress::fromHBO(0x020900000000 + i),
+              PortDescriptor(PortID(1)),
+              InterfaceID(1),
+              NeighborState::REACHABLE);
+        }
+        return newState;
+      });
+}
 } // unnamed namespace
 
 template <typename StandaloneRib>
@@ -1131,3 +1234,140 @@ TYPED_TEST(ThriftTest, routeUpdatesWithConcurrentReads) {
   done = true;
   routeReads.join();
 }
+
+TYPED_TEST(ThriftTest, streamRouteTableDetails) {
+  ThriftHandler handler(this->sw_);
+  std::vector<RouteDetails> routeDetails;
+  handler.getRouteTableDetails(routeDetails);
+  auto stream = handler.streamRouteTableDetails(2);
+  // Pages come from the state as of the call
+  handler.addUnicastRoutes(
+      10,
+      std::make_unique<std::vector<UnicastRoute>>(std::vector<UnicastRoute>{
+          *makeUnicastRoute("aaaa::/64", "2401:db00:2110:3001::1")}));
+
+  StreamReader<std::vector<RouteDetails>> reader(std::move(stream));
+  auto pages = reader.readAll();
+  // 6 intf routes + 2 default routes + 1 link local route, 2 per page
+  EXPECT_EQ(5, pages.size());
+  EXPECT_THAT(
+      concatPages(pages, 2), UnorderedElementsAreArray(routeDetails));
+
+  EXPECT_THROW(handler.streamRouteTableDetails(0), FbossError);
+}
+
+TYPED_TEST(ThriftTest, streamArpTable) {
+  ThriftHandler handler(this->sw_);
+  addArpEntries(this->sw_, 0, 5);
+
+  StreamReader<std::vector<ArpEntryThrift>> reader(
+      handler.streamArpTable(3));
+  auto pages = reader.readAll();
+  ASSERT_EQ(2, pages.size());
+  EXPECT_EQ(3, pages[0].size());
+  EXPECT_EQ(2, pages[1].size());
+  std::vector<BinaryAddress> ips;
+  for (const auto& entry : concatPages(pages, 3)) {
+    EXPECT_EQ(1, *entry.vlanID_ref());
+    EXPECT_EQ("REACHABLE", *entry.state_ref());
+    ips.push_back(*entry.ip_ref());
+  }
+  std::vector<BinaryAddress> expectedIps;
+  for (auto i = 0; i < 5; ++i) {
+    expectedIps.push_back(toBinaryAddress(arpEntryIp(i)));
+  }
+  EXPECT_THAT(ips, UnorderedElementsAreArray(expectedIps));
+}
+
+TYPED_TEST(ThriftTest, subscribeToRouteTableUpdates) {
+  ThriftHandler handler(this->sw_);
+  std::vector<RouteDetails> routeDetails;
+  handler.getRouteTableDetails(routeDetails);
+
+  StreamReader<RouteTableUpdate> reader(
+      handler.subscribeToRouteTableUpdates(4));
+  // The 9 routes of VRF 0 in pages of 4, the last one ending the snapshot
+  auto updates = reader.waitFor(3);
+  ASSERT_EQ(3, updates.size());
+  std::vector<RouteDetails> snapshot;
+  for (const auto& update : updates) {
+    EXPECT_TRUE(*update.snapshot_ref());
+    EXPECT_EQ(0, *update.vrf_ref());
+    EXPECT_LE(update.addedOrChanged_ref()->size(), 4);
+    EXPECT_TRUE(update.removed_ref()->empty());
+    snapshot.insert(
+        snapshot.end(),
+        update.addedOrChanged_ref()->begin(),
+        update.addedOrChanged_ref()->end());
+  }
+  EXPECT_FALSE(*updates[0].endOfSnapshot_ref());
+  EXPECT_TRUE(*updates[2].endOfSnapshot_ref());
+  EXPECT_THAT(snapshot, UnorderedElementsAreArray(routeDetails));
+
+  handler.addUnicastRoutes(
+      10,
+      std::make_unique<std::vector<UnicastRoute>>(std::vector<UnicastRoute>{
+          *makeUnicastRoute("aaaa::/64", "2401:db00:2110:3001::1")}));
+  updates = reader.waitFor(4);
+  ASSERT_EQ(4, updates.size());
+  const auto& update = updates[3];
+  EXPECT_FALSE(*update.snapshot_ref());
+  ASSERT_EQ(1, update.addedOrChanged_ref()->size());
+  EXPECT_EQ(
+      ipPrefix("aaaa::", 64), *update.addedOrChanged_ref()->at(0).dest_ref());
+
+  handler.deleteUnicastRoutes(
+      10,
+      std::make_unique<std::vector<IpPrefix>>(
+          std::vector<IpPrefix>{ipPrefix("aaaa::", 64)}));
+  updates = reader.waitFor(5);
+  ASSERT_EQ(5, updates.size());
+  EXPECT_TRUE(updates[4].addedOrChanged_ref()->empty());
+  EXPECT_THAT(
+      *updates[4].removed_ref(),
+      ::testing::ElementsAre(ipPrefix("aaaa::", 64)));
+}
+
+TYPED_TEST(ThriftTest, subscribeToNeighborTableUpdates) {
+  ThriftHandler handler(this->sw_);
+  addArpEntries(this->sw_, 0, 5);
+
+  StreamReader<NeighborTableUpdate> reader(
+      handler.subscribeToNeighborTableUpdates(2));
+  auto updates = reader.waitFor(3);
+  ASSERT_EQ(3, updates.size());
+  size_t arpEntries = 0;
+  for (const auto& update : updates) {
+    EXPECT_TRUE(*update.snapshot_ref());
+    arpEntries += update.arpAddedOrChanged_ref()->size();
+  }
+  EXPECT_EQ(5, arpEntries);
+  EXPECT_TRUE(*updates[2].endOfSnapshot_ref());
+
+  addArpEntries(this->sw_, 5, 6);
+  updates = reader.waitFor(4);
+  ASSERT_EQ(4, updates.size());
+  const auto& update = updates[3];
+  EXPECT_FALSE(*update.snapshot_ref());
+  ASSERT_EQ(1, update.arpAddedOrChanged_ref()->size());
+  EXPECT_EQ(
+      toBinaryAddress(arpEntryIp(5)),
+      *update.arpAddedOrChanged_ref()->at(0).ip_ref());
+}
+
+TYPED_TEST(ThriftTest, tableUpdateSubscriberDisconnect) {
+  ThriftHandler handler(this->sw_);
+  {
+    StreamReader<RouteTableUpdate> reader(
+        handler.subscribeToRouteTableUpdates(4));
+    EXPECT_EQ(3, reader.waitFor(3).size());
+  }
+  // The publisher is unregistered and freed on the update thread once
+  // the subscriber goes away. Updates after that must not reach it.
+  waitForStateUpdates(this->sw_);
+  handler.addUnicastRoutes(
+      10,
+      std::make_unique<std::vector<UnicastRoute>>(std::vector<UnicastRoute>{
+          *makeUnicastRoute("aaaa::/64", "2401:db00:2110:3001::1")}));
+  waitForStateUpdates(this->sw_);
+}
@@ -0,0 +1,256 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+/*
+ * Measures packets per second through the tun interfaces in both directions:
+ *  - host to switch: packets sent by host sockets out of the tun interface,
+ *    read by TunIntf and sent out by the switch
+ *  - switch to host: packets the switch hands to TunManager, received by a
+ *    host socket
+ *
+ * The switch is simulated, so only the host stack and tun path are measured.
+ * Needs CAP_NET_ADMIN to create the tun interface, so it runs once, with
+ * hw_benchmark_main. Run with --tun_intf_queues to compare single-queue and
+ * multi-queue interfaces.
+ */
+
+#include <boost/cast.hpp>
+
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/TunManager.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+#include "fboss/agent/hw/sim/SimPlatform.h"
+#include "fboss/agent/hw/sim/SimSwitch.h"
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/SwitchState.h"
+#include "fboss/agent/state/Vlan.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddress.h>
+#include <folly/ScopeGuard.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+#include <folly/logging/xlog.h>
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+DEFINE_bool(json, true, "Output in json form");
+DEFINE_int32(
+    host_sender_threads,
+    4,
+    "Number of host threads sending packets to the switch, each its own flow");
+DEFINE_int32(
+    switch_sender_threads,
+    1,
+    "Number of switch threads sending packets to the host");
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+using folly::MacAddress;
+using std::make_shared;
+using std::make_unique;
+using std::shared_ptr;
+using std::unique_ptr;
+
+namespace {
+
+const InterfaceID kIntfID(1);
+const VlanID kVlanID(1);
+const auto kIntfAddr = IPAddress("10.0.0.1");
+// Multicast, so that the switch does not try to resolve the destination
+const auto kHostToSwitchDst = folly::IPAddressV4("239.1.1.1");
+constexpr uint16_t kSwitchToHostPort = 8001;
+constexpr auto kWarmupInterval = std::chrono::seconds(1);
+constexpr auto kMeasureInterval = std::chrono::seconds(5);
+
+unique_ptr<SwSwitch> setupSwitch() {
+  auto sw = make_unique<SwSwitch>(
+      make_unique<SimPlatform>(MacAddress("02:00:01:00:00:01"), 10));
+  sw->init(nullptr /* No custom TunManager */, SwitchFlags::ENABLE_TUN);
+
+  auto updateFn = [](const shared_ptr<SwitchState>& oldState) {
+    auto state = oldState->clone();
+    auto vlan1 = make_shared<Vlan>(kVlanID, "Vlan1");
+    state->addVlan(vlan1);
+    // Virtual, so that the interface is up without any ports up
+    auto intf1 = make_shared<Interface>(
+        kIntfID,
+        RouterID(0),
+        kVlanID,
+        "interface1",
+        MacAddress("02:00:01:00:00:01"),
+        9000,
+        true, /* is virtual */
+        false /* is state_sync disabled*/);
+    Interface::Addresses addrs1;
+    addrs1.emplace(kIntfAddr, 24);
+    intf1->setAddresses(addrs1);
+    state->addIntf(intf1);
+    return state;
+  };
+  sw->updateStateBlocking("setup", updateFn);
+
+  // Creates the tun interface
+  sw->initialConfigApplied(std::chrono::steady_clock::now());
+  auto ifName = util::createTunIntfName(kIntfID);
+  for (auto i = 0; i < 100 && !if_nametoindex(ifName.c_str()); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  CHECK(if_nametoindex(ifName.c_str())) << "No interface " << ifName;
+  // Let TunManager finish bringing it up and adding its address
+  std::this_thread::sleep_for(kWarmupInterval);
+  return sw;
+}
+
+uint32_t perSecond(uint64_t count, std::chrono::duration<double> interval) {
+  return count / interval.count();
+}
+
+uint32_t runHostToSwitch(SwSwitch* sw) {
+  auto sim = boost::polymorphic_downcast<SimSwitch*>(sw->getHw());
+  auto ifIndex = if_nametoindex(util::createTunIntfName(kIntfID).c_str());
+  std::atomic<bool> done{false};
+  std::vector<std::thread> senders;
+  for (auto i = 0; i < FLAGS_host_sender_threads; ++i) {
+    senders.emplace_back([ifIndex, i, &done]() {
+      auto sock = socket(AF_INET, SOCK_DGRAM, 0);
+      CHECK_GE(sock, 0);
+      SCOPE_EXIT {
+        close(sock);
+      };
+      struct ip_mreqn mreq {};
+      mreq.imr_ifindex = ifIndex;
+      CHECK_EQ(
+          setsockopt(sock, IPPROTO_IP, IP_MULTICAST_IF, &mreq, sizeof(mreq)),
+          0);
+      struct sockaddr_in dst {};
+      dst.sin_family = AF_INET;
+      dst.sin_port = htons(8000 + i);
+      dst.sin_addr.s_addr = kHostToSwitchDst.toLong();
+      char payload[64] = {};
+      while (!done) {
+        // Drops when the tun queue is full are expected
+        sendto(
+            sock,
+            payload,
+            sizeof(payload),
+            0,
+            reinterpret_cast<sockaddr*>(&dst),
+            sizeof(dst));
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(kWarmupInterval);
+  auto pktsBefore = sim->getTxCount();
+  auto timeBefore = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(kMeasureInterval);
+  auto pktsAfter = sim->getTxCount();
+  auto timeAfter = std::chrono::steady_clock::now();
+  done = true;
+  for (auto& sender : senders) {
+    sender.join();
+  }
+  return perSecond(pktsAfter - pktsBefore, timeAfter - timeBefore);
+}
+
+uint32_t runSwitchToHost(SwSwitch* sw) {
+  auto sock = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  CHECK_GE(sock, 0);
+  SCOPE_EXIT {
+    close(sock);
+  };
+  struct sockaddr_in addr {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(kSwitchToHostPort);
+  addr.sin_addr.s_addr = kIntfAddr.asV4().toLong();
+  CHECK_EQ(bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+  // UDP 10.0.0.2:8000 -> 10.0.0.1:8001, as trapped to CPU on vlan 1
+  auto pkt = MockRxPacket::fromHex(
+      // dst mac, src mac
+      "02 00 01 00 00 01  02 00 02 00 00 02"
+      // 802.1q, VLAN 1
+      "81 00  00 01"
+      // IPv4
+      "08 00"
+      // Version, IHL, DSCP, length 28
+      "45 00  00 1c"
+      // ID, flags, TTL 64, UDP, checksum
+      "00 00  40 00  40  11  26 cf"
+      // Source IP: 10.0.0.2
+      "0a 00 00 02"
+      // Destination IP: 10.0.0.1
+      "0a 00 00 01"
+      // Source port 8000, destination port 8001, length 8, no checksum
+      "1f 40  1f 41  00 08  00 00");
+  pkt->setSrcPort(PortID(1));
+  pkt->setSrcVlan(kVlanID);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> senders;
+  for (auto i = 0; i < FLAGS_switch_sender_threads; ++i) {
+    senders.emplace_back([sw, &pkt, &done]() {
+      while (!done) {
+        sw->sendPacketToHost(kIntfID, pkt->clone());
+      }
+    });
+  }
+
+  auto drain = [sock]() {
+    uint64_t received = 0;
+    char buf[64];
+    while (recv(sock, buf, sizeof(buf), 0) >= 0) {
+      ++received;
+    }
+    return received;
+  };
+  std::this_thread::sleep_for(kWarmupInterval);
+  drain();
+  uint64_t received = 0;
+  auto timeBefore = std::chrono::steady_clock::now();
+  auto timeEnd = timeBefore + kMeasureInterval;
+  while (std::chrono::steady_clock::now() < timeEnd) {
+    received += drain();
+  }
+  auto timeAfter = std::chrono::steady_clock::now();
+  done = true;
+  for (auto& sender : senders) {
+    sender.join();
+  }
+  return perSecond(received, timeAfter - timeBefore);
+}
+
+} // unnamed namespace
+
+BENCHMARK(TunIntfRate) {
+  folly::BenchmarkSuspender suspender;
+  auto sw = setupSwitch();
+  auto hostToSwitchPps = runHostToSwitch(sw.get());
+  auto switchToHostPps = runSwitchToHost(sw.get());
+
+  if (FLAGS_json) {
+    folly::dynamic tunRateJson = folly::dynamic::object;
+    tunRateJson["tun_host_to_switch_pps"] = hostToSwitchPps;
+    tunRateJson["tun_switch_to_host_pps"] = switchToHostPps;
+    std::cout << toPrettyJson(tunRateJson) << std::endl;
+  } else {
+    XLOG(INFO) << " Host to switch pps: " << hostToSwitchPps
+               << " switch to host pps: " << switchToHostPps;
+  }
+}
@@ -5,6 +5,76 @@
 
 namespace facebook::network {
 
+template <typename NODE>
+void RadixTreeNodeDeleter<NODE>::operator()(NODE* node) const {
+  RadixTreeNodePool<NODE>::deallocate(node);
+}
+
+template <typename NODE>
+RadixTreeNodePool<NODE>::~RadixTreeNodePool() {
+  // The tree frees all its nodes before its pool
+  DCHECK_EQ(liveNodes_, 0);
+  for (auto slab : slabs_) {
+    ::free(slab);
+  }
+}
+
+template <typename NODE>
+void RadixTreeNodePool<NODE>::addSlab() {
+  auto slab = ::aligned_alloc(kSlabBytes, kSlabBytes);
+  if (!slab) {
+    throw std::bad_alloc();
+  }
+  slabs_.push_back(slab);
+  static_cast<SlabHeader*>(slab)->pool = this;
+  auto slots =
+      reinterpret_cast<Slot*>(static_cast<char*>(slab) + kFirstSlotOffset);
+  // Hand out slots in address order
+  for (auto i = kSlotsPerSlab; i > 0; --i) {
+    slots[i - 1].nextFree = freeList_;
+    freeList_ = &slots[i - 1];
+  }
+}
+
+template <typename NODE>
+template <typename... Args>
+NODE* RadixTreeNodePool<NODE>::allocate(Args&&... args) {
+  if (!freeList_) {
+    addSlab();
+  }
+  auto slot = freeList_;
+  freeList_ = slot->nextFree;
+  NODE* node;
+  try {
+    node = new (&slot->node) NODE(std::forward<Args>(args)...);
+  } catch (...) {
+    slot->nextFree = freeList_;
+    freeList_ = slot;
+    throw;
+  }
+  ++liveNodes_;
+  return node;
+}
+
+template <typename NODE>
+void RadixTreeNodePool<NODE>::deallocate(NODE* node) {
+  auto slab = reinterpret_cast<SlabHeader*>(
+      reinterpret_cast<uintptr_t>(node) & ~(kSlabBytes - 1));
+  slab->pool->freeNode(node);
+}
+
+template <typename NODE>
+void RadixTreeNodePool<NODE>::freeNode(NODE* node) {
+  if (deleteCallback_) {
+    deleteCallback_(*node);
+  }
+  node->~NODE();
+  auto slot = reinterpret_cast<Slot*>(node);
+  slot->nextFree = freeList_;
+  freeList_ = slot;
+  --liveNodes_;
+}
+
 template <typename IPADDRTYPE, typename T>
 typename RadixTreeNode<IPADDRTYPE, T>::TreeDirection
 RadixTreeNode<IPADDRTYPE, T>::searchDirection(
@@ -96,6 +166,38 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::longestMatchImpl(
   return includeNonValueNodes ? curNode : lastValueNodeSeen;
 }
 
+template <typename IPADDRTYPE, typename T, typename TreeTraits>
+const typename RadixTree<IPADDRTYPE, T, TreeTraits>::TreeNode*
+RadixTree<IPADDRTYPE, T, TreeTraits>::lookupImpl(
+    const IPADDRTYPE& ipaddr,
+    uint8_t masklen,
+    bool& foundExact) const {
+  DCHECK_LE(masklen, IPADDRTYPE::bitCount());
+  typedef RadixTreeKey<IPADDRTYPE> Key;
+  // Bits past masklen are never compared, so no need to mask ipaddr
+  const auto key = Key::fromAddress(ipaddr);
+  const TreeNode* lastValueNodeSeen = nullptr;
+  auto curNode = root_.get();
+  while (curNode) {
+    auto nodeMasklen = curNode->masklen();
+    if (nodeMasklen > masklen ||
+        !radixTreeKeysMatch(
+            key, Key::fromAddress(curNode->ipAddress()), nodeMasklen)) {
+      break;
+    }
+    if (curNode->isValueNode()) {
+      lastValueNodeSeen = curNode;
+      foundExact = nodeMasklen == masklen;
+    }
+    if (nodeMasklen == masklen) {
+      break;
+    }
+    curNode = radixTreeKeyBit(key, nodeMasklen) ? curNode->right()
+                                                 : curNode->left();
+  }
+  return lastValueNodeSeen;
+}
+
 template <typename IPADDRTYPE, typename T, typename TreeTraits>
 inline void RadixTree<IPADDRTYPE, T, TreeTraits>::trailAppend(
     VecConstIterators* trail,
@@ -146,7 +248,7 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
       // specific root.
       auto prefix = IPADDRTYPE::longestCommonPrefix(
           {root_->ipAddress(), root_->masklen()}, {toAdd, mask});
-      std::unique_ptr<TreeNode> newRoot = nullptr;
+      NodePtr newRoot = nullptr;
       if (prefix.first == toAdd && prefix.second == mask) {
         // To be added node is the new root
         newRoot = std::move(newNode);
@@ -217,7 +319,7 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
         // bestMatchChild and new node.
         auto internalNode = makeNode(prefix.first, prefix.second);
         auto internalNodeRaw = internalNode.get();
-        std::unique_ptr<TreeNode> oldBestMatchChild = nullptr;
+        NodePtr oldBestMatchChild = nullptr;
         if (toAddDirection == TreeDirection::LEFT) {
           oldBestMatchChild = bestMatch->resetLeft(std::move(internalNode));
         } else {
@@ -237,7 +339,7 @@ RadixTree<IPADDRTYPE, T, TreeTraits>::insert(
         CHECK(internalNode == nullptr);
       } else {
         // New node needs to be inserted  b/w bestMatch and bestMatchChild
-        std::unique_ptr<TreeNode> oldBestMatchChild = nullptr;
+        NodePtr oldBestMatchChild = nullptr;
         if (toAddDirection == TreeDirection::LEFT) {
           oldBestMatchChild = bestMatch->resetLeft(std::move(newNode));
         } else {
@@ -402,21 +504,16 @@ bool RadixTree<IPADDRTYPE, T, TreeTraits>::radixSubTreesEqual(
 }
 
 template <typename IPADDRTYPE, typename T, typename TreeTraits>
-std::unique_ptr<typename RadixTree<IPADDRTYPE, T, TreeTraits>::TreeNode>
+typename RadixTree<IPADDRTYPE, T, TreeTraits>::NodePtr
 RadixTree<IPADDRTYPE, T, TreeTraits>::cloneSubTree(const TreeNode* node) {
   if (!node) {
     return nullptr;
   }
-  std::unique_ptr<TreeNode> copy;
+  NodePtr copy;
   if (node->isValueNode()) {
-    copy = std::make_unique<TreeNode>(
-        node->ipAddress(),
-        node->masklen(),
-        node->value(),
-        node->nodeDeleteCallback());
+    copy = makeNode(node->ipAddress(), node->masklen(), node->value());
   } else {
-    copy = std::make_unique<TreeNode>(
-        node->ipAddress(), node->masklen(), node->nodeDeleteCallback());
+    copy = makeNode(node->ipAddress(), node->masklen());
   }
   copy->resetLeft(cloneSubTree(node->left()));
   copy->resetRight(cloneSubTree(node->right()));
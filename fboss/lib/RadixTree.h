@@ -5,9 +5,13 @@
 
 #include <sys/socket.h>
 #include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <functional>
 #include <memory>
+#include <new>
 #include <string>
 #include <utility>
 #include <vector>
@@ -19,45 +23,108 @@
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
 #include <folly/Memory.h>
+#include <folly/lang/Bits.h>
 #include <optional>
 
 namespace facebook::network {
+
+template <typename IPADDRTYPE, typename T>
+class RadixTreeNode;
+
+/*
+ * Frees a RadixTreeNode back to the RadixTreeNodePool it was allocated
+ * from. Stateless, so that owning pointers to nodes stay pointer sized.
+ */
+template <typename NODE>
+struct RadixTreeNodeDeleter {
+  void operator()(NODE* node) const;
+};
+
+/*
+ * Slab allocator for the nodes of one RadixTree, which also holds the
+ * tree's (optional) node delete callback.
+ * Nodes are carved out of kSlabBytes sized, kSlabBytes aligned slabs, each
+ * starting with a pointer back to the pool, so a node can be freed given
+ * just its address. Freed nodes go on a free list for reuse, slabs are
+ * only released when the pool is destroyed.
+ */
+template <typename NODE>
+class RadixTreeNodePool {
+ public:
+  typedef std::function<void(const NODE&)> NodeDeleteCallback;
+  static constexpr size_t kSlabBytes = 16 * 1024;
+
+  explicit RadixTreeNodePool(NodeDeleteCallback deleteCallback)
+      : deleteCallback_(std::move(deleteCallback)) {}
+  ~RadixTreeNodePool();
+
+  template <typename... Args>
+  NODE* allocate(Args&&... args);
+  // Call the delete callback on node, destroy and free it
+  static void deallocate(NODE* node);
+
+  const NodeDeleteCallback& nodeDeleteCallback() const {
+    return deleteCallback_;
+  }
+  // Memory held by the pool, including free nodes
+  size_t bytesAllocated() const {
+    return slabs_.size() * kSlabBytes;
+  }
+  size_t liveNodes() const {
+    return liveNodes_;
+  }
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  RadixTreeNodePool(const RadixTreeNodePool&) = delete;
+  RadixTreeNodePool& operator=(const RadixTreeNodePool&) = delete;
+
+  union Slot {
+    Slot* nextFree;
+    typename std::aligned_storage<sizeof(NODE), alignof(NODE)>::type node;
+  };
+  struct SlabHeader {
+    RadixTreeNodePool* pool;
+  };
+  static constexpr size_t kFirstSlotOffset =
+      (sizeof(SlabHeader) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+  static constexpr size_t kSlotsPerSlab =
+      (kSlabBytes - kFirstSlotOffset) / sizeof(Slot);
+  static_assert(kSlotsPerSlab >= 16, "Radix tree node too large for slabs");
+
+  void addSlab();
+  void freeNode(NODE* node);
+
+  NodeDeleteCallback deleteCallback_;
+  std::vector<void*> slabs_;
+  Slot* freeList_{nullptr};
+  size_t liveNodes_{0};
+};
+
 /*
  * Node in RadixTree, holds IP, mask. Will hold  value for nodes
  * created as a result of user inserts. Other type of nodes are
  * ones created by the radix tree implementation, which will
  * hold no values. All non value nodes will have 2 children,
  * this invariant must be maintained at all times.
+ * Nodes are allocated from their tree's RadixTreeNodePool, which calls
+ * the tree's delete callback (if any) when a node is freed.
  */
 template <typename IPADDRTYPE, typename T>
 class RadixTreeNode {
  public:
-  // Optional function parameter to call from destructor
-  typedef std::function<void(const RadixTreeNode<IPADDRTYPE, T>&)>
-      NodeDeleteCallback;
+  typedef std::unique_ptr<RadixTreeNode, RadixTreeNodeDeleter<RadixTreeNode>>
+      NodePtr;
+  typedef RadixTreeNodePool<RadixTreeNode> NodePool;
+  // Optional function parameter to call before freeing a node
+  typedef std::function<void(const RadixTreeNode&)> NodeDeleteCallback;
 
-  RadixTreeNode(
-      const IPADDRTYPE& ipAddr,
-      uint8_t mlen,
-      NodeDeleteCallback deleteCallback)
-      : ipAddress_(ipAddr), masklen_(mlen), deleteCallback_(deleteCallback) {}
+  RadixTreeNode(const IPADDRTYPE& ipAddr, uint8_t mlen)
+      : ipAddress_(ipAddr), masklen_(mlen) {}
 
   template <typename VALUE>
-  RadixTreeNode(
-      const IPADDRTYPE& ipAddr,
-      uint8_t mlen,
-      VALUE&& val,
-      NodeDeleteCallback deleteCallback)
-      : ipAddress_(ipAddr),
-        masklen_(mlen),
-        value_(std::forward<VALUE>(val)),
-        deleteCallback_(deleteCallback) {}
-
-  ~RadixTreeNode() {
-    if (deleteCallback_) {
-      deleteCallback_(*this);
-    }
-  }
+  RadixTreeNode(const IPADDRTYPE& ipAddr, uint8_t mlen, VALUE&& val)
+      : ipAddress_(ipAddr), masklen_(mlen), value_(std::forward<VALUE>(val)) {}
 
   enum class TreeDirection { LEFT, RIGHT, PARENT, THIS_NODE };
 
@@ -100,11 +167,8 @@ class RadixTreeNode {
   T& value() {
     return value_.value();
   }
-  NodeDeleteCallback nodeDeleteCallback() const {
-    return deleteCallback_;
-  }
   std::string str(bool printValue = true) const {
-    auto nodeStr = folly::to<std::string>(ipAddress_.str(), "/", masklen_);
+    auto nodeStr = folly::to<std::string>(ipAddress_.str(), "/", masklen());
     if (printValue) {
       nodeStr += isNonValueNode()
           ? "(*)"
@@ -129,8 +193,7 @@ class RadixTreeNode {
         (!isValueNode() || this->value() == r.value());
   }
 
-  std::unique_ptr<RadixTreeNode> resetLeft(
-      std::unique_ptr<RadixTreeNode> newLeft) {
+  NodePtr resetLeft(NodePtr newLeft) {
     auto old = std::move(left_);
     left_ = std::move(newLeft);
     if (left_) {
@@ -139,8 +202,7 @@ class RadixTreeNode {
     return old;
   }
 
-  std::unique_ptr<RadixTreeNode> resetRight(
-      std::unique_ptr<RadixTreeNode> newRight) {
+  NodePtr resetRight(NodePtr newRight) {
     auto old = std::move(right_);
     right_ = std::move(newRight);
     if (right_) {
@@ -163,15 +225,65 @@ class RadixTreeNode {
   }
 
  protected:
+  // Laid out so that the mask length packs in after the address
   IPADDRTYPE ipAddress_;
-  uint32_t masklen_{0}; // Number of bits to match.
-  std::optional<T> value_;
-  std::unique_ptr<RadixTreeNode> left_{nullptr};
-  std::unique_ptr<RadixTreeNode> right_{nullptr};
+  uint8_t masklen_{0}; // Number of bits to match.
   RadixTreeNode* parent_{nullptr};
-  NodeDeleteCallback deleteCallback_;
+  NodePtr left_{nullptr};
+  NodePtr right_{nullptr};
+  std::optional<T> value_;
 };
 
+/*
+ * The bits of an address packed most significant first into 64 bit
+ * words, so that longest match can compare a node's whole prefix a word
+ * at a time rather than materializing masked addresses bit by bit.
+ */
+template <typename IPADDRTYPE>
+struct RadixTreeKey;
+
+template <>
+struct RadixTreeKey<folly::IPAddressV4> {
+  typedef std::array<uint64_t, 1> Words;
+  static Words fromAddress(const folly::IPAddressV4& addr) {
+    return {{static_cast<uint64_t>(addr.toLongHBO()) << 32}};
+  }
+};
+
+template <>
+struct RadixTreeKey<folly::IPAddressV6> {
+  typedef std::array<uint64_t, 2> Words;
+  static Words fromAddress(const folly::IPAddressV6& addr) {
+    Words words;
+    std::memcpy(words.data(), addr.bytes(), sizeof(words));
+    return {{folly::Endian::big(words[0]), folly::Endian::big(words[1])}};
+  }
+};
+
+// Whether the first masklen bits of a and b are the same
+template <size_t N>
+bool radixTreeKeysMatch(
+    const std::array<uint64_t, N>& a,
+    const std::array<uint64_t, N>& b,
+    uint32_t masklen) {
+  for (size_t i = 0; i < N && masklen; ++i) {
+    if (masklen < 64) {
+      return ((a[i] ^ b[i]) >> (64 - masklen)) == 0;
+    }
+    if (a[i] != b[i]) {
+      return false;
+    }
+    masklen -= 64;
+  }
+  return true;
+}
+
+// The n'th most significant bit of key, 0 indexed
+template <size_t N>
+bool radixTreeKeyBit(const std::array<uint64_t, N>& key, uint32_t n) {
+  return (key[n / 64] >> (63 - n % 64)) & 1;
+}
+
 /*
  * Forward Iterator to traverse a Radix tree
  * Traverses the tree in DFS/preorder fashion
@@ -378,6 +490,8 @@ class RadixTree {
   typedef RadixTreeNode<IPADDRTYPE, T> TreeNode;
   typedef typename TreeNode::TreeDirection TreeDirection;
   typedef typename TreeNode::NodeDeleteCallback NodeDeleteCallback;
+  typedef typename TreeNode::NodePtr NodePtr;
+  typedef typename TreeNode::NodePool NodePool;
   typedef typename TreeTraits::Iterator Iterator;
   typedef typename TreeTraits::ConstIterator ConstIterator;
   typedef typename std::vector<ConstIterator> VecConstIterators;
@@ -385,7 +499,8 @@ class RadixTree {
   explicit RadixTree(
       NodeDeleteCallback nodeDelCallback = NodeDeleteCallback(),
       const TreeTraits& treeTraits = TreeTraits())
-      : nodeDeleteCallback_(nodeDelCallback), traits_(treeTraits) {}
+      : nodePool_(std::make_unique<NodePool>(std::move(nodeDelCallback))),
+        traits_(treeTraits) {}
 
   RadixTree(const RadixTree& r) = delete;
   RadixTree& operator=(const RadixTree& r) = delete;
@@ -409,13 +524,19 @@ class RadixTree {
     size_ = 0;
   }
   RadixTree(RadixTree&& r) noexcept
-      : nodeDeleteCallback_(r.nodeDeleteCallback_), traits_(r.traits_) {
+      : RadixTree(r.nodeDeleteCallback(), r.traits_) {
     *this = std::move(r);
   }
   // Move radix tree onto this
   RadixTree& operator=(RadixTree&& r) noexcept {
-    // Don't copy the traits and delete callback, use
-    // ones with which this Radix tree was created
+    if (this == &r) {
+      return *this;
+    }
+    // Don't copy the traits, use ones with which this Radix tree was
+    // created. The nodes move along with the pool they were allocated
+    // from, and so keep the delete callback they were created with.
+    root_.reset();
+    std::swap(nodePool_, r.nodePool_);
     size_ = r.size_;
     makeRoot(std::move(r.root_));
     r.size_ = 0;
@@ -428,9 +549,9 @@ class RadixTree {
     static_assert(
         std::is_same<T, U>::value,
         "clone template type must be the same as Radix tree value type");
-    RadixTree copy(nodeDeleteCallback_, traits_);
+    RadixTree copy(nodeDeleteCallback(), traits_);
     copy.size_ = size_;
-    copy.root_ = cloneSubTree(root_.get());
+    copy.makeRoot(copy.cloneSubTree(root_.get()));
     return copy;
   }
   /*
@@ -465,7 +586,7 @@ class RadixTree {
   // NOTE: masklen is unsigned and must be <= ipaddr.bitCount()
   ConstIterator longestMatch(const IPADDRTYPE& ipaddr, uint8_t masklen) const {
     auto foundExact = false;
-    return traits_.makeCItr(longestMatchImpl(ipaddr, masklen, foundExact));
+    return traits_.makeCItr(lookupImpl(ipaddr, masklen, foundExact));
   }
 
   // Non const longest match
@@ -480,7 +601,7 @@ class RadixTree {
    */
   ConstIterator exactMatch(const IPADDRTYPE& ipaddr, uint8_t masklen) const {
     auto foundExact = false;
-    auto match = longestMatchImpl(ipaddr, masklen, foundExact);
+    auto match = lookupImpl(ipaddr, masklen, foundExact);
     return traits_.makeCItr(foundExact ? match : nullptr);
   }
 
@@ -583,14 +704,26 @@ class RadixTree {
     return root_.get();
   }
   NodeDeleteCallback nodeDeleteCallback() const {
-    return nodeDeleteCallback_;
+    return nodePool_->nodeDeleteCallback();
   }
   const TreeTraits& traits() const {
     return traits_;
   }
+  // Memory taken up by the tree's nodes, including freed ones kept for reuse
+  size_t nodeBytesAllocated() const {
+    return nodePool_->bytesAllocated();
+  }
 
  private:
-  static std::unique_ptr<TreeNode> cloneSubTree(const TreeNode* node);
+  NodePtr cloneSubTree(const TreeNode* node);
+  /*
+   * Read only lookup behind longestMatch and exactMatch. Returns the
+   * longest matching value node, comparing node prefixes a word at a time.
+   * Sets foundExact if that node's prefix is ipaddr/masklen itself.
+   */
+  const TreeNode*
+  lookupImpl(const IPADDRTYPE& ipaddr, uint8_t masklen, bool& foundExact)
+      const;
   // Worker function to do the actual longest match lookup.
   const TreeNode* longestMatchImpl(
       const IPADDRTYPE& ipaddr,
@@ -611,18 +744,17 @@ class RadixTree {
             ipaddr, masklen, foundExact, includeNonValueNodes, trail));
   }
 
-  std::unique_ptr<TreeNode> makeNode(const IPADDRTYPE& ip, uint8_t masklen) {
-    return std::make_unique<TreeNode>(ip, masklen, nodeDeleteCallback_);
+  NodePtr makeNode(const IPADDRTYPE& ip, uint8_t masklen) {
+    return NodePtr(nodePool_->allocate(ip, masklen));
   }
 
   template <typename VALUE>
-  std::unique_ptr<TreeNode>
-  makeNode(const IPADDRTYPE& ip, uint8_t masklen, VALUE&& value) {
-    return std::make_unique<TreeNode>(
-        ip, masklen, std::forward<VALUE>(value), nodeDeleteCallback_);
+  NodePtr makeNode(const IPADDRTYPE& ip, uint8_t masklen, VALUE&& value) {
+    return NodePtr(
+        nodePool_->allocate(ip, masklen, std::forward<VALUE>(value)));
   }
 
-  void makeRoot(std::unique_ptr<TreeNode> newRoot) {
+  void makeRoot(NodePtr newRoot) {
     CHECK(root_ != newRoot || root_ == nullptr);
     if (newRoot) {
       newRoot->setParent(nullptr);
@@ -635,9 +767,10 @@ class RadixTree {
       bool includeNonValueNodes,
       const TreeNode* node) const;
 
-  std::unique_ptr<TreeNode> root_{nullptr};
+  // Declared before root_, so that it outlives the nodes
+  std::unique_ptr<NodePool> nodePool_;
+  NodePtr root_{nullptr};
   size_t size_{0};
-  NodeDeleteCallback nodeDeleteCallback_;
   TreeTraits traits_;
 };
 
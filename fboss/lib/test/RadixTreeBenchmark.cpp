@@ -3,6 +3,7 @@
 #include <folly/Benchmark.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
+#include <algorithm>
 #include <set>
 #include <vector>
 #include "PyRadixWrapper.h"
@@ -27,6 +28,10 @@ DEFINE_int32(
     lookup_count,
     5000,
     "The number of elements to look up on each lookup iteration");
+DEFINE_int32(
+    rib_prefix_count,
+    200000,
+    "The number of v6 prefixes in the tree of the *Rib6 benchmarks");
 namespace {
 set<Prefix4> insertSet4;
 set<Prefix4> eraseSet4;
@@ -37,6 +42,9 @@ set<Prefix6> eraseSet6;
 set<Prefix6> exactMatchSet6;
 set<Prefix6> longestMatchSet6;
 vector<int> valueSet;
+vector<IPAddressV6> ribLookups6;
+PyRadixWrapper<IPAddressV6, int> ribPyRadix6;
+RadixTree<IPAddressV6, int> ribTree6;
 
 // V4 Benchmarks
 template <typename TREE>
@@ -197,6 +205,45 @@ BENCHMARK_RELATIVE(RadixTreeLongestMatch6) {
   }
 }
 
+/*
+ * Longest match of host addresses in a RIB sized tree, one per iteration,
+ * so that iters/s reads as lookups per second.
+ */
+BENCHMARK(PyRadixLongestMatchRib6, iters) {
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(
+        ribPyRadix6.longestMatch(ribLookups6[i % ribLookups6.size()], 128));
+  }
+}
+
+BENCHMARK_RELATIVE(RadixTreeLongestMatchRib6, iters) {
+  for (size_t i = 0; i < iters; ++i) {
+    folly::doNotOptimizeAway(
+        ribTree6.longestMatch(ribLookups6[i % ribLookups6.size()], 128));
+  }
+}
+
+void setupRib6() {
+  auto prefixes = ribSizedPrefixes6(FLAGS_rib_prefix_count);
+  for (auto pfx : prefixes) {
+    ribPyRadix6.insert(pfx.ip, pfx.mask, pfx.mask);
+    ribTree6.insert(pfx.ip, pfx.mask, pfx.mask);
+  }
+  // Random hosts in random prefixes
+  while (ribLookups6.size() < FLAGS_lookup_count) {
+    const auto& pfx = prefixes[folly::Random::rand32(prefixes.size())];
+    ByteArray16 ba;
+    *(uint64_t*)(&ba[0]) = folly::Random::rand64();
+    *(uint64_t*)(&ba[8]) = folly::Random::rand64();
+    // RIB prefixes are byte aligned
+    std::copy(pfx.ip.bytes(), pfx.ip.bytes() + pfx.mask / 8, ba.begin());
+    ribLookups6.push_back(IPAddressV6(ba));
+  }
+  LOG(INFO) << "RadixTree node memory per prefix: "
+            << ribTree6.nodeBytesAllocated() / ribTree6.size() << " bytes, "
+            << ribTree6.size() << " prefixes";
+}
+
 } // namespace
 
 int main(int /*argc*/, char* /*argv*/[]) {
@@ -252,5 +299,6 @@ int main(int /*argc*/, char* /*argv*/[]) {
     auto newIp = pfx.ip.mask(newMask);
     longestMatchSet6.insert(Prefix6(newIp, newMask));
   }
+  setupRib6();
   runBenchmarks();
 }
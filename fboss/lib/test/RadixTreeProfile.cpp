@@ -2,7 +2,10 @@
 
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <iostream>
 #include <set>
 #include <vector>
 #include "Utils.h"
@@ -23,6 +26,12 @@ DEFINE_bool(v6Inserts, false, "Do inserts into v6 trees");
 DEFINE_bool(v6Deletes, false, "Perform deletes on v6 trees");
 DEFINE_bool(v6Exact, false, "Perform exact match on v6 trees");
 DEFINE_bool(v6Longest, false, "Perform longest match on v6 trees");
+DEFINE_bool(
+    v6Rib,
+    false,
+    "Perform longest match of hosts on one RIB sized v6 tree, reporting "
+    "node memory per prefix and lookups per second");
+DEFINE_int32(v6RibPrefixes, 200000, "Number of prefixes in the RIB sized tree");
 
 constexpr auto kTreeCount = 1000;
 constexpr auto kInsertCount = 10000;
@@ -143,6 +152,37 @@ void radixTreeLongestMatch6() {
   }
 }
 
+void radixTreeRib6() {
+  RadixTree<IPAddressV6, int> rtree;
+  auto prefixes = ribSizedPrefixes6(FLAGS_v6RibPrefixes);
+  for (auto pfx : prefixes) {
+    rtree.insert(pfx.ip, pfx.mask, pfx.mask);
+  }
+  vector<IPAddressV6> hosts;
+  for (auto i = 0; i < kMatchCount; ++i) {
+    const auto& pfx = prefixes[folly::Random::rand32(prefixes.size())];
+    ByteArray16 ba;
+    *(uint64_t*)(&ba[0]) = folly::Random::rand64();
+    *(uint64_t*)(&ba[8]) = folly::Random::rand64();
+    // RIB prefixes are byte aligned
+    std::copy(pfx.ip.bytes(), pfx.ip.bytes() + pfx.mask / 8, ba.begin());
+    hosts.push_back(IPAddressV6(ba));
+  }
+  auto start = std::chrono::steady_clock::now();
+  size_t matched = 0;
+  for (auto i = 0; i < kTreeCount; ++i) {
+    for (const auto& host : hosts) {
+      matched += !rtree.longestMatch(host, 128).atEnd();
+    }
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  std::cout << "prefixes: " << rtree.size() << " node bytes per prefix: "
+            << rtree.nodeBytesAllocated() / rtree.size()
+            << " lookups/sec: " << kTreeCount * hosts.size() / elapsed.count()
+            << " matched: " << matched << std::endl;
+}
+
 void fillV4MatchVec() {
   if (matchVec4.size()) {
     return;
@@ -229,6 +269,9 @@ int main(int argc, char* argv[]) {
       radixTreeLongestMatch6();
     }
   }
+  if (FLAGS_v6Rib) {
+    radixTreeRib6();
+  }
 
   return 0;
 }
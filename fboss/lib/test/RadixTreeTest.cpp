@@ -1527,3 +1527,64 @@ TEST(RadixTree, SubTreeIterator) {
   }
   EXPECT_EQ(rtree.end().subTreeIterator(), rtree.end());
 }
+
+/*
+ * Check the word at a time lookup behind longestMatch and exactMatch
+ * against the node by node walk of longestMatchWithTrail.
+ */
+TEST(RadixTree, LookupMatchesTrailWalk) {
+  RadixTree<IPAddressV6, int> rtree;
+  vector<Prefix6> inserted;
+  for (auto i = 0; i < 1000; ++i) {
+    folly::ByteArray16 ba;
+    *(uint64_t*)(&ba[0]) = folly::Random::rand64();
+    *(uint64_t*)(&ba[8]) = folly::Random::rand64();
+    // Keep prefixes close together, so that they share nodes
+    ba[0] = ba[1] = 0;
+    auto mask = folly::Random::rand32(129);
+    auto ip = IPAddressV6(ba).mask(mask);
+    if (rtree.insert(ip, mask, i).second) {
+      inserted.push_back(Prefix6(ip, mask));
+    }
+  }
+  for (auto pfx : inserted) {
+    auto shorterMask = pfx.mask ? folly::Random::rand32(pfx.mask) : 0;
+    for (auto mask : {pfx.mask, static_cast<uint8_t>(shorterMask)}) {
+      RadixTree<IPAddressV6, int>::VecConstIterators trail;
+      EXPECT_EQ(
+          rtree.longestMatchWithTrail(pfx.ip, mask, trail),
+          rtree.longestMatch(pfx.ip, mask));
+      EXPECT_EQ(
+          rtree.exactMatchWithTrail(pfx.ip, mask, trail),
+          rtree.exactMatch(pfx.ip, mask));
+    }
+  }
+}
+
+TEST(RadixTree, NodePool) {
+  auto deleteCount = 0;
+  auto deleteCallback = [&](const RadixTreeNode<IPAddressV4, int>& /*node*/) {
+    ++deleteCount;
+  };
+  RadixTree<IPAddressV4, int> rtree(deleteCallback), rtreeOrig;
+  setupTestTree4(rtree);
+  setupTestTree4(rtreeOrig);
+  auto bytesAllocated = rtree.nodeBytesAllocated();
+  EXPECT_GT(bytesAllocated, 0);
+
+  // Freed nodes are reused
+  rtree.clear();
+  EXPECT_GT(deleteCount, 0);
+  setupTestTree4(rtree);
+  EXPECT_TRUE(rtree == rtreeOrig);
+  EXPECT_EQ(bytesAllocated, rtree.nodeBytesAllocated());
+
+  // Nodes keep their delete callback when moved to another tree
+  deleteCount = 0;
+  RadixTree<IPAddressV4, int> moved(std::move(rtree));
+  EXPECT_EQ(0, rtree.size());
+  EXPECT_EQ(0, deleteCount);
+  EXPECT_TRUE(moved == rtreeOrig);
+  moved.clear();
+  EXPECT_GT(deleteCount, 0);
+}
@@ -2,6 +2,12 @@
 #include "common/network/IPAddressV4.h"
 #include "common/network/IPAddressV6.h"
 
+#include <folly/IPAddressV6.h>
+#include <folly/Random.h>
+
+#include <set>
+#include <vector>
+
 // Utility structs used in multiple test files
 struct Prefix4 {
   Prefix4(const facebook::network::IPAddressV4& _ip, uint8_t _mask)
@@ -22,3 +28,25 @@ struct Prefix6 {
   facebook::network::IPAddressV6 ip;
   uint8_t mask;
 };
+
+/*
+ * count distinct v6 prefixes shaped like a production RIB: /48s, /56s and
+ * /64s under a handful of /32 aggregates.
+ */
+inline std::vector<Prefix6> ribSizedPrefixes6(size_t count) {
+  constexpr auto kAggregates = 16;
+  std::set<Prefix6> prefixes;
+  while (prefixes.size() < count) {
+    folly::ByteArray16 ba;
+    *(uint64_t*)(&ba[0]) = folly::Random::rand64();
+    *(uint64_t*)(&ba[8]) = folly::Random::rand64();
+    ba[0] = 0x24;
+    ba[1] = 0x01;
+    ba[2] = 0xdb;
+    ba[3] = folly::Random::rand32(kAggregates);
+    auto pick = folly::Random::rand32(10);
+    uint8_t mask = pick < 4 ? 48 : (pick < 6 ? 56 : 64);
+    prefixes.insert(Prefix6(folly::IPAddressV6(ba).mask(mask), mask));
+  }
+  return {prefixes.begin(), prefixes.end()};
+}
@@ -425,6 +425,11 @@ void QsfpModule::refresh() {
   refreshLocked();
 }
 
+bool QsfpModule::needsFullRefresh() {
+  lock_guard<std::mutex> g(qsfpModuleMutex_);
+  return dirty_;
+}
+
 folly::Future<folly::Unit> QsfpModule::futureRefresh() {
   auto i2cEvb = qsfpImpl_->getI2cEventBase();
   if (!i2cEvb) {
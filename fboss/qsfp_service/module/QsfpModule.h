@@ -78,6 +78,11 @@ class QsfpModule : public Transceiver {
   virtual void refresh() override;
   folly::Future<folly::Unit> futureRefresh() override;
 
+  bool needsFullRefresh() override;
+  folly::EventBase* getI2cEventBase() override {
+    return qsfpImpl_->getI2cEventBase();
+  }
+
   /*
    * Customize QSPF fields as necessary
    *
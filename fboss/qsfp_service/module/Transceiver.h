@@ -15,6 +15,7 @@
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
 #include <folly/futures/Future.h>
+#include <folly/io/async/EventBase.h>
 
 namespace facebook {
 namespace fboss {
@@ -53,6 +54,18 @@ class Transceiver {
   virtual void refresh() = 0;
   virtual folly::Future<folly::Unit> futureRefresh() = 0;
 
+  /*
+   * Whether the next refresh reads all pages, static ones included, rather
+   * than only the DOM and alarm pages that change.
+   */
+  virtual bool needsFullRefresh() = 0;
+
+  /*
+   * The event base running the I2C transactions of this transceiver, one per
+   * independent I2C controller. nullptr if the platform has a single bus.
+   */
+  virtual folly::EventBase* getI2cEventBase() = 0;
+
   /*
    * Return all of the transceiver information
    */
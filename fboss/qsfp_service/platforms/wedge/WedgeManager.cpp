@@ -18,18 +18,48 @@
 #include <folly/logging/xlog.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 
+#include <algorithm>
+
 // allow us to configure the warmboot dir so that the qsfp cold boot test can
 // run concurrently with itself
 DEFINE_string(
     warmboot_dir,
     "/dev/shm/fboss/warm_boot",
     "Path to the directory in which we store the warmboot flag");
+DEFINE_int32(
+    qsfp_refresh_max_backoff_cycles,
+    8,
+    "Most refresh cycles a transceiver that keeps failing to refresh is "
+    "skipped for. The number of cycles skipped doubles with each failure");
 
 namespace {
 
 constexpr int kSecAfterModuleOutOfReset = 2;
 constexpr auto kForceColdBootFileName = "cold_boot_once_qsfp_service";
 
+/*
+ * Transceivers accessed through the same I2C controller, refreshed one
+ * after the other.
+ */
+struct I2cBusRefresh {
+  std::vector<facebook::fboss::Transceiver*> transceivers;
+  // Whether each of transceivers refreshed fine
+  std::vector<bool> refreshed;
+};
+
+void refreshI2cBus(I2cBusRefresh& bus) {
+  for (size_t i = 0; i < bus.transceivers.size(); ++i) {
+    auto transceiver = bus.transceivers[i];
+    try {
+      transceiver->refresh();
+      bus.refreshed[i] = true;
+    } catch (const std::exception& ex) {
+      XLOG(DBG2) << "Transceiver " << static_cast<int>(transceiver->getID())
+                 << ": Error calling refresh(): " << ex.what();
+    }
+  }
+}
+
 } // namespace
 
 namespace facebook {
@@ -360,21 +390,78 @@ void WedgeManager::refreshTransceivers() {
   // transceiver mapping and type here.
   updateTransceiverMap();
 
-  std::vector<folly::Future<folly::Unit>> futs;
   XLOG(INFO) << "Start refreshing all transceivers...";
 
   auto lockedTransceivers = transceivers_.rlock();
 
+  // Transceivers on different I2C controllers are refreshed in parallel, each
+  // controller's by its event base. Transceivers without one share the single
+  // bus of the platform.
+  std::map<folly::EventBase*, I2cBusRefresh> buses;
   for (const auto& transceiver : *lockedTransceivers) {
-    XLOG(DBG3) << "Fired to refresh transceiver "
-               << transceiver.second->getID();
-    futs.push_back(transceiver.second->futureRefresh());
+    auto& backoff = refreshBackoff_[transceiver.first];
+    if (backoff.cyclesToSkip > 0) {
+      --backoff.cyclesToSkip;
+      XLOG(DBG3) << "Skipped refreshing failing transceiver "
+                 << transceiver.first;
+      continue;
+    }
+    buses[transceiver.second->getI2cEventBase()].transceivers.push_back(
+        transceiver.second.get());
   }
 
+  std::vector<folly::Future<folly::Unit>> futs;
+  for (auto& evbAndBus : buses) {
+    auto& bus = evbAndBus.second;
+    // Transceivers only needing their DOM and alarm pages go first, rather
+    // than waiting behind reading all pages of newly detected ones.
+    std::stable_partition(
+        bus.transceivers.begin(),
+        bus.transceivers.end(),
+        [](Transceiver* transceiver) {
+          return !transceiver->needsFullRefresh();
+        });
+    bus.refreshed.resize(bus.transceivers.size(), false);
+    if (auto evb = evbAndBus.first) {
+      XLOG(DBG3) << "Fired to refresh " << bus.transceivers.size()
+                 << " transceivers on an I2C controller";
+      futs.push_back(
+          via(evb).thenValue([&bus](auto&&) { refreshI2cBus(bus); }));
+    }
+  }
+  // This thread takes the single bus while the controllers work
+  if (auto it = buses.find(nullptr); it != buses.end()) {
+    refreshI2cBus(it->second);
+  }
   folly::collectAll(futs.begin(), futs.end()).wait();
+
+  for (const auto& evbAndBus : buses) {
+    const auto& bus = evbAndBus.second;
+    for (size_t i = 0; i < bus.transceivers.size(); ++i) {
+      updateRefreshBackoff(bus.transceivers[i]->getID(), bus.refreshed[i]);
+    }
+  }
   XLOG(INFO) << "Finished refreshing all transceivers";
 }
 
+void WedgeManager::updateRefreshBackoff(TransceiverID id, bool refreshed) {
+  auto& backoff = refreshBackoff_[id];
+  if (refreshed) {
+    backoff = RefreshBackoff();
+    return;
+  }
+  // Retry right away after a first failure, then after 1, 3, 7... cycles
+  ++backoff.failures;
+  backoff.cyclesToSkip = std::min(
+      (1 << std::min(backoff.failures - 1, 30)) - 1,
+      FLAGS_qsfp_refresh_max_backoff_cycles);
+  if (backoff.cyclesToSkip > 0) {
+    XLOG(WARN) << "Transceiver " << id << " failed to refresh "
+               << backoff.failures << " times in a row, skipping it for "
+               << backoff.cyclesToSkip << " refresh cycles";
+  }
+}
+
 int WedgeManager::scanTransceiverPresence(
     std::unique_ptr<std::vector<int32_t>> ids) {
   // If the id list is empty, we default to scan the presence of all the
@@ -402,14 +489,19 @@ int WedgeManager::scanTransceiverPresence(
 void WedgeManager::clearAllTransceiverReset() {
   qsfpPlatApi_->clearAllTransceiverReset();
   // Required delay time between a transceiver getting out of reset and fully
-  // functional.
-  sleep(kSecAfterModuleOutOfReset);
+  // functional. Only transceivers held in reset since boot, or just hard
+  // reset, need it. Others coming out of reset in between fail to refresh
+  // until ready, and get retried.
+  if (resetDelayPending_.exchange(false)) {
+    sleep(kSecAfterModuleOutOfReset);
+  }
 }
 
 void WedgeManager::triggerQsfpHardReset(int idx) {
   // This api accepts 1 based module id however the module id in
   // WedgeManager is 0 based.
   qsfpPlatApi_->triggerQsfpHardReset(idx + 1);
+  resetDelayPending_ = true;
 }
 
 std::unique_ptr<TransceiverI2CApi> WedgeManager::getI2CBus() {
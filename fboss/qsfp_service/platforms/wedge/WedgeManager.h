@@ -14,6 +14,8 @@
 #include "fboss/qsfp_service/TransceiverManager.h"
 #include "fboss/qsfp_service/platforms/wedge/WedgeI2CBusLock.h"
 
+#include <atomic>
+
 DECLARE_string(warmboot_dir);
 
 namespace facebook::fboss {
@@ -139,6 +141,11 @@ class WedgeManager : public TransceiverManager {
     phyManager_ = std::move(phyManager);
   }
 
+  int getRefreshCyclesToSkip(TransceiverID id) const {
+    auto it = refreshBackoff_.find(id);
+    return it == refreshBackoff_.end() ? 0 : it->second.cyclesToSkip;
+  }
+
   // thread safe handle to access bus
   std::unique_ptr<TransceiverI2CApi> wedgeI2cBus_;
 
@@ -155,6 +162,25 @@ class WedgeManager : public TransceiverManager {
 
  private:
   void loadConfig() override;
+
+  // Record how the refresh of a transceiver went, and how many of the next
+  // refresh cycles to skip it for if it failed.
+  void updateRefreshBackoff(TransceiverID id, bool refreshed);
+
+  /*
+   * Transceivers failing to refresh, typically because they do not answer on
+   * I2C, are refreshed less and less often so as not to hold up the other
+   * transceivers on their bus. Only accessed by refreshTransceivers().
+   */
+  struct RefreshBackoff {
+    int failures{0};
+    int cyclesToSkip{0};
+  };
+  std::map<TransceiverID, RefreshBackoff> refreshBackoff_;
+
+  // Whether transceivers may have just come out of reset, and need time
+  // before being accessed. True until the first refresh.
+  std::atomic<bool> resetDelayPending_{true};
   // Forbidden copy constructor and assignment operator
   WedgeManager(WedgeManager const&) = delete;
   WedgeManager& operator=(WedgeManager const&) = delete;
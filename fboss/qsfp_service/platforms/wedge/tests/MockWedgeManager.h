@@ -74,6 +74,8 @@ class MockWedgeManager : public WedgeManager {
     mockApi->throwReadExceptionForDomQuery_ = throwReadExceptionForDomQuery;
   }
 
+  using WedgeManager::getRefreshCyclesToSkip;
+
  private:
   MOCK_METHOD0(loadConfig, void());
   int numModules_;
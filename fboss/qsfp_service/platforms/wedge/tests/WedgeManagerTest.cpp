@@ -138,6 +138,30 @@ TEST_F(WedgeManagerTest, getTransceiverInfoWithReadExceptions) {
   }
 }
 
+TEST_F(WedgeManagerTest, refreshBacksOffFailingTransceivers) {
+  // Transceivers failing to refresh are skipped for more and more cycles
+  wedgeManager_->setReadException(false, true);
+  std::vector<int> expectedCyclesToSkip = {0, 1, 0, 3, 2, 1, 0, 7};
+  for (auto cyclesToSkip : expectedCyclesToSkip) {
+    wedgeManager_->refreshTransceivers();
+    for (int id = 0; id < wedgeManager_->getNumQsfpModules(); ++id) {
+      EXPECT_EQ(
+          wedgeManager_->getRefreshCyclesToSkip(TransceiverID(id)),
+          cyclesToSkip);
+    }
+  }
+
+  // Once skipped long enough, a transceiver that is fine again is refreshed
+  // every cycle
+  wedgeManager_->setReadException(false, false);
+  for (auto i = 0; i < 8; ++i) {
+    wedgeManager_->refreshTransceivers();
+  }
+  for (int id = 0; id < wedgeManager_->getNumQsfpModules(); ++id) {
+    EXPECT_EQ(wedgeManager_->getRefreshCyclesToSkip(TransceiverID(id)), 0);
+  }
+}
+
 TEST_F(WedgeManagerTest, readTransceiver) {
   std::map<int32_t, ReadResponse> response;
   std::unique_ptr<ReadRequest> request(new ReadRequest);